@@ -0,0 +1,34 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_BENCH_UTILS_H
+#define EDDL_BENCH_UTILS_H
+
+#include <benchmark/benchmark.h>
+
+#include "eddl/tensor/tensor.h"
+
+// Shapes are given as benchmark args: {batch, channels, rows, cols}
+inline vector<int> bench_shape(const benchmark::State& state, int n){
+    vector<int> shape;
+    for (int i = 0; i < n; i++) shape.push_back((int)state.range(i));
+    return shape;
+}
+
+// Bytes touched by the kernel (reads + writes), reported as "bytes_per_second"
+inline void bench_set_bytes(benchmark::State& state, long int nfloats){
+    state.SetBytesProcessed((int64_t)state.iterations() * nfloats * (int64_t)sizeof(float));
+}
+
+// Floating point operations per iteration, reported as "FLOPS" (rate)
+inline void bench_set_flops(benchmark::State& state, double flops){
+    state.counters["FLOPS"] = benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate, benchmark::Counter::kIs1000);
+}
+
+#endif //EDDL_BENCH_UTILS_H
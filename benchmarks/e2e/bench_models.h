@@ -0,0 +1,143 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_BENCH_MODELS_H
+#define EDDL_BENCH_MODELS_H
+
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#include "eddl/apis/eddl.h"
+#include "eddl/serialization/onnx/eddl_onnx.h"
+
+using namespace eddl;
+
+// Helpers shared by the end-to-end drivers: model zoo (synthetic weights) and argument parsing
+
+static vector<int> parse_ints(const string &s){
+    vector<int> v;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t end = s.find(',', start);
+        if (end == string::npos) end = s.size();
+        if (end > start) v.push_back(std::stoi(s.substr(start, end - start)));
+        start = end + 1;
+    }
+    return v;
+}
+
+static double peak_rss_mb(){
+#if !defined(_WIN32)
+    struct rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes
+#else
+    return usage.ru_maxrss / 1024.0;  // kilobytes
+#endif
+#else
+    return 0.0;
+#endif
+}
+
+
+// Models ******************************************
+
+static layer VGGBlock(layer l, int filters, int nconv, bool bn){
+    for (int i = 0; i < nconv; i++) {
+        l = Conv2D(l, filters, {3, 3});
+        if (bn) l = BatchNormalization(l, 0.99f, 0.001f, true);
+        l = ReLu(l);
+    }
+    return MaxPool2D(l, {2, 2}, {2, 2});
+}
+
+static layer VGG16(layer l, int num_classes, bool bn){
+    l = VGGBlock(l, 64, 2, bn);
+    l = VGGBlock(l, 128, 2, bn);
+    l = VGGBlock(l, 256, 3, bn);
+    l = VGGBlock(l, 512, 3, bn);
+    l = VGGBlock(l, 512, 3, bn);
+    l = Flatten(l);
+    l = ReLu(Dense(l, 4096));
+    l = ReLu(Dense(l, 4096));
+    return Softmax(Dense(l, num_classes));
+}
+
+static layer ConvBN(layer l, int filters, vector<int> ks, vector<int> st, bool relu){
+    // Strided "same" convolutions pad asymmetrically, which Conv does not allow: pad explicitly
+    string padding = "same";
+    if (st[0] > 1 && ks[0] > 1) {
+        l = Pad(l, {ks[0] / 2, ks[1] / 2});
+        padding = "valid";
+    }
+    l = BatchNormalization(Conv2D(l, filters, ks, st, padding, false), 0.99f, 0.001f, true);
+    return relu ? ReLu(l) : l;
+}
+
+static layer BasicBlock(layer l, int filters, bool half){
+    vector<int> st = half ? vector<int>{2, 2} : vector<int>{1, 1};
+    layer shortcut = l;
+    if (half || l->output->shape[1] != filters) shortcut = ConvBN(l, filters, {1, 1}, st, false);
+    l = ConvBN(l, filters, {3, 3}, st, true);
+    l = ConvBN(l, filters, {3, 3}, {1, 1}, false);
+    return ReLu(Add({l, shortcut}));
+}
+
+static layer Bottleneck(layer l, int filters, bool half){
+    vector<int> st = half ? vector<int>{2, 2} : vector<int>{1, 1};
+    layer shortcut = l;
+    if (half || l->output->shape[1] != filters * 4) shortcut = ConvBN(l, filters * 4, {1, 1}, st, false);
+    l = ConvBN(l, filters, {1, 1}, {1, 1}, true);
+    l = ConvBN(l, filters, {3, 3}, st, true);
+    l = ConvBN(l, filters * 4, {1, 1}, {1, 1}, false);
+    return ReLu(Add({l, shortcut}));
+}
+
+static layer ResNet(layer l, int num_classes, const vector<int> &blocks, bool bottleneck){
+    l = ConvBN(l, 64, {7, 7}, {2, 2}, true);
+    l = MaxPool2D(Pad(l, {1, 1}), {3, 3}, {2, 2}, "valid");
+    int filters = 64;
+    for (int s = 0; s < blocks.size(); s++, filters *= 2) {
+        for (int b = 0; b < blocks[s]; b++) {
+            bool half = (s > 0 && b == 0);
+            l = bottleneck ? Bottleneck(l, filters, half) : BasicBlock(l, filters, half);
+        }
+    }
+    l = Flatten(GlobalAveragePool2D(l));
+    return Softmax(Dense(l, num_classes));
+}
+
+static model build_model(const string &name, const vector<int> &input_shape, int num_classes){
+    if (name.size() > 5 && name.substr(name.size() - 5) == ".onnx") {
+        return import_net_from_onnx_file(name, input_shape);
+    }
+
+    layer in = Input(input_shape);
+    layer out;
+    if (name == "mlp") {
+        layer l = Flatten(in);
+        for (int i = 0; i < 3; i++) l = ReLu(Dense(l, 1024));
+        out = Softmax(Dense(l, num_classes));
+    }
+    else if (name == "vgg16") out = VGG16(in, num_classes, false);
+    else if (name == "vgg16_bn") out = VGG16(in, num_classes, true);
+    else if (name == "resnet18") out = ResNet(in, num_classes, {2, 2, 2, 2}, false);
+    else if (name == "resnet34") out = ResNet(in, num_classes, {3, 4, 6, 3}, false);
+    else if (name == "resnet50") out = ResNet(in, num_classes, {3, 4, 6, 3}, true);
+    else msg("Unknown model '" + name + "'", "build_model");
+
+    return Model({in}, {out});
+}
+
+#endif //EDDL_BENCH_MODELS_H
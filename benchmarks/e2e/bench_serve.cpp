@@ -0,0 +1,196 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+
+#include "bench_models.h"
+#include "eddl/serving/batcher.h"
+#include "eddl/serving/server.h"
+
+
+using namespace eddl;
+using namespace std::chrono;
+
+//////////////////////////////////
+// bench_serve.cpp:
+// Load generator for the batching
+// inference server. Closed loop: each
+// client sends a single-sample request
+// and waits for the answer
+//
+// Usage: eddl_bench_serve [options]
+//   --model <name|file.onnx>  mlp, vgg16, vgg16_bn, resnet18, resnet34, resnet50 (default: resnet18)
+//   --input <c,h,w>           Input shape (default: 3,224,224)
+//   --classes <n>             Number of classes (default: 1000)
+//   --clients <n>             Concurrent clients (default: 16)
+//   --requests <n>            Requests per client (default: 50)
+//   --max-batch <n>           Batcher: maximum batch size (default: 32)
+//   --max-delay <us>          Batcher: maximum wait of a request (default: 2000)
+//   --workers <n>             Batcher: concurrent forward passes (default: 1)
+//   --no-pad                  Batcher: run the actual batch size (resizes the net)
+//   --transport <socket|local|direct>
+//                             socket: clients connect through a Unix socket (default)
+//                             local: clients call the batcher in-process
+//                             direct: no batching, each client predicts with batch 1 on its own context
+//   --socket <path>           (default: /tmp/eddl_bench_serve.sock)
+//   --threads <n>             CPU threads (default: -1, all)
+//   --json <file>             Store the results as JSON
+//////////////////////////////////
+
+static double percentile(vector<double> &sorted, double p){
+    if (sorted.empty()) return 0.0;
+    size_t i = std::min(sorted.size() - 1, (size_t)(p * sorted.size()));
+    return sorted[i];
+}
+
+
+int main(int argc, char **argv){
+    string model_name = "resnet18";
+    vector<int> input_shape = {3, 224, 224};
+    int num_classes = 1000;
+    int clients = 16;
+    int requests = 50;
+    int max_batch = BATCHER_MAX_BATCH;
+    int max_delay = BATCHER_MAX_DELAY_US;
+    int workers = 1;
+    bool pad = true;
+    string transport = "socket";
+    string socket_path = "/tmp/eddl_bench_serve.sock";
+    int threads = -1;
+    string json_file;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (arg == "--model" && has_value) model_name = argv[++i];
+        else if (arg == "--input" && has_value) input_shape = parse_ints(argv[++i]);
+        else if (arg == "--classes" && has_value) num_classes = std::stoi(argv[++i]);
+        else if (arg == "--clients" && has_value) clients = std::stoi(argv[++i]);
+        else if (arg == "--requests" && has_value) requests = std::stoi(argv[++i]);
+        else if (arg == "--max-batch" && has_value) max_batch = std::stoi(argv[++i]);
+        else if (arg == "--max-delay" && has_value) max_delay = std::stoi(argv[++i]);
+        else if (arg == "--workers" && has_value) workers = std::stoi(argv[++i]);
+        else if (arg == "--no-pad") pad = false;
+        else if (arg == "--transport" && has_value) transport = argv[++i];
+        else if (arg == "--socket" && has_value) socket_path = argv[++i];
+        else if (arg == "--threads" && has_value) threads = std::stoi(argv[++i]);
+        else if (arg == "--json" && has_value) json_file = argv[++i];
+        else {
+            cerr << "Unknown or incomplete argument: " << arg << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (transport != "socket" && transport != "local" && transport != "direct")
+        msg("Transport must be 'socket', 'local' or 'direct'", "bench_serve");
+    if (clients <= 0 || requests <= 0) msg("The number of clients and requests must be positive", "bench_serve");
+
+    // Model
+    model net = build_model(model_name, input_shape, num_classes);
+    if (net == nullptr) msg("Unable to build the model '" + model_name + "'", "bench_serve");
+    net->verbosity_level = 0;
+    build(net, sgd(0.01f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(threads), !net->onnx_pretrained);
+
+    InferenceBatcher *batcher = nullptr;
+    InferenceServer *server = nullptr;
+    if (transport != "direct") batcher = new InferenceBatcher(net, max_batch, max_delay, workers, pad);
+    if (transport == "socket") server = new InferenceServer(batcher, socket_path);
+
+    // One synthetic sample per client
+    vector<int> xshape = net->lin[0]->output->shape;
+    xshape[0] = 1;
+
+    std::mutex mtx;
+    vector<double> latencies;
+    auto client = [&](int c){
+        Tensor *x = Tensor::randu(xshape);
+        InferenceClient *conn = (transport == "socket") ? new InferenceClient(socket_path) : nullptr;
+        model ctx = (transport == "direct") ? create_context(net) : nullptr;
+
+        vector<double> times;
+        for (int r = 0; r < requests; r++) {
+            auto t0 = high_resolution_clock::now();
+            vtensor out;
+            if (conn != nullptr) out = conn->predict({x});
+            else if (ctx != nullptr) out = predict(ctx, {x});
+            else out = batcher->predict({x});
+            times.push_back(duration<double>(high_resolution_clock::now() - t0).count());
+            for (auto *t : out) delete t;
+        }
+
+        delete conn;
+        delete ctx;
+        delete x;
+        std::lock_guard<std::mutex> lock(mtx);
+        latencies.insert(latencies.end(), times.begin(), times.end());
+    };
+
+    auto t0 = high_resolution_clock::now();
+    vector<std::thread> pool;
+    for (int c = 0; c < clients; c++) pool.emplace_back(client, c);
+    for (auto &t : pool) t.join();
+    double elapsed = duration<double>(high_resolution_clock::now() - t0).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    double mean = 0.0;
+    for (double t : latencies) mean += t;
+    mean /= latencies.size();
+    double throughput = latencies.size() / elapsed;
+    float avg_batch = batcher != nullptr ? batcher->average_batch_size() : 1.0f;
+
+    // Report
+    cout << "===========================================" << endl;
+    cout << "Model:       " << model_name << " (" << net->layers.size() << " layers)" << endl;
+    cout << "Transport:   " << transport << endl;
+    cout << "Clients:     " << clients << " x " << requests << " requests" << endl;
+    if (batcher != nullptr) {
+        cout << "Batcher:     max_batch=" << max_batch << ", max_delay=" << max_delay << " us, workers=" << workers
+             << (pad ? ", padded" : "") << endl;
+    }
+    cout << "-------------------------------------------" << endl;
+    cout << "Throughput:  " << throughput << " requests/sec" << endl;
+    cout << "Latency:     mean " << mean * 1000.0 << " ms, p50 " << percentile(latencies, 0.50) * 1000.0
+         << " ms, p95 " << percentile(latencies, 0.95) * 1000.0 << " ms, p99 " << percentile(latencies, 0.99) * 1000.0 << " ms" << endl;
+    cout << "Avg. batch:  " << avg_batch << endl;
+    cout << "Peak RSS:    " << peak_rss_mb() << " MB" << endl;
+    cout << "===========================================" << endl;
+
+    if (!json_file.empty()) {
+        std::ofstream ofs(json_file);
+        if (!ofs.good()) msg("Unable to open '" + json_file + "'", "bench_serve");
+        ofs << "{\n";
+        ofs << "  \"model\": \"" << model_name << "\",\n";
+        ofs << "  \"transport\": \"" << transport << "\",\n";
+        ofs << "  \"clients\": " << clients << ",\n";
+        ofs << "  \"requests_per_client\": " << requests << ",\n";
+        ofs << "  \"max_batch\": " << max_batch << ",\n";
+        ofs << "  \"max_delay_us\": " << max_delay << ",\n";
+        ofs << "  \"workers\": " << workers << ",\n";
+        ofs << "  \"requests_per_sec\": " << throughput << ",\n";
+        ofs << "  \"latency_mean_ms\": " << mean * 1000.0 << ",\n";
+        ofs << "  \"latency_p50_ms\": " << percentile(latencies, 0.50) * 1000.0 << ",\n";
+        ofs << "  \"latency_p95_ms\": " << percentile(latencies, 0.95) * 1000.0 << ",\n";
+        ofs << "  \"latency_p99_ms\": " << percentile(latencies, 0.99) * 1000.0 << ",\n";
+        ofs << "  \"average_batch_size\": " << avg_batch << ",\n";
+        ofs << "  \"peak_rss_mb\": " << peak_rss_mb() << "\n";
+        ofs << "}\n";
+    }
+
+    delete server;
+    delete batcher;
+    delete net;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,220 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+
+#include "bench_models.h"
+
+
+using namespace eddl;
+using namespace std::chrono;
+
+//////////////////////////////////
+// bench_train.cpp:
+// End-to-end throughput of train_batch/predict
+// with synthetic data
+//
+// Usage: eddl_bench_train [options]
+//   --model <name|file.onnx>  mlp, vgg16, vgg16_bn, resnet18, resnet34, resnet50 (default: resnet18)
+//   --input <c,h,w>           Input shape (default: 3,224,224)
+//   --classes <n>             Number of classes (default: 1000)
+//   --batch <n>               Batch size (default: 32)
+//   --warmup <n>              Warm-up iterations (default: 2)
+//   --iters <n>               Timed iterations (default: 10)
+//   --mode <train|predict>    (default: train)
+//   --gpu <g1,g2,...>         Use CS_GPU with this mask (default: CS_CPU)
+//   --lsb <n>                 Weight sync for multi-gpu (default: 1)
+//   --threads <n>             CPU threads (default: -1, all)
+//   --mem <full_mem|mid_mem|low_mem>  (default: full_mem)
+//   --layers                  Print the per-layer forward/backward times
+//   --json <file>             Store the results as JSON
+//////////////////////////////////
+
+// Report ******************************************
+
+struct LayerTime {
+    string name;
+    double fwd;
+    double bwd;
+};
+
+static vector<LayerTime> collect_layer_times(model net, int iters){
+    // Sum the timers of every snet (one per device) and average them per iteration
+    vector<LayerTime> times;
+    for (int i = 0; i < net->vfts.size(); i++) {
+        times.push_back({net->vfts[i]->name, 0.0, 0.0});
+    }
+    for (auto *snet : net->snets) {
+        for (int i = 0; i < snet->vfts_time.size() && i < times.size(); i++) {
+            times[i].fwd += snet->vfts_time[i] / (iters * net->snets.size());
+        }
+        for (int i = 0; i < snet->vbts_time.size(); i++) {
+            // vbts is not the reverse of vfts in general, match them by name
+            for (auto &t : times) {
+                if (t.name == snet->vbts[i]->name) {
+                    t.bwd += snet->vbts_time[i] / (iters * net->snets.size());
+                    break;
+                }
+            }
+        }
+    }
+    return times;
+}
+
+int main(int argc, char **argv){
+    string model_name = "resnet18";
+    vector<int> input_shape = {3, 224, 224};
+    int num_classes = 1000;
+    int batch_size = 32;
+    int warmup = 2;
+    int iters = 10;
+    string mode = "train";
+    vector<int> gpus;
+    int lsb = 1;
+    int threads = -1;
+    string mem = "full_mem";
+    bool show_layers = false;
+    string json_file;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (arg == "--model" && has_value) model_name = argv[++i];
+        else if (arg == "--input" && has_value) input_shape = parse_ints(argv[++i]);
+        else if (arg == "--classes" && has_value) num_classes = std::stoi(argv[++i]);
+        else if (arg == "--batch" && has_value) batch_size = std::stoi(argv[++i]);
+        else if (arg == "--warmup" && has_value) warmup = std::stoi(argv[++i]);
+        else if (arg == "--iters" && has_value) iters = std::stoi(argv[++i]);
+        else if (arg == "--mode" && has_value) mode = argv[++i];
+        else if (arg == "--gpu" && has_value) gpus = parse_ints(argv[++i]);
+        else if (arg == "--lsb" && has_value) lsb = std::stoi(argv[++i]);
+        else if (arg == "--threads" && has_value) threads = std::stoi(argv[++i]);
+        else if (arg == "--mem" && has_value) mem = argv[++i];
+        else if (arg == "--layers") show_layers = true;
+        else if (arg == "--json" && has_value) json_file = argv[++i];
+        else {
+            cerr << "Unknown or incomplete argument: " << arg << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (mode != "train" && mode != "predict") msg("Mode must be 'train' or 'predict'", "bench_train");
+    if (iters <= 0) msg("The number of iterations must be positive", "bench_train");
+
+    // Model
+    model net = build_model(model_name, input_shape, num_classes);
+    if (net == nullptr) msg("Unable to build the model '" + model_name + "'", "bench_train");
+    net->verbosity_level = 0;
+
+    compserv cs = gpus.empty() ? CS_CPU(threads, mem) : CS_GPU(gpus, lsb, mem);
+    build(net, sgd(0.01f, 0.9f), {"softmax_cross_entropy"}, {"categorical_accuracy"}, cs, !net->onnx_pretrained);
+
+    // Synthetic data (the content does not matter for the throughput)
+    vector<int> xshape = net->lin[0]->output->shape;
+    vector<int> yshape = net->lout[0]->output->shape;
+    xshape[0] = batch_size;
+    yshape[0] = batch_size;
+    Tensor *x = Tensor::randu(xshape);
+    Tensor *y = Tensor::zeros(yshape);
+    for (int i = 0; i < batch_size; i++) y->ptr[i * (y->size / batch_size) + (i % (y->size / batch_size))] = 1.0f;
+    vector<int> indices(batch_size);
+    for (int i = 0; i < batch_size; i++) indices[i] = i;
+
+    auto step = [&](){
+        if (mode == "train") {
+            train_batch(net, {x}, {y}, indices);
+        } else {
+            vtensor out = predict(net, {x});
+            for (auto *t : out) delete t;
+        }
+    };
+
+    // Warm-up (allocations, first-touch, autotuning...)
+    for (int i = 0; i < warmup; i++) step();
+
+    // Timed iterations
+    net->set_layer_timing(show_layers || !json_file.empty());
+    vector<double> times;
+    for (int i = 0; i < iters; i++) {
+        auto t0 = high_resolution_clock::now();
+        step();
+        times.push_back(duration<double>(high_resolution_clock::now() - t0).count());
+    }
+    vector<LayerTime> layer_times = collect_layer_times(net, iters);
+    net->set_layer_timing(false);
+
+    double total = 0.0;
+    for (double t : times) total += t;
+    double mean = total / times.size();
+    vector<double> sorted(times);
+    std::sort(sorted.begin(), sorted.end());
+    double median = sorted[sorted.size() / 2];
+    double images_sec = batch_size / mean;
+    double rss = peak_rss_mb();
+
+    // Report
+    cout << "===========================================" << endl;
+    cout << "Model:       " << model_name << " (" << net->layers.size() << " layers)" << endl;
+    cout << "Mode:        " << mode << endl;
+    cout << "Device:      " << (gpus.empty() ? "CPU (threads=" + to_string(threads) + ")" : "GPU (" + printVector(gpus) + ")") << endl;
+    cout << "Memory:      " << mem << endl;
+    cout << "Batch size:  " << batch_size << endl;
+    cout << "Iterations:  " << iters << " (+" << warmup << " warm-up)" << endl;
+    cout << "-------------------------------------------" << endl;
+    cout << "Time/batch:  " << mean * 1000.0 << " ms (median " << median * 1000.0 << " ms, min " << sorted.front() * 1000.0 << " ms)" << endl;
+    cout << "Throughput:  " << images_sec << " images/sec" << endl;
+    cout << "Peak RSS:    " << rss << " MB" << endl;
+    cout << "===========================================" << endl;
+
+    if (show_layers) {
+        double fwd_total = 0.0, bwd_total = 0.0;
+        for (auto &t : layer_times) { fwd_total += t.fwd; bwd_total += t.bwd; }
+        printf("%-30s %12s %12s %8s\n", "Layer", "Fwd (ms)", "Bwd (ms)", "%");
+        for (auto &t : layer_times) {
+            printf("%-30s %12.3f %12.3f %7.2f%%\n", t.name.c_str(), t.fwd * 1000.0, t.bwd * 1000.0,
+                   100.0 * (t.fwd + t.bwd) / std::max(fwd_total + bwd_total, 1e-12));
+        }
+        printf("%-30s %12.3f %12.3f\n", "Total", fwd_total * 1000.0, bwd_total * 1000.0);
+    }
+
+    if (!json_file.empty()) {
+        std::ofstream ofs(json_file);
+        if (!ofs.good()) msg("Unable to open '" + json_file + "'", "bench_train");
+        ofs << "{\n";
+        ofs << "  \"model\": \"" << model_name << "\",\n";
+        ofs << "  \"mode\": \"" << mode << "\",\n";
+        ofs << "  \"device\": \"" << (gpus.empty() ? "cpu" : "gpu") << "\",\n";
+        ofs << "  \"mem\": \"" << mem << "\",\n";
+        ofs << "  \"batch_size\": " << batch_size << ",\n";
+        ofs << "  \"iterations\": " << iters << ",\n";
+        ofs << "  \"time_per_batch_ms\": " << mean * 1000.0 << ",\n";
+        ofs << "  \"median_time_per_batch_ms\": " << median * 1000.0 << ",\n";
+        ofs << "  \"images_per_sec\": " << images_sec << ",\n";
+        ofs << "  \"peak_rss_mb\": " << rss << ",\n";
+        ofs << "  \"layers\": [\n";
+        for (int i = 0; i < layer_times.size(); i++) {
+            auto &t = layer_times[i];
+            ofs << "    {\"name\": \"" << t.name << "\", \"forward_ms\": " << t.fwd * 1000.0
+                << ", \"backward_ms\": " << t.bwd * 1000.0 << "}" << (i + 1 < layer_times.size() ? "," : "") << "\n";
+        }
+        ofs << "  ]\n";
+        ofs << "}\n";
+    }
+
+    delete x;
+    delete y;
+    delete net;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+#include "eddl/apis/eddl.h"
+
+using namespace eddl;
+
+// Full-layer forward/backward (includes the layer bookkeeping: bias, activations, delta accumulation...)
+// The layer under test is the output layer of a tiny net: Input -> [layer]
+
+typedef layer (*LayerBuilder)(layer in);
+
+static layer build_dense(layer in) { return Dense(in, 1024); }
+static layer build_conv(layer in) { return Conv2D(in, 64, {3, 3}); }
+static layer build_maxpool(layer in) { return MaxPool2D(in, {2, 2}, {2, 2}); }
+static layer build_batchnorm(layer in) { return BatchNormalization(in); }
+static layer build_relu(layer in) { return ReLu(in); }
+static layer build_softmax(layer in) { return Softmax(in); }
+static layer build_concat(layer in) { return Concat({in, in}); }
+static layer build_add(layer in) { return Add({in, in}); }
+
+static void BM_layer(benchmark::State& state, LayerBuilder builder, vector<int> ishape, bool forward){
+    int batch = (int)state.range(0);
+
+    layer in = Input(ishape);
+    layer out = builder(in);
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+    build(net, sgd(0.01f), {"mse"}, {"mse"}, CS_CPU(), true);
+
+    vector<int> shape(ishape);
+    shape.insert(shape.begin(), batch);
+    Tensor* x = Tensor::randn(shape);
+    net->forward({x});
+
+    // Deltas are allocated lazily by the training loop
+    out->mem_delta();
+    out->mem_delta_parent();
+    out->delta->fill_rand_normal_(0.0f, 1.0f);
+
+    for (auto _ : state) {
+        if (forward) out->forward();
+        else out->backward();
+        benchmark::ClobberMemory();
+    }
+    bench_set_bytes(state, x->size + out->output->size);
+
+    delete x;
+    delete net;
+}
+
+#define LAYER_BENCHMARK(name, builder, ...) \
+    BENCHMARK_CAPTURE(BM_layer, name##_forward, builder, __VA_ARGS__, true)->ArgName("batch")->Arg(1)->Arg(32)->Unit(benchmark::kMicrosecond); \
+    BENCHMARK_CAPTURE(BM_layer, name##_backward, builder, __VA_ARGS__, false)->ArgName("batch")->Arg(1)->Arg(32)->Unit(benchmark::kMicrosecond)
+
+LAYER_BENCHMARK(dense_784, build_dense, vector<int>{784});
+LAYER_BENCHMARK(conv_64x56x56, build_conv, vector<int>{64, 56, 56});
+LAYER_BENCHMARK(maxpool_64x112x112, build_maxpool, vector<int>{64, 112, 112});
+LAYER_BENCHMARK(batchnorm_64x56x56, build_batchnorm, vector<int>{64, 56, 56});
+LAYER_BENCHMARK(relu_64x56x56, build_relu, vector<int>{64, 56, 56});
+LAYER_BENCHMARK(softmax_1000, build_softmax, vector<int>{1000});
+LAYER_BENCHMARK(concat_64x56x56, build_concat, vector<int>{64, 56, 56});
+LAYER_BENCHMARK(add_64x56x56, build_add, vector<int>{64, 56, 56});
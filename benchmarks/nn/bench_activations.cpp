@@ -0,0 +1,65 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+
+// Args: {rows, cols}
+#define ACT_ARGS ArgNames({"rows", "cols"}) \
+    ->Args({32, 128})       /* Small RNN hidden state */ \
+    ->Args({128, 1000})     /* Classifier output */ \
+    ->Args({32, 50000})     /* Vocabulary */ \
+    ->Args({32, 200704})    /* Conv activation (64x56x56) */ \
+    ->Unit(benchmark::kMicrosecond)
+
+template <void (*F)(Tensor*, Tensor*)>
+static void BM_activation(benchmark::State& state){
+    Tensor* A = Tensor::randn(bench_shape(state, 2));
+    Tensor* B = Tensor::empty_like(A);
+    for (auto _ : state) {
+        F(A, B);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+}
+BENCHMARK_TEMPLATE(BM_activation, tensorNN::ReLu)->ACT_ARGS;
+BENCHMARK_TEMPLATE(BM_activation, tensorNN::Sigmoid)->ACT_ARGS;
+BENCHMARK_TEMPLATE(BM_activation, tensorNN::Tanh)->ACT_ARGS;
+BENCHMARK_TEMPLATE(BM_activation, tensorNN::Exp)->ACT_ARGS;
+BENCHMARK_TEMPLATE(BM_activation, tensorNN::Softmax)->ACT_ARGS;
+
+template <void (*F)(Tensor*, Tensor*, Tensor*)>
+static void BM_activation_derivative(benchmark::State& state){
+    Tensor* I = Tensor::randn(bench_shape(state, 2));
+    Tensor* D = Tensor::randn(I->shape);
+    Tensor* PD = Tensor::zeros(I->shape);
+    for (auto _ : state) {
+        F(D, I, PD);
+        benchmark::DoNotOptimize(PD->ptr);
+    }
+    bench_set_bytes(state, 3 * I->size);
+    delete I; delete D; delete PD;
+}
+BENCHMARK_TEMPLATE(BM_activation_derivative, tensorNN::D_ReLu)->ACT_ARGS;
+BENCHMARK_TEMPLATE(BM_activation_derivative, tensorNN::D_Sigmoid)->ACT_ARGS;
+BENCHMARK_TEMPLATE(BM_activation_derivative, tensorNN::D_Tanh)->ACT_ARGS;
+BENCHMARK_TEMPLATE(BM_activation_derivative, tensorNN::D_Softmax)->ACT_ARGS;
+
+static void BM_full_softmax(benchmark::State& state){
+    Tensor* A = Tensor::randn(bench_shape(state, 2));
+    Tensor* B = Tensor::empty_like(A);
+    for (auto _ : state) {
+        tensorNN::FullSoftmax(A, B, 1);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+}
+BENCHMARK(BM_full_softmax)->ACT_ARGS;
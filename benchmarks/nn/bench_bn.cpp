@@ -0,0 +1,57 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+
+// Args: {batch, channels, rows, cols}
+#define BN_ARGS ArgNames({"b", "c", "h", "w"}) \
+    ->Args({32, 64, 56, 56}) \
+    ->Args({32, 512, 7, 7}) \
+    ->Args({128, 1024, 1, 1})  /* BN after Dense */ \
+    ->Unit(benchmark::kMicrosecond)
+
+template <bool FORWARD>
+static void BM_batchnorm(benchmark::State& state){
+    auto shape = bench_shape(state, 4);
+    vector<int> cshape = {shape[1]};
+
+    Tensor* input = Tensor::randn(shape);
+    Tensor* output = Tensor::empty(shape);
+    Tensor* opa = Tensor::zeros(shape);
+    Tensor* delta = Tensor::randn(shape);
+    Tensor* pdelta = Tensor::zeros(shape);
+    Tensor* mean = Tensor::zeros(cshape);
+    Tensor* variance = Tensor::ones(cshape);
+    Tensor* bn_mean = Tensor::zeros(cshape);
+    Tensor* bn_var = Tensor::ones(cshape);
+    Tensor* bn_g = Tensor::ones(cshape);
+    Tensor* bn_b = Tensor::zeros(cshape);
+    Tensor* gbn_g = Tensor::zeros(cshape);
+    Tensor* gbn_b = Tensor::zeros(cshape);
+    Tensor* work1 = Tensor::zeros(cshape);
+    Tensor* work2 = Tensor::zeros(cshape);
+
+    // Backward needs the pre-affine output and the batch statistics
+    tensorNN::BatchNormForward(input, output, opa, mean, variance, bn_g, bn_b, bn_mean, bn_var, true, 1e-5f, 0.99f);
+
+    for (auto _ : state) {
+        if (FORWARD) {
+            tensorNN::BatchNormForward(input, output, opa, mean, variance, bn_g, bn_b, bn_mean, bn_var, true, 1e-5f, 0.99f);
+        } else {
+            tensorNN::BatchNormBackward(delta, opa, pdelta, gbn_g, gbn_b, bn_g, bn_var, work1, work2);
+        }
+        benchmark::ClobberMemory();
+    }
+    bench_set_bytes(state, 3 * input->size);
+
+    for (auto t : {input, output, opa, delta, pdelta, mean, variance, bn_mean, bn_var, bn_g, bn_b, gbn_g, gbn_b, work1, work2}) delete t;
+}
+BENCHMARK_TEMPLATE(BM_batchnorm, true)->BN_ARGS;
+BENCHMARK_TEMPLATE(BM_batchnorm, false)->BN_ARGS;
@@ -0,0 +1,134 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/descriptors/descriptors.h"
+
+// Args: {batch, in_channels, rows, cols, filters, kernel, stride}
+#define CONV_ARGS ArgNames({"b", "c", "h", "w", "k", "ks", "s"}) \
+    ->Args({32, 3, 224, 224, 64, 3, 1})    /* VGG conv1 */ \
+    ->Args({32, 64, 56, 56, 64, 3, 1})     /* ResNet stage 1 */ \
+    ->Args({32, 256, 14, 14, 256, 3, 1})   /* ResNet stage 3 */ \
+    ->Args({32, 64, 56, 56, 256, 1, 1})    /* 1x1 bottleneck */ \
+    ->Args({32, 3, 224, 224, 64, 7, 2})    /* ResNet stem */ \
+    ->Unit(benchmark::kMillisecond)
+
+enum ConvPass { FORWARD, GRAD, BACK };
+
+template <ConvPass P>
+static void BM_conv2D(benchmark::State& state){
+    auto shape = bench_shape(state, 4);
+    int nk = (int)state.range(4), ks = (int)state.range(5), st = (int)state.range(6);
+
+    Tensor* A = Tensor::randn(shape);
+    auto *cd = new ConvolDescriptor(nk, {ks, ks}, {st, st}, "same", {}, 1, {1, 1}, true);
+    cd->build(A);
+    cd->K->fill_rand_normal_(0.0f, 0.1f);
+    cd->bias->fill_(0.0f);
+    cd->gK->fill_(0.0f);
+    cd->gbias->fill_(0.0f);
+    cd->ID = Tensor::zeros(cd->I->getShape());
+    cd->D = Tensor::randn(cd->O->getShape());
+
+    // The lowered input (ptrI) is filled by the forward pass
+    tensorNN::Conv2D(cd);
+
+    for (auto _ : state) {
+        if (P == FORWARD) tensorNN::Conv2D(cd);
+        else if (P == GRAD) tensorNN::Conv2D_grad(cd);
+        else tensorNN::Conv2D_back(cd);
+        benchmark::ClobberMemory();
+    }
+    bench_set_flops(state, 2.0 * cd->O->size * cd->kz * cd->kr * cd->kc);
+
+    delete cd->O; delete cd->ID; delete cd->D;
+    delete cd->K; delete cd->bias; delete cd->gK; delete cd->gbias;
+    delete cd; delete A;
+}
+BENCHMARK_TEMPLATE(BM_conv2D, FORWARD)->CONV_ARGS;
+BENCHMARK_TEMPLATE(BM_conv2D, GRAD)->CONV_ARGS;
+BENCHMARK_TEMPLATE(BM_conv2D, BACK)->CONV_ARGS;
+
+
+// Args: {batch, in_channels, depth, rows, cols, filters, kernel, mem}. mem=0: tiled vol2col+GEMM, mem=2: direct loops
+#define CONV3D_ARGS ArgNames({"b", "c", "d", "h", "w", "k", "ks", "mem"}) \
+    ->ArgsProduct({{1}, {16}, {32}, {32}, {32}, {16}, {3}, {0, 2}}) \
+    ->ArgsProduct({{2}, {32}, {16}, {16}, {16}, {32}, {3}, {0, 2}}) \
+    ->Unit(benchmark::kMillisecond)
+
+template <ConvPass P>
+static void BM_conv3D(benchmark::State& state){
+    auto shape = bench_shape(state, 5);
+    int nk = (int)state.range(5), ks = (int)state.range(6), mem = (int)state.range(7);
+
+    Tensor* A = Tensor::randn(shape);
+    auto *cd = new ConvolDescriptor3D(nk, {ks, ks, ks}, {1, 1, 1}, "same", {}, {1, 1, 1}, true, mem);
+    cd->build(A);
+    cd->K->fill_rand_normal_(0.0f, 0.1f);
+    cd->bias->fill_(0.0f);
+    cd->gK->fill_(0.0f);
+    cd->gbias->fill_(0.0f);
+    cd->ID = Tensor::zeros(cd->I->getShape());
+    cd->D = Tensor::randn(cd->O->getShape());
+
+    for (auto _ : state) {
+        if (P == FORWARD) tensorNN::Conv3D(cd);
+        else if (P == GRAD) tensorNN::Conv3D_grad(cd);
+        else tensorNN::Conv3D_back(cd);
+        benchmark::ClobberMemory();
+    }
+    bench_set_flops(state, 2.0 * cd->O->size * cd->kz * cd->kd * cd->kr * cd->kc);
+
+    delete cd->O; delete cd->ID; delete cd->D;
+    delete cd->K; delete cd->bias; delete cd->gK; delete cd->gbias;
+    delete cd; delete A;
+}
+BENCHMARK_TEMPLATE(BM_conv3D, FORWARD)->CONV3D_ARGS;
+BENCHMARK_TEMPLATE(BM_conv3D, GRAD)->CONV3D_ARGS;
+BENCHMARK_TEMPLATE(BM_conv3D, BACK)->CONV3D_ARGS;
+
+
+// Args: {batch, in_channels, rows, cols, filters, kernel, stride}. Decoder-like upsampling by the stride
+#define CONVT2D_ARGS ArgNames({"b", "c", "h", "w", "k", "ks", "s"}) \
+    ->Args({8, 64, 32, 32, 32, 4, 2})      /* DCGAN / U-Net up block */ \
+    ->Args({8, 128, 16, 16, 64, 3, 2})    \
+    ->Args({8, 32, 64, 64, 32, 3, 1})     \
+    ->Unit(benchmark::kMillisecond)
+
+template <ConvPass P>
+static void BM_convT2D(benchmark::State& state){
+    auto shape = bench_shape(state, 4);
+    int nk = (int)state.range(4), ks = (int)state.range(5), st = (int)state.range(6);
+
+    Tensor* A = Tensor::randn(shape);
+    auto *cd = new ConvolDescriptorT2D(nk, {ks, ks}, {st, st}, "same", {}, 1, {1, 1}, true);
+    cd->build(A);
+    cd->K->fill_rand_normal_(0.0f, 0.1f);
+    cd->bias->fill_(0.0f);
+    cd->gK->fill_(0.0f);
+    cd->gbias->fill_(0.0f);
+    cd->ID = Tensor::zeros(cd->I->getShape());
+    cd->D = Tensor::randn(cd->O->getShape());
+
+    for (auto _ : state) {
+        if (P == FORWARD) tensorNN::ConvT2D(cd);
+        else if (P == GRAD) tensorNN::ConvT2D_grad(cd);
+        else tensorNN::ConvT2D_back(cd);
+        benchmark::ClobberMemory();
+    }
+    bench_set_flops(state, 2.0 * cd->I->size * cd->kz * cd->kr * cd->kc);
+
+    delete cd->O; delete cd->ID; delete cd->D;
+    delete cd->K; delete cd->bias; delete cd->gK; delete cd->gbias;
+    delete cd; delete A;
+}
+BENCHMARK_TEMPLATE(BM_convT2D, FORWARD)->CONVT2D_ARGS;
+BENCHMARK_TEMPLATE(BM_convT2D, GRAD)->CONVT2D_ARGS;
+BENCHMARK_TEMPLATE(BM_convT2D, BACK)->CONVT2D_ARGS;
@@ -0,0 +1,53 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/descriptors/descriptors.h"
+
+// Args: {batch, channels, rows, cols, kernel, stride}
+#define POOL_ARGS ArgNames({"b", "c", "h", "w", "ks", "s"}) \
+    ->Args({32, 64, 112, 112, 3, 2}) \
+    ->Args({32, 256, 28, 28, 2, 2}) \
+    ->Unit(benchmark::kMicrosecond)
+
+enum PoolPass { MAX_FORWARD, MAX_BACK, AVG_FORWARD, AVG_BACK };
+
+template <PoolPass P>
+static void BM_pool2D(benchmark::State& state){
+    auto shape = bench_shape(state, 4);
+    int ks = (int)state.range(4), st = (int)state.range(5);
+
+    Tensor* A = Tensor::randn(shape);
+    auto *pd = new PoolDescriptor({ks, ks}, {st, st}, "same");
+    pd->build(A);
+    pd->ID = Tensor::zeros(pd->I->getShape());
+    pd->D = Tensor::randn(pd->O->getShape());
+    pd->indX = new Tensor(pd->O->getShape());
+    pd->indY = new Tensor(pd->O->getShape());
+
+    // Max-pool backward needs the indices of the forward pass
+    if (P == MAX_BACK) tensorNN::MPool2D(pd);
+
+    for (auto _ : state) {
+        if (P == MAX_FORWARD) tensorNN::MPool2D(pd);
+        else if (P == MAX_BACK) tensorNN::MPool2D_back(pd);
+        else if (P == AVG_FORWARD) tensorNN::AvgPool2D(pd);
+        else tensorNN::AvgPool2D_back(pd);
+        benchmark::ClobberMemory();
+    }
+    bench_set_bytes(state, pd->I->size + pd->O->size);
+
+    delete pd->O; delete pd->ID; delete pd->D;  // indX and indY are deleted by the descriptor
+    delete pd; delete A;
+}
+BENCHMARK_TEMPLATE(BM_pool2D, MAX_FORWARD)->POOL_ARGS;
+BENCHMARK_TEMPLATE(BM_pool2D, MAX_BACK)->POOL_ARGS;
+BENCHMARK_TEMPLATE(BM_pool2D, AVG_FORWARD)->POOL_ARGS;
+BENCHMARK_TEMPLATE(BM_pool2D, AVG_BACK)->POOL_ARGS;
@@ -0,0 +1,91 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+
+// Data augmentation kernels over a {batch, channels, rows, cols} batch
+
+#define DA_ARGS ArgNames({"b", "c", "h", "w"}) \
+    ->Args({32, 3, 32, 32}) \
+    ->Args({32, 3, 224, 224}) \
+    ->Unit(benchmark::kMicrosecond)
+
+static void BM_da_shift(benchmark::State& state){
+    Tensor* A = Tensor::randn(bench_shape(state, 4));
+    Tensor* B = Tensor::empty_like(A);
+    for (auto _ : state) {
+        Tensor::shift(A, B, {3, -5});
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+}
+BENCHMARK(BM_da_shift)->DA_ARGS;
+
+static void BM_da_rotate(benchmark::State& state){
+    Tensor* A = Tensor::randn(bench_shape(state, 4));
+    Tensor* B = Tensor::empty_like(A);
+    for (auto _ : state) {
+        Tensor::rotate(A, B, 30.0f);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+}
+BENCHMARK(BM_da_rotate)->DA_ARGS;
+
+static void BM_da_scale(benchmark::State& state){
+    Tensor* A = Tensor::randn(bench_shape(state, 4));
+    Tensor* B = Tensor::empty_like(A);
+    for (auto _ : state) {
+        Tensor::scale(A, B, {A->shape[2] * 5 / 4, A->shape[3] * 5 / 4});
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+}
+BENCHMARK(BM_da_scale)->DA_ARGS;
+
+static void BM_da_flip(benchmark::State& state){
+    Tensor* A = Tensor::randn(bench_shape(state, 4));
+    Tensor* B = Tensor::empty_like(A);
+    for (auto _ : state) {
+        Tensor::flip(A, B, 1);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+}
+BENCHMARK(BM_da_flip)->DA_ARGS;
+
+static void BM_da_crop_scale(benchmark::State& state){
+    Tensor* A = Tensor::randn(bench_shape(state, 4));
+    Tensor* B = Tensor::empty_like(A);
+    int h = A->shape[2], w = A->shape[3];
+    for (auto _ : state) {
+        Tensor::crop_scale(A, B, {h / 8, w / 8}, {h - h / 8 - 1, w - w / 8 - 1});
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+}
+BENCHMARK(BM_da_crop_scale)->DA_ARGS;
+
+static void BM_da_cutout(benchmark::State& state){
+    Tensor* A = Tensor::randn(bench_shape(state, 4));
+    Tensor* B = Tensor::empty_like(A);
+    int h = A->shape[2], w = A->shape[3];
+    for (auto _ : state) {
+        Tensor::cutout(A, B, {h / 4, w / 4}, {h / 2, w / 2});
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+}
+BENCHMARK(BM_da_cutout)->DA_ARGS;
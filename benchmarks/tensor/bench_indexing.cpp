@@ -0,0 +1,82 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+#include "eddl/descriptors/tensor_descriptors.h"
+
+
+// Select a spatial window: A[:, :, 0:h/2, 0:w/2]  [cpu_select]
+static void BM_select(benchmark::State& state){
+    auto shape = bench_shape(state, 4);
+    Tensor* A = Tensor::randn(shape);
+
+    auto *sd = new SelDescriptor({":", ":", "0:" + to_string(shape[2] / 2), "0:" + to_string(shape[3] / 2)}, DEV_CPU);
+    sd->build(A->shape);
+    Tensor* B = Tensor::empty(sd->oshape);
+
+    for (auto _ : state) {
+        Tensor::select(A, B, sd);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * B->size);
+
+    delete sd; delete A; delete B;
+}
+BENCHMARK(BM_select)->ArgNames({"b", "c", "h", "w"})
+    ->Args({32, 3, 224, 224})
+    ->Args({32, 64, 56, 56})
+    ->Unit(benchmark::kMicrosecond);
+
+
+// Batch gather used by Net::fit to build each batch  [cpu_select (deprecated index version)]
+static void BM_select_batch(benchmark::State& state){
+    auto shape = bench_shape(state, 4);
+    int batch = (int)state.range(4);
+    Tensor* A = Tensor::randn(shape);
+    vector<int> bshape(shape); bshape[0] = batch;
+    Tensor* B = Tensor::empty(bshape);
+
+    vector<int> sind(batch);
+    for (int i = 0; i < batch; i++) sind[i] = (i * 7919) % shape[0];
+
+    for (auto _ : state) {
+        Tensor::select(A, B, sind, 0, batch);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * B->size);
+
+    delete A; delete B;
+}
+BENCHMARK(BM_select_batch)->ArgNames({"n", "c", "h", "w", "batch"})
+    ->Args({1024, 3, 32, 32, 128})
+    ->Args({256, 3, 224, 224, 32})
+    ->Unit(benchmark::kMicrosecond);
+
+
+// Permute (NCHW -> NHWC)  [cpu_select with PermuteDescriptor]
+static void BM_permute(benchmark::State& state){
+    auto shape = bench_shape(state, 4);
+    Tensor* A = Tensor::randn(shape);
+
+    auto *pd = new PermuteDescriptor({0, 2, 3, 1}, DEV_CPU);
+    pd->build(A->shape);
+    Tensor* B = Tensor::empty(pd->oshape);
+
+    for (auto _ : state) {
+        Tensor::select(A, B, pd);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * B->size);
+
+    delete pd; delete A; delete B;
+}
+BENCHMARK(BM_permute)->ArgNames({"b", "c", "h", "w"})
+    ->Args({32, 3, 224, 224})
+    ->Args({32, 64, 56, 56})
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,61 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+
+
+// C(m,n) = A(m,k) * B(k,n)   [cpu_mult2D]
+static void BM_mult2D(benchmark::State& state){
+    int m = (int)state.range(0), k = (int)state.range(1), n = (int)state.range(2);
+    int tA = (int)state.range(3), tB = (int)state.range(4);
+    Tensor* A = Tensor::randn(tA ? vector<int>{k, m} : vector<int>{m, k});
+    Tensor* B = Tensor::randn(tB ? vector<int>{n, k} : vector<int>{k, n});
+    Tensor* C = Tensor::zeros({m, n});
+
+    for (auto _ : state) {
+        Tensor::mult2D(A, tA, B, tB, C, 0);
+        benchmark::DoNotOptimize(C->ptr);
+    }
+    bench_set_flops(state, 2.0 * m * n * k);
+    bench_set_bytes(state, (long)m * k + (long)k * n + (long)m * n);
+
+    delete A; delete B; delete C;
+}
+BENCHMARK(BM_mult2D)->ArgNames({"m", "k", "n", "tA", "tB"})
+    ->Args({32, 784, 1024, 0, 0})       // Dense forward (MLP)
+    ->Args({784, 32, 1024, 1, 0})       // Dense grad (weights)
+    ->Args({32, 1024, 784, 0, 1})       // Dense backward (delta)
+    ->Args({64, 4096, 4096, 0, 0})      // VGG classifier
+    ->Args({3136, 576, 64, 0, 0})       // Conv lowering (56x56x64, 3x3)
+    ->Args({16, 128, 512, 0, 0})        // LSTM step (small hidden)
+    ->Unit(benchmark::kMicrosecond);
+
+
+// C = A + B (elementwise, incl. broadcasting-free path)
+static void BM_add(benchmark::State& state){
+    auto shape = bench_shape(state, 2);
+    Tensor* A = Tensor::randn(shape);
+    Tensor* B = Tensor::randn(shape);
+    Tensor* C = Tensor::zeros(shape);
+
+    for (auto _ : state) {
+        Tensor::add(1.0f, A, 1.0f, B, C, 0);
+        benchmark::DoNotOptimize(C->ptr);
+    }
+    bench_set_flops(state, 3.0 * A->size);
+    bench_set_bytes(state, 3 * A->size);
+
+    delete A; delete B; delete C;
+}
+BENCHMARK(BM_add)->ArgNames({"rows", "cols"})
+    ->Args({1, 256})         // Bias / BN params
+    ->Args({32, 128})        // Small RNN state
+    ->Args({128, 4096})
+    ->Args({1024, 16384})
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,80 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+#include "eddl/hardware/cpu/cpu_parallel.h"
+
+// Elementwise ops with size-aware threading ("adaptive"=1) and with the whole team always ("adaptive"=0, the
+// previous behaviour). Args: {size, adaptive}
+#define ELEM_ARGS ArgNames({"size", "adaptive"}) \
+    ->ArgsProduct({{64, 512, 4096, 32768, 262144, 4194304}, {0, 1}}) \
+    ->Unit(benchmark::kMicrosecond)
+
+static void bench_set_adaptive(benchmark::State& state, long int &saved){
+    saved = cpu_grain;
+    if (state.range(1) == 0) cpu_set_grain(1);
+}
+
+static void BM_elementwise_add(benchmark::State& state){
+    long int saved;
+    bench_set_adaptive(state, saved);
+    Tensor* A = Tensor::randn({(int)state.range(0)});
+    Tensor* B = Tensor::randn({(int)state.range(0)});
+    Tensor* C = Tensor::empty_like(A);
+    for (auto _ : state) {
+        Tensor::add(A, B, C);
+        benchmark::DoNotOptimize(C->ptr);
+    }
+    bench_set_bytes(state, 3 * A->size);
+    delete A; delete B; delete C;
+    cpu_set_grain(saved);
+}
+BENCHMARK(BM_elementwise_add)->ELEM_ARGS;
+
+static void BM_elementwise_mult_scalar(benchmark::State& state){
+    long int saved;
+    bench_set_adaptive(state, saved);
+    Tensor* A = Tensor::randn({(int)state.range(0)});
+    for (auto _ : state) {
+        A->mult_(1.0001f);
+        benchmark::DoNotOptimize(A->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A;
+    cpu_set_grain(saved);
+}
+BENCHMARK(BM_elementwise_mult_scalar)->ELEM_ARGS;
+
+static void BM_elementwise_sqrt(benchmark::State& state){
+    long int saved;
+    bench_set_adaptive(state, saved);
+    Tensor* A = Tensor::randu({(int)state.range(0)});
+    Tensor* B = Tensor::empty_like(A);
+    for (auto _ : state) {
+        Tensor::sqrt(A, B);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_bytes(state, 2 * A->size);
+    delete A; delete B;
+    cpu_set_grain(saved);
+}
+BENCHMARK(BM_elementwise_sqrt)->ELEM_ARGS;
+
+static void BM_elementwise_sum_all(benchmark::State& state){
+    long int saved;
+    bench_set_adaptive(state, saved);
+    Tensor* A = Tensor::randn({(int)state.range(0)});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(A->sum());
+    }
+    bench_set_bytes(state, A->size);
+    delete A;
+    cpu_set_grain(saved);
+}
+BENCHMARK(BM_elementwise_sum_all)->ELEM_ARGS;
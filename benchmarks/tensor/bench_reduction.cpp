@@ -0,0 +1,43 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include "bench_utils.h"
+#include "eddl/descriptors/tensor_descriptors.h"
+
+
+// Reductions over one axis of a {batch, channels, rows, cols} tensor
+template <void (*F)(Tensor*, Tensor*, ReduceDescriptor2*)>
+static void BM_reduce(benchmark::State& state){
+    auto shape = bench_shape(state, 4);
+    int axis = (int)state.range(4);
+    Tensor* A = Tensor::randn(shape);
+
+    auto *rd = new ReduceDescriptor2({axis}, false, DEV_CPU);
+    rd->build(A->shape);
+    Tensor* B = Tensor::empty(rd->oshape);
+
+    for (auto _ : state) {
+        F(A, B, rd);
+        benchmark::DoNotOptimize(B->ptr);
+    }
+    bench_set_flops(state, (double)A->size);
+    bench_set_bytes(state, A->size + B->size);
+
+    delete rd; delete A; delete B;
+}
+
+#define REDUCE_ARGS ArgNames({"b", "c", "h", "w", "axis"}) \
+    ->Args({32, 64, 56, 56, 1}) \
+    ->Args({32, 64, 56, 56, 3}) \
+    ->Args({128, 1000, 1, 1, 1}) \
+    ->Unit(benchmark::kMicrosecond)
+
+BENCHMARK_TEMPLATE(BM_reduce, Tensor::sum)->REDUCE_ARGS;
+BENCHMARK_TEMPLATE(BM_reduce, Tensor::mean)->REDUCE_ARGS;
+BENCHMARK_TEMPLATE(BM_reduce, Tensor::max)->REDUCE_ARGS;
@@ -0,0 +1,164 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.9
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+
+using namespace eddl;
+
+
+
+//////////////////////////////////
+// mnist_mlp_pipeline_distr.cpp:
+// A very basic MLP for mnist
+// Pipeline parallelism: every process
+// trains some layers of the net
+//////////////////////////////////
+
+int main(int argc, char **argv) {
+    bool testing = false;
+    bool use_cpu = false;
+
+    int id;
+
+    id = init_distributed("MPI");
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--testing") == 0) testing = true;
+        else if (strcmp(argv[i], "--cpu") == 0) use_cpu = true;
+    }
+
+    // Download mnist
+    download_mnist();
+
+    // Settings
+    int epochs = testing ? 2 : 10;
+    int batch_size = 200;
+    int micro_batches = 8;
+    int num_classes = 10;
+
+    // Define network
+    layer in = Input({784});
+    layer l = in;  // Aux var
+
+    l = ReLu(Dense(l, 1024));
+    l = ReLu(Dense(l, 1024));
+    l = ReLu(Dense(l, 1024));
+
+    layer out = Softmax(Dense(l, num_classes));
+    model net = Model({in}, {out});
+
+    // Define computing service: one device per process
+    compserv cs = nullptr;
+    if (use_cpu) {
+        cs = CS_CPU();
+    } else {
+        cs = CS_GPU(get_gpu_vec_distributed());
+    }
+
+    // Build model
+    build(net,
+          sgd(0.01, 0.9), // Optimizer
+          {"softmax_cross_entropy"}, // Losses
+          {"categorical_accuracy"}, // Metrics
+          cs);
+
+    // View model
+    if (id == 0)
+        summary(net);
+
+    // Same initial weights in all the processes, then split the layers among them
+    bcast_weights_distributed(net);
+    set_pipeline_distributed(net, micro_batches);
+
+    // Load dataset
+    Tensor* x_train = Tensor::load("mnist_trX.bin");
+    Tensor* y_train = Tensor::load("mnist_trY.bin");
+    Tensor* x_test = Tensor::load("mnist_tsX.bin");
+    Tensor* y_test = Tensor::load("mnist_tsY.bin");
+
+    if (testing) {
+        std::string _range_ = "0:" + std::to_string(2 * batch_size);
+        Tensor* x_mini_train = x_train->select({_range_, ":"});
+        Tensor* y_mini_train = y_train->select({_range_, ":"});
+        Tensor* x_mini_test  = x_test->select({_range_, ":"});
+        Tensor* y_mini_test  = y_test->select({_range_, ":"});
+
+        delete x_train;
+        delete y_train;
+        delete x_test;
+        delete y_test;
+
+        x_train = x_mini_train;
+        y_train = y_mini_train;
+        x_test  = x_mini_test;
+        y_test  = y_mini_test;
+    }
+
+    // Preprocessing
+    x_train->div_(255.0f);
+    x_test->div_(255.0f);
+
+    // Every process goes through the same batches
+    tshape s = x_train->getShape();
+    int num_batches = s[0] / batch_size;
+
+    Tensor* xbatch = new Tensor({batch_size, 784});
+    Tensor* ybatch = new Tensor({batch_size, 10});
+
+    // Train model
+    for (int i = 0; i < epochs; i++) {
+        reset_loss(net);
+        if (id == 0)
+            fprintf(stdout, "Epoch %d/%d (%d batches)\n", i + 1, epochs, num_batches);
+
+        for (int j = 0; j < num_batches; j++) {
+            vector<int> indices(batch_size);
+            for (int k = 0; k < indices.size(); k++)
+                indices[k] = (j * batch_size) + k;
+            Tensor::select(x_train, xbatch, indices, 0, batch_size);
+            Tensor::select(y_train, ybatch, indices, 0, batch_size);
+
+            train_batch_pipeline_distributed(net, {xbatch}, {ybatch});
+
+            print_loss(net, j);
+            if (id == 0)
+                printf("\r");
+        }
+        if (id == 0)
+            printf("\n");
+    }
+
+    // Evaluate model: the whole net in process 0
+    gather_pipeline_weights_distributed(net);
+    if (id == 0) {
+        printf("Evaluate:\n");
+        evaluate(net, {x_test}, {y_test});
+    }
+
+    set_pipeline_distributed(net, 0);
+
+    delete xbatch;
+    delete ybatch;
+
+    delete x_train;
+    delete y_train;
+    delete x_test;
+    delete y_test;
+    delete net;
+
+    // Finalize distributed training
+    end_distributed();
+
+    return EXIT_SUCCESS;
+}
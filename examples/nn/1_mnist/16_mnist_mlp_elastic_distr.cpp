@@ -0,0 +1,141 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 0.9
+* copyright (c) 2020, Universidad Politécnica de Valencia (UPV), PRHLT Research Centre
+* Date: November 2020
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+
+using namespace eddl;
+
+
+
+//////////////////////////////////
+// mnist_mlp_elastic_distr.cpp:
+// A very basic MLP for mnist
+// Elastic training: the survivors go on
+// when a process fails. Run with
+// mpirun --enable-recovery -np 4 ...
+// --fail <id> kills a process
+//////////////////////////////////
+
+int main(int argc, char **argv) {
+    bool testing = false;
+    bool use_cpu = false;
+    int fail = -1;
+
+    int id;
+
+    id = init_distributed("MPI");
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--testing") == 0) testing = true;
+        else if (strcmp(argv[i], "--cpu") == 0) use_cpu = true;
+        else if (strcmp(argv[i], "--fail") == 0) fail = atoi(argv[++i]);
+    }
+
+    // Sync every 4 batches
+    set_avg_method_distributed(FIXED, 4);
+
+    // Download mnist
+    download_mnist();
+
+    // Settings
+    int epochs = testing ? 2 : 10;
+    int batch_size = 400;
+    int num_classes = 10;
+
+    // Define network
+    layer in = Input({784});
+    layer l = in;  // Aux var
+
+    l = ReLu(Dense(l, 1024));
+    l = ReLu(Dense(l, 1024));
+
+    layer out = Softmax(Dense(l, num_classes));
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+
+    // Define computing service: one device per process
+    compserv cs = nullptr;
+    if (use_cpu) {
+        cs = CS_CPU();
+    } else {
+        cs = CS_GPU(get_gpu_vec_distributed());
+    }
+
+    // Build model
+    build(net,
+          adam(0.001), // Optimizer
+          {"softmax_cross_entropy"}, // Losses
+          {"categorical_accuracy"}, // Metrics
+          cs);
+
+    // View model
+    if (id == 0)
+        summary(net);
+
+    // Snapshot every 8 batches. A process that does not reach a sync point in 30 secs has failed
+    set_elastic_distributed(net, 8, 30.0f);
+
+    // Load dataset
+    Tensor* x_train = Tensor::load("mnist_trX.bin");
+    Tensor* y_train = Tensor::load("mnist_trY.bin");
+    Tensor* x_test = Tensor::load("mnist_tsX.bin");
+    Tensor* y_test = Tensor::load("mnist_tsY.bin");
+
+    if (testing) {
+        std::string _range_ = "0:" + std::to_string(2 * batch_size);
+        Tensor* x_mini_train = x_train->select({_range_, ":"});
+        Tensor* y_mini_train = y_train->select({_range_, ":"});
+        Tensor* x_mini_test  = x_test->select({_range_, ":"});
+        Tensor* y_mini_test  = y_test->select({_range_, ":"});
+
+        delete x_train;
+        delete y_train;
+        delete x_test;
+        delete y_test;
+
+        x_train = x_mini_train;
+        y_train = y_mini_train;
+        x_test  = x_mini_test;
+        y_test  = y_mini_test;
+    }
+
+    // Preprocessing
+    x_train->div_(255.0f);
+    x_test->div_(255.0f);
+
+    // Train model, one epoch at a time. Ids and nr of processes change after a failure
+    for (int i = 0; i < epochs; i++) {
+        if (i == 1 && get_id_distributed() == fail) {
+            fprintf(stdout, "[DISTR] Process %d fails\n", fail);
+            raise(SIGKILL);
+        }
+        fit(net, {x_train}, {y_train}, batch_size, 1);
+    }
+
+    // Evaluate
+    if (get_id_distributed() == 0)
+        evaluate(net, {x_test}, {y_test});
+
+    delete x_train;
+    delete y_train;
+    delete x_test;
+    delete y_test;
+    delete net;
+
+    // Finalize distributed training
+    end_distributed();
+
+    return EXIT_SUCCESS;
+}
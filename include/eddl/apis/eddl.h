@@ -39,6 +39,7 @@
 #include "eddl/layers/fpga/layer_hlsinf.h"
 #include "eddl/mpi_distributed/mpi_distributed.h"
 #include "eddl/mpi_distributed/data_generator.h"
+#include "eddl/data/dataloader.h"
 
 // EDDL namespace defines the API
 namespace eddl {
@@ -152,9 +153,11 @@ namespace eddl {
       *
       *  @param th  CPU Threads. (if '-1', use all threads)
       *  @param mem  Indicates the memory consumption of the model. One of "full_mem" (default), "mid_mem" or "low_mem".
+      *  @param affinity  Pins the threads to CPUs. One of "none" (default), "close" (fill a NUMA node first) or "spread" (round-robin among the nodes).
+      *  @param numa  NUMA-aware placement: weights, gradients and optimizer state interleaved among the nodes, activations local to the threads that compute them.
       *  @return     The computer service itself.
     */
-    compserv CS_CPU(int th=-1, const string& mem="full_mem");
+    compserv CS_CPU(int th=-1, const string& mem="full_mem", const string& affinity="none", bool numa=false);
 
     /**
       *  @brief Executes the code in the GPU.
@@ -254,6 +257,27 @@ namespace eddl {
     */
     void save(model m, const string& fname, const string& format="bin");
 
+    /**
+      *  @brief  Save a checkpoint of the model: params (including normalization statistics) and optimizer state.
+      *  The file contains an index of named, 64-byte aligned tensors. The tensors are copied into a
+      *  double buffer and the file is written by a background thread, so training can continue.
+      *
+      *  @param m  Model
+      *  @param fname  File where the checkpoint will be saved
+      *  @param async  If false, waits until the file has been written
+      *  @return     (void) Saves the checkpoint
+    */
+    void save_checkpoint(model m, const string& fname, bool async=true);
+
+    /**
+      *  @brief  Load a checkpoint saved with save_checkpoint(). The file is memory-mapped.
+      *
+      *  @param m  Model (already built)
+      *  @param fname  File where the checkpoint is saved
+      *  @return     (void) Loads the params and, if present, the optimizer state
+    */
+    void load_checkpoint(model m, const string& fname);
+
     // Optimizer
     /**
       *  @brief  Changes the learning rate and hyperparameters of the model optimizer.
@@ -377,6 +401,41 @@ namespace eddl {
     */
     optimizer sgd(float lr = 0.01f, float momentum = 0.0f, float weight_decay = 0.0f, bool nesterov = false);
 
+    /**
+      *  @brief LARS optimizer (Layer-wise Adaptive Rate Scaling).
+      *
+      *  @details
+      *   SGD with momentum where the step of every weight tensor is scaled by the trust ratio
+      *   eta*||w|| / (||g|| + weight_decay*||w||). Keeps large global batches (e.g. many ranks with
+      *   set_batch_distributed) converging. Biases and normalization params use the plain learning rate.
+      *   @see  https://arxiv.org/abs/1708.03888
+      *
+      *  @param lr  Learning rate
+      *  @param momentum  Momentum factor
+      *  @param weight_decay   Weight decay (L2 penalty)
+      *  @param eta   Trust coefficient
+      *  @param epsilon   Term added to the denominator of the trust ratio
+      *  @return     LARS optimizer
+    */
+    optimizer lars(float lr = 0.01f, float momentum = 0.9f, float weight_decay = 0.0005f, float eta = 0.001f, float epsilon = 1e-9f);
+
+    /**
+      *  @brief LAMB optimizer (Layer-wise Adaptive Moments for Batch training).
+      *
+      *  @details
+      *   Adam (with decoupled weight decay) where the step of every weight tensor is scaled by the trust ratio
+      *   ||w|| / ||update||. Biases and normalization params use the plain learning rate.
+      *   @see  https://arxiv.org/abs/1904.00962
+      *
+      *  @param lr  Learning rate
+      *  @param beta_1  Coefficients used for computing running averages of gradient and its square
+      *  @param beta_2  Coefficients used for computing running averages of gradient and its square
+      *  @param epsilon   Term added to the denominator to improve numerical stability
+      *  @param weight_decay   Weight decay (decoupled, added to the update)
+      *  @return     LAMB optimizer
+    */
+    optimizer lamb(float lr = 0.001f, float beta_1 = 0.9f, float beta_2 = 0.999f, float epsilon = 1e-6f, float weight_decay = 0.01f);
+
     // Training and Evaluation
     // Coarse methods
     /**
@@ -390,6 +449,17 @@ namespace eddl {
       *  @return     (void) Trains the model
     */
     void fit(model m, const vector<Tensor *> &in, const vector<Tensor *> &out, int batch, int epochs);
+    /**
+      *  @brief Trains the model for a fixed number of epochs with the batches produced by a DataLoader.
+      *  The next batches are assembled (and augmented) by the loader workers while the current one is computed.
+      *  The last partial batch of every epoch is dropped unless the loader keeps it (drop_last=false).
+      *
+      *  @param m  Model to train
+      *  @param loader  Batch producer. The batch size is taken from it
+      *  @param epochs  Number of epochs to train the model
+      *  @return     (void) Trains the model
+    */
+    void fit(model m, DataLoader *loader, int epochs);
     /**
       *  @brief Returns the loss value & metrics values for the model in test mode. Only *1* MPI process
       *
@@ -420,6 +490,16 @@ namespace eddl {
     */
     vector<Tensor *>  predict(model m, const vector<Tensor *> &in);
 
+    /**
+      *  @brief Creates an inference context: a model that shares the parameters of "m" but owns its activations.
+      *  Each context can be used by a different thread, so several predictions run concurrently without
+      *  duplicating the weights. "m" must not be trained or deleted while its contexts are in use.
+      *
+      *  @param m  Model (built)
+      *  @return   Context to use with predict() or forward(). Delete it when no longer needed
+    */
+    model create_context(model m);
+
 
     // Finer methods
 
@@ -697,6 +777,20 @@ namespace eddl {
      */
     void reset_profile();
 
+    /**
+      *  @brief Enables or disables the profiler (net, layer and kernel zones). Disabled by default.
+      *
+      *  @param enable  Whether to record the zones
+    */
+    void enable_profile(bool enable=true);
+
+    /**
+      *  @brief Saves the recorded zones as a Chrome trace (chrome://tracing or Perfetto).
+      *
+      *  @param fname  Output JSON file
+    */
+    void save_profile(const string& fname);
+
 
     ///////////////////////////////////////
     //  LAYERS
@@ -1140,11 +1234,13 @@ namespace eddl {
       *  @brief 2D Upsampling layer.
       *
       *  @details
-      *   Identical to the ``scale`` transformation, it is an alias of the Resize layer.
+      *   Upsamples by integer factors without any batch-sized workspace. "nearest" repeats the rows and columns,
+      *   "bilinear" (or "linear") interpolates with half-pixel centers, as ONNX Resize and PyTorch (align_corners=False).
+      *   Bilinear is only available on CPU.
       *
       *  @param parent  Parent layer
       *  @param size  Vector of 2 integers. The upsampling factors for rows and columns
-      *  @param interpolation (Deprecated) A string, only "nearest" is valid
+      *  @param interpolation A string, "nearest" or "bilinear"
       *  @param name  A name for the operation
       *  @return     Output layer after upsampling operation
     */
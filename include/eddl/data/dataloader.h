@@ -0,0 +1,200 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_DATALOADER_H
+#define EDDL_DATALOADER_H
+
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eddl/tensor/tensor.h"
+
+using namespace std;
+
+typedef vector<Tensor *> vtensor;
+
+#define DATALOADER_WORKERS 2
+#define DATALOADER_BUFFERS 4
+#define DATALOADER_SEED 1
+
+
+/**
+  *  @brief Source of samples for a DataLoader. "load" is called concurrently from the loader workers,
+  *  so it must be thread-safe.
+*/
+class DataSource {
+public:
+    virtual ~DataSource() {}
+
+    /**
+      *  @brief Number of samples
+    */
+    virtual int num_samples() = 0;
+
+    /**
+      *  @brief Shape of one sample (without the batch dimension) of every input and every output
+    */
+    virtual vector<vector<int>> input_shapes() = 0;
+    virtual vector<vector<int>> output_shapes() = 0;
+
+    /**
+      *  @brief Writes sample "index" into the given buffers (one per input/output, row-major)
+    */
+    virtual void load(int index, const vector<float *> &x, const vector<float *> &y) = 0;
+};
+
+
+/**
+  *  @brief In-memory dataset. The tensors are not copied and must outlive the source.
+*/
+class TensorDataSource : public DataSource {
+private:
+    vtensor x, y;
+
+public:
+    TensorDataSource(const vtensor &x, const vtensor &y);
+
+    int num_samples() override;
+    vector<vector<int>> input_shapes() override;
+    vector<vector<int>> output_shapes() override;
+    void load(int index, const vector<float *> &x, const vector<float *> &y) override;
+};
+
+
+/**
+  *  @brief Out-of-core dataset stored as EDDL binary tensors (Tensor::save(fname, "bin")): one file per
+  *  input/output, with the samples along the first dimension. Only the requested rows are read.
+*/
+class BinaryFileDataSource : public DataSource {
+private:
+    struct File {
+        string path;
+        vector<int> shape;  // Without the batch dimension
+        long int row_size;  // Floats per sample
+        long int offset;    // Bytes of the header
+        int fd;             // POSIX (pread)
+        std::ifstream *ifs; // Fallback, guarded by "mtx"
+    };
+    vector<File> inputs, outputs;
+    int n;
+    std::mutex mtx;
+
+    File open(const string &path);
+    void read(File &f, int index, float *dst);
+
+public:
+    BinaryFileDataSource(const vector<string> &x_files, const vector<string> &y_files);
+    ~BinaryFileDataSource() override;
+
+    int num_samples() override;
+    vector<vector<int>> input_shapes() override;
+    vector<vector<int>> output_shapes() override;
+    void load(int index, const vector<float *> &x, const vector<float *> &y) override;
+};
+
+
+/**
+  *  @brief Augmentation (or any other preprocessing) stage applied by the workers to every assembled batch.
+  *  It must work in place (the tensors cannot be replaced). Stages run concurrently on different batches.
+*/
+typedef std::function<void(const vtensor &x, const vtensor &y)> DataLoaderStage;
+
+
+/**
+  *  @brief Asynchronous batch producer. "num_workers" threads assemble the batches of the current epoch
+  *  (and run the stages) into a ring of "num_buffers" batch buffers, so the next batches are ready while
+  *  the net is computing the current one. Batches are delivered in order.
+*/
+class DataLoader {
+private:
+    struct Slot {
+        vtensor x, y;
+        vtensor tail_x, tail_y;  // Last partial batch of the epoch (if it is kept)
+        int batch;    // Batch assigned to the slot, -1 if free
+        bool ready;
+        std::exception_ptr error;
+    };
+
+    DataSource *source;
+    vector<Slot> slots;
+    vector<DataLoaderStage> stages;
+    vector<int> order;  // Samples of the current epoch
+    vector<long int> x_sizes, y_sizes;
+    int tail;  // Samples of the last partial batch, 0 if it is dropped or there is none
+    int dropped;
+    std::mt19937 rng;
+
+    vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable cv_work;   // Workers: new epoch, free slot or stop
+    std::condition_variable cv_ready;  // Consumer: batch ready
+
+    int next_batch;     // Next batch to assemble
+    int next_out;       // Next batch to deliver
+    int current;        // Slot delivered by the last call to next(), -1 if none
+    int epoch_batches;  // 0 if no epoch is running
+    int busy;           // Batches being assembled
+    bool stop;
+
+    void begin_epoch(std::unique_lock<std::mutex> &lock);
+    void worker();
+    void assemble(Slot &s, int b);
+    void release_current();
+
+public:
+    int batch_size;
+    bool shuffle;
+
+    /**
+      *  @brief Starts the workers. The batches of an epoch are the consecutive groups of batch_size samples of a
+      *  (shuffled) permutation of the samples. The last one has num_samples % batch_size samples and it is
+      *  dropped, as in Net::fit, unless drop_last is false.
+      *
+      *  @param source  Samples. It is not owned and must outlive the loader
+      *  @param batch_size  Samples per batch
+      *  @param shuffle  Reshuffle the samples at every epoch
+      *  @param num_workers  Threads assembling batches
+      *  @param num_buffers  Batches that can be prepared in advance (>= 2 for double buffering)
+      *  @param drop_last  Drop the last partial batch of every epoch
+      *  @param seed  Seed of the generator used to shuffle
+    */
+    DataLoader(DataSource *source, int batch_size, bool shuffle=true, int num_workers=DATALOADER_WORKERS, int num_buffers=DATALOADER_BUFFERS,
+               bool drop_last=true, unsigned int seed=DATALOADER_SEED);
+    ~DataLoader();
+
+    /**
+      *  @brief Appends a stage. Must be called before the first epoch starts.
+    */
+    void add_stage(const DataLoaderStage &stage);
+
+    int num_batches();
+    int dropped_samples() { return dropped; }  // Per epoch, see drop_last
+    int num_inputs() { return (int)x_sizes.size(); }
+    int num_outputs() { return (int)y_sizes.size(); }
+
+    /**
+      *  @brief Reshuffles and starts prefetching a new epoch. Called by next() if no epoch is running.
+    */
+    void start_epoch();
+
+    /**
+      *  @brief Returns the next batch of the epoch. The tensors belong to the loader and are valid until
+      *  the next call. The last batch has fewer samples if drop_last is false. At the end of the epoch returns false and the next call starts a new epoch.
+    */
+    bool next(vtensor &x, vtensor &y);
+};
+
+#endif //EDDL_DATALOADER_H
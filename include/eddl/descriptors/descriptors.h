@@ -101,7 +101,8 @@ public:
     Tensor *O= nullptr; // Outputmap
 
     // CPU implementation
-    float *ptrI;
+    float *ptrI = nullptr;
+    unsigned long int ptrI_size = 0;  // Allocated elements of ptrI (high-water mark)
     Eigen::MatrixXf matI; // input
     Eigen::MatrixXf matK; // kernels
     Eigen::MatrixXf matO; // output
@@ -187,7 +188,8 @@ public:
     Tensor *O= nullptr; // Outputmap
 
     // CPU implementation
-    float *ptrI;
+    float *ptrI = nullptr;
+    unsigned long int ptrI_size = 0;  // Allocated elements of ptrI (high-water mark)
     Eigen::MatrixXf matI; // input
     Eigen::MatrixXf matK; // kernels
     Eigen::MatrixXf matO; // output
@@ -278,7 +280,8 @@ public:
     Tensor *O= nullptr; // Outputmap
 
     // CPU implementation
-    float *ptrI;
+    float *ptrI = nullptr;
+    unsigned long int ptrI_size = 0;  // Allocated elements of ptrI (high-water mark)
     Eigen::MatrixXf matI; // input
     Eigen::MatrixXf matK; // kernels
     Eigen::MatrixXf matO; // output
@@ -370,7 +373,8 @@ public:
     Tensor *O= nullptr; // Outputmap
 
     // CPU implementation
-    float *ptrI;
+    float *ptrI = nullptr;
+    unsigned long int ptrI_size = 0;  // Allocated elements of ptrI (high-water mark)
     Eigen::MatrixXf matI; // input
     Eigen::MatrixXf matK; // kernels
     Eigen::MatrixXf matO; // output
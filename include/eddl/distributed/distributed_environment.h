@@ -30,6 +30,7 @@ public:
         this->udp_ack_port  = base_udp_ack_port;
         this->my_ip_addr = "";
         this->my_s_addr = 0;
+        this->bind_my_ip_addr = false;
         this->set_multicast_group_addr(eddl_multicast_group_addr);
         this->verbose_level = 0;
         this->batch_size = 10;
@@ -151,6 +152,11 @@ public:
     int get_udp_ack_port() { return this->udp_ack_port; }
     void set_udp_ack_port(int port_number) { this->udp_ack_port = port_number; }
 
+    // TCP receivers listen on my_ip_addr instead of on all the interfaces,
+    // so several nodes can share a host, e.g. 127.0.0.1, 127.0.0.2, ...
+    bool get_bind_my_ip_addr() { return this->bind_my_ip_addr; }
+    void set_bind_my_ip_addr(bool b) { this->bind_my_ip_addr = b; }
+
 
 private:
     std::string     master_ip_addr;
@@ -160,6 +166,7 @@ private:
     int             udp_ack_port;
     std::string     my_ip_addr;
     in_addr_t       my_s_addr;
+    bool            bind_my_ip_addr;
     int             verbose_level;
     int             batch_size;
     std::string     multicast_group_addr;
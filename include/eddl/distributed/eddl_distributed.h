@@ -82,7 +82,7 @@ static std::string  eddl_multicast_group_addr("239.193.111.211"); // campus scop
 static constexpr size_t eddl_alignment = 8; ///< alignment in bytes to allocate memory
 static constexpr int listen_max_pending = 50; ///< maximum number of connections pending to be accepted by the master node
 static constexpr int eddl_checksum_len = 32; ///< SHA256 algorithm is used, whose output is 256 bits (32 bytes) length
-static constexpr size_t eddl_msg_id_len = 19; ///< 19=8+3+8 hexadecimal digits, 8 of the IP address, 3 of the message type and 8 of the timestamp in milliseconds
+static constexpr size_t eddl_msg_id_len = 19; ///< 19=8+3+8 hexadecimal digits, 8 of the IP address, 3 of the message type and 8 of the sequence number of the message in its process
 static constexpr size_t _eddl_msg_id_len_ = next_multiple(eddl_msg_id_len,eddl_alignment); ///< next eight-multiple from 19
 static constexpr size_t eddl_default_mtu = 8192; // 1500; //1536; ///< MTU -- block size for sending/receiving packets (mainly affects UDP multicast)
 static constexpr size_t eddl_packet_data_size = prev_multiple(eddl_default_mtu
@@ -91,6 +91,7 @@ static constexpr size_t eddl_packet_data_size = prev_multiple(eddl_default_mtu
                                                 - 4*sizeof(size_t)
                                                 - eddl_checksum_len, 8);
                                                 // check this with eddl_packet class definition
+static constexpr size_t eddl_packet_pool_size = 1024; ///< packets kept for reuse once released, must be a power of two
 
 uint64_t                    get_system_milliseconds();
 std::vector<std::string>    str_split(std::string s, char sep);
@@ -104,6 +104,7 @@ private:
     uint32_t        source_addr;
     uint32_t        target_addr;
     uint64_t        timestamp;
+    uint32_t        sequence;
     size_t          seq_len;
     size_t          message_data_size;
     size_t          packet_data_size;
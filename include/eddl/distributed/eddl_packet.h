@@ -39,6 +39,10 @@ public:
                 uint32_t command);
     ~eddl_packet();
 
+    // packets are recycled through a lock-free pool instead of going back to the heap
+    static void * operator new(size_t size);
+    static void operator delete(void * ptr, size_t size);
+
     inline uint32_t get_type() { return type; }
     inline uint32_t get_source_addr() { return source_addr; }
     inline uint32_t get_target_addr() { return target_addr; }
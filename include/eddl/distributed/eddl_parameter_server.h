@@ -0,0 +1,190 @@
+/*
+ * EDDL Library - European Distributed Deep Learning Library.
+ * Version: x.y
+ * copyright (c) 2020, Universitat Politècnica de València (UPV), PRHLT Research Centre
+ * Date: July 2020
+ * Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+ * All rights reserved
+ */
+
+#ifndef __EDDL_PARAMETER_SERVER_H__
+#define __EDDL_PARAMETER_SERVER_H__ 1
+
+#include <vector>
+#include <map>
+#include <list>
+#include <string>
+
+#include <eddl/distributed/eddl_distributed.h>
+#include <eddl/distributed/distributed_environment.h>
+#include <eddl/distributed/eddl_queue.h>
+#include <eddl/distributed/tcp_receiver.h>
+#include <eddl/distributed/tcp_sender.h>
+
+#include "eddl/net/net.h"
+
+namespace eddl {
+
+/*
+    Asynchronous parameter server.
+
+    The trainable parameters of the model (those with accumulated gradients,
+    see Layer::enable_distributed()) are flattened in layer order and split in
+    as many contiguous shards as parameter servers. Every worker trains its
+    own replica and every push_every batches:
+
+        1. pushes to every server the slice of its accumulated gradients, i.e.
+           the steps applied by its local optimizer, compressed with the codec,
+        2. pulls the slices of the weights from every server.
+
+    A server adds the pushed steps to its shard as soon as they arrive, scaled
+    by update_scale over the number of active workers. Pulls
+    implement bounded staleness (stale synchronous parallel): the weights are
+    sent to a worker when its push with the same clock has been applied and it
+    is not more than max_staleness pushes ahead of the slowest active worker.
+    max_staleness=0 makes every worker wait for the others at every push.
+
+    A worker that says nothing for worker_timeout seconds, while it is not
+    waiting for weights, is considered dead: it stops counting as an active
+    worker, so it does not hold the others, and its later messages are
+    dropped. worker_timeout=0 waits forever.
+
+    Messages:
+        DATA_GRADIENTS  PS_INIT (initial weights), PS_PUSH (compressed steps)
+        PARAMETER       PS_PULL, PS_BYE
+        DATA_WEIGHTS    PS_WEIGHTS (reply to a pull, float32)
+*/
+
+enum eddl_ps_kinds {PS_INIT    = 0x01,
+                    PS_PUSH    = 0x02,
+                    PS_PULL    = 0x04,
+                    PS_WEIGHTS = 0x08,
+                    PS_BYE     = 0x10};
+
+enum eddl_ps_codecs {PS_FLOAT32 = 0x01,
+                     PS_INT8    = 0x02};   // one float scale for every ps_block values
+
+struct eddl_ps_header
+{
+    uint32_t kind;
+    uint32_t codec;
+    uint64_t clock;     ///< nr of pushes done by the worker (PS_PUSH, PS_PULL)
+    uint64_t version;   ///< nr of pushes applied to the shard when the weights were sent (PS_WEIGHTS), or those the pushed steps were computed on (PS_PUSH)
+    uint64_t offset;    ///< first parameter of the shard in the flattened model
+    uint64_t count;     ///< nr of parameters of the shard
+};
+
+static constexpr size_t ps_block = 256; ///< values sharing one scale in PS_INT8 messages
+
+size_t ps_encoded_size(size_t count, uint32_t codec);
+// values keep the compression error, to be added to the next push (error feedback)
+void ps_encode(float * values, size_t count, uint32_t codec, void * out);
+// w += alpha * decoded values
+void ps_accumulate(const void * in, size_t count, uint32_t codec, float alpha, float * w);
+
+class ParameterServer
+{
+public:
+    ParameterServer(DistributedEnvironment & distributed_environment,
+                    int max_staleness,
+                    float update_scale = 1.0f,
+                    int worker_timeout = 60);
+    ~ParameterServer();
+
+    // serves until a shutdown command is received or, if num_workers > 0, num_workers workers said goodbye
+    void run(int num_workers = 0);
+    void shutdown() { input_queue.push(eddl_message::shutdown_command(0)); }
+
+private:
+    struct worker_info
+    {
+        uint64_t    base;       // clock of the slowest worker when this one joined
+        uint64_t    pushes;     // pushes applied from this worker
+        uint64_t    version;    // version of the last weights sent
+        uint64_t    goodbye;    // clock of the worker when it left
+        uint64_t    last_seen;  // milliseconds, last message from or weights sent to this worker
+        bool        active;
+        bool        timed_out;
+    };
+    struct pending_pull
+    {
+        uint32_t    s_addr;
+        uint64_t    clock;
+    };
+
+    void        handle(eddl_message * message);
+    void        register_worker(uint32_t s_addr, eddl_ps_header * h, float * weights);
+    void        apply_push(uint32_t s_addr, eddl_ps_header * h, void * data);
+    bool        can_be_served(pending_pull & p);
+    void        serve_pending_pulls();
+    void        send_weights(uint32_t s_addr);
+    void        drop_silent_workers();
+    uint64_t    slowest_clock();
+    int         workers_gone();
+
+    DistributedEnvironment &    distributed_environment;
+    eddl_queue                  input_queue;
+    eddl_queue                  output_queue;
+    eddl_queue                  ack_queue;
+    TCP_Receiver *              tcp_receiver;
+    TCP_Sender *                tcp_sender;
+
+    int                         max_staleness;
+    float                       update_scale;
+    int                         worker_timeout;
+    uint64_t                    offset;
+    uint64_t                    version;
+    std::vector<float>          weights;
+    std::map<uint32_t, worker_info> workers;
+    std::list<pending_pull>     pending_pulls;
+
+    uint64_t                    sum_of_staleness;
+    uint64_t                    max_observed_staleness;
+};
+
+class ParameterServerWorker
+{
+public:
+    ParameterServerWorker(Net * net,
+                          DistributedEnvironment & distributed_environment,
+                          std::vector<std::string> servers,
+                          int push_every = 1,
+                          uint32_t codec = PS_INT8);
+    ~ParameterServerWorker();
+
+    void start();   // the first worker initializes the servers, then every worker pulls
+    void train_batch(std::vector<Tensor *> X, std::vector<Tensor *> Y, std::vector<int> sind);
+    void push();
+    void pull();
+    void stop();    // pushes the pending steps and leaves
+
+    inline uint64_t get_clock() { return clock; }
+
+private:
+    void        send(uint32_t type, uint32_t s_addr, eddl_ps_header & h, size_t size, void * data);
+
+    Net *                       net;
+    DistributedEnvironment &    distributed_environment;
+    eddl_queue                  input_queue;
+    eddl_queue                  output_queue;
+    eddl_queue                  ack_queue;
+    TCP_Receiver *              tcp_receiver;
+    TCP_Sender *                tcp_sender;
+
+    std::vector<uint32_t>       servers;
+    std::vector<uint64_t>       shard_offset;   // servers.size()+1 entries
+    std::vector<uint64_t>       shard_version;
+    std::vector<Tensor *>       params;
+    std::vector<Tensor *>       acc_gradients;
+    std::vector<float>          residual;       // steps not pushed yet plus compression error
+    std::vector<unsigned char>  buffer;
+    int                         push_every;
+    uint32_t                    codec;
+    uint64_t                    clock;
+    int                         batches;
+    bool                        running;
+};
+
+};
+
+#endif // __EDDL_PARAMETER_SERVER_H__
@@ -12,16 +12,48 @@
 
 #include <queue>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
 #include <condition_variable>
 
 #include <eddl/distributed/eddl_message.h>
+#include <eddl/distributed/eddl_ring.h>
 
 namespace eddl {
 
+/*
+    Multi-producer/multi-consumer queue of messages with two lanes.
+
+    Acknowledgements, START commands and messages pushed with push_front()
+    go to the priority lane, that is always drained before the normal one;
+    every lane keeps the FIFO order. So these messages overtake the data
+    queued before them, the order is only kept among messages of the same
+    lane. STOP and SHUTDOWN commands stay in the normal lane, behind the
+    data queued before them, which is delivered before stopping.
+
+    Each lane is a lock-free ring, so pushing and popping does not take any
+    lock while the rings are neither full nor empty. When a ring is full the
+    messages are kept in an overflow queue protected by a mutex until the
+    consumers catch up, messages are never dropped and producers never block.
+
+    The mutex and the condition variable are only used to put consumers to
+    sleep when the queue is empty, and producers only take the mutex to wake
+    them up when some consumer is waiting. pop() and front() block until a
+    message is available, they do not return on spurious wake-ups; nullptr
+    can be pushed to wake up a consumer, as the multicast sender does.
+*/
 class eddl_queue
 {
 public:
-    eddl_queue() {}
+    eddl_queue(size_t capacity = 1024) :
+        normal_lane(capacity),
+        priority_lane(std::max(capacity / 4, (size_t)2))
+    {
+        count = 0;
+        waiters = 0;
+    }
 
     ~eddl_queue()
     {
@@ -30,90 +62,191 @@ public:
 
     void clear()
     {
-        // Critical region starts
-        std::unique_lock<std::mutex> lck(mutex_queue);
-
-        while (! q.empty()) {
-            eddl_message *m = q.front();
-            q.pop();
+        eddl_message * m = nullptr;
+        while (try_pop(m))
             delete m;
-        }
-        // Critical region ends
     }
 
     void push(eddl_message * message)
     {
-        // Critical region starts
-        std::unique_lock<std::mutex> lck(mutex_queue);
-        q.push(message);
-        cond_var.notify_one();
-        // Critical region ends
+        if (nullptr == message || is_urgent(message))
+            priority_lane.push(message);
+        else
+            normal_lane.push(message);
+        signal();
     }
 
     void push_front(eddl_message * message)
     {
-        // Critical region starts
-        std::unique_lock<std::mutex> lck(mutex_queue);
-        q.push(message);
-        for (auto i = q.size(); i > 0; i--) {
-            q.push(q.front());
-            q.pop();
-        }
-        cond_var.notify_one();
-        // Critical region ends
+        priority_lane.push(message);
+        signal();
     }
 
+    // the next message without removing it, to be used by the only consumer of the queue
     eddl_message * front()
     {
         eddl_message * message = nullptr;
-        // Critical region starts
-        std::unique_lock<std::mutex> lck(mutex_queue);
-
-        if ( q.empty() ) cond_var.wait(lck);
-
-        if ( ! q.empty() ) {
-            message = q.front();
-        }
+        while (! priority_lane.peek(message) && ! normal_lane.peek(message))
+            wait_until_not_empty();
 
         return message;
-        // Critical region ends
     }
 
     eddl_message * pop()
     {
         eddl_message * message = nullptr;
-        // Critical region starts
-        std::unique_lock<std::mutex> lck(mutex_queue);
+        while (! try_pop(message))
+            wait_until_not_empty();
 
-        if ( q.empty() ) cond_var.wait(lck);
+        return message;
+    }
 
-        if ( ! q.empty() ) {
-            message = q.front();
-            q.pop();
+    // non-blocking version of pop(), returns false if the queue is empty
+    bool try_pop(eddl_message * & message)
+    {
+        if (priority_lane.pop(message) || normal_lane.pop(message)) {
+            count.fetch_sub(1);
+            return true;
         }
-
-        return message;
-        // Critical region ends
+        return false;
     }
 
-    size_t size()
+    // waits until the queue is not empty or the timeout expires
+    bool wait_for(std::chrono::milliseconds timeout)
     {
+        if (! empty()) return true;
+
         // Critical region starts
         std::unique_lock<std::mutex> lck(mutex_queue);
-        return q.size();
+        waiters.fetch_add(1);
+        bool not_empty = cond_var.wait_for(lck, timeout, [this] { return ! empty(); });
+        waiters.fetch_sub(1);
+        return not_empty;
         // Critical region ends
     }
 
+    size_t size()
+    {
+        // transiently negative while a pushed message is being counted
+        int64_t n = count.load();
+        return n > 0 ? (size_t)n : 0;
+    }
+
     bool empty()
     {
+        return count.load() <= 0;
+    }
+
+private:
+    class lane
+    {
+    public:
+        lane(size_t capacity) : ring(capacity)
+        {
+            spilled = 0;
+        }
+
+        void push(eddl_message * message)
+        {
+            // once a message has overflowed the next ones follow it to keep the order
+            if (0 == spilled.load() && ring.try_push(message)) return;
+
+            // Critical region starts
+            std::unique_lock<std::mutex> lck(mutex_overflow);
+            overflow.push(message);
+            spilled.fetch_add(1);
+            // Critical region ends
+        }
+
+        bool pop(eddl_message * & message)
+        {
+            if (ring.try_pop(message)) return true;
+            // the overflow comes after the ring, also after the pushes to the ring still in progress
+            if (0 == spilled.load() || ! ring.empty()) return false;
+
+            // Critical region starts
+            std::unique_lock<std::mutex> lck(mutex_overflow);
+            if (overflow.empty()) return false;
+            message = overflow.front();
+            overflow.pop();
+            spilled.fetch_sub(1);
+            return true;
+            // Critical region ends
+        }
+
+        bool peek(eddl_message * & message)
+        {
+            if (ring.peek(message)) return true;
+            if (0 == spilled.load() || ! ring.empty()) return false;
+
+            // Critical region starts
+            std::unique_lock<std::mutex> lck(mutex_overflow);
+            if (overflow.empty()) return false;
+            message = overflow.front();
+            return true;
+            // Critical region ends
+        }
+
+    private:
+        eddl_ring<eddl_message *>   ring;
+        std::queue<eddl_message *>  overflow;
+        std::mutex                  mutex_overflow;
+        std::atomic<size_t>         spilled;
+    };
+
+    static bool is_urgent(eddl_message * message)
+    {
+        switch (message->get_type()) {
+            case eddl_message_types::COMMAND:
+                return message->get_command() == eddl_command_types::START;
+            case eddl_message_types::PKG_ACK:
+            case eddl_message_types::MSG_ACK_WEIGHTS:
+            case eddl_message_types::MSG_ACK_GRADIENTS:
+            case eddl_message_types::MSG_ACK_SAMPLES:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void signal()
+    {
+        /*
+            count is increased before checking for waiters and consumers
+            register themselves before checking count (both sequentially
+            consistent), so either the consumer sees the message or the
+            producer sees the consumer and notifies it while holding the
+            mutex, i.e., after the consumer started to wait
+        */
+        count.fetch_add(1);
+        if (waiters.load() > 0) {
+            // Critical region starts
+            std::unique_lock<std::mutex> lck(mutex_queue);
+            cond_var.notify_all();
+            // Critical region ends
+        }
+    }
+
+    void wait_until_not_empty()
+    {
+        // a message was counted but is still being written by its producer
+        if (! empty()) {
+            std::this_thread::yield();
+            return;
+        }
+
         // Critical region starts
         std::unique_lock<std::mutex> lck(mutex_queue);
-        return q.empty();
+        waiters.fetch_add(1);
+        cond_var.wait(lck, [this] { return ! empty(); });
+        waiters.fetch_sub(1);
         // Critical region ends
     }
 
-private:
-    std::queue<eddl_message *>  q; // the actual queue
+    lane                        normal_lane;
+    lane                        priority_lane;
+    std::atomic<int64_t>        count;      // messages in both lanes
+    std::atomic<int>            waiters;    // consumers sleeping on the condition variable
     std::mutex                  mutex_queue;
     std::condition_variable     cond_var;
 };
@@ -0,0 +1,129 @@
+/*
+ * EDDL Library - European Distributed Deep Learning Library.
+ * Version: x.y
+ * copyright (c) 2020, Universitat Politècnica de València (UPV), PRHLT Research Centre
+ * Date: July 2020
+ * Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+ * All rights reserved
+ */
+
+#ifndef __EDDL_RING_H__
+#define __EDDL_RING_H__ 1
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+
+#include <eddl/distributed/eddl_distributed.h>
+
+namespace eddl {
+
+/*
+    Bounded lock-free multi-producer/multi-consumer ring (D. Vyukov).
+
+    Every cell carries a sequence number that tells producers and consumers
+    whether the cell is free for the current lap or holds a value, so
+    try_push() and try_pop() only need one compare-and-swap on the
+    corresponding position and never block. They return false when the ring
+    is full or empty respectively. The capacity must be a power of two.
+*/
+template <typename T>
+class eddl_ring
+{
+public:
+    eddl_ring(size_t capacity) : mask(capacity - 1)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+            throw std::runtime_error(err_msg("ring capacity must be a power of two."));
+
+        cells.reset(new cell[capacity]);
+        for (size_t i = 0; i < capacity; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        enqueue_pos.store(0, std::memory_order_relaxed);
+        dequeue_pos.store(0, std::memory_order_relaxed);
+    }
+
+    bool try_push(T value)
+    {
+        cell * c;
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            c = & cells[pos & mask];
+            size_t seq = c->sequence.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (0 == dif) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (dif < 0) {
+                return false; // full
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        c->value = value;
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T & value)
+    {
+        cell * c;
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            c = & cells[pos & mask];
+            size_t seq = c->sequence.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (0 == dif) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (dif < 0) {
+                return false; // empty
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        value = c->value;
+        c->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // the next value to be popped, only meaningful when there is a single consumer
+    bool peek(T & value)
+    {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        cell & c = cells[pos & mask];
+        if (c.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+        value = c.value;
+        return true;
+    }
+
+    // no value pushed or being pushed is left to pop, a try_pop() that failed can be
+    // due to a producer that has not finished its push yet
+    bool empty()
+    {
+        return dequeue_pos.load(std::memory_order_acquire) == enqueue_pos.load(std::memory_order_acquire);
+    }
+
+    inline size_t capacity() { return mask + 1; }
+
+private:
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        T                   value;
+    };
+
+    // padding keeps producers and consumers on different cache lines
+    std::unique_ptr<cell[]>     cells;
+    const size_t                mask;
+    char                        pad_0[64];
+    std::atomic<size_t>         enqueue_pos;
+    char                        pad_1[64];
+    std::atomic<size_t>         dequeue_pos;
+    char                        pad_2[64];
+};
+
+};
+
+#endif // __EDDL_RING_H__
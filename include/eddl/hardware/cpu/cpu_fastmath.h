@@ -0,0 +1,113 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_CPU_FASTMATH_H
+#define EDDL_CPU_FASTMATH_H
+
+#include <cstdint>
+#include <cstring>
+
+// Elementwise transcendentals as branch-free polynomials (Cephes coefficients), so loops calling them
+// vectorize. Relative error below 2e-7 (exp, log) and 1e-6 (tanh, sigmoid) on their whole domain.
+// Subnormal results are flushed to zero.
+
+static inline float fm_from_bits(uint32_t u) { float f; std::memcpy(&f, &u, sizeof(f)); return f; }
+static inline uint32_t fm_to_bits(float f) { uint32_t u; std::memcpy(&u, &f, sizeof(u)); return u; }
+
+static inline float fast_expf(float x) {
+    const float hi = 88.7228391116729996f;  // ln(FLT_MAX)
+    const float lo = -87.3365447504f;  // exp(lo) is the smallest normal float
+    float xc = x > hi ? hi : (x < lo ? lo : x);
+
+    // exp(x) = 2^n * exp(r), |r| <= ln(2)/2
+    float fn = xc * 1.44269504088896341f;
+    fn = fn >= 0.0f ? (float)(int)(fn + 0.5f) : (float)(int)(fn - 0.5f);
+    float r = xc - fn * 0.693359375f + fn * 2.12194440e-4f;
+
+    float z = r * r;
+    float p = 1.9875691500E-4f;
+    p = p * r + 1.3981999507E-3f;
+    p = p * r + 8.3334519073E-3f;
+    p = p * r + 4.1665795894E-2f;
+    p = p * r + 1.6666665459E-1f;
+    p = p * r + 5.0000001201E-1f;
+    p = p * z + r + 1.0f;
+
+    // 2^n in two halves: n reaches 128 near hi and -126 near lo, out of the range of a single normal scale
+    int n = (int)fn;
+    int n1 = n >> 1, n2 = n - n1;
+    float y = p * fm_from_bits((uint32_t)(n1 + 127) << 23) * fm_from_bits((uint32_t)(n2 + 127) << 23);
+    y = x < lo ? 0.0f : y;
+    y = x > hi ? fm_from_bits(0x7f800000u) : y;  // inf
+    return y;
+}
+
+static inline float fast_logf(float x) {
+    // x = m * 2^e, m in [sqrt(0.5), sqrt(2))
+    uint32_t u = fm_to_bits(x);
+    int e = (int)((u >> 23) & 0xff) - 126;
+    float m = fm_from_bits((u & 0x007fffffu) | 0x3f000000u);  // [0.5, 1)
+    bool small = m < 0.707106781186547524f;
+    e = small ? e - 1 : e;
+    m = small ? m + m - 1.0f : m - 1.0f;
+    float fe = (float)e;
+
+    float z = m * m;
+    float p = 7.0376836292E-2f;
+    p = p * m - 1.1514610310E-1f;
+    p = p * m + 1.1676998740E-1f;
+    p = p * m - 1.2420140846E-1f;
+    p = p * m + 1.4249322787E-1f;
+    p = p * m - 1.6668057665E-1f;
+    p = p * m + 2.0000714765E-1f;
+    p = p * m - 2.4999993993E-1f;
+    p = p * m + 3.3333331174E-1f;
+    float y = p * m * z;
+    y += -2.12194440e-4f * fe;
+    y += -0.5f * z;
+    y = m + y;
+    y += 0.693359375f * fe;
+
+    y = x < 1.17549435e-38f ? -fm_from_bits(0x7f800000u) : y;  // 0 and subnormals: -inf
+    y = x < 0.0f ? fm_from_bits(0x7fc00000u) : y;  // nan
+    y = (x > 3.40282346e+38f || x != x) ? x : y;  // inf, nan
+    return y;
+}
+
+static inline float fast_tanhf(float x) {
+    float ax = x < 0.0f ? -x : x;
+
+    // Small |x|: odd polynomial. Otherwise: 1 - 2 / (exp(2|x|) + 1)
+    float z = x * x;
+    float p = -5.70498872745E-3f;
+    p = p * z + 2.06390887954E-2f;
+    p = p * z - 5.37397155531E-2f;
+    p = p * z + 1.33314422036E-1f;
+    p = p * z - 3.33332819422E-1f;
+    float small = p * z * x + x;
+
+    float big = 1.0f - 2.0f / (fast_expf(ax + ax) + 1.0f);
+    big = x < 0.0f ? -big : big;
+    return ax < 0.625f ? small : big;
+}
+
+static inline float fast_sigmoidf(float x) {
+    return 1.0f / (1.0f + fast_expf(-x));
+}
+
+
+// Array versions: dispatched at runtime to the widest SIMD extension of the CPU (when the compiler supports
+// function multi-versioning) and split among the OpenMP threads according to cpu_threads (cpu_parallel.h).
+// In-place (x == y) is allowed
+void cpu_fast_exp(const float *x, float *y, long int n);
+void cpu_fast_log(const float *x, float *y, long int n);
+void cpu_fast_tanh(const float *x, float *y, long int n);
+void cpu_fast_sigmoid(const float *x, float *y, long int n);
+
+#endif //EDDL_CPU_FASTMATH_H
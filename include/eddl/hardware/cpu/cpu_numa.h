@@ -0,0 +1,68 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_CPU_NUMA_H
+#define EDDL_CPU_NUMA_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// NUMA placement and thread affinity for CPU nets (CS_CPU "affinity" and "numa" arguments). Linux only: on
+// other systems (or when the kernel refuses, e.g. in some containers) the functions do nothing.
+//
+// Placement policy:
+//  - Weights, gradients and optimizer state are read by every thread: their pages are interleaved among
+//    the nodes, so no socket serves all the traffic.
+//  - The rest of the CPU tensors (activations, deltas, im2col buffers...) are first touched in parallel, with
+//    the partition of the cheap elementwise kernels (cpu_threads(n, CPU_COST_CHEAP), static schedule; see
+//    cpu_parallel.h), so those kernels find their chunk in their local node. Kernels that split the work
+//    otherwise (GEMM, convolutions) may still read remote pages.
+
+/**
+  *  @brief CPUs of every online NUMA node (only those allowed to the process, as when it started).
+  *  A single node with all the allowed CPUs if the topology is not available.
+*/
+const vector<vector<int>> &cpu_numa_topology();
+
+/**
+  *  @brief Order in which the OpenMP threads are pinned.
+  *  @param topology  CPUs per node
+  *  @param policy  "close": fill a node before moving to the next one. "spread": round-robin among the nodes.
+*/
+vector<int> cpu_affinity_order(const vector<vector<int>> &topology, const string &policy);
+
+/**
+  *  @brief Pins every thread of the OpenMP team (including the calling one) to one CPU.
+  *  @return false if the affinity could not be set
+*/
+bool cpu_pin_threads(const string &policy);
+
+/**
+  *  @brief Interleaves the (whole) pages of [ptr, ptr+size) among all the nodes, moving the pages already touched.
+  *  @return false if the policy could not be applied
+*/
+bool cpu_numa_interleave(void *ptr, size_t size);
+
+/**
+  *  @brief Reference count of the parallel first touch of the new CPU tensors (cpu_numa_first_touch): it is
+  *  enabled while some user (a net built with numa=true) holds a reference.
+*/
+void cpu_numa_first_touch_acquire();
+void cpu_numa_first_touch_release();
+bool cpu_numa_first_touch_enabled();
+
+/**
+  *  @brief Zeroes a new buffer in parallel (static partition) when the first touch is enabled; no-op otherwise.
+*/
+void cpu_numa_first_touch(float *ptr, long int n);
+
+#endif //EDDL_CPU_NUMA_H
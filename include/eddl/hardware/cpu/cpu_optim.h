@@ -0,0 +1,34 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_CPU_OPTIM_H
+#define EDDL_CPU_OPTIM_H
+
+#include "eddl/tensor/tensor.h"
+
+// Fused layer-wise adaptive updates of one parameter tensor. The first parallel pass produces the update
+// direction and reduces ||w|| and ||update|| together, the second one applies the step scaled by the trust
+// ratio. With adapt=false (biases, normalization params) the ratio is 1 and no weight decay is applied.
+// ACC (nullable) receives the same step as W (distributed accumulation of gradients).
+
+// LARS: ratio = eta*||w|| / (||g|| + wd*||w|| + eps), v = mu*v + lr*ratio*(g + wd*w), w -= v
+void cpu_lars_update(Tensor *W, Tensor *G, Tensor *V, Tensor *ACC, float lr, float mu, float weight_decay,
+                     float eta, float epsilon, bool adapt);
+
+// LAMB: Adam moments, u = m^/(sqrt(v^) + eps) + wd*w (kept in U), w -= lr * ||w||/||u|| * u
+void cpu_lamb_update(Tensor *W, Tensor *G, Tensor *M, Tensor *V, Tensor *U, Tensor *ACC, float lr, float beta_1,
+                     float beta_2, float epsilon, float weight_decay, long t, bool adapt);
+
+// Adam on raw arrays (a parameter tensor or a shard of the flattened params, see set_zero_distributed):
+// m^ = m/(1-b1^t), v^ = v/(1-b2^t), w -= lr * m^/sqrt(v^ + eps). The update of Adam::applygrads, without
+// the m^ and v^ temporaries. acc (nullable) receives the same step as w
+void cpu_adam_update(float *w, const float *g, float *m, float *v, float *acc, long int size, float lr, float beta_1,
+                     float beta_2, float epsilon, long t);
+
+#endif //EDDL_CPU_OPTIM_H
@@ -0,0 +1,55 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_CPU_PARALLEL_H
+#define EDDL_CPU_PARALLEL_H
+
+// Size-aware OpenMP regions. The CPU kernels open their loops with
+//
+//     #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
+//
+// so that small tensors (biases, BN parameters, small RNN states...) run on the calling thread instead of
+// paying the fork/join of the whole team, and medium ones use only as many threads as they can keep busy.
+// Each thread gets a contiguous chunk (static schedule).
+
+// Approximate cost per element, in units of a simple arithmetic operation
+#define CPU_COST_CHEAP   1   // copy, add, mult, max, comparisons...
+#define CPU_COST_MEDIUM  4   // div, sqrt, rounding, polynomial approximations (cpu_fastmath.h)
+#define CPU_COST_HEAVY  16   // libm transcendentals (pow, sin, fmod...), sorting
+
+#define CPU_GRAIN_DEFAULT 32768  // Work units per thread (see cpu_set_grain)
+
+extern long int cpu_grain;  // Current value (read only, see cpu_set_grain)
+
+/**
+  *  @brief Threads for a loop of "n" elements of the given cost: 1 below two grains of work, then one
+  *  thread per grain up to the OpenMP maximum.
+*/
+int cpu_threads(long int n, int cost);
+
+/**
+  *  @brief Sets the size of the OpenMP team of the calling thread (the maximum of cpu_threads).
+  *  @return The previous size
+*/
+int cpu_set_threads(int threads);
+
+/**
+  *  @brief Sets the minimum work per thread (elements x cost). Also taken from the environment variable
+  *  EDDL_CPU_GRAIN at startup: a number, or "auto" to run cpu_calibrate_grain().
+*/
+void cpu_set_grain(long int grain);
+
+/**
+  *  @brief Measures the fork/join overhead of the OpenMP team and the time of a cheap elementwise
+  *  operation, and sets the grain so that the overhead stays below ~10% of the work of a thread.
+  *  @return The new grain
+*/
+long int cpu_calibrate_grain();
+
+#endif //EDDL_CPU_PARALLEL_H
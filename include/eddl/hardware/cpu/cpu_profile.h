@@ -150,7 +150,6 @@
 #define _CPU_FLIP                  146
 
 #define _NUM_CPU_FUNCS       147
-extern int num_instances[_NUM_CPU_FUNCS];
 void _profile(int f_id, int end);
 void _profile_add_tensor(unsigned long int size);
 
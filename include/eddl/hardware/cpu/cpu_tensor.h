@@ -13,6 +13,7 @@
 //#define CPU_DEBUG
 
 #include "cpu_profile.h"
+#include "cpu_parallel.h"
 
 #include "eddl/tensor/tensor.h"
 #include "eddl/tensor/tensor_reduction.h"
@@ -34,6 +35,7 @@ void cpu_fill(Tensor *A, int aini, int aend, Tensor *B, int bini, int bend, int
 void _cpu_sort(Tensor *A, Tensor *B, bool descending, bool stable);
 void cpu_sort(Tensor *A, Tensor *B, bool descending, bool stable);
 void cpu_argsort(Tensor *A, Tensor *B, bool descending, bool stable);
+void cpu_topk(Tensor *A, Tensor *values, Tensor *indices, int axis, int k, bool largest, bool sorted);
 
 void cpu_select(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_select_back(Tensor *A, Tensor *B, SelDescriptor *sd);
@@ -43,16 +43,16 @@ void cpu_d_softplus(Tensor *D, Tensor *I, Tensor *PD);
 void cpu_softsign(Tensor *A, Tensor *B);
 void cpu_d_softsign(Tensor *D, Tensor *I, Tensor *PD);
 
-void cpu_sigmoid(Tensor *A, Tensor *B);
+void cpu_sigmoid_nn(Tensor *A, Tensor *B);
 void cpu_d_sigmoid(Tensor *D, Tensor *I, Tensor *PD);
 
 void cpu_hard_sigmoid(Tensor *A, Tensor *B);
 void cpu_d_hard_sigmoid(Tensor *D, Tensor *I, Tensor *PD);
 
-void cpu_exp(Tensor *A, Tensor *B);
+void cpu_exp_nn(Tensor *A, Tensor *B);
 void cpu_d_exp(Tensor *D, Tensor *I, Tensor *PD);
 
-void cpu_tanh(Tensor *A, Tensor *B);
+void cpu_tanh_nn(Tensor *A, Tensor *B);
 void cpu_d_tanh(Tensor *D, Tensor *I, Tensor *PD);
 
 void cpu_softmax(Tensor *A, Tensor *B);
@@ -75,6 +75,7 @@ void cpu_bin_cent(Tensor *A, Tensor *B, Tensor *C);
 
 float cpu_categorical_cross_entropy(Tensor* y_true, Tensor* y_pred);
 void cpu_d_categorical_cross_entropy(Tensor* y_true, Tensor* y_pred, Tensor* delta);
+float cpu_softmax_cross_entropy(Tensor* y_true, Tensor* logits, Tensor* y_pred, Tensor* delta);
 
 float cpu_binary_cross_entropy(Tensor* y_true, Tensor* y_pred);
 void cpu_d_binary_cross_entropy(Tensor* y_true, Tensor* y_pred, Tensor* delta);
@@ -95,6 +96,11 @@ void cpu_conv3D(ConvolDescriptor3D *D);
 void cpu_conv3D_grad(ConvolDescriptor3D *D);
 void cpu_conv3D_back(ConvolDescriptor3D *D);
 
+// ConvT2D
+void cpu_convT2D(ConvolDescriptorT2D *D);
+void cpu_convT2D_grad(ConvolDescriptorT2D *D);
+void cpu_convT2D_back(ConvolDescriptorT2D *D);
+
 // MaxPool2D
 void cpu_mpool2D(PoolDescriptor*D);
 void cpu_mpool2D_back(PoolDescriptor *D);
@@ -114,6 +120,8 @@ void cpu_avgpool3D_back(PoolDescriptor3D *D);
 // Tensor (special functions that deal with 4D tensors)
 void cpu_repeat_nn(Tensor *A, Tensor *B, vector<int> size);
 void cpu_d_repeat_nn(Tensor *D, Tensor *A, vector<int> size);
+void cpu_upsampling2D(Tensor *A, Tensor *B, vector<int> size, bool bilinear);
+void cpu_d_upsampling2D(Tensor *D, Tensor *A, vector<int> size, bool bilinear);
 
 void cpu_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
 void cpu_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd);
@@ -25,6 +25,9 @@
 
 using namespace std;
 
+// Analytical cost of a convolution with filters K (transposed or not). See Layer::get_cost
+LayerCost conv_cost(Tensor *input, Tensor *output, Tensor *K, bool transposed);
+
 
 /// Conv2D Layer
 class LConv : public LinLayer {
@@ -54,6 +57,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void resize(int batch) override;
 
     void initialize() override;
@@ -103,6 +108,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void resize(int batch) override;
 
     void initialize() override;
@@ -156,6 +163,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void resize(int batch) override;
 
     void initialize() override;
@@ -203,6 +212,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void resize(int batch) override;
 
     void initialize() override;
@@ -251,6 +262,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void resize(int batch) override;
 
     void initialize() override;
@@ -75,6 +75,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     string plot(int c) override;
 
 };
@@ -147,6 +149,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void resize(int batch) override;
 
 	// Sets the weights to the values of the parameter w
@@ -210,6 +214,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     string plot(int c) override;
 
 };
@@ -236,6 +242,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void resize(int batch) override;
 
     string plot(int c) override;
@@ -29,6 +29,14 @@ using namespace std;
 
 class Net;
 
+// Analytical cost of a layer at the current batch size (see Net::summary)
+struct LayerCost {
+    double fwd_flops = 0.0;
+    double bwd_flops = 0.0;
+    double fwd_bytes = 0.0;  // Bytes read + written
+    double bwd_bytes = 0.0;
+};
+
 class Layer {
 private:
     int    reference_counter;
@@ -115,6 +123,7 @@ public:
     virtual int get_trainable_params_count();
     virtual void zeroGrads();
     virtual string plot(int c) { return ""; }
+    virtual LayerCost get_cost();
 
     virtual void addchild(Layer *l) {}
 
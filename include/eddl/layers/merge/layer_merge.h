@@ -163,6 +163,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     string plot(int c) override;
 
 };
@@ -23,6 +23,9 @@
 
 using namespace std;
 
+// Analytical cost of a normalization (batch, layer or group). See Layer::get_cost
+LayerCost normalization_cost(Tensor *input, Tensor *output);
+
 void BN_forward(Tensor *input, Tensor *bn_mean, Tensor *bn_var, Tensor *mean, Tensor *variance,float momentum, float epsilon, int trmode);
 void BN_backward(Tensor *delta, Tensor *bn_var, Tensor *opa);
 void rsum(Tensor *A, Tensor *b, Tensor *ones, Tensor *mem,int p=1);
@@ -82,6 +85,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void initialize() override;
 
     void resize(int batch) override;
@@ -128,6 +133,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     string plot(int c) override;
 };
 
@@ -163,6 +170,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void initialize() override;
 
     void resize(int batch) override;
@@ -37,6 +37,8 @@ public:
     void mem_delta() override;
 
     void resize(int batch) override;
+
+    LayerCost get_cost() override;
 };
 
 /// Pool1D Layer
@@ -54,6 +56,8 @@ public:
     void mem_delta() override;
 
     void resize(int batch) override;
+
+    LayerCost get_cost() override;
 };
 
 /// Pool3D Layer
@@ -70,6 +74,8 @@ public:
     void mem_delta() override;
 
     void resize(int batch) override;
+
+    LayerCost get_cost() override;
 };
 
 /// MaxPool2D Layer
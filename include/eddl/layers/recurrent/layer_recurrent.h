@@ -22,6 +22,9 @@
 
 using namespace std;
 
+// Analytical cost of one time step of a recurrent cell with "gates" gates. See Layer::get_cost
+LayerCost recurrent_cost(Layer *l, int gates, double elementwise_ops);
+
 
 /// RNN Layer
 class LCopyStates : public MLayer {
@@ -100,6 +103,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void update_weights(vector<Tensor*> weights) override;
 
     void accumulate_accumulated_gradients(vector<Tensor*> grads) override;
@@ -174,6 +179,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void update_weights(vector<Tensor*> weights) override;
 
     void accumulate_accumulated_gradients(vector<Tensor*> grads) override;
@@ -247,6 +254,8 @@ public:
 
     void backward() override;
 
+    LayerCost get_cost() override;
+
     void update_weights(vector<Tensor*> weights) override;
 
     void accumulate_accumulated_gradients(vector<Tensor*> grads) override;
@@ -166,6 +166,58 @@ void set_avg_method_distributed(int method, int batch_avg, int epoch_avg=1, floa
  */
 void end_distributed();
 
+/**
+ *  @brief Selects how the weights are reduced and broadcast among the processes
+ *  Hierarchical: shared-memory reduce-scatter among the processes of a node, allreduce among the nodes
+ *  on 1/(processes per node) of the data, and shared-memory allgather. Only for processes with the weights
+ *  in host memory (CPU, or GPU without CUDA-aware MPI). Enabled by init_distributed; it falls back to a
+ *  flat allreduce when there is one process per node or nodes run different nr of processes
+ *
+ *  @param enable 1: hierarchical, 0: flat MPI_Allreduce/MPI_Bcast over all the processes
+ *  @param ranks_per_node Groups the processes of a node in "nodes" of this size (0: whole node). Allows
+ *  testing the inter-node step on a single machine (e.g. mpirun --oversubscribe)
+ */
+void set_hierarchical_distributed(int enable, int ranks_per_node=0);
+
+/**
+ *  @brief Sums a buffer in host memory over all the processes, in place, with the reduction selected by
+ *  set_hierarchical_distributed. Buffers of more than INT_MAX elements are reduced in chunks. Collective
+ *
+ *  @param myptr  Buffer
+ *  @param count  Nr of elements
+ */
+void fn_mpi_hier_AllReduce(float* myptr, size_t count);
+
+/**
+ *  @brief Shards the Adam optimizer among the processes (ZeRO-style). The gradients are averaged with a
+ *  reduce-scatter, every process keeps the moments of and updates 1/(nr of processes) of the flattened
+ *  params, and the new weights are allgathered. Both collectives go in fixed-size buckets, without a copy of
+ *  the whole flattened params. The weights are in sync after every batch, so
+ *  avg_weights_distributed has nothing to do. Only for nets on CPU. Collective
+ *
+ *  @param net  Built net with an Adam optimizer
+ *  @param enable 1: shard the optimizer state, 0: back to the full state in every process
+ */
+void set_zero_distributed(Net* net, int enable);
+
+/**
+ *  @brief Elastic training: the training goes on when processes fail. Every snapshot_batches batches (at a
+ *  sync point of avg_weights_distributed) every process keeps an in-memory snapshot of the weights and the
+ *  optimizer state, and replicates it to its buddy (the next process). A collective that does not complete
+ *  in timeout secs means a failed process: the survivors agree on who is alive, build a new communicator
+ *  (ids and nr of processes change), roll back to the last snapshot and go on. The sharded Adam state
+ *  (set_zero_distributed) of a failed process comes from its buddy. Needs a runtime that does not abort
+ *  the job when a process dies (Open MPI: mpirun --enable-recovery). MPI only, one device per process,
+ *  not with the hierarchical reduction nor the pipeline. For the synchronous data-parallel training, that
+ *  runs over MPI; the asynchronous parameter server of the TCP runtime drops silent workers on its own
+ *  (worker_timeout of ParameterServer). Collective
+ *
+ *  @param net  Built net, trained with fit or train_batch + avg_weights_distributed
+ *  @param snapshot_batches  Nr of batches between snapshots (0 disables elastic training)
+ *  @param timeout  Secs. Longer than the computation between two collectives (e.g. the batches between averages)
+ */
+void set_elastic_distributed(Net* net, int snapshot_batches, float timeout=60.0f);
+
 
 /**
  *  @brief Checks if running in mpi_distributed mode
@@ -311,6 +363,35 @@ void set_batch_avg_overhead_distributed(double secs_train, double secs_comm, int
  */
 void set_batch_avg_overhead_distributed(double secs_train, double secs_comm, int max_ba, float overhead);
 
+/**
+ *  @brief Sets pipeline model parallelism: the layers of the net (forward order) are split in
+ *  consecutive stages, one per process, and every batch is processed as micro-batches in a 1F1B
+ *  schedule. The activations and deltas are sent point-to-point among the stages. A process only
+ *  holds the activations of its stage (one copy per micro-batch in flight). Collective
+ *
+ *  @param net  Built net (CPU or one GPU per process). Every process builds the same net
+ *  @param micro_batches  Nr of micro-batches per batch (0 disables the pipeline)
+ *  @param stage_layers  Nr of layers of every stage. Default: stages with a similar cost (see summary)
+ */
+void set_pipeline_distributed(Net* net, int micro_batches, vector<int> stage_layers={});
+
+/**
+ *  @brief Trains one batch with the pipeline (see set_pipeline_distributed). Losses and metrics are
+ *  accumulated in every process, as train_batch does (see print_loss). Collective
+ *
+ *  @param net  Net of set_pipeline_distributed
+ *  @param X  Batch of every input. Only read by the stages with the input layers
+ *  @param Y  Batch of every output. Only read by the stages with the output layers
+ */
+void train_batch_pipeline_distributed(Net* net, vtensor X, vtensor Y);
+
+/**
+ *  @brief Copies the params of every stage to all the processes (e.g. to evaluate or save the net). Collective
+ *
+ *  @param net  Net of set_pipeline_distributed
+ */
+void gather_pipeline_weights_distributed(Net* net);
+
 // For Debugging purposes
 void gpu_layer_print (Net* net, int layer);
 
@@ -36,6 +36,10 @@ public:
     // 2: low memory. save memory as much as possible
     int mem_level;
 
+    // CPU only (see cpu_numa.h)
+    string affinity = "none";  // Thread pinning: "none", "close" or "spread"
+    bool numa = false;  // NUMA-aware placement of the tensors
+
     CompServ();
     CompServ * share();
     CompServ * clone();
@@ -19,6 +19,7 @@
 #include "eddl/losses/loss.h"
 #include "eddl/metrics/metric.h"
 #include "eddl/net/compserv.h"
+#include "eddl/serialization/checkpoint/checkpoint.h"
 
 using namespace std;
 
@@ -31,12 +32,15 @@ typedef vector<int> vind;
 typedef vector<Loss *> vloss;
 typedef vector<Metric *> vmetrics;
 
+class DataLoader;
+
 
 /////////////////////////////////////////
 int isIn(Layer *l, vlayer vl, int &ind);
 int isInorig(Layer *l, vlayer vl, int &ind);
 
 #define MAX_THREADS 1024
+#define RIDGE_POINT 10.0f  // FLOPs/byte. Typical for a multi-core CPU (peak GFLOP/s / memory GB/s)
 
 class Net {
 private:
@@ -44,8 +48,13 @@ private:
 
     void check_compserv_compatibility(CompServ *cs);
 
+    void get_checkpoint_tensors(vector<string> &names, vtensor &tensors, bool with_optimizer);
+
     void set_compserv(CompServ *cs, bool do_compserv_delete);
 
+    void set_numa_placement();
+    bool numa_first_touch;  // This net holds a reference on the first touch (released when deleted)
+
 public:
     string name;
     int dev;
@@ -78,7 +87,21 @@ public:
     vlayer vbts;
     vlayer netinput;
 
+    // Per-layer accumulated time in seconds, indexed as vfts/vbts (only when layer_timing is enabled)
+    bool layer_timing;
+    vector<double> vfts_time;
+    vector<double> vbts_time;
+    vector<int> vfts_zone;  // Profiler zones of the layers, see profiler_register()
+    vector<int> vbts_zone;
+    int timed_forwards;
+    int timed_backwards;
+
+    // Machine balance (FLOPs/byte) used by summary() to classify layers as compute or memory bound
+    float ridge_point;
+
     vloss losses;
+    vector<bool> fused_loss;   // Per output: softmax + cross-entropy computed by one kernel (see do_compute_loss)
+    vector<bool> fused_delta;  // Per output: the fused kernel already computed the delta of this batch
     vmetrics metrics;
     verr fiterr;
     verr total_loss;
@@ -92,6 +115,7 @@ public:
     bool do_optimizer_delete;
     vector<Net *> snets;
     Net* rnet;
+    CheckpointWriter *ckpt_writer;
 
     vtensor Xs[MAX_THREADS];
     vtensor Ys[MAX_THREADS];
@@ -111,6 +135,7 @@ public:
     void fts();
     void bts();
     void split(int c, int todev);
+    Net *create_context();
     Net *unroll(int inl, int outl);
     Net *unroll_enc(int inl, int outl);
     Net *unroll_enc_dec(int inl, int outl);
@@ -137,10 +162,14 @@ public:
     void plot(const string& fname="model.pdf", const string& rankdir="LR");
 
     void setmode(int m);
+    void set_layer_timing(bool enable);
 
 
     void save(const string& filename, const string& format="");
     void load(const string& filename, const string& format="");
+    void save_checkpoint(const string& filename, bool async=true);
+    void load_checkpoint(const string& filename);
+    void wait_checkpoint();
     void setlogfile(const string& fname);
 
 
@@ -187,6 +216,7 @@ public:
     vector<float> get_metrics();
 
     void fit(vtensor tin, vtensor tout, int batch_size, int epochs);
+    void fit(DataLoader *loader, int epochs);
     void prepare_recurrent(vtensor tin, vtensor tout, int &inl, int &outl, vtensor &xt,vtensor &xtd,vtensor &yt,vtensor &tinr,vtensor &toutr, Tensor *Z=nullptr);
     void prepare_recurrent_enc(vtensor tin, vtensor tout, int &inl, int &outl, vtensor &xt,vtensor &xtd,vtensor &yt,vtensor &tinr,vtensor &toutr, Tensor *Z=nullptr);
     void prepare_recurrent_dec(vtensor tin, vtensor tout, int &inl, int &outl, vtensor &xt,vtensor &xtd,vtensor &yt,vtensor &tinr,vtensor &toutr, Tensor *Z=nullptr);
@@ -195,6 +225,7 @@ public:
     void fit_recurrent(vtensor tin, vtensor tout, int batch_size, int epochs);
     void train_batch(vtensor X, vtensor Y, vind sind, int eval = 0);
     void train_batch_recurrent(vtensor X, vtensor Y, vind sind, int eval = 0);
+    void train_loaded_batch(vtensor X, vtensor Y);
     void evaluate(vtensor tin, vtensor tout, int bs=100);
     void evaluate_recurrent(vtensor tin, vtensor tout, int bs);
     void evaluate_distr(vtensor tin, vtensor tout, int bs=100);
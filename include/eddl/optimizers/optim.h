@@ -47,6 +47,12 @@ public:
 
     virtual void change(vector<float> p) {}
 
+    // Checkpointing: named state tensors (e.g. momentum) and step counter
+    virtual void get_state(vector<string> &names, vtensor &tensors) {}
+    virtual long get_step() { return 0; }
+    virtual void set_step(long step) {}
+    void add_state(const string &slot, const vtensor &state, vector<string> &names, vtensor &tensors);
+
 };
 
 class SGD : public Optimizer {
@@ -69,6 +75,8 @@ public:
     void applygrads(int batch) override;
 
     void change(vector<float> p) override;
+
+    void get_state(vector<string> &names, vtensor &tensors) override;
 };
 
 // ---- Adam ----
@@ -80,7 +88,7 @@ public:
     float epsilon;
     float weight_decay;
     bool amsgrad;
-    int t;
+    long t;
 
     vtensor mT;
     vtensor vT;
@@ -98,6 +106,10 @@ public:
     void applygrads(int batch) override;
 
     void change(vector<float> p) override;
+
+    void get_state(vector<string> &names, vtensor &tensors) override;
+    long get_step() override;
+    void set_step(long step) override;
 };
 
 
@@ -214,6 +226,67 @@ public:
     void applygrads(int batch) override;
 
     void change(vector<float> p) override;
+
+    void get_state(vector<string> &names, vtensor &tensors) override;
+};
+
+// ---- LARS ----
+// Layer-wise Adaptive Rate Scaling (SGD with momentum and a per-layer trust ratio), for large global batches
+class LARS : public Optimizer {
+public:
+    float lr;
+    float mu;
+    float weight_decay;
+    float eta;
+    float epsilon;
+
+    vtensor mT;
+
+    explicit LARS(float lr=0.01f, float momentum=0.9f, float weight_decay=0.0005f, float eta=0.001f, float epsilon=1e-9f);
+    virtual ~LARS();
+
+    Optimizer *clone() override;
+    Optimizer *share() override;
+
+    void setlayers(vlayer l) override;
+
+    void applygrads(int batch) override;
+
+    void change(vector<float> p) override;
+
+    void get_state(vector<string> &names, vtensor &tensors) override;
+};
+
+// ---- LAMB ----
+// Layer-wise Adaptive Moments (Adam with a per-layer trust ratio), for large global batches
+class LAMB : public Optimizer {
+public:
+    float lr;
+    float beta_1;
+    float beta_2;
+    float epsilon;
+    float weight_decay;
+    long t;
+
+    vtensor mT;
+    vtensor vT;
+    vtensor uT;
+
+    explicit LAMB(float lr=0.001f, float beta_1=0.9f, float beta_2=0.999f, float epsilon=1e-6f, float weight_decay=0.01f);
+    virtual ~LAMB();
+
+    Optimizer *clone() override;
+    Optimizer *share() override;
+
+    void setlayers(vlayer l) override;
+
+    void applygrads(int batch) override;
+
+    void change(vector<float> p) override;
+
+    void get_state(vector<string> &names, vtensor &tensors) override;
+    long get_step() override;
+    void set_step(long step) override;
 };
 #endif
 
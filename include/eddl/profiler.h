@@ -0,0 +1,100 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_PROFILER_H
+#define EDDL_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Hierarchical profiler: Net -> Layer -> kernel.
+// Every zone is registered once and identified by an integer id afterwards. Each thread records
+// its zones in its own ring buffer (the oldest events are overwritten) and accumulates them in its
+// own array of counters indexed by the id, so recording takes no lock and never contends with other
+// threads. When disabled, a zone costs a relaxed atomic load.
+
+#define PROFILER_BUFFER_SIZE 65536  // Events per thread
+#define PROFILER_MAX_DEPTH 64
+#define PROFILER_MAX_ZONES 4096     // Distinct (name, category) pairs
+
+#define PROFILER_NET 0
+#define PROFILER_FORWARD 1
+#define PROFILER_BACKWARD 2
+#define PROFILER_KERNEL 3
+#define PROFILER_NUM_CATEGORIES 4
+
+struct ProfilerEvent {
+    int zone;
+    uint8_t depth;
+    uint64_t begin;  // ns
+    uint64_t end;    // ns
+    uint64_t self;   // ns, excluding the nested zones
+};
+
+extern std::atomic<bool> profiler_enabled;
+
+inline bool profiler_is_enabled(){ return profiler_enabled.load(std::memory_order_relaxed); }
+
+void profiler_enable(bool enable=true);
+// Clears the recorded zones. Meant to be called while the profiled threads are idle
+void profiler_reset();
+
+// Returns the id of the zone (the same for the same name and category), or -1 if there are already
+// PROFILER_MAX_ZONES zones, in which case it is not recorded. Thread-safe; call it once per zone
+int profiler_register(const char *name, int category);
+
+// Low-level interface (prefer PROFILER_ZONE). The zone id matches begin/end pairs that are not scoped
+void profiler_begin(int zone);
+void profiler_end(int zone);
+
+/**
+  *  @brief Prints the accumulated time per layer (forward/backward) and per kernel.
+*/
+void profiler_show_summary();
+
+/**
+  *  @brief Stores the recorded zones as a Chrome trace (open it with chrome://tracing or Perfetto).
+  *
+  *  @param filename  Output JSON file
+  *  @return false if the file could not be written
+*/
+bool profiler_export_chrome_trace(const string &filename);
+
+
+class ProfilerZone {
+private:
+    int zone;
+
+public:
+    explicit ProfilerZone(int zone) {
+        this->zone = (zone >= 0 && profiler_is_enabled()) ? zone : -1;
+        if (this->zone >= 0) profiler_begin(this->zone);
+    }
+
+    ~ProfilerZone() {
+        if (zone >= 0) profiler_end(zone);
+    }
+
+    ProfilerZone(const ProfilerZone &) = delete;
+    ProfilerZone &operator=(const ProfilerZone &) = delete;
+};
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+// For zones with a constant name: it is registered the first time the line is reached
+#define PROFILER_ZONE(name, category) \
+    static const int PROFILER_CONCAT(_profiler_id_, __LINE__) = profiler_register(name, category); \
+    ProfilerZone PROFILER_CONCAT(_profiler_zone_, __LINE__)(PROFILER_CONCAT(_profiler_id_, __LINE__))
+// For zones registered by the caller (e.g. one per layer)
+#define PROFILER_ZONE_ID(zone) ProfilerZone PROFILER_CONCAT(_profiler_zone_, __LINE__)(zone)
+
+#endif //EDDL_PROFILER_H
@@ -0,0 +1,118 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_CHECKPOINT_H
+#define EDDL_CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <cstdint>
+
+#include "eddl/tensor/tensor.h"
+
+// Checkpoint file layout (little-endian):
+//   [header]  magic "EDDLCKPT", version, number of entries, step, data offset, file size
+//   [index]   per entry: name length, name, ndim, shape, data offset, data size (bytes)
+//   [data]    raw float32 row-major tensors, each one aligned to CKPT_ALIGNMENT bytes
+#define CKPT_MAGIC "EDDLCKPT"
+#define CKPT_VERSION 1
+#define CKPT_ALIGNMENT 64
+#define CKPT_NUM_BUFFERS 2
+
+struct CheckpointEntry {
+    std::string name;
+    std::vector<int> shape;
+    uint64_t offset;  // From the beginning of the file
+    uint64_t nbytes;
+};
+
+
+/**
+  *  @brief Writes checkpoints using a double buffer. The tensors are copied (snapshot) into a free
+  *  buffer when save() is called and the file is written by a background thread, so training can
+  *  continue while the previous checkpoint is still being written.
+*/
+class CheckpointWriter {
+private:
+    struct Buffer {
+        std::vector<char> data;  // Full file image (header + index + data). Capacity is reused
+        std::string filename;
+        bool busy = false;
+    };
+
+    Buffer buffers[CKPT_NUM_BUFFERS];
+    std::deque<int> pending;
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stop;
+    std::string last_error;
+
+    void run();
+    void snapshot(Buffer &buffer, const std::vector<std::string> &names, const std::vector<Tensor *> &tensors, int64_t step);
+
+public:
+    CheckpointWriter();
+    ~CheckpointWriter();
+
+    /**
+      *  @brief Takes a snapshot of the tensors and writes it to "filename".
+      *
+      *  @param filename  Output file. It is written to "filename.tmp" and renamed when complete
+      *  @param names  Unique name of each tensor
+      *  @param tensors  Tensors to save (any device)
+      *  @param step  Training step stored in the header
+      *  @param async  If true, returns as soon as the snapshot is taken
+    */
+    void save(const std::string &filename, const std::vector<std::string> &names, const std::vector<Tensor *> &tensors, int64_t step=0, bool async=true);
+
+    /**
+      *  @brief Blocks until every pending checkpoint has been written to disk.
+    */
+    void wait();
+};
+
+
+/**
+  *  @brief Read-only view of a checkpoint file. The file is memory-mapped (when supported) so
+  *  tensors are copied straight from the page cache without intermediate buffers.
+*/
+class CheckpointReader {
+private:
+    char *base;
+    size_t length;
+    bool mapped;
+    std::vector<char> fallback;  // Used when mmap is not available
+
+public:
+    std::vector<CheckpointEntry> entries;
+    int64_t step;
+
+    explicit CheckpointReader(const std::string &filename);
+    ~CheckpointReader();
+
+    int find(const std::string &name);
+    const float *data(int i);
+
+    /**
+      *  @brief Copies the entry "name" into "t" (any device).
+      *
+      *  @param name  Name of the entry
+      *  @param t  Destination tensor
+      *  @param position  Entry to use if "name" is not found (e.g. same net with different layer names). Ignored if -1
+      *  @return false if the entry does not exist. Throws if the sizes do not match
+    */
+    bool copy_to(const std::string &name, Tensor *t, int position=-1);
+};
+
+#endif //EDDL_CHECKPOINT_H
@@ -0,0 +1,100 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_BATCHER_H
+#define EDDL_BATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eddl/net/net.h"
+
+using namespace std;
+
+#define BATCHER_MAX_BATCH 32
+#define BATCHER_MAX_DELAY_US 2000
+
+
+/**
+  *  @brief Dynamic batching scheduler. Single-sample requests submitted from any thread are
+  *  coalesced into one batch (until "max_batch" requests are queued or the oldest one has waited
+  *  "max_delay_us"), a single forward pass is run and the outputs are scattered back through futures.
+  *  Each worker runs on its own inference context (see Net::create_context), so the weights are shared.
+*/
+class InferenceBatcher {
+private:
+    struct Request {
+        vector<vector<float>> inputs;  // One sample per input layer
+        std::promise<vtensor> result;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    Net *net;
+    vector<Net *> contexts;  // One per worker
+    vector<std::thread> workers;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    deque<Request *> queue;
+    bool stop;
+
+    vector<int> sample_sizes;  // Number of floats of one sample, per input layer
+
+    void run(int w);
+    void process(Net *ctx, vtensor &batch, vtensor &outputs, vector<Request *> &requests);
+
+public:
+    int max_batch;
+    int max_delay_us;
+    bool pad;
+    std::atomic<uint64_t> num_requests;
+    std::atomic<uint64_t> num_batches;
+
+    /**
+      *  @brief Starts the workers.
+      *
+      *  @param net  Built model. It must not be trained or deleted while the batcher is running
+      *  @param max_batch  Maximum number of requests per forward pass
+      *  @param max_delay_us  Maximum time (microseconds) that a request waits for others to fill the batch
+      *  @param num_workers  Number of forward passes that can run concurrently
+      *  @param pad  If true, batches are padded to the next power of two (up to "max_batch"), so the net is only resized to a few sizes
+    */
+    InferenceBatcher(Net *net, int max_batch=BATCHER_MAX_BATCH, int max_delay_us=BATCHER_MAX_DELAY_US, int num_workers=1, bool pad=true);
+    ~InferenceBatcher();
+
+    /**
+      *  @brief Queues one sample.
+      *
+      *  @param input  One tensor per input layer with the data of a single sample (e.g. shape (1, C, H, W)). They are copied
+      *  @return   Future with one tensor per output layer, shape (1, ...)
+    */
+    std::future<vtensor> submit(const vtensor &input);
+
+    /**
+      *  @brief Same as submit(input).get()
+    */
+    vtensor predict(const vtensor &input);
+
+    /**
+      *  @brief Number of floats of one sample of the given input layer
+    */
+    int sample_size(int i) { return sample_sizes[i]; }
+    int num_inputs() { return (int)sample_sizes.size(); }
+
+    float average_batch_size();
+};
+
+#endif //EDDL_BATCHER_H
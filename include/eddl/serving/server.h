@@ -0,0 +1,100 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#ifndef EDDL_SERVER_H
+#define EDDL_SERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eddl/serving/batcher.h"
+
+using namespace std;
+
+// Local (Unix domain socket) front-end of the InferenceBatcher. Native byte order, one request
+// at a time per connection:
+//   request:  [uint32 number of inputs] then per input [uint32 number of floats][floats]
+//   response: [uint32 status] then
+//               status == 0: [uint32 number of outputs] then per output [uint32 ndim][int32 shape][floats]
+//               otherwise:   [uint32 length][error message]
+#define SERVER_OK 0
+#define SERVER_ERROR 1
+#define SERVER_MAX_CONNECTIONS 64
+
+
+/**
+  *  @brief Serves the requests received through a Unix domain socket (one thread per connection).
+  *  Concurrent connections are batched together by the InferenceBatcher. Inputs of a wrong size are
+  *  drained through a fixed-size buffer and answered with an error. Over max_connections open
+  *  connections, new ones wait in the listen backlog until one of them closes.
+*/
+class InferenceServer {
+private:
+    InferenceBatcher *batcher;
+    string path;
+    int socket_fd;
+    std::atomic<bool> running;
+    std::thread acceptor_thread;
+
+    int max_connections;
+
+    // The acceptor joins the finished connection threads, stop() shuts down the open fds and joins the rest
+    std::mutex mtx;
+    std::condition_variable connection_done;  // A connection closed, or stop()
+    vector<int> connection_fds;  // Open connections. Closed (and removed) under mtx by their thread
+    vector<std::thread> connection_threads;
+    vector<std::thread::id> finished_threads;  // Their connection is closed, not joined yet
+
+    void acceptor();
+    void serve(int fd);
+    void join_finished();
+
+public:
+    /**
+      *  @brief Starts listening on "path" (an existing socket file is replaced).
+      *
+      *  @param batcher  Scheduler that runs the requests. It must outlive the server
+      *  @param path  Filesystem path of the socket
+      *  @param max_connections  Maximum number of open connections (and connection threads)
+    */
+    InferenceServer(InferenceBatcher *batcher, const string &path, int max_connections=SERVER_MAX_CONNECTIONS);
+    ~InferenceServer();
+
+    /**
+      *  @brief Closes the socket and every connection, and waits for the connection threads.
+    */
+    void stop();
+};
+
+
+/**
+  *  @brief Blocking client of the InferenceServer. Use one client per thread.
+*/
+class InferenceClient {
+private:
+    int socket_fd;
+
+public:
+    explicit InferenceClient(const string &path);
+    ~InferenceClient();
+
+    /**
+      *  @brief Sends one sample and waits for the result.
+      *
+      *  @param input  One tensor per input layer with the data of a single sample
+      *  @return   One tensor per output layer, shape (1, ...). Throws if the server reports an error
+    */
+    vtensor predict(const vtensor &input);
+};
+
+#endif //EDDL_SERVER_H
@@ -21,6 +21,9 @@ namespace tensorNN{
     float categorical_cross_entropy(Tensor* y_true, Tensor* y_pred);
     void d_categorical_cross_entropy(Tensor* y_true, Tensor* y_pred, Tensor* delta);
 
+    // Cross-entropy of y_pred=softmax(logits) (last axis). Also writes (y_pred - y_true)/batch, the delta w.r.t. the logits, if delta is not null
+    float softmax_cross_entropy(Tensor* y_true, Tensor* logits, Tensor* y_pred, Tensor* delta);
+
     float binary_cross_entropy(Tensor* y_true, Tensor* y_pred);
     void d_binary_cross_entropy(Tensor* y_true, Tensor* y_pred, Tensor* delta);
 
@@ -145,6 +148,8 @@ namespace tensorNN{
 // ***** Tensor operations *****************************
     void repeat_nn(Tensor *A, Tensor *B, vector<int> size);  // Deprecated (for UpSampling2d)
     void d_repeat_nn(Tensor *D, Tensor *P, vector<int> size);
+    void upsampling2D(Tensor *A, Tensor *B, vector<int> size, bool bilinear=false);
+    void d_upsampling2D(Tensor *D, Tensor *A, vector<int> size, bool bilinear=false);
 
     void select(Tensor *A, Tensor* B, SelDescriptor *sd);
     void select_back(Tensor *A, Tensor* B, SelDescriptor *sd);
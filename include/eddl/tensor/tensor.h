@@ -89,6 +89,7 @@ public:
     bool isshared=false;
     unsigned int ndim;
     unsigned long int size;
+    unsigned long int capacity = 0;  // Allocated elements (>= size). Zero if the data is not owned
     vector<int> shape;
     vector<int> stride;
 
@@ -2909,6 +2910,30 @@ public:
     */
     static void argsort(Tensor* A, Tensor* B, bool descending=false, bool stable=true);
 
+    /**
+      *  @brief Largest (or smallest) k elements along an axis, and their positions along it.
+      *
+      *  @param A   Input tensor.
+      *  @param values   Output tensor (shape of A with k elements along "axis"), or nullptr.
+      *  @param indices   Output tensor with the positions (same shape as values), or nullptr.
+      *  @param k   Number of elements.
+      *  @param axis   Axis (-1 for the last one).
+      *  @param largest   Whether to select the largest elements or the smallest ones.
+      *  @param sorted   Whether to sort the selected elements or not. Ties are resolved by position.
+    */
+    static void topk(Tensor* A, Tensor* values, Tensor* indices, int k, int axis=-1, bool largest=true, bool sorted=true);
+
+    /**
+      *  @brief Sort each slice along an axis independently (stable).
+      *
+      *  @param A   Input tensor.
+      *  @param values   Output tensor with the sorted elements, or nullptr.
+      *  @param indices   Output tensor with the positions of the sorted elements along "axis", or nullptr.
+      *  @param axis   Axis (-1 for the last one).
+      *  @param descending   Wether to sort the tensor descending or not.
+    */
+    static void sort(Tensor* A, Tensor* values, Tensor* indices, int axis, bool descending=false);
+
     // Indexing, Slicing, Joining, Mutating Ops *************
     /**
       *  @brief Join a sequence of arrays along an existing axis.
@@ -3058,7 +3083,8 @@ public:
     void reallocate(Tensor* old_t, const vector<int> &shape);
 
     /**
-      *  @brief Resizes a tensor ({2, 2, 2} => {10, 2, 2}).
+      *  @brief Resizes a tensor ({2, 2, 2} => {10, 2, 2}). The allocation is kept (high-water mark) if the
+      *  new size fits in it, so shrinking and growing back do not allocate. The content is not preserved.
       *
       *  @return
     */
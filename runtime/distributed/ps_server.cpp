@@ -0,0 +1,74 @@
+#include <cstring>
+#include <csignal>
+#include <iostream>
+
+#include <eddl/distributed/eddl_parameter_server.h>
+
+/*
+    parameter server of the asynchronous training mode, one per shard,
+    see ps_worker.cpp. Example on loopback with two shards and three workers:
+
+        ./ps_server --my-ip-addr 127.0.0.1 --bind-my-ip-addr --workers 3 &
+        ./ps_server --my-ip-addr 127.0.0.2 --bind-my-ip-addr --workers 3 &
+        for i in 11 12 13; do
+            ./ps_worker --my-ip-addr 127.0.0.$i --bind-my-ip-addr --server 127.0.0.1 --server 127.0.0.2 --workers 3 &
+        done
+*/
+
+eddl::ParameterServer * global_parameter_server = nullptr;
+
+void handler_funtion(int parameter)
+{
+    if (nullptr != global_parameter_server)
+        global_parameter_server->shutdown();
+    eddl::print_log_msg("signal caught " + std::to_string(parameter));
+}
+
+int main(int argc, char *argv[])
+{
+    eddl::DistributedEnvironment distributed_environment;
+    int max_staleness = 4;
+    int num_workers = 0;
+    float update_scale = 1.0f;
+    int worker_timeout = 60;
+
+    for (int i = 0; i < argc; i++) {
+        if (! strcmp(argv[i], "--my-ip-addr")) {
+            distributed_environment.set_my_ip_addr(argv[++i]);
+        } else if (! strcmp(argv[i], "--bind-my-ip-addr")) {
+            // listen on --my-ip-addr only, to run several nodes in the same host
+            distributed_environment.set_bind_my_ip_addr(true);
+        } else if (! strcmp(argv[i], "--tcp-port")) {
+            distributed_environment.set_tcp_port(atoi(argv[++i]));
+        } else if (! strcmp(argv[i], "--staleness")) {
+            max_staleness = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "--workers")) {
+            // the server ends when this number of workers have finished
+            num_workers = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "--update-scale")) {
+            update_scale = atof(argv[++i]);
+        } else if (! strcmp(argv[i], "--worker-timeout")) {
+            // seconds, silent workers are considered dead, 0 waits forever
+            worker_timeout = atoi(argv[++i]);
+        } else if (! strncmp(argv[i], "--verbose=", 10)) {
+            std::vector<std::string> parts = eddl::str_split(argv[i],'=');
+            distributed_environment.set_verbose_level(std::stoi(parts[1]));
+        } else if (! strcmp(argv[i], "--verbose")) {
+            distributed_environment.increase_verbose_level();
+        }
+    }
+
+    eddl::ParameterServer parameter_server(distributed_environment, max_staleness, update_scale, worker_timeout);
+
+    global_parameter_server = & parameter_server;
+    signal(SIGINT,  handler_funtion);
+    signal(SIGTERM, handler_funtion);
+
+    parameter_server.run(num_workers);
+
+    global_parameter_server = nullptr;
+
+    eddl::print_log_msg("parameter server main thread ready to finish when threads stop");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+
+#include <eddl/apis/eddl.h>
+#include <eddl/distributed/eddl_parameter_server.h>
+
+/*
+    worker of the asynchronous training mode: trains a MLP for mnist on its own
+    replica and exchanges the accumulated gradients and the weights with the
+    parameter servers, see ps_server.cpp.
+*/
+
+int main(int argc, char *argv[])
+{
+    eddl::DistributedEnvironment    distributed_environment;
+    std::vector<std::string>        servers;
+    uint32_t    codec = eddl::eddl_ps_codecs::PS_INT8;
+    int         push_every = 1;
+    int         num_workers = 1;
+    int         threads = -1;
+    int         epochs = 1;
+    int         batch_size = 100;
+    bool        testing = false;
+
+    for (int i = 0; i < argc; i++) {
+        if (! strcmp(argv[i], "--my-ip-addr")) {
+            distributed_environment.set_my_ip_addr(argv[++i]);
+        } else if (! strcmp(argv[i], "--bind-my-ip-addr")) {
+            // listen on --my-ip-addr only, to run several nodes in the same host
+            distributed_environment.set_bind_my_ip_addr(true);
+        } else if (! strcmp(argv[i], "--server")) {
+            // once per parameter server, every one keeps a shard of the weights
+            servers.push_back(argv[++i]);
+        } else if (! strcmp(argv[i], "--tcp-port")) {
+            distributed_environment.set_tcp_port(atoi(argv[++i]));
+        } else if (! strncmp(argv[i], "--codec=", 8)) {
+            std::vector<std::string> parts = eddl::str_split(argv[i],'=');
+            if (parts[1] == "int8")
+                codec = eddl::eddl_ps_codecs::PS_INT8;
+            else if (parts[1] == "float32")
+                codec = eddl::eddl_ps_codecs::PS_FLOAT32;
+            else
+                throw std::runtime_error(eddl::err_msg("unrecognized codec"));
+        } else if (! strcmp(argv[i], "--push-every")) {
+            push_every = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "--workers")) {
+            // an epoch is shared among this number of workers
+            num_workers = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "--threads")) {
+            threads = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "--epochs")) {
+            epochs = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "--batch-size")) {
+            batch_size = atoi(argv[++i]);
+        } else if (! strcmp(argv[i], "--testing")) {
+            testing = true;
+        } else if (! strncmp(argv[i], "--verbose=", 10)) {
+            std::vector<std::string> parts = eddl::str_split(argv[i],'=');
+            distributed_environment.set_verbose_level(std::stoi(parts[1]));
+        } else if (! strcmp(argv[i], "--verbose")) {
+            distributed_environment.increase_verbose_level();
+        }
+    }
+
+    eddl::download_mnist();
+
+    eddl::layer in = eddl::Input({784});
+    eddl::layer l = in;
+    l = eddl::ReLu(eddl::Dense(l, 1024));
+    l = eddl::ReLu(eddl::Dense(l, 1024));
+    eddl::layer out = eddl::Softmax(eddl::Dense(l, 10));
+    eddl::model net = eddl::Model({in}, {out});
+    net->verbosity_level = 0;
+
+    eddl::build(net,
+                eddl::adam(0.001),
+                {"softmax_cross_entropy"},
+                {"categorical_accuracy"},
+                eddl::CS_CPU(threads));
+
+    Tensor * x_train = Tensor::load("mnist_trX.bin");
+    Tensor * y_train = Tensor::load("mnist_trY.bin");
+    Tensor * x_test = Tensor::load("mnist_tsX.bin");
+    Tensor * y_test = Tensor::load("mnist_tsY.bin");
+    x_train->div_(255.0f);
+    x_test->div_(255.0f);
+
+    int n = x_train->shape[0];
+    int num_batches = n / (batch_size * std::max(1, num_workers));
+    if (testing) num_batches = std::min(num_batches, 10);
+
+    eddl::ParameterServerWorker worker(net, distributed_environment, servers, push_every, codec);
+    worker.start();
+
+    std::vector<int> sind(batch_size);
+    for (int e = 0; e < epochs; e++) {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+        net->reset_loss();
+        for (int j = 0; j < num_batches; j++) {
+            for (int k = 0; k < batch_size; k++) sind[k] = rand() % n;
+            worker.train_batch({x_train}, {y_train}, sind);
+            net->print_loss(j + 1, num_batches, false);
+        }
+
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout << std::endl << "epoch " << e + 1 << " done in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() / 1.0e3
+                  << " seconds, " << worker.get_clock() << " pushes" << std::endl;
+    }
+    worker.stop();
+
+    eddl::evaluate(net, {x_test}, {y_test});
+
+    delete x_train;
+    delete y_train;
+    delete x_test;
+    delete y_test;
+    delete net;
+
+    eddl::print_log_msg("worker main thread ready to finish when threads stop");
+
+    return EXIT_SUCCESS;
+}
@@ -18,6 +18,7 @@
 
 #include "eddl/apis/eddl.h"
 #include "eddl/utils.h"
+#include "eddl/profiler.h"
 #include "eddl/serialization/onnx/eddl_onnx.h" // Not allowed
 //#include "eddl/hardware/fpga/fpga_hw.h"
 #include "eddl/hardware/cpu/cpu_tensor.h"
@@ -157,12 +158,17 @@ namespace eddl {
         net->toCPU(th);
     }
 
-    compserv CS_CPU(int th, const string& mem){
-        if (mem=="low_mem") return new CompServ(th, {}, {}, 0, 2);
-        else if (mem=="mid_mem") return new CompServ(th, {}, {}, 0, 1);
-        else if (mem=="full_mem") return new CompServ(th, {}, {}, 0, 0);
-        else msg("Error mem param","CS_CPU"); // Exits
-        return nullptr; // To silent warnings
+    compserv CS_CPU(int th, const string& mem, const string& affinity, bool numa){
+        int mem_level = 0;
+        if (mem=="low_mem") mem_level = 2;
+        else if (mem=="mid_mem") mem_level = 1;
+        else if (mem!="full_mem") msg("Error mem param","CS_CPU"); // Exits
+        if (affinity!="none" && affinity!="close" && affinity!="spread") msg("Error affinity param","CS_CPU");
+
+        auto *cs = new CompServ(th, {}, {}, 0, mem_level);
+        cs->affinity = affinity;
+        cs->numa = numa;
+        return cs;
     }
 
     compserv CS_GPU(){
@@ -229,6 +235,14 @@ namespace eddl {
         m->save(fname, format);
     }
 
+    void save_checkpoint(model m, const string& fname, bool async){
+        m->save_checkpoint(fname, async);
+    }
+
+    void load_checkpoint(model m, const string& fname){
+        m->load_checkpoint(fname);
+    }
+
     // Optimizer
     void setlr(model net,vector<float>p){
         net->setlr(p);
@@ -262,12 +276,24 @@ namespace eddl {
         return new SGD(lr, momentum, weight_decay, nesterov);
     }
 
+    optimizer lars(float lr, float momentum, float weight_decay, float eta, float epsilon){
+        return new LARS(lr, momentum, weight_decay, eta, epsilon);
+    }
+
+    optimizer lamb(float lr, float beta_1, float beta_2, float epsilon, float weight_decay){
+        return new LAMB(lr, beta_1, beta_2, epsilon, weight_decay);
+    }
+
     // Training and Evaluation
     // Coarse methods
     void fit(model net, const vector<Tensor *> &in, const vector<Tensor *> &out, int batch, int epochs){
         net->fit(in, out, batch, epochs);
     }
 
+    void fit(model net, DataLoader *loader, int epochs){
+        net->fit(loader, epochs);
+    }
+
     void evaluate(model net, const vector<Tensor *> &in, const vector<Tensor *> &out,int bs){
         net->evaluate(in, out, bs);
     }
@@ -281,6 +307,10 @@ namespace eddl {
         return m->predict(in);
     }
 
+    model create_context(model m){
+        return m->create_context();
+    }
+
     // Finer methods
     vector<int> random_indices(int batch_size, int num_samples){
         vector<int> sind;
@@ -305,6 +335,16 @@ namespace eddl {
         __reset_profile();
     }
 
+    void enable_profile(bool enable) {
+        profiler_enable(enable);
+    }
+
+    void save_profile(const string& fname) {
+        if (!profiler_export_chrome_trace(fname)) {
+            msg("Unable to write the profile to '" + fname + "'", "save_profile");
+        }
+    }
+
     void next_batch(vector<Tensor *> in,vector<Tensor *> out){
         int i,n;
         int batch_size;
@@ -634,7 +674,7 @@ namespace eddl {
         // To achieve so, we can have one filter per channel (3xdepth) and then use groups to force each filter to have depth=1
         int filters = parent->output->shape[1];  // one filter per channel (...with depth D)
         int groups = filters;  // one filter per channel (...with depth 1)
-        return new LConv(parent, filters, kernel_size, strides, "none", {}, filters, dilation_rate, use_bias, name, DEV_CPU, 0);
+        return new LConv(parent, filters, kernel_size, strides, padding, {}, groups, dilation_rate, use_bias, name, DEV_CPU, 0);
     }
 
     layer PointwiseConv2D(layer parent, int filters,
@@ -687,9 +727,10 @@ namespace eddl {
     }
 
     layer UpSampling2D(layer parent, const vector<int> &size, string interpolation, string name){
-        // interpolation param is deprecated, we only accept "nearest"
-        if (interpolation != "nearest")
-            std::cerr << "Warning: In UpSampling2D the interpolation type \"" << interpolation << "\" is not valid. Only \"nearest\" is available.\n";
+        if (interpolation != "nearest" && interpolation != "bilinear" && interpolation != "linear") {
+            std::cerr << "Warning: In UpSampling2D the interpolation type \"" << interpolation << "\" is not valid. Using \"nearest\".\n";
+            interpolation = "nearest";
+        }
 
         const vector<int> parent_shape = parent->output->getShape();
         // Parent output must be of shape (batch, channels, height, width)
@@ -700,16 +741,12 @@ namespace eddl {
         if (size.size() != 2)
             msg("The number of dimensions of the \"size\" parameter must be 2", "EDDL::UpSampling2D");
 
-        // Get the target output shape by applying the scale factor to the input
-        vector<int> target_shape;
-        for (const int i : {2, 3}) { // Loop through 2:height and 3:width dimensions (0:batch, 1:channels)
-            const int dim_scale = size[i-2];
+        for (const int dim_scale : size) {
             if (dim_scale < 1)
                 msg("The scale factors in \"size\" parameter must be greater or equal to 1", "EDDL::UpSampling2D");
-            target_shape.push_back(parent_shape[i] * dim_scale);
         }
 
-        return new LResize(parent, target_shape, true, getWrappingMode("nearest"), 0.0f, getTransformationMode("asymmetric"), name, DEV_CPU, 0);
+        return new LUpSampling(parent, size, interpolation, name, DEV_CPU, 0);
     }
 
     layer UpSampling3D(layer parent, vector<int> new_shape, bool reshape, string da_mode, float constant, string coordinate_transformation_mode, string name){
@@ -2045,14 +2082,24 @@ namespace eddl {
             throw std::runtime_error("'k' must be a number greater than zero and smaller than the number of classes");
         }
 
-        // Sort indices by probability
-        Tensor* top_k_probs_idx = class_probs->argsort(true);
+        // Select the k most probable classes (partial selection, no full sort)
+        Tensor* probs = class_probs->clone();
+        probs->toCPU();
+        probs->reshape_({(int)probs->size});
+        Tensor* top_k_probs = new Tensor({k}, DEV_CPU);
+        Tensor* top_k_probs_idx = new Tensor({k}, DEV_CPU);
+        Tensor::topk(probs, top_k_probs, top_k_probs_idx, k);
+
         std::stringstream stream;
         for(int i=0; i<k; i++){
             int idx = (int)top_k_probs_idx->ptr[i];
-            float prob = class_probs->ptr[idx] * 100.0f;
+            float prob = top_k_probs->ptr[i] * 100.0f;
             stream << i+1 << ". " << class_names[idx] << " (" << std::fixed << std::setprecision(decimals) << prob << "%)" << std::endl;
         }
+        delete top_k_probs_idx;
+        delete top_k_probs;
+        delete probs;
+
         std::string result = stream.str();
         return result;
     }
@@ -0,0 +1,344 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "eddl/data/dataloader.h"
+#include "eddl/utils.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+// TensorDataSource ******************************************
+
+TensorDataSource::TensorDataSource(const vtensor &x, const vtensor &y) {
+    if (x.empty()) msg("At least one input tensor is required", "TensorDataSource");
+    for (auto t : x) {
+        if (!t->isCPU()) msg("The tensors must be on CPU", "TensorDataSource");
+        if (t->shape[0] != x[0]->shape[0]) msg("different number of samples in input tensor", "TensorDataSource");
+    }
+    for (auto t : y) {
+        if (!t->isCPU()) msg("The tensors must be on CPU", "TensorDataSource");
+        if (t->shape[0] != x[0]->shape[0]) msg("different number of samples in output tensor", "TensorDataSource");
+    }
+    this->x = x;
+    this->y = y;
+}
+
+int TensorDataSource::num_samples() {
+    return x[0]->shape[0];
+}
+
+static vector<vector<int>> sample_shapes(const vtensor &v) {
+    vector<vector<int>> shapes;
+    for (auto t : v) shapes.push_back(vector<int>(t->shape.begin() + 1, t->shape.end()));
+    return shapes;
+}
+
+vector<vector<int>> TensorDataSource::input_shapes() {
+    return sample_shapes(x);
+}
+
+vector<vector<int>> TensorDataSource::output_shapes() {
+    return sample_shapes(y);
+}
+
+void TensorDataSource::load(int index, const vector<float *> &xs, const vector<float *> &ys) {
+    for (int i = 0; i < x.size(); i++) {
+        long int row = x[i]->size / x[i]->shape[0];
+        memcpy(xs[i], x[i]->ptr + index * row, row * sizeof(float));
+    }
+    for (int i = 0; i < y.size(); i++) {
+        long int row = y[i]->size / y[i]->shape[0];
+        memcpy(ys[i], y[i]->ptr + index * row, row * sizeof(float));
+    }
+}
+
+
+// BinaryFileDataSource ******************************************
+
+BinaryFileDataSource::BinaryFileDataSource(const vector<string> &x_files, const vector<string> &y_files) {
+    if (x_files.empty()) msg("At least one input file is required", "BinaryFileDataSource");
+    n = -1;
+    for (auto &f : x_files) inputs.push_back(open(f));
+    for (auto &f : y_files) outputs.push_back(open(f));
+}
+
+BinaryFileDataSource::~BinaryFileDataSource() {
+    for (auto v : {&inputs, &outputs}) {
+        for (auto &f : *v) {
+#if !defined(_WIN32)
+            close(f.fd);
+#else
+            delete f.ifs;
+#endif
+        }
+    }
+}
+
+BinaryFileDataSource::File BinaryFileDataSource::open(const string &path) {
+    // Header written by Tensor::save2bin: ndim, shape, data (row-major)
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    if (!ifs.good()) msg("Could not open " + path, "BinaryFileDataSource");
+    int ndim = 0;
+    ifs.read(reinterpret_cast<char *>(&ndim), sizeof(int));
+    if (!ifs.good() || ndim < 1) msg("Wrong header in " + path, "BinaryFileDataSource");
+    vector<int> shape(ndim);
+    ifs.read(reinterpret_cast<char *>(shape.data()), ndim * sizeof(int));
+    if (!ifs.good()) msg("Wrong header in " + path, "BinaryFileDataSource");
+    ifs.close();
+
+    if (n == -1) n = shape[0];
+    else if (shape[0] != n) msg("different number of samples in " + path, "BinaryFileDataSource");
+
+    File f;
+    f.path = path;
+    f.shape = vector<int>(shape.begin() + 1, shape.end());
+    f.row_size = 1;
+    for (int d : f.shape) f.row_size *= d;
+    f.offset = (long int)(ndim + 1) * sizeof(int);
+    f.fd = -1;
+    f.ifs = nullptr;
+#if !defined(_WIN32)
+    f.fd = ::open(path.c_str(), O_RDONLY);
+    if (f.fd < 0) msg("Could not open " + path, "BinaryFileDataSource");
+#else
+    f.ifs = new std::ifstream(path, std::ios::in | std::ios::binary);
+#endif
+    return f;
+}
+
+void BinaryFileDataSource::read(File &f, int index, float *dst) {
+    size_t size = f.row_size * sizeof(float);
+    long int pos = f.offset + (long int)index * size;
+#if !defined(_WIN32)
+    // pread does not move the file offset, so the workers can read concurrently
+    char *p = (char *)dst;
+    while (size > 0) {
+        ssize_t r = pread(f.fd, p, size, pos);
+        if (r <= 0) msg("Could not read sample " + to_string(index) + " of " + f.path, "BinaryFileDataSource");
+        p += r;
+        pos += r;
+        size -= r;
+    }
+#else
+    std::lock_guard<std::mutex> lock(mtx);
+    f.ifs->seekg(pos);
+    f.ifs->read(reinterpret_cast<char *>(dst), size);
+    if (!f.ifs->good()) msg("Could not read sample " + to_string(index) + " of " + f.path, "BinaryFileDataSource");
+#endif
+}
+
+int BinaryFileDataSource::num_samples() {
+    return n;
+}
+
+vector<vector<int>> BinaryFileDataSource::input_shapes() {
+    vector<vector<int>> shapes;
+    for (auto &f : inputs) shapes.push_back(f.shape);
+    return shapes;
+}
+
+vector<vector<int>> BinaryFileDataSource::output_shapes() {
+    vector<vector<int>> shapes;
+    for (auto &f : outputs) shapes.push_back(f.shape);
+    return shapes;
+}
+
+void BinaryFileDataSource::load(int index, const vector<float *> &x, const vector<float *> &y) {
+    for (int i = 0; i < inputs.size(); i++) read(inputs[i], index, x[i]);
+    for (int i = 0; i < outputs.size(); i++) read(outputs[i], index, y[i]);
+}
+
+
+// DataLoader ******************************************
+
+DataLoader::DataLoader(DataSource *source, int batch_size, bool shuffle, int num_workers, int num_buffers,
+                       bool drop_last, unsigned int seed) : rng(seed) {
+    if (source == nullptr) msg("The source is null", "DataLoader");
+    if (batch_size <= 0) msg("batch_size must be > 0", "DataLoader");
+    if (num_workers <= 0) msg("num_workers must be > 0", "DataLoader");
+    if (num_buffers <= 0) msg("num_buffers must be > 0", "DataLoader");
+
+    this->source = source;
+    this->batch_size = batch_size;
+    this->shuffle = shuffle;
+    next_batch = next_out = 0;
+    current = -1;
+    epoch_batches = 0;
+    busy = 0;
+    stop = false;
+    int remainder = source->num_samples() % batch_size;
+    tail = drop_last ? 0 : remainder;
+    dropped = drop_last ? remainder : 0;
+
+    vector<vector<int>> xs = source->input_shapes();
+    vector<vector<int>> ys = source->output_shapes();
+    slots.resize(num_buffers);
+    for (auto &s : slots) {
+        for (int rows : {batch_size, tail}) {
+            if (rows == 0) continue;
+            vtensor &bx = rows == batch_size ? s.x : s.tail_x;
+            vtensor &by = rows == batch_size ? s.y : s.tail_y;
+            for (auto &shape : xs) {
+                vector<int> bshape = {rows};
+                bshape.insert(bshape.end(), shape.begin(), shape.end());
+                bx.push_back(new Tensor(bshape, DEV_CPU));
+            }
+            for (auto &shape : ys) {
+                vector<int> bshape = {rows};
+                bshape.insert(bshape.end(), shape.begin(), shape.end());
+                by.push_back(new Tensor(bshape, DEV_CPU));
+            }
+        }
+        s.batch = -1;
+        s.ready = false;
+    }
+    for (auto t : slots[0].x) x_sizes.push_back(t->size / batch_size);
+    for (auto t : slots[0].y) y_sizes.push_back(t->size / batch_size);
+
+    for (int w = 0; w < num_workers; w++) workers.emplace_back(&DataLoader::worker, this);
+}
+
+DataLoader::~DataLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+    cv_work.notify_all();
+    for (auto &w : workers) w.join();
+    for (auto &s : slots) {
+        for (auto t : s.x) delete t;
+        for (auto t : s.y) delete t;
+        for (auto t : s.tail_x) delete t;
+        for (auto t : s.tail_y) delete t;
+    }
+}
+
+void DataLoader::add_stage(const DataLoaderStage &stage) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (epoch_batches > 0) msg("Stages must be added before the first epoch", "DataLoader.add_stage");
+    stages.push_back(stage);
+}
+
+int DataLoader::num_batches() {
+    return source->num_samples() / batch_size + (tail > 0 ? 1 : 0);
+}
+
+void DataLoader::start_epoch() {
+    std::unique_lock<std::mutex> lock(mtx);
+    begin_epoch(lock);
+}
+
+void DataLoader::begin_epoch(std::unique_lock<std::mutex> &lock) {
+    // Drop what is left of the previous epoch
+    release_current();
+    epoch_batches = 0;
+    cv_ready.wait(lock, [this]{ return busy == 0; });
+    for (auto &s : slots) {
+        s.batch = -1;
+        s.ready = false;
+        s.error = nullptr;
+    }
+
+    int n = source->num_samples();
+    order.resize(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    if (shuffle) {
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+
+    next_batch = next_out = 0;
+    epoch_batches = num_batches();
+    cv_work.notify_all();
+}
+
+void DataLoader::release_current() {
+    if (current < 0) return;
+    slots[current].batch = -1;
+    slots[current].ready = false;
+    current = -1;
+    cv_work.notify_all();
+}
+
+bool DataLoader::next(vtensor &x, vtensor &y) {
+    std::unique_lock<std::mutex> lock(mtx);
+    release_current();
+    if (epoch_batches == 0) begin_epoch(lock);
+    if (next_out >= epoch_batches) {
+        epoch_batches = 0;  // The next call starts a new epoch
+        return false;
+    }
+
+    int b = next_out++;
+    Slot &s = slots[b % slots.size()];
+    cv_ready.wait(lock, [&]{ return s.batch == b && s.ready; });
+    current = b % (int)slots.size();
+    if (s.error) {
+        std::exception_ptr e = s.error;
+        s.error = nullptr;
+        std::rethrow_exception(e);
+    }
+
+    bool partial = tail > 0 && b == source->num_samples() / batch_size;
+    x = partial ? s.tail_x : s.x;
+    y = partial ? s.tail_y : s.y;
+    return true;
+}
+
+void DataLoader::worker() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        // Batches are delivered in order, so the slot of the next batch is the first one to be freed
+        cv_work.wait(lock, [this]{
+            return stop || (next_batch < epoch_batches && slots[next_batch % slots.size()].batch == -1);
+        });
+        if (stop) break;
+
+        int b = next_batch++;
+        Slot &s = slots[b % slots.size()];
+        s.batch = b;
+        s.ready = false;
+        busy++;
+        if (next_batch < epoch_batches) cv_work.notify_one();  // The next slot may be free too
+
+        lock.unlock();
+        try {
+            assemble(s, b);
+        } catch (...) {
+            s.error = std::current_exception();
+        }
+        lock.lock();
+
+        busy--;
+        s.ready = true;
+        cv_ready.notify_all();
+    }
+}
+
+void DataLoader::assemble(Slot &s, int b) {
+    bool partial = tail > 0 && b == source->num_samples() / batch_size;
+    vtensor &bx = partial ? s.tail_x : s.x;
+    vtensor &by = partial ? s.tail_y : s.y;
+    int rows = partial ? tail : batch_size;
+
+    vector<float *> xp(bx.size()), yp(by.size());
+    for (int k = 0; k < rows; k++) {
+        int index = order[b * batch_size + k];
+        for (int i = 0; i < bx.size(); i++) xp[i] = bx[i]->ptr + k * x_sizes[i];
+        for (int i = 0; i < by.size(); i++) yp[i] = by[i]->ptr + k * y_sizes[i];
+        source->load(index, xp, yp);
+    }
+    for (auto &stage : stages) stage(bx, by);
+}
@@ -23,9 +23,6 @@ ConvolDescriptor::ConvolDescriptor() {}
 
 ConvolDescriptor::ConvolDescriptor(int filters, const vector<int> &kernel_size, const vector<int> &strides, string padding, const vector<int> &pads,
                  int groups, const vector<int> &dilation_rate, bool use_bias, int mem){
-#ifndef cCUDNN
-    if (groups > 1) { msg("Grouped convolutions are only available with CuDNN", "ConvolDescriptor::ConvolDescriptor"); }
-#endif
     if (kernel_size.size() != 2) { msg("Kernels must have 3 dimensions", "ConvolDescriptor::ConvolDescriptor"); }
     if (strides.size() != 2) { msg("Strides must have 2 dimensions", "ConvolDescriptor::ConvolDescriptor"); }
     if (dilation_rate.size() != 2) { msg("Dilations must have 2 elements", "ConvolDescriptor::ConvolDescriptor"); }
@@ -166,11 +163,13 @@ void ConvolDescriptor::build(Tensor *A) {
 
     if (I->isCPU() || (I->isFPGA())) {
         if (mem_level < 2) {
-            // mem for ptr, lowering im2col
-            unsigned long int l_size =  (unsigned long)(A->shape[0] * r * c) * (unsigned long)(kr * kc * kz);
+            // mem for ptr, lowering im2col (one block per group; depthwise convolutions are not lowered)
+            int lgroups = kz == 1 ? 1 : groups;
+            unsigned long int l_size =  (unsigned long)(A->shape[0] * r * c) * (unsigned long)(kr * kc * kz * lgroups);
             ptrI=get_fmem(l_size,"ConvolDescriptor::build");
+            ptrI_size=l_size;
             matI=Eigen::Map<Eigen::MatrixXf>(ptrI, r*c,kz*kr*kc);
-               _profile_add_tensor(A->shape[0] * r * c * kr * kc * kz);
+               _profile_add_tensor(l_size);
         }
     }
 #ifdef cGPU
@@ -245,12 +244,17 @@ void ConvolDescriptor::resize(int b)
     O->resize(b);
 
     // Prevent overflow. (512*512*512*3*3*3 = 3,623,878,656 > MAX_INT (2,147,483,647))
-    unsigned long int l_size =  (unsigned long)(b * r * c) * (unsigned long)(kr * kc * kz);
+    int lgroups = kz == 1 ? 1 : groups;
+    unsigned long int l_size =  (unsigned long)(b * r * c) * (unsigned long)(kr * kc * kz * lgroups);
 
     if (I->isCPU()) {
-        eddl_free(ptrI); // because get_fmem() now uses posix_memalign()
-        ptrI=get_fmem(l_size, "ConvolDescriptor::build");
-	   _profile_add_tensor(l_size);
+        // Keep the largest im2col buffer: smaller batches reuse it
+        if (l_size > ptrI_size) {
+            eddl_free(ptrI); // because get_fmem() now uses posix_memalign()
+            ptrI=get_fmem(l_size, "ConvolDescriptor::build");
+            ptrI_size=l_size;
+            _profile_add_tensor(l_size);
+        }
     }
 #ifdef cGPU
     else if (I->isGPU()) {
@@ -267,7 +271,6 @@ void ConvolDescriptor::resize(int b)
    cudnnSetTensor4dDescriptor(xDesc, tensor_format, data_type,
                  b,iz,ir,ic);
 
-   cudnnCreateTensorDescriptor(&yDesc);
    cudnnSetTensor4dDescriptor(yDesc, tensor_format, data_type, O->shape[0], O->shape[1],O->shape[2],O->shape[3]);
    cudnn_env_init = -1;
    cudnn_conv_back_init = -1;
@@ -183,11 +183,9 @@ void ConvolDescriptor3D::build(Tensor *A) {
     gbias = new Tensor(vector<int>{nk}, I->device);
 
     if (I->isCPU()) {
-        // mem for ptr, lowering im2col
-        unsigned long int l_size =  (unsigned long)(A->shape[0] * d * r * c) * (unsigned long)(kz * kd* kr * kc);
-        ptrI=get_fmem(l_size,"ConvolDescriptor3D::build");
-        matI=Eigen::Map<Eigen::MatrixXf>(ptrI, d*r*c,kz*kd*kr*kc);
-	   _profile_add_tensor(A->shape[0] * d * r * c * kz * kd * kr * kc);
+        // Nothing to lower in advance: the CPU kernels keep a workspace bounded per thread in ptrI
+        ptrI=nullptr;
+        ptrI_size=0;
     }
 #ifdef cGPU
     else if (I->isGPU()) {
@@ -273,16 +271,9 @@ void ConvolDescriptor3D::resize(int b)
     O->resize(b);
 
 
-    // Prevent overflow. (512*512*512*512*3*3*3*3 = 3,623,878,656 > MAX_INT (2,147,483,647))
-    unsigned long int l_size =  (unsigned long)(b * d * r * c) * (unsigned long)(kz * kd * kr * kc);
-
-    if (I->isCPU()) {
-        eddl_free(ptrI);
-        ptrI=get_fmem(l_size, "ConvolDescriptor3D::build");
-	   _profile_add_tensor(l_size);
-    }
+    // The CPU workspace does not depend on the batch size
 #ifdef cGPU
-    else if (I->isGPU()) {
+    if (I->isGPU()) {
 #ifndef cCUDNN
         if (mem_level<2)
             gpuIB->resize(b*d*r*c);
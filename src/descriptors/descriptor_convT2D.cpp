@@ -79,10 +79,15 @@ void ConvolDescriptorT2D::build(Tensor *A) {
 
     I = A;
     
-    nk = A->shape[1]; //ksize[0];
+    // Kernels as in ONNX: (in_channels, filters/groups, kr, kc)
+    if (A->shape[1] % groups || filters % groups)
+        msg("The number of input channels and filters must be divisible by the number groups."
+            " Received: in_channels=" + to_string(A->shape[1]) + " filters=" + to_string(filters) + " groups=" + to_string(groups),
+            "ConvolDescriptorT2D::build");
+    nk = A->shape[1];
     kr = ksize[1];
     kc = ksize[2];
-    kz = A->shape[1]/groups;
+    kz = filters/groups;
 
     sr = stride[0];
     sc = stride[1];
@@ -94,7 +99,7 @@ void ConvolDescriptorT2D::build(Tensor *A) {
 
     if(this->padding=="custom"){  // Known padding
         // Compute output
-        z = nk;
+        z = filters;
         vector<int>pr; pr.push_back(pads[0]);pr.push_back(pads[1]);
         r = compute_output(pr, ir, kr, sr);
 
@@ -103,7 +108,7 @@ void ConvolDescriptorT2D::build(Tensor *A) {
 
     }else{  // Common padding (same/zeros)
         // Compute output
-        z = nk;
+        z = filters;
 
         if (padding=="same,none") r = compute_output("same", ir, kr, sr);
         else if (padding=="none,same")  r = compute_output("none", ir, kr, sr);
@@ -150,17 +155,15 @@ void ConvolDescriptorT2D::build(Tensor *A) {
 
     // Params
     K = new Tensor(vector<int>{nk, kz, kr, kc}, I->device);
-    bias = new Tensor(vector<int>{nk}, I->device);
+    bias = new Tensor(vector<int>{z}, I->device);
 
     gK = new Tensor(vector<int>{nk, kz, kr, kc}, I->device);
-    gbias = new Tensor(vector<int>{nk}, I->device);
+    gbias = new Tensor(vector<int>{z}, I->device);
 
     if (I->isCPU()) {
-        // mem for ptr, lowering im2col
-        unsigned long int l_size =  (unsigned long)(A->shape[0] * r * c) * (unsigned long)(kr * kc * kz);
-        ptrI=get_fmem(l_size,"ConvolDescriptorT::build");
-        matI=Eigen::Map<Eigen::MatrixXf>(ptrI, r*c,kz*kr*kc);
-	   _profile_add_tensor(A->shape[0] * r * c * kr * kc * kz);
+        // Nothing to lower in advance: the CPU kernels keep a workspace bounded per thread in ptrI
+        ptrI=nullptr;
+        ptrI_size=0;
     }
 #ifdef cGPU
     else if (I->isGPU()) {
@@ -219,7 +222,7 @@ void ConvolDescriptorT2D::build(Tensor *A) {
    cudnnSetTensor4dDescriptor(yDesc, tensor_format, data_type, in, z,r,c);
 
    cudnnCreateTensorDescriptor(&bDesc);
-   cudnnSetTensor4dDescriptor(bDesc, tensor_format, data_type, 1, nk,1,1);
+   cudnnSetTensor4dDescriptor(bDesc, tensor_format, data_type, 1, z,1,1);
    cudnn_env_init = -1;
    cudnn_conv_back_init = -1;
 
@@ -235,16 +238,9 @@ void ConvolDescriptorT2D::resize(int b)
     O->resize(b);
 
 
-    // Prevent overflow. (512*512*512*3*3*3 = 3,623,878,656 > MAX_INT (2,147,483,647))
-    unsigned long int l_size =  (unsigned long)(b * r * c) * (unsigned long)(kr * kc * kz);
-
-    if (I->isCPU()) {
-        eddl_free(ptrI); // because get_fmem() now uses posix_memalign()
-        ptrI=get_fmem(l_size, "ConvolDescriptorT2D::build");
-	   _profile_add_tensor(l_size);
-    }
+    // The CPU workspace does not depend on the batch size
 #ifdef cGPU
-    else if (I->isGPU()) {
+    if (I->isGPU()) {
 #ifndef cCUDNN
       if (mem_level<2)
             gpuIB->resize(b*r*c);
@@ -258,7 +254,6 @@ void ConvolDescriptorT2D::resize(int b)
    cudnnSetTensor4dDescriptor(xDesc, tensor_format, data_type,
                  b,iz,ir,ic);
 
-   cudnnCreateTensorDescriptor(&yDesc);
    cudnnSetTensor4dDescriptor(yDesc, tensor_format, data_type, O->shape[0], O->shape[1],O->shape[2],O->shape[3]);
 
    cudnn_env_init = -1;
@@ -274,7 +269,7 @@ void ConvolDescriptorT2D::enable_distributed() {
     // Create and initialize the tensors for accumulating gradients in distributed training
     acc_gK = new Tensor(vector<int>{nk, kz, kr, kc}, I->device);
     acc_gK->fill_(0.0);
-    acc_gbias = new Tensor(vector<int>{nk}, I->device);
+    acc_gbias = new Tensor(vector<int>{z}, I->device);
     acc_gbias->fill_(0.0);
 }
 
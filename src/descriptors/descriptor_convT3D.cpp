@@ -177,6 +177,7 @@ void ConvolDescriptorT3D::build(Tensor *A) {
         // mem for ptr, lowering im2col
         unsigned long int l_size =  (unsigned long)(A->shape[0] * d * r * c) * (unsigned long)(kz * kd* kr * kc);
         ptrI=get_fmem(l_size,"ConvolDescriptorT3D::build");
+        ptrI_size=l_size;
         matI=Eigen::Map<Eigen::MatrixXf>(ptrI, d*r*c,kz*kd*kr*kc);
 	   _profile_add_tensor(A->shape[0] * d * r * c * kz * kd * kr * kc);
     }
@@ -268,9 +269,13 @@ void ConvolDescriptorT3D::resize(int b)
     unsigned long int l_size =  (unsigned long)(b * d * r * c) * (unsigned long)(kz * kd * kr * kc);
 
     if (I->isCPU()) {
-        eddl_free(ptrI);
-        ptrI=get_fmem(l_size, "ConvolDescriptorT3D::build");
-	   _profile_add_tensor(l_size);
+        // Keep the largest im2col buffer: smaller batches reuse it
+        if (l_size > ptrI_size) {
+            eddl_free(ptrI);
+            ptrI=get_fmem(l_size, "ConvolDescriptorT3D::build");
+            ptrI_size=l_size;
+            _profile_add_tensor(l_size);
+        }
     }
 #ifdef cGPU
     else if (I->isGPU()) {
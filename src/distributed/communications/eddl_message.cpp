@@ -11,11 +11,27 @@
 
 #include <cstring>
 #include <openssl/sha.h>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 
 namespace eddl {
 
+/*
+    the message id is made of the source address, the type and a sequence
+    number unique within the process, so two messages of the same type
+    created in the same millisecond get different ids and their
+    acknowledgements are not mixed up; the timestamp keeps the wall clock
+    time of creation. The counter starts at the clock so that a restarted
+    process does not repeat the ids of the previous one
+*/
+static uint32_t get_next_sequence()
+{
+    static std::atomic<uint32_t> sequence((uint32_t)get_system_milliseconds());
+
+    return sequence.fetch_add(1);
+}
+
 eddl_message::eddl_message(uint32_t type,
                            uint32_t source_addr,
                            uint32_t target_addr,
@@ -25,6 +41,7 @@ eddl_message::eddl_message(uint32_t type,
 : type(type), source_addr(source_addr), target_addr(target_addr)
 {
     this->timestamp = get_system_milliseconds();
+    this->sequence = get_next_sequence();
     this->set_message_id();
     this->message_data_size = 0;
     this->packet_data_size = 0;
@@ -61,6 +78,7 @@ eddl_message::eddl_message(eddl_packet * packet)
     this->source_addr = packet->get_source_addr();
     this->target_addr = packet->get_target_addr();
     this->timestamp = get_system_milliseconds();
+    this->sequence = 0; // the message id comes from the packet
     this->seq_len = 1;
     this->message_data_size = packet->get_data_size();
     this->packet_data_size = packet->get_data_size();
@@ -153,10 +171,10 @@ void eddl_message::set_message_id(char * message_id)
             type >>= 4;
         }
 
-        uint64_t msec = this->timestamp;
+        uint32_t sequence = this->sequence;
         for (int k=0; k < 8; k++) {
-            s[i++] = hex[msec & 0x00f];
-            msec >>= 4;
+            s[i++] = hex[sequence & 0x00f];
+            sequence >>= 4;
         }
         s[i++] = '\0';
 
@@ -8,6 +8,7 @@
  */
 
 #include <eddl/distributed/eddl_packet.h>
+#include <eddl/distributed/eddl_ring.h>
 
 #include <cstring>
 #include <openssl/sha.h>
@@ -80,6 +81,42 @@ eddl_packet::~eddl_packet()
 {
 }
 
+/*
+    Released packets are kept in a lock-free ring and handed out again, so
+    the threads sending and receiving packets of the size of the MTU do not
+    go through the heap for every packet. Blocks are allocated with
+    eddl_malloc(), hence those not fitting in the pool are released with free().
+*/
+class eddl_packet_pool
+{
+public:
+    eddl_packet_pool() : ring(eddl_packet_pool_size) {}
+    ~eddl_packet_pool()
+    {
+        void * ptr = nullptr;
+        while (ring.try_pop(ptr)) free(ptr);
+    }
+
+    eddl_ring<void *>   ring;
+};
+static eddl_packet_pool packet_pool;
+
+void * eddl_packet::operator new(size_t size)
+{
+    void * ptr = nullptr;
+    if (size == sizeof(eddl_packet) && packet_pool.ring.try_pop(ptr))
+        return ptr;
+
+    return eddl_malloc(size);
+}
+void eddl_packet::operator delete(void * ptr, size_t size)
+{
+    if (nullptr == ptr) return;
+
+    if (size != sizeof(eddl_packet) || ! packet_pool.ring.try_push(ptr))
+        free(ptr);
+}
+
 uint32_t eddl_packet::get_command()
 {
     uint32_t *p = (uint32_t *)this->data;
@@ -150,9 +150,8 @@ void MulticastReceiver::receiver()
         struct sockaddr_in  peer_addr;
         socklen_t peer_addr_size = sizeof(peer_addr);
         int flags = MSG_NOSIGNAL; // MSG_WAITALL;
-        data = eddl_malloc(sizeof(eddl_packet));
-        if (nullptr == data)
-            throw std::runtime_error(err_msg("error allocating memory."));
+        // taken from the pool of packets, see eddl_packet::operator new()
+        data = eddl_packet::operator new(sizeof(eddl_packet));
 
         ssize_t l = sizeof(eddl_packet);
         // blocking call
@@ -160,7 +159,7 @@ void MulticastReceiver::receiver()
                              (struct sockaddr *)&peer_addr, &peer_addr_size);
         if (n < 0) {
             print_err_msg("error receiving a packet: " + std::to_string(errno) + ": " + strerror(errno));
-            free(data);
+            eddl_packet::operator delete(data, sizeof(eddl_packet));
             continue; // do not abort the process, just drop the packet
         }
 
@@ -168,7 +167,7 @@ void MulticastReceiver::receiver()
             print_err_msg("warning: received an incomplete packet of "
                         + std::to_string(n) + " bytes instead of "
                         + std::to_string(l) + " bytes requrested");
-            free(data);
+            eddl_packet::operator delete(data, sizeof(eddl_packet));
             continue; // do not abort the process, just drop the packet
         }
 
@@ -302,10 +301,10 @@ void MulticastReceiver::receiver()
         }
         /*
             instead of deleting the object of the class eddl_packet, we have
-            to free the memory block
+            to return the memory block to the pool
             delete packet -- DON'T DO THIS IN THIS CASE
         */
-        free(data);
+        eddl_packet::operator delete(data, sizeof(eddl_packet));
     } // while receiver_active
     close(socket_fd_in);
     print_log_msg("multicast receiver thread stopped normally");
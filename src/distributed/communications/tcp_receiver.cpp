@@ -38,12 +38,20 @@ TCP_Receiver::TCP_Receiver( eddl_queue & input_queue,
     if (socket_fd < 0)
         throw std::runtime_error(err_msg("socket cannot be created."));
 
+    int reuse = 1;
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0)
+        throw std::runtime_error(err_msg("cannot set address reuse."));
+
     struct sockaddr_in  my_addr;
 
     /* Clear data structure */
     memset(&my_addr, 0, sizeof(struct sockaddr_in));
     my_addr.sin_family = AF_INET;
-    my_addr.sin_addr.s_addr = INADDR_ANY;
+    // all the interfaces unless the node listens on its own address only, see DistributedEnvironment
+    if (distributed_environment.get_bind_my_ip_addr())
+        my_addr.sin_addr.s_addr = distributed_environment.get_my_s_addr();
+    else
+        my_addr.sin_addr.s_addr = INADDR_ANY;
     my_addr.sin_port = htons(distributed_environment.get_tcp_port());
 
     if (bind(socket_fd, (struct sockaddr *) &my_addr, sizeof(struct sockaddr_in)) < 0)
@@ -67,7 +75,9 @@ TCP_Receiver::~TCP_Receiver()
     // a signal must be sent to the acceptor thread in order to wake up it
     // from the accept() system call, but the solution is to deatch the thread
     // and leave the program to end, then the thread is killed.
+    // in Linux shutdown() makes accept() return with an error.
 
+    shutdown(socket_fd, SHUT_RDWR);
     close(socket_fd);
 
     joiner_thread.join();
@@ -79,7 +79,9 @@ void TCP_Sender::sender()
             while (sender_active  &&  nullptr == message  &&  ! queue_of_pending_messages.empty()) {
                 // the pop() method blocks and waits until data is ready
                 message = queue_of_pending_messages.pop();
-                if (get_system_milliseconds() - message->get_timestamp() > 50000 /* 50 seconds */) {
+                uint64_t now = get_system_milliseconds();
+                // the clock can go backwards, the age is only computed when it does not
+                if (now > message->get_timestamp() && now - message->get_timestamp() > 50000 /* 50 seconds */) {
                     // too old messages are dropped
                     print_err_msg("dropping too old message " + message->get_message_id()
                                 + " from the queue of pending messages!");
@@ -88,24 +90,25 @@ void TCP_Sender::sender()
                 }
             }
             // only gets messages from the output queue if the queue of pending messages is empty
-            if (nullptr == message  &&  ! output_queue.empty()) {
-                // the pop() method blocks and waits until data is ready
-                message = output_queue.pop();
+            if (nullptr == message) {
+                // does not block, acknowledgements and commands come out first
+                output_queue.try_pop(message);
             }
 
             if (nullptr != message) {
                 manage_to_send_message(message);
             } else {
+                // wakes up as soon as a new message is pushed into the output queue
                 if (generic_ack_queue.empty())
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                    output_queue.wait_for(std::chrono::milliseconds(100));
             }
         } else {
             if (get_system_milliseconds()-this->timestamp_last_status_change > 1000) {
                 change_status_to(NORMAL_OPERATION);
             }
         }
-        while (! generic_ack_queue.empty()) {
-            eddl_message * ack = generic_ack_queue.pop();
+        eddl_message * ack = nullptr;
+        while (generic_ack_queue.try_pop(ack)) {
             std::string msg_id = ack->get_acknowledged_message_id();
             if (sent_messages.count(msg_id) > 0) {
                 delete sent_messages.at(msg_id);
@@ -0,0 +1,582 @@
+/*
+ * EDDL Library - European Distributed Deep Learning Library.
+ * Version: x.y
+ * copyright (c) 2020, Universitat Politècnica de València (UPV), PRHLT Research Centre
+ * Date: July 2020
+ * Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+ * All rights reserved
+ */
+
+#include <cstring>
+#include <cmath>
+#include <arpa/inet.h>
+
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <iostream>
+
+#include <eddl/distributed/eddl_parameter_server.h>
+
+namespace eddl {
+
+/////////////////////////////////////////////////////////////////////////////
+//////////////////////////////// CODECS /////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+size_t ps_encoded_size(size_t count, uint32_t codec)
+{
+    switch (codec) {
+        case eddl_ps_codecs::PS_FLOAT32:
+            return count * sizeof(float);
+        case eddl_ps_codecs::PS_INT8:
+            return next_multiple(count, ps_block) / ps_block * sizeof(float) + count;
+        default:
+            throw std::runtime_error(err_msg("unknown codec " + std::to_string(codec)));
+    }
+}
+
+void ps_encode(float * values, size_t count, uint32_t codec, void * out)
+{
+    if (codec == eddl_ps_codecs::PS_FLOAT32) {
+        memcpy(out, values, count * sizeof(float));
+        memset(values, 0, count * sizeof(float));
+        return;
+    }
+    if (codec != eddl_ps_codecs::PS_INT8)
+        throw std::runtime_error(err_msg("unknown codec " + std::to_string(codec)));
+
+    // the scales of all the blocks first, then the quantized values
+    size_t num_blocks = next_multiple(count, ps_block) / ps_block;
+    float * scales = (float *)out;
+    int8_t * q = (int8_t *)(scales + num_blocks);
+
+    #pragma omp parallel for
+    for (size_t b = 0; b < num_blocks; b++) {
+        size_t first = b * ps_block;
+        size_t last = std::min(first + ps_block, count);
+
+        float max_abs = 0.0f;
+        for (size_t i = first; i < last; i++) max_abs = std::max(max_abs, std::fabs(values[i]));
+
+        float scale = max_abs / 127.0f;
+        float inv = (scale > 0.0f) ? 1.0f / scale : 0.0f;
+        scales[b] = scale;
+        for (size_t i = first; i < last; i++) {
+            int v = (int)std::lround(values[i] * inv);
+            q[i] = (int8_t)v;
+            values[i] -= v * scale;
+        }
+    }
+}
+
+void ps_accumulate(const void * in, size_t count, uint32_t codec, float alpha, float * w)
+{
+    if (codec == eddl_ps_codecs::PS_FLOAT32) {
+        const float * v = (const float *)in;
+        #pragma omp parallel for
+        for (size_t i = 0; i < count; i++) w[i] += alpha * v[i];
+        return;
+    }
+    if (codec != eddl_ps_codecs::PS_INT8)
+        throw std::runtime_error(err_msg("unknown codec " + std::to_string(codec)));
+
+    size_t num_blocks = next_multiple(count, ps_block) / ps_block;
+    const float * scales = (const float *)in;
+    const int8_t * q = (const int8_t *)(scales + num_blocks);
+
+    #pragma omp parallel for
+    for (size_t b = 0; b < num_blocks; b++) {
+        float scale = alpha * scales[b];
+        size_t last = std::min((b + 1) * ps_block, count);
+        for (size_t i = b * ps_block; i < last; i++) w[i] += scale * q[i];
+    }
+}
+
+static void stop_communications(eddl_queue & output_queue, TCP_Sender * tcp_sender, TCP_Receiver * tcp_receiver)
+{
+    // let the sender deliver the last messages and receive their acknowledgements
+    for (int i = 0; i < 100 && ! output_queue.empty(); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    tcp_sender->stop();
+    tcp_receiver->stop();
+    delete tcp_sender;
+    delete tcp_receiver;
+    output_queue.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////// METHODS OF CLASS ParameterServer ////////////////////
+/////////////////////////////////////////////////////////////////////////////
+ParameterServer::ParameterServer(DistributedEnvironment & distributed_environment,
+                                 int max_staleness,
+                                 float update_scale,
+                                 int worker_timeout) :
+    distributed_environment(distributed_environment),
+    max_staleness(std::max(0, max_staleness)),
+    update_scale(update_scale),
+    worker_timeout(std::max(0, worker_timeout))
+{
+    offset = 0;
+    version = 0;
+    sum_of_staleness = 0;
+    max_observed_staleness = 0;
+
+    // acknowledgements of weights and gradients are managed by the tcp sender
+    tcp_receiver = new TCP_Receiver(input_queue, ack_queue, ack_queue, output_queue, distributed_environment);
+    tcp_sender = new TCP_Sender(output_queue, ack_queue, distributed_environment);
+}
+
+ParameterServer::~ParameterServer()
+{
+    stop_communications(output_queue, tcp_sender, tcp_receiver);
+}
+
+void ParameterServer::run(int num_workers)
+{
+    print_log_msg("parameter server ready at " + distributed_environment.get_my_ip_addr()
+                + " with max staleness " + std::to_string(max_staleness));
+
+    bool shutdown_server = false;
+    while (! shutdown_server) {
+        eddl_message * message = nullptr;
+        // wakes up every second to look for silent workers
+        if (input_queue.wait_for(std::chrono::milliseconds(1000)))
+            message = input_queue.pop();
+
+        if (nullptr != message && message->get_type() == eddl_message_types::COMMAND) {
+            shutdown_server = message->get_command() == eddl_command_types::SHUTDOWN;
+        } else {
+            if (nullptr != message) handle(message);
+            drop_silent_workers();
+            serve_pending_pulls();
+            shutdown_server = num_workers > 0 && workers_gone() >= num_workers;
+        }
+        delete message;
+    }
+
+    print_log_msg("parameter server done: " + std::to_string(version) + " pushes applied"
+                + ", average staleness " + std::to_string(version > 0 ? (double)sum_of_staleness / version : 0.0)
+                + ", max staleness " + std::to_string(max_observed_staleness));
+}
+
+void ParameterServer::handle(eddl_message * message)
+{
+    if (message->get_message_data_size() < sizeof(eddl_ps_header)) {
+        print_err_msg("unexpected message " + get_message_type_name(message->get_type())
+                    + " from " + get_ip_address(message->get_source_addr()));
+        return;
+    }
+    eddl_ps_header * h = (eddl_ps_header *)message->get_data();
+    void * data = (unsigned char *)message->get_data() + sizeof(eddl_ps_header);
+    uint32_t s_addr = message->get_source_addr();
+
+    if (workers.count(s_addr) > 0 && h->kind != eddl_ps_kinds::PS_INIT) {
+        if (workers[s_addr].timed_out) {
+            print_err_msg("dropping message from worker " + get_ip_address(s_addr) + " after its timeout");
+            return;
+        }
+        workers[s_addr].last_seen = get_system_milliseconds();
+    }
+
+    switch (h->kind) {
+        case eddl_ps_kinds::PS_INIT:
+            if (message->get_message_data_size() != sizeof(eddl_ps_header) + h->count * sizeof(float)) {
+                print_err_msg("init of wrong size from " + get_ip_address(s_addr));
+                break;
+            }
+            register_worker(s_addr, h, (float *)data);
+            break;
+
+        case eddl_ps_kinds::PS_PUSH:
+            if ((h->codec != eddl_ps_codecs::PS_FLOAT32 && h->codec != eddl_ps_codecs::PS_INT8)
+                || message->get_message_data_size() != sizeof(eddl_ps_header) + ps_encoded_size(h->count, h->codec)) {
+                print_err_msg("push of wrong size from " + get_ip_address(s_addr));
+                break;
+            }
+            apply_push(s_addr, h, data);
+            break;
+
+        case eddl_ps_kinds::PS_PULL:
+            pending_pulls.push_back({s_addr, h->clock});
+            break;
+
+        case eddl_ps_kinds::PS_BYE:
+            if (workers.count(s_addr) > 0) {
+                workers[s_addr].active = false;
+                workers[s_addr].goodbye = h->clock;
+                if (distributed_environment.get_verbose_level() >= 1)
+                    print_log_msg("worker " + get_ip_address(s_addr) + " left after " + std::to_string(h->clock) + " pushes");
+            }
+            break;
+
+        default:
+            print_err_msg("unexpected kind " + std::to_string(h->kind) + " from " + get_ip_address(s_addr));
+            break;
+    }
+}
+
+void ParameterServer::register_worker(uint32_t s_addr, eddl_ps_header * h, float * w)
+{
+    if (weights.empty()) {
+        // the first worker sets the shard and its initial values
+        offset = h->offset;
+        weights.assign(w, w + h->count);
+        print_log_msg("shard of " + std::to_string(h->count) + " parameters at offset "
+                    + std::to_string(offset) + " initialized by " + get_ip_address(s_addr));
+    } else if (h->offset != offset || h->count != weights.size()) {
+        print_err_msg("worker " + get_ip_address(s_addr) + " rejected: it expects the shard at offset "
+                    + std::to_string(h->offset) + " with " + std::to_string(h->count) + " parameters");
+        return;
+    }
+
+    // a new worker is as far as the slowest one, otherwise it would hold the others
+    worker_info info;
+    info.base = slowest_clock();
+    info.pushes = 0;
+    info.version = version;
+    info.goodbye = std::numeric_limits<uint64_t>::max();
+    info.last_seen = get_system_milliseconds();
+    info.active = true;
+    info.timed_out = false;
+    workers[s_addr] = info;
+
+    if (distributed_environment.get_verbose_level() >= 1)
+        print_log_msg("worker " + get_ip_address(s_addr) + " joined at clock " + std::to_string(info.base));
+}
+
+void ParameterServer::apply_push(uint32_t s_addr, eddl_ps_header * h, void * data)
+{
+    if (workers.count(s_addr) == 0 || h->offset != offset || h->count != weights.size()) {
+        print_err_msg("push from unknown worker or for another shard: " + get_ip_address(s_addr));
+        return;
+    }
+
+    // a round of pushes moves the weights by the average of the local steps, as in federated averaging
+    int active_workers = 0;
+    for (auto & w : workers) active_workers += w.second.active;
+    ps_accumulate(data, h->count, h->codec, update_scale / std::max(1, active_workers), weights.data());
+
+    uint64_t staleness = version - std::min(version, h->version);
+    sum_of_staleness += staleness;
+    max_observed_staleness = std::max(max_observed_staleness, staleness);
+    version++;
+    workers[s_addr].pushes++;
+}
+
+uint64_t ParameterServer::slowest_clock()
+{
+    uint64_t clock = std::numeric_limits<uint64_t>::max();
+    for (auto & w : workers)
+        if (w.second.active)
+            clock = std::min(clock, w.second.base + w.second.pushes);
+
+    return (clock == std::numeric_limits<uint64_t>::max()) ? 0 : clock;
+}
+
+int ParameterServer::workers_gone()
+{
+    int n = 0;
+    for (auto & w : workers)
+        if (! w.second.active && w.second.pushes >= w.second.goodbye) n++;
+
+    return n;
+}
+
+bool ParameterServer::can_be_served(pending_pull & p)
+{
+    // pulls can arrive before the corresponding init or push, they use different connections
+    if (workers.count(p.s_addr) == 0) return false;
+
+    worker_info & w = workers[p.s_addr];
+    if (w.pushes < p.clock) return false;
+
+    return w.base + p.clock <= slowest_clock() + max_staleness;
+}
+
+void ParameterServer::serve_pending_pulls()
+{
+    for (auto it = pending_pulls.begin(); it != pending_pulls.end(); ) {
+        if (can_be_served(*it)) {
+            send_weights(it->s_addr);
+            it = pending_pulls.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ParameterServer::send_weights(uint32_t s_addr)
+{
+    eddl_ps_header h;
+    h.kind = eddl_ps_kinds::PS_WEIGHTS;
+    h.codec = eddl_ps_codecs::PS_FLOAT32;
+    h.clock = 0;
+    h.version = version;
+    h.offset = offset;
+    h.count = weights.size();
+
+    std::vector<unsigned char> data(sizeof(h) + weights.size() * sizeof(float));
+    memcpy(data.data(), &h, sizeof(h));
+    memcpy(data.data() + sizeof(h), weights.data(), weights.size() * sizeof(float));
+
+    output_queue.push(new eddl_message(eddl_message_types::DATA_WEIGHTS,
+                                       0, // source addr will be set by the sender thread
+                                       s_addr,
+                                       data.size(),
+                                       eddl_packet_data_size,
+                                       data.data()));
+    workers[s_addr].version = version;
+    workers[s_addr].last_seen = get_system_milliseconds();
+}
+
+void ParameterServer::drop_silent_workers()
+{
+    if (worker_timeout == 0) return;
+
+    uint64_t now = get_system_milliseconds();
+    for (auto & w : workers) {
+        worker_info & info = w.second;
+        if (! info.active || now < info.last_seen + 1000 * (uint64_t)worker_timeout) continue;
+
+        // a worker whose pull waits for slower workers is not silent, it does not hold anybody
+        bool waiting = false;
+        for (auto & p : pending_pulls)
+            waiting |= p.s_addr == w.first && info.pushes >= p.clock;
+        if (waiting) continue;
+
+        info.active = false;
+        info.timed_out = true;
+        info.goodbye = info.pushes;
+        pending_pulls.remove_if([&](pending_pull & p) { return p.s_addr == w.first; });
+        print_err_msg("worker " + get_ip_address(w.first) + " silent for more than "
+                    + std::to_string(worker_timeout) + " seconds, it is considered dead");
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//////////////////// METHODS OF CLASS ParameterServerWorker /////////////////
+/////////////////////////////////////////////////////////////////////////////
+static void ps_save(std::vector<Tensor *> & ts, float * dst)
+{
+    for (auto t : ts) {
+        if (t->isCPU()) {
+            memcpy(dst, t->ptr, t->size * sizeof(float));
+        } else {
+            Tensor * h = new Tensor(t->getShape(), DEV_CPU);
+            Tensor::copy(t, h);
+            memcpy(dst, h->ptr, t->size * sizeof(float));
+            delete h;
+        }
+        dst += t->size;
+    }
+}
+
+static void ps_add(std::vector<Tensor *> & ts, float * dst)
+{
+    for (auto t : ts) {
+        if (t->isCPU()) {
+            for (int i = 0; i < t->size; i++) dst[i] += t->ptr[i];
+        } else {
+            Tensor * h = new Tensor(t->getShape(), DEV_CPU);
+            Tensor::copy(t, h);
+            for (int i = 0; i < t->size; i++) dst[i] += h->ptr[i];
+            delete h;
+        }
+        dst += t->size;
+    }
+}
+
+// copies src[first..last) into the flattened tensors
+static void ps_load(std::vector<Tensor *> & ts, const float * src, uint64_t first, uint64_t last)
+{
+    uint64_t pos = 0;
+    for (auto t : ts) {
+        uint64_t from = std::max(first, pos), to = std::min(last, pos + t->size);
+        if (from < to) {
+            if (t->isCPU()) {
+                memcpy(t->ptr + (from - pos), src + (from - first), (to - from) * sizeof(float));
+            } else {
+                Tensor * h = new Tensor(t->getShape(), DEV_CPU);
+                Tensor::copy(t, h);
+                memcpy(h->ptr + (from - pos), src + (from - first), (to - from) * sizeof(float));
+                Tensor::copy(h, t);
+                delete h;
+            }
+        }
+        pos += t->size;
+    }
+}
+
+ParameterServerWorker::ParameterServerWorker(Net * net,
+                                             DistributedEnvironment & distributed_environment,
+                                             std::vector<std::string> servers,
+                                             int push_every,
+                                             uint32_t codec) :
+    net(net),
+    distributed_environment(distributed_environment),
+    push_every(std::max(1, push_every)),
+    codec(codec)
+{
+    if (servers.empty())
+        throw std::runtime_error(err_msg("no parameter servers provided."));
+    if (net->snets.size() != 1)
+        throw std::runtime_error(err_msg("a worker must train on one computing device."));
+    ps_encoded_size(0, codec); // checks the codec
+
+    for (auto & s : servers) {
+        struct in_addr addr;
+        if (inet_aton(s.c_str(), &addr) != 1)
+            throw std::runtime_error(err_msg("invalid ip addr provided: " + s));
+        this->servers.push_back(addr.s_addr);
+    }
+
+    // the optimizer accumulates in acc_gradients the steps it applies
+    bool enabled = false;
+    for (auto l : net->snets[0]->layers) enabled |= ! l->acc_gradients.empty();
+    if (! enabled) net->enable_distributed();
+
+    for (auto l : net->snets[0]->layers) {
+        if (l->acc_gradients.empty()) continue;
+        if (l->acc_gradients.size() != l->params.size())
+            throw std::runtime_error(err_msg("layer " + l->name + " has not an accumulated gradient per parameter."));
+        for (size_t i = 0; i < l->params.size(); i++) {
+            if (l->params[i]->size != l->acc_gradients[i]->size)
+                throw std::runtime_error(err_msg("layer " + l->name + " has accumulated gradients of wrong size."));
+            params.push_back(l->params[i]);
+            acc_gradients.push_back(l->acc_gradients[i]);
+        }
+    }
+
+    uint64_t size = 0;
+    for (auto t : params) size += t->size;
+    for (size_t k = 0; k <= this->servers.size(); k++)
+        shard_offset.push_back(size * k / this->servers.size());
+    shard_version.assign(this->servers.size(), 0);
+    residual.assign(size, 0.0f);
+
+    clock = 0;
+    batches = 0;
+    running = false;
+
+    tcp_receiver = new TCP_Receiver(input_queue, ack_queue, ack_queue, output_queue, distributed_environment);
+    tcp_sender = new TCP_Sender(output_queue, ack_queue, distributed_environment);
+}
+
+ParameterServerWorker::~ParameterServerWorker()
+{
+    if (running) stop();
+    stop_communications(output_queue, tcp_sender, tcp_receiver);
+}
+
+void ParameterServerWorker::send(uint32_t type, uint32_t s_addr, eddl_ps_header & h, size_t size, void * data)
+{
+    std::vector<unsigned char> message_data(sizeof(h) + size);
+    memcpy(message_data.data(), &h, sizeof(h));
+    if (size > 0) memcpy(message_data.data() + sizeof(h), data, size);
+
+    output_queue.push(new eddl_message(type,
+                                       0, // source addr will be set by the sender thread
+                                       s_addr,
+                                       message_data.size(),
+                                       eddl_packet_data_size,
+                                       message_data.data()));
+}
+
+void ParameterServerWorker::start()
+{
+    std::vector<float> w(residual.size());
+    ps_save(params, w.data());
+
+    for (size_t k = 0; k < servers.size(); k++) {
+        eddl_ps_header h = {eddl_ps_kinds::PS_INIT, eddl_ps_codecs::PS_FLOAT32,
+                            0, 0, shard_offset[k], shard_offset[k+1] - shard_offset[k]};
+        send(eddl_message_types::DATA_GRADIENTS, servers[k], h, h.count * sizeof(float), w.data() + h.offset);
+    }
+    running = true;
+    pull();
+}
+
+void ParameterServerWorker::train_batch(std::vector<Tensor *> X, std::vector<Tensor *> Y, std::vector<int> sind)
+{
+    net->train_batch(X, Y, sind);
+
+    if (++batches % push_every == 0) {
+        push();
+        pull();
+    }
+}
+
+void ParameterServerWorker::push()
+{
+    // residual keeps the steps (and the compression error) not received by the servers yet
+    ps_add(acc_gradients, residual.data());
+    net->snets[0]->reset_accumulated_gradients();
+
+    clock++;
+    for (size_t k = 0; k < servers.size(); k++) {
+        eddl_ps_header h = {eddl_ps_kinds::PS_PUSH, codec,
+                            clock, shard_version[k], shard_offset[k], shard_offset[k+1] - shard_offset[k]};
+        buffer.resize(ps_encoded_size(h.count, codec));
+        ps_encode(residual.data() + h.offset, h.count, codec, buffer.data());
+        send(eddl_message_types::DATA_GRADIENTS, servers[k], h, buffer.size(), buffer.data());
+    }
+}
+
+void ParameterServerWorker::pull()
+{
+    for (size_t k = 0; k < servers.size(); k++) {
+        eddl_ps_header h = {eddl_ps_kinds::PS_PULL, eddl_ps_codecs::PS_FLOAT32,
+                            clock, shard_version[k], shard_offset[k], shard_offset[k+1] - shard_offset[k]};
+        send(eddl_message_types::PARAMETER, servers[k], h, 0, nullptr);
+    }
+
+    // the servers answer when the staleness bound allows it
+    std::vector<bool> received(servers.size(), false);
+    size_t pending = servers.size();
+    while (pending > 0) {
+        eddl_message * message = input_queue.pop();
+        if (nullptr == message) continue;
+
+        if (message->get_type() == eddl_message_types::DATA_WEIGHTS
+            && message->get_message_data_size() >= sizeof(eddl_ps_header)) {
+            eddl_ps_header * h = (eddl_ps_header *)message->get_data();
+            for (size_t k = 0; k < servers.size(); k++) {
+                if (received[k] || message->get_source_addr() != servers[k]) continue;
+                if (h->offset != shard_offset[k] || h->count != shard_offset[k+1] - shard_offset[k]
+                    || message->get_message_data_size() != sizeof(eddl_ps_header) + h->count * sizeof(float))
+                    throw std::runtime_error(err_msg("server " + get_ip_address(servers[k]) + " sent a wrong shard."));
+
+                ps_load(params, (float *)(h + 1), h->offset, h->offset + h->count);
+                shard_version[k] = h->version;
+                received[k] = true;
+                pending--;
+            }
+        } else if (message->get_type() == eddl_message_types::COMMAND
+                   && message->get_command() == eddl_command_types::SHUTDOWN) {
+            delete message;
+            throw std::runtime_error(err_msg("shutdown while waiting for the weights."));
+        } else {
+            print_err_msg("unexpected message " + get_message_type_name(message->get_type())
+                        + " from " + get_ip_address(message->get_source_addr()));
+        }
+        delete message;
+    }
+}
+
+void ParameterServerWorker::stop()
+{
+    if (! running) return;
+    running = false;
+
+    if (batches % push_every != 0) push();
+
+    for (size_t k = 0; k < servers.size(); k++) {
+        eddl_ps_header h = {eddl_ps_kinds::PS_BYE, eddl_ps_codecs::PS_FLOAT32,
+                            clock, shard_version[k], shard_offset[k], shard_offset[k+1] - shard_offset[k]};
+        send(eddl_message_types::PARAMETER, servers[k], h, 0, nullptr);
+    }
+}
+
+};
@@ -18,7 +18,7 @@ bool cpu_all(Tensor *A){
 
     _profile(_CPU_ALL, 0);
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         if (A->ptr[i] != 1.0f){
             #pragma omp critical
@@ -40,7 +40,7 @@ bool cpu_any(Tensor *A){
     _profile(_CPU_ANY, 0);
 
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         if (A->ptr[i] == 1.0f){
             #pragma omp critical
@@ -59,7 +59,7 @@ bool cpu_any(Tensor *A){
 // CPU: Logic functions: Comparisons
 void cpu_isfinite(Tensor *A, Tensor* B){
     _profile(_CPU_ISFINITE, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = std::isfinite(A->ptr[i]);
     }
@@ -68,7 +68,7 @@ void cpu_isfinite(Tensor *A, Tensor* B){
 
 void cpu_isinf(Tensor *A, Tensor* B){
     _profile(_CPU_ISINF, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = std::isinf(A->ptr[i]);
     }
@@ -77,7 +77,7 @@ void cpu_isinf(Tensor *A, Tensor* B){
 
 void cpu_isnan(Tensor *A, Tensor* B){
     _profile(_CPU_ISNAN, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = std::isnan(A->ptr[i]);
     }
@@ -87,7 +87,7 @@ void cpu_isnan(Tensor *A, Tensor* B){
 
 void cpu_isneginf(Tensor *A, Tensor* B){
     _profile(_CPU_ISNEGINF, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = std::isinf(A->ptr[i]) && A->ptr[i] < 0.0f;
     }
@@ -96,7 +96,7 @@ void cpu_isneginf(Tensor *A, Tensor* B){
 
 void cpu_isposinf(Tensor *A, Tensor* B){
     _profile(_CPU_ISPOSINF, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = std::isinf(A->ptr[i]) && A->ptr[i] > 0.0f;
     }
@@ -107,7 +107,7 @@ void cpu_isposinf(Tensor *A, Tensor* B){
 // CPU: Logic functions: Comparisons
 void cpu_logical_and(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_LOGICAL_AND, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = (bool)A->ptr[i] & (bool)B->ptr[i];
     }
@@ -116,7 +116,7 @@ void cpu_logical_and(Tensor *A, Tensor *B, Tensor *C){
 
 void cpu_logical_or(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_LOGICAL_OR, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = (bool)A->ptr[i] | (bool)B->ptr[i];
     }
@@ -125,7 +125,7 @@ void cpu_logical_or(Tensor *A, Tensor *B, Tensor *C){
 
 void cpu_logical_not(Tensor *A, Tensor *B){
     _profile(_CPU_LOGICAL_NOT, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = !((bool)A->ptr[i]);  // why not use "~"
     }
@@ -134,7 +134,7 @@ void cpu_logical_not(Tensor *A, Tensor *B){
 
 void cpu_logical_xor(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_LOGICAL_XOR, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = (bool)A->ptr[i] ^ (bool)B->ptr[i];
     }
@@ -148,7 +148,7 @@ bool cpu_allclose(Tensor *A, Tensor *B, float rtol, float atol, bool equal_nan){
     int first_idx = -1;
 
     _profile(_CPU_ALLCLOSE, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i){
         // Check if both values are NaN
         if (equal_nan && std::isnan(A->ptr[i]) && std::isnan(B->ptr[i])) {
@@ -198,7 +198,7 @@ bool cpu_allclose_verbose(Tensor *A, Tensor *B, float rtol, float atol, bool equ
 
 void cpu_isclose(Tensor *A, Tensor *B, Tensor *C, float rtol, float atol, bool equal_nan){
     _profile(_CPU_ISCLOSE, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = ::fabsf(A->ptr[i] - B->ptr[i]) <= (atol + rtol * ::fabsf(B->ptr[i]));
     }
@@ -207,7 +207,7 @@ void cpu_isclose(Tensor *A, Tensor *B, Tensor *C, float rtol, float atol, bool e
 
 
 void cpu_greater(Tensor *A, Tensor *B, float v){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = A->ptr[i] > v;
     }
@@ -216,7 +216,7 @@ void cpu_greater(Tensor *A, Tensor *B, float v){
 void cpu_greater(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_GREATER, 0);
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = A->ptr[i] > B->ptr[i];
     }
@@ -225,7 +225,7 @@ void cpu_greater(Tensor *A, Tensor *B, Tensor *C){
 
 
 void cpu_greater_equal(Tensor *A, Tensor *B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = A->ptr[i] >= v;
     }
@@ -234,7 +234,7 @@ void cpu_greater_equal(Tensor *A, Tensor *B, float v){
 void cpu_greater_equal(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_GREATER_EQUAL, 0);
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = A->ptr[i] >= B->ptr[i];
     }
@@ -242,7 +242,7 @@ void cpu_greater_equal(Tensor *A, Tensor *B, Tensor *C){
 }
 
 void cpu_less(Tensor *A, Tensor *B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = A->ptr[i] < v;
     }
@@ -251,7 +251,7 @@ void cpu_less(Tensor *A, Tensor *B, float v){
 void cpu_less(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_LESS, 0);
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = A->ptr[i] < B->ptr[i];
     }
@@ -259,7 +259,7 @@ void cpu_less(Tensor *A, Tensor *B, Tensor *C){
 }
 
 void cpu_less_equal(Tensor *A, Tensor *B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = A->ptr[i] <= v;
     }
@@ -267,7 +267,7 @@ void cpu_less_equal(Tensor *A, Tensor *B, float v){
 
 void cpu_less_equal(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_LESS_EQUAL, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = A->ptr[i] <= B->ptr[i];
     }
@@ -275,7 +275,7 @@ void cpu_less_equal(Tensor *A, Tensor *B, Tensor *C){
 }
 
 void cpu_equal(Tensor *A, Tensor *B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = A->ptr[i] == v;
     }
@@ -283,7 +283,7 @@ void cpu_equal(Tensor *A, Tensor *B, float v){
 
 void cpu_equal(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_EQUAL, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = A->ptr[i] == B->ptr[i];
     }
@@ -291,7 +291,7 @@ void cpu_equal(Tensor *A, Tensor *B, Tensor *C){
 }
 
 void cpu_not_equal(Tensor *A, Tensor *B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         B->ptr[i] = A->ptr[i] != v;
     }
@@ -299,7 +299,7 @@ void cpu_not_equal(Tensor *A, Tensor *B, float v){
 
 void cpu_not_equal(Tensor *A, Tensor *B, Tensor *C){
     _profile(_CPU_NOT_EQUAL, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         C->ptr[i] = A->ptr[i] != B->ptr[i];
     }
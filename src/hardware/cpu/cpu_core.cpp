@@ -9,12 +9,13 @@
 
 #include "eddl/hardware/cpu/cpu_tensor.h"
 #include "eddl/profiling.h"
+#include "eddl/profiler.h"
 #include <algorithm>
+#include <cstring>
 #include <numeric>
 #include <float.h>
 #include <omp.h>
 
-int num_instances[_NUM_CPU_FUNCS];
 float mb_memory_needed;
 
 void _profile_funcname(int i, char *name) {
@@ -193,29 +194,34 @@ void _profile_cpu_tensor(Tensor *T) {
 #endif
 }
 
-struct timeval time_ini[_NUM_CPU_FUNCS];
-unsigned long long acc_time[_NUM_CPU_FUNCS];
+// Profiler zones of the kernels, registered once (thread-safe static initialization)
+static int _profile_kernel_zone(int f_id) {
+  static int zones[_NUM_CPU_FUNCS];
+  static bool initialized = [](){
+      char name[50];
+      for (int i=0; i<_NUM_CPU_FUNCS; i++) {
+          _profile_funcname(i, name);
+          zones[i] = profiler_register(name, PROFILER_KERNEL);
+      }
+      return true;
+  }();
+  (void)initialized;
+  return zones[f_id];
+}
 
+// Kernel zones are recorded by the profiler (see eddl/profiler.h). The zone matches the begin/end pair
 void _profile(int f_id, int end) {
-  num_instances[f_id]++;
-  if (!end) gettimeofday(&time_ini[f_id], NULL);
-  else {
-      timeval t1;
-      gettimeofday(&t1, NULL);
-      acc_time[f_id] += ((t1.tv_sec - time_ini[f_id].tv_sec) * 1000000) +
-                        (t1.tv_usec - time_ini[f_id].tv_usec);
+  int zone = _profile_kernel_zone(f_id);
+  if (zone < 0) return;
+  if (!end) {
+      if (profiler_is_enabled()) profiler_begin(zone);
+  } else {
+      profiler_end(zone);
   }
 }
 
 void _show_profile() {
-  printf("\nCPU functions called:\n");
-  for (int i=0; i<_NUM_CPU_FUNCS; i++) {
-    if (num_instances[i] != 0) {
-      char func_name[50];
-      _profile_funcname(i, func_name);
-      printf("%-50s: %d instances, %llu us\n", func_name, num_instances[i], acc_time[i]);
-    }
-  }
+  profiler_show_summary();
   printf("Memory: %f MB\n", mb_memory_needed);
 }
 
@@ -233,7 +239,7 @@ void cpu_transpose(Tensor * A, Tensor * B) {
     _profile(_CPU_TRANSPOSE, 0);
     //memcpy(B->ptr, A->ptr, A->size*sizeof(float));
     
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; i++){
         B->ptr[i] = A->ptr[i];
     }
@@ -245,7 +251,7 @@ void cpu_copy(Tensor * A, Tensor * B){
     _profile(_CPU_COPY, 0);
     //memcpy(B->ptr, A->ptr, A->size*sizeof(float));
     
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; i++){
         B->ptr[i] = A->ptr[i];
     }
@@ -273,7 +279,7 @@ void cpu_fill(Tensor * A, int aini, int aend, Tensor * B, int bini, int bend, in
     for (int i = 2; i < A->ndim; i++)
         t *= A->shape[i];
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (int i = 0; i < A->shape[0]; i++) {
         int ap = (i * at) + (aini * t);
         int bp = (i * bt) + (bini * t);
@@ -343,7 +349,7 @@ void cpu_select(Tensor * A, Tensor * B, vector<int> sind, int ini, int end,bool
     unsigned long int s = A->size / A->shape[0];
  //   printf("%s s=%ld\n",__func__,s);
  
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads((long int)(end - ini) * s, CPU_COST_CHEAP))
     for (int i = ini; i < end; i++) {
         unsigned long int p  = sind[i] * s;
         unsigned long int pb = (i - ini) * s;
@@ -361,7 +367,7 @@ void cpu_deselect(Tensor * A, Tensor * B, vector<int> sind, int ini, int end,int
     _profile(_CPU_DESELECT, 0);
     unsigned long int s = A->size / A->shape[0];
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads((long int)(end - ini) * s, CPU_COST_CHEAP))
     for (int i = ini; i < end; i++) {
         unsigned long int p  = sind[i] * s;
         unsigned long int pb = (i - ini) * s;
@@ -377,29 +383,39 @@ void cpu_deselect(Tensor * A, Tensor * B, vector<int> sind, int ini, int end,int
 
 void cpu_concat(Tensor *A, vector<Tensor*> t, unsigned int axis, bool derivative){
     _profile(_CPU_CONCAT, 0);
-  // Walk through all the tensors to concat one axis (once)
-    unsigned int offset = 0;
-    unsigned int src_stride = 0;
-    int steps = A->stride[axis] * A->shape[axis];  // Equivalent to A->stride[axis-1], but without the negative index problem
-
-    // Walk through each tensor
-    for (unsigned long int i = 0; i < t.size(); i++) {
-        offset += src_stride;
-        src_stride = t[i]->stride[axis] * t[i]->shape[axis];
-
-        // Copy n bytes from src to dest
-        float *dest = A->ptr + offset;
-        float *src = t[i]->ptr;
-
-        // Walk tensor i
-        //#pragma omp parallel for
-        for (unsigned long int j = 0; j < t[i]->size; j++) {
-            unsigned int k = j % src_stride;  // Pos (index) in the stride (src)
-            unsigned int stride_idx = j / src_stride;  // Index of the stride (src/dst)
-            unsigned int dest_offset = stride_idx * steps;  // Offset in dest
-
-            if(derivative){ src[j] += dest[dest_offset + k]; }
-            else{ dest[dest_offset + k] = src[j]; }
+    // Nothing to copy (and no blocks to divide A in when A->shape[axis] is 0)
+    if (A->size == 0) {
+        _profile(_CPU_CONCAT, 1);
+        return;
+    }
+
+    // Every source is a sequence of contiguous blocks (one per index of the dimensions before "axis"),
+    // interleaved in A: copy block by block instead of element by element
+    long int steps = (long int)A->stride[axis] * A->shape[axis];  // Equivalent to A->stride[axis-1], but without the negative index problem
+    long int nblocks = A->size / steps;
+
+    int ntensors = (int)t.size();
+    vector<long int> offsets(ntensors);
+    vector<long int> block_sizes(ntensors);
+    long int offset = 0;
+    for (int i = 0; i < ntensors; i++) {
+        offsets[i] = offset;
+        block_sizes[i] = (long int)t[i]->stride[axis] * t[i]->shape[axis];
+        offset += block_sizes[i];
+    }
+
+    long int ntasks = nblocks * ntensors;
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
+    for (long int task = 0; task < ntasks; task++) {
+        long int b = task / ntensors;
+        int i = (int)(task % ntensors);
+        float *dest = A->ptr + b * steps + offsets[i];
+        float *src = t[i]->ptr + b * block_sizes[i];
+
+        if(derivative){
+            for (long int k = 0; k < block_sizes[i]; k++) src[k] += dest[k];
+        }else{
+            std::memcpy(dest, src, block_sizes[i] * sizeof(float));
         }
     }
     _profile(_CPU_CONCAT, 1);
@@ -468,23 +484,118 @@ void cpu_sort(Tensor *A, Tensor *B, bool descending, bool stable){
 }
 
 void cpu_argsort(Tensor *A, Tensor *B, bool descending, bool stable) {
-    // Fill B with indices
-    std::iota(B->ptr, B->ptr + B->size, 0);
+    // Sort integer indices (float indices lose precision beyond 2^24 elements)
+    vector<size_t> idx(A->size);
+    std::iota(idx.begin(), idx.end(), 0);
 
     // Set orders
-    auto order_desc = [&A](float i1, float i2) {
-        return A->ptr[(size_t)i1] > A->ptr[(size_t)i2];
+    auto order_desc = [&A](size_t i1, size_t i2) {
+        return A->ptr[i1] > A->ptr[i2];
     };
-    auto order_asc = [&A](float i1, float i2) {
-        return A->ptr[(size_t)i1] < A->ptr[(size_t)i2];
+    auto order_asc = [&A](size_t i1, size_t i2) {
+        return A->ptr[i1] < A->ptr[i2];
     };
 
     // Sort data
     if(stable) {
-        if (descending) { std::stable_sort(B->ptr, B->ptr + B->size, order_desc); }
-        else { std::stable_sort(B->ptr, B->ptr + B->size, order_asc); }
+        if (descending) { std::stable_sort(idx.begin(), idx.end(), order_desc); }
+        else { std::stable_sort(idx.begin(), idx.end(), order_asc); }
     } else{
-        if (descending) { std::sort(B->ptr, B->ptr+B->size, order_desc); }
-        else { std::sort(B->ptr, B->ptr+B->size, order_asc); }
+        if (descending) { std::sort(idx.begin(), idx.end(), order_desc); }
+        else { std::sort(idx.begin(), idx.end(), order_asc); }
+    }
+
+    for (size_t i = 0; i < idx.size(); i++) B->ptr[i] = (float)idx[i];
+}
+
+// Top-k of one row (contiguous). "better" is a strict total order (ties resolved by position), so the
+// result does not depend on the selection algorithm
+template <typename Better>
+static void topk_row(const float *v, int n, int k, bool largest, bool sorted, Better better, vector<int> &idx) {
+    if (k <= 16 && k < n) {
+        // Small k: one pass keeping a sorted list. Once the list is full, the best element of each block
+        // is found with a vectorized max (min) and the block is skipped if it does not beat the k-th one
+        // (ties lose: the block comes after every selected position)
+        const int block = 64;
+        idx.resize(k);
+        int count = 0;
+        for (int b = 0; b < n; b += block) {
+            int end = std::min(n, b + block);
+            if (count == k) {
+                float kth = v[idx[k - 1]];
+                bool skip;
+                if (largest) {
+                    float m = kth;
+                    #pragma omp simd reduction(max:m)
+                    for (int j = b; j < end; j++) m = v[j] > m ? v[j] : m;
+                    skip = !(m > kth);
+                } else {
+                    float m = kth;
+                    #pragma omp simd reduction(min:m)
+                    for (int j = b; j < end; j++) m = v[j] < m ? v[j] : m;
+                    skip = !(m < kth);
+                }
+                if (skip) continue;
+            }
+
+            for (int j = b; j < end; j++) {
+                if (count == k && !better(j, idx[k - 1])) continue;
+                int pos = (count < k) ? count++ : k - 1;
+                while (pos > 0 && better(j, idx[pos - 1])) {
+                    idx[pos] = idx[pos - 1];
+                    pos--;
+                }
+                idx[pos] = j;
+            }
+        }
+        return;
+    }
+
+    idx.resize(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    if (k < n) {
+        std::nth_element(idx.begin(), idx.begin() + k, idx.end(), better);
+        if (sorted) std::sort(idx.begin(), idx.begin() + k, better);
+    } else if (sorted) {
+        std::sort(idx.begin(), idx.end(), better);
+    }
+}
+
+void cpu_topk(Tensor *A, Tensor *values, Tensor *indices, int axis, int k, bool largest, bool sorted) {
+    int n = A->shape[axis];
+    long int inner = A->stride[axis];
+    long int outer = A->size / (inner * n);
+    long int rows = outer * inner;
+    // Rows along other axes than the last one are strided: copy them first. Also when sorting in place
+    bool gather = (inner != 1) || (values == A) || (indices == A);
+
+    #pragma omp parallel
+    {
+        vector<float> buffer(gather ? n : 0);
+        vector<int> idx;
+
+        #pragma omp for
+        for (long int r = 0; r < rows; r++) {
+            long int o = r / inner;
+            long int in = r % inner;
+            const float *src = A->ptr + o * n * inner + in;
+            const float *v = src;
+            if (gather) {
+                for (int j = 0; j < n; j++) buffer[j] = src[j * inner];
+                v = buffer.data();
+            }
+
+            if (largest) {
+                topk_row(v, n, k, largest, sorted, [v](int a, int b) { return v[a] > v[b] || (v[a] == v[b] && a < b); }, idx);
+            } else {
+                topk_row(v, n, k, largest, sorted, [v](int a, int b) { return v[a] < v[b] || (v[a] == v[b] && a < b); }, idx);
+            }
+
+            long int dst = o * k * inner + in;
+            for (int i = 0; i < k; i++) {
+                if (values != nullptr) values->ptr[dst + i * inner] = v[idx[i]];
+                if (indices != nullptr) indices->ptr[dst + i * inner] = (float)idx[i];
+            }
+        }
     }
 }
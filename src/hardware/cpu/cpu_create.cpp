@@ -24,7 +24,7 @@ void cpu_range(Tensor *A, float min, float step){
 
 void cpu_eye(Tensor *A, int offset){
     _profile(_CPU_EYE, 0);
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(unsigned long int i=0; i<A->size; i++){
         if ((i/A->shape[0]+offset) == i%A->shape[1]){ A->ptr[i] = 1.0f; }  // rows+offset == col?
         else { A->ptr[i] = 0.0f; }
@@ -33,7 +33,7 @@ void cpu_eye(Tensor *A, int offset){
 }
 
 void cpu_diag(Tensor *A, Tensor *B, int k){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(unsigned long int i=0; i<A->size; i++){
         if ((i/A->shape[0]+k) == i%A->shape[1]){ B->ptr[i] = A->ptr[i]; }  // rows+offset == col?
         else { B->ptr[i] = 0.0f; }
@@ -0,0 +1,82 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <algorithm>
+#include <omp.h>
+
+#include "eddl/hardware/cpu/cpu_fastmath.h"
+#include "eddl/hardware/cpu/cpu_parallel.h"
+
+// Runtime dispatch: GCC builds one clone per target and picks the best one when the library is loaded
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define FASTMATH_CLONES __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#else
+#define FASTMATH_CLONES
+#endif
+
+
+FASTMATH_CLONES
+static void exp_kernel(const float *x, float *y, long int n) {
+    #pragma omp simd
+    for (long int i = 0; i < n; i++) y[i] = fast_expf(x[i]);
+}
+
+FASTMATH_CLONES
+static void log_kernel(const float *x, float *y, long int n) {
+    #pragma omp simd
+    for (long int i = 0; i < n; i++) y[i] = fast_logf(x[i]);
+}
+
+FASTMATH_CLONES
+static void tanh_kernel(const float *x, float *y, long int n) {
+    #pragma omp simd
+    for (long int i = 0; i < n; i++) y[i] = fast_tanhf(x[i]);
+}
+
+FASTMATH_CLONES
+static void sigmoid_kernel(const float *x, float *y, long int n) {
+    #pragma omp simd
+    for (long int i = 0; i < n; i++) y[i] = fast_sigmoidf(x[i]);
+}
+
+
+// Contiguous chunk per thread (the kernels are serial, so each chunk keeps the SIMD clone)
+static void run_chunks(void (*kernel)(const float *, float *, long int), const float *x, float *y, long int n) {
+    int threads = cpu_threads(n, CPU_COST_MEDIUM);
+    if (threads <= 1) {
+        kernel(x, y, n);
+        return;
+    }
+
+    #pragma omp parallel num_threads(threads)
+    {
+        int t = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+        long int chunk = (n + nt - 1) / nt;
+        long int begin = t * chunk;
+        long int end = std::min(n, begin + chunk);
+        if (begin < end) kernel(x + begin, y + begin, end - begin);
+    }
+}
+
+void cpu_fast_exp(const float *x, float *y, long int n) {
+    run_chunks(exp_kernel, x, y, n);
+}
+
+void cpu_fast_log(const float *x, float *y, long int n) {
+    run_chunks(log_kernel, x, y, n);
+}
+
+void cpu_fast_tanh(const float *x, float *y, long int n) {
+    run_chunks(tanh_kernel, x, y, n);
+}
+
+void cpu_fast_sigmoid(const float *x, float *y, long int n) {
+    run_chunks(sigmoid_kernel, x, y, n);
+}
@@ -18,7 +18,7 @@ std::pair<unsigned int*, int> cpu_nonzero(Tensor *A){
     auto* indices = new unsigned long int[A->size];
     unsigned int size = 0;
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
 
         if (A->ptr[i] != 0.0f){
@@ -39,7 +39,7 @@ std::pair<unsigned int*, int> cpu_nonzero(Tensor *A){
 
 
 void cpu_where(Tensor *condition, Tensor *A, Tensor *B, Tensor *C){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         if((bool) condition->ptr[i]){
             C->ptr[i] = A->ptr[i];
@@ -50,7 +50,7 @@ void cpu_where(Tensor *condition, Tensor *A, Tensor *B, Tensor *C){
 }
 
 void cpu_where_back(Tensor *condition, Tensor *PD_A, Tensor *PD_B, Tensor *D){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(PD_A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < PD_A->size; ++i){
         if((bool) condition->ptr[i]){
             PD_A->ptr[i] += D->ptr[i];
@@ -24,7 +24,7 @@ float cpu_norm(Tensor *A, string ord){
 
 
 void cpu_norm(Tensor *A, Tensor *B, ReduceDescriptor2 *rd, string ord){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = cpu_norm_(A->ptr, rd->index[i].size(), rd->index[i].data(), ord);
     }
@@ -37,10 +37,10 @@ float cpu_norm_(float *ptr, int size, int *map, string ord){
 
         // TODO: I don't like this approach
         if(map == nullptr){
-            #pragma omp parallel for reduction(+:norm)
+            #pragma omp parallel for reduction(+:norm) num_threads(cpu_threads(size, CPU_COST_HEAVY))
             for (int i = 0; i < size; ++i){ norm += ::pow(ptr[i], 2); }  // Compiler trick: pow(x,2) == x*x
         }else{
-            #pragma omp parallel for reduction(+:norm)
+            #pragma omp parallel for reduction(+:norm) num_threads(cpu_threads(size, CPU_COST_HEAVY))
             for (int i = 0; i < size; ++i){ norm += ::pow(ptr[map[i]], 2); }
         }
 
@@ -14,12 +14,12 @@
 // CPU: Math (in-place) ********************************************
 
 void cpu_abs(Tensor *A, Tensor *B) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::fabs(A->ptr[i]);
 }
 
 void cpu_acos(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::acosf(A->ptr[i]);
 }
 
@@ -28,7 +28,7 @@ void cpu_add(Tensor *A, Tensor *B, float v) {
         printf("cpu_add (v = %f)\n", v);
         _profile_cpu_tensor(A);
 #endif
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = A->ptr[i] + v;
 
 #ifdef CPU_DEBUG
@@ -38,22 +38,22 @@ void cpu_add(Tensor *A, Tensor *B, float v) {
 
 
 void cpu_asin(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::asinf(A->ptr[i]);
 }
 
 void cpu_atan(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::atanf(A->ptr[i]);
 }
 
 void cpu_ceil(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::ceilf(A->ptr[i]);
 }
 
 void cpu_clamp(Tensor *A, Tensor *B, float min, float max){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i){
         if (A->ptr[i] < min){ B->ptr[i] = min; }
         else if(A->ptr[i] > max){ B->ptr[i] = max; }
@@ -89,7 +89,7 @@ void cpu_clamp(Tensor *A, Tensor *B, float min, float max){
 }
 
 void cpu_d_clamp(Tensor *D, Tensor *I, Tensor *PD, float min, float max){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < D->size; ++i){
         if (I->ptr[i] < min || I->ptr[i] > max){ PD->ptr[i] += 0.0f; }
         else{ PD->ptr[i] += D->ptr[i]; }  // * 1.0f
@@ -97,53 +97,53 @@ void cpu_d_clamp(Tensor *D, Tensor *I, Tensor *PD, float min, float max){
 }
 
 void cpu_cos(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::cosf(A->ptr[i]);
 }
 
 void cpu_cosh(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::coshf(A->ptr[i]);
 }
 
 void cpu_exp(Tensor *A, Tensor *B) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::expf(A->ptr[i]);
 }
 
 void cpu_floor(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::floorf(A->ptr[i]);
 }
 
 void cpu_inv(Tensor *A, Tensor *B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = v/A->ptr[i];
 }
 
 void cpu_log(Tensor *A, Tensor *B) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::logf(A->ptr[i]);
 }
 
 void cpu_log2(Tensor *A, Tensor *B) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::log2f(A->ptr[i]);
 }
 
 void cpu_log10(Tensor *A, Tensor *B) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::log10f(A->ptr[i]);
 }
 
 void cpu_logn(Tensor *A, Tensor *B, float n) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::logf(A->ptr[i])/::logf(n);
 }
 
 
 void cpu_mod(Tensor *A, Tensor *B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::fmod(A->ptr[i], v);
 }
 
@@ -153,7 +153,7 @@ void cpu_mult(Tensor *A, Tensor *B, float v) {
 	_profile_cpu_tensor(A);
 #endif
         
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = A->ptr[i] * v;
 #ifdef CPU_DEBUG
     _profile_cpu_tensor(B);
@@ -166,7 +166,7 @@ void cpu_normalize(Tensor *A, Tensor *B, float min, float max){
     float max_ori = A->max();
     float min_ori = A->min();
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) {
         B->ptr[i] = (max-min)/(max_ori-min_ori) * (A->ptr[i]-min_ori) + min;
     }
@@ -176,37 +176,37 @@ void cpu_pow(Tensor *A, Tensor *B, float exp) {
     // To compute the power, std uses real floating-point number with the formurla: e^(y*log_(x))
     // Quite inefficient (x100 slower) in g++ except for pow_(x, 2) which is inlined as x*x
     // speed: 0.057887s
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::powf(A->ptr[i], exp);
 }
 
 void cpu_powb(Tensor *A, Tensor *B, float base) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::powf(base, A->ptr[i]);
 }
 
 void cpu_remainder(Tensor *A, Tensor *B, float v) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = fmod((v + fmod(A->ptr[i], v)), v);
 }
 
 void cpu_round(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::roundf(A->ptr[i]);
 }
 
 void cpu_rsqrt(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = 1.0f/::sqrtf(A->ptr[i]);
 }
 
 void cpu_sigmoid(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = 1.0f/(1.0f + ::expf(-A->ptr[i]));
 }
 
 void cpu_sign(Tensor *A, Tensor *B, float zero_sign){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) {
         if(A->ptr[i] > 0.0f){
             B->ptr[i] = 1.0f;
@@ -220,24 +220,24 @@ void cpu_sign(Tensor *A, Tensor *B, float zero_sign){
 
 
 void cpu_sin(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::sinf(A->ptr[i]);
 }
 
 void cpu_sinh(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::sinhf(A->ptr[i]);
 }
 
 void cpu_sqr(Tensor *A, Tensor *B) {
     // pow(x, 2) == x*x  To know more, read comments in pow_'s function
     // speed: 0.000497s
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = A->ptr[i] * A->ptr[i];
 }
 
 void cpu_sqrt(Tensor *A, Tensor *B) {
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::sqrtf(A->ptr[i]);
 }
 
@@ -254,7 +254,7 @@ void cpu_tan(Tensor *A, Tensor *B){
 }
 
 void cpu_tanh(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::tanhf(A->ptr[i]);
 }
 
@@ -263,7 +263,7 @@ void cpu_trunc(Tensor *A, Tensor *B){
     printf("cpu_trunc\n");
     _profile_cpu_tensor(A);
 #endif
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; ++i) B->ptr[i] = ::truncf(A->ptr[i]);
 
 #ifdef CPU_DEBUG
@@ -282,7 +282,7 @@ void cpu_add(float scA, Tensor *A, float scB, Tensor *B, Tensor *C, int incC) {
         printf(" input A : "); _profile_cpu_tensor(A);
         printf(" input B : "); _profile_cpu_tensor(B);
 #endif
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; i++)
         if (incC) C->ptr[i] += scA * A->ptr[i] + scB * B->ptr[i];
         else C->ptr[i] = scA * A->ptr[i] + scB * B->ptr[i];
@@ -292,7 +292,7 @@ void cpu_add(float scA, Tensor *A, float scB, Tensor *B, Tensor *C, int incC) {
 void cpu_inc(Tensor *A, Tensor *B) {
 
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; i++){
         B->ptr[i] += A->ptr[i];
     }
@@ -329,7 +329,7 @@ void cpu_mult2D(Tensor *A, int tA, Tensor *B, int tB, Tensor *C, int incC) {
 }
 
 void cpu_el_div(Tensor *A, Tensor *B, Tensor *C, int incC) {
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < A->size; i++)
         if (incC) C->ptr[i] += A->ptr[i] / B->ptr[i];
         else C->ptr[i] = A->ptr[i] / B->ptr[i];
@@ -342,7 +342,7 @@ void cpu_el_mult(Tensor *A, Tensor *B, Tensor *C, int incC) {
   _profile_cpu_tensor(A);
   _profile_cpu_tensor(B);
 #endif
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; i++)
         if (incC) C->ptr[i] += A->ptr[i] * B->ptr[i];
         else C->ptr[i] = A->ptr[i] * B->ptr[i];
@@ -358,7 +358,7 @@ void cpu_sum2D_rowwise(Tensor *A, Tensor *B, Tensor *C) {
         printf(" input A : "); _profile_cpu_tensor(A);
         printf(" input B : "); _profile_cpu_tensor(B);
 #endif
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->shape[0]; i++) {
         int p=i*A->shape[1];
         for (int j = 0; j < A->shape[1]; j++, p++)
@@ -371,7 +371,7 @@ void cpu_sum2D_rowwise(Tensor *A, Tensor *B, Tensor *C) {
 
 void cpu_sum2D_colwise(Tensor *A, Tensor *B, Tensor *C) {
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->shape[0]; i++) {
         int p=i*A->shape[1];
         for (int j = 0; j < A->shape[1]; j++, p++)
@@ -381,28 +381,28 @@ void cpu_sum2D_colwise(Tensor *A, Tensor *B, Tensor *C) {
 
 
 void cpu_maximum(Tensor* A, Tensor* B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i) {
         B->ptr[i] = ::max(A->ptr[i], v);
     }
 }
 
 void cpu_maximum(Tensor* A, Tensor* B, Tensor* C){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i) {
         C->ptr[i] = ::max(A->ptr[i], B->ptr[i]);
     }
 }
 
 void cpu_minimum(Tensor* A, Tensor* B, float v){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i) {
         B->ptr[i] = ::min(A->ptr[i], v);
     }
 }
 
 void cpu_minimum(Tensor* A, Tensor* B, Tensor* C){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (unsigned long int i = 0; i < A->size; ++i) {
         C->ptr[i] = ::min(A->ptr[i], B->ptr[i]);
     }
@@ -419,7 +419,7 @@ float cpu_max(Tensor *A) {
 
 
 void cpu_max(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(int i=0; i<rd->index.size(); i++){
         auto t = cpu_max(A->ptr, rd->index[i].size(), rd->index[i].data());
         B->ptr[i] = std::get<0>(t);  // get max
@@ -433,7 +433,7 @@ int cpu_argmax(Tensor *A) {
 
 
 void cpu_argmax(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(int i=0; i<rd->index.size(); i++){
         auto t = cpu_max(A->ptr, rd->index[i].size(), rd->index[i].data());
         B->ptr[i] = std::get<1>(t);  // get argmax
@@ -442,7 +442,7 @@ void cpu_argmax(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
 
 void cpu_argmax_d(Tensor *D, Tensor *O, Tensor *PD){
     int reduction_size = PD->size/D->size;
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_MEDIUM))
     for (unsigned long int i = 0; i < D->size; i++){
         int argmax = (int)O->ptr[i];  // local
         int offset = i*reduction_size;
@@ -455,7 +455,7 @@ std::tuple<float, int> cpu_max(float *ptr, int size, int *map) {
     float shared_max = MIN_FLOAT;
     int shared_argmax = 0;
 
-    #pragma omp parallel
+    #pragma omp parallel num_threads(cpu_threads(size, CPU_COST_CHEAP))
     {
         float max = MIN_FLOAT;
         int argmax = 0;
@@ -481,7 +481,7 @@ std::tuple<float, int> cpu_max(float *ptr, int size, int *map) {
 
         #pragma omp critical
         {
-            if(max>shared_max){
+            if(max>shared_max || (max==shared_max && argmax<shared_argmax)){  // Ties: first index, as the serial loop
                 shared_max = max;
                 shared_argmax = argmax;
             }
@@ -499,7 +499,7 @@ float cpu_min(Tensor *A) {
 
 
 void cpu_min(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(int i=0; i<rd->index.size(); i++){
         auto t = cpu_min(A->ptr, rd->index[i].size(), rd->index[i].data());
         B->ptr[i] = std::get<0>(t);  // get min
@@ -514,7 +514,7 @@ int cpu_argmin(Tensor *A) {
 
 
 void cpu_argmin(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(int i=0; i<rd->index.size(); i++){
         auto t = cpu_min(A->ptr, rd->index[i].size(), rd->index[i].data());
         B->ptr[i] = std::get<1>(t);  // get argmmin
@@ -526,7 +526,7 @@ std::tuple<float, int> cpu_min(float *ptr, int size, int *map) {
     float shared_min = MAX_FLOAT;
     int shared_argmin = 0;
 
-    #pragma omp parallel
+    #pragma omp parallel num_threads(cpu_threads(size, CPU_COST_CHEAP))
     {
         float min = MAX_FLOAT;
         int argmin = 0;
@@ -552,7 +552,7 @@ std::tuple<float, int> cpu_min(float *ptr, int size, int *map) {
 
         #pragma omp critical
         {
-            if(min<shared_min){
+            if(min<shared_min || (min==shared_min && argmin<shared_argmin)){  // Ties: first index, as the serial loop
                 shared_min = min;
                 shared_argmin = argmin;
             }
@@ -570,7 +570,7 @@ float cpu_sum(Tensor *A) {
 
 
 void cpu_sum(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = cpu_sum(A->ptr, rd->index[i].size(), rd->index[i].data());
     }
@@ -581,10 +581,10 @@ float cpu_sum(float *ptr, int size, int *map) {
 
     // TODO: I don't like this approach
     if(map == nullptr){
-        #pragma omp parallel for reduction(+:sum)
+        #pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) { sum += ptr[i]; }
     }else{
-        #pragma omp parallel for reduction(+:sum)
+        #pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) { sum += ptr[map[i]]; }
     }
 
@@ -598,7 +598,7 @@ float cpu_sum_abs(Tensor *A) {
 
 
 void cpu_sum_abs(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = cpu_sum_abs(A->ptr, rd->index[i].size(), rd->index[i].data());
     }
@@ -609,10 +609,10 @@ float cpu_sum_abs(float *ptr, int size, int *map) {
 
     // TODO: I don't like this approach
     if(map == nullptr){
-#pragma omp parallel for reduction(+:sum)
+#pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) { sum += ::fabs(ptr[i]); }
     }else{
-#pragma omp parallel for reduction(+:sum)
+#pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) { sum += ::fabs(ptr[map[i]]); }
     }
 
@@ -626,7 +626,7 @@ float cpu_prod(Tensor *A) {
 
 
 void cpu_prod(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = cpu_prod(A->ptr, rd->index[i].size(), rd->index[i].data());
     }
@@ -637,10 +637,10 @@ float cpu_prod(float *ptr, int size, int *map) {
 
     // TODO: I don't like this approach
     if(map == nullptr){
-#pragma omp parallel for reduction(*:prod)
+#pragma omp parallel for reduction(*:prod) num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) { prod *= ptr[i]; }
     }else{
-#pragma omp parallel for reduction(*:prod)
+#pragma omp parallel for reduction(*:prod) num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) { prod *= ptr[map[i]]; }
     }
 
@@ -653,7 +653,7 @@ float cpu_mean(Tensor *A) {
 
 
 void cpu_mean(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = cpu_sum(A->ptr, rd->index[i].size(), rd->index[i].data()) / rd->index[i].size();
     }
@@ -666,7 +666,7 @@ float cpu_var(Tensor *A, bool unbiased){
 
 
 void cpu_var(Tensor *A, Tensor *B, ReduceDescriptor2 *rd, bool unbiased){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = cpu_var(A->ptr, rd->index[i].size(), rd->index[i].data(), unbiased);
     }
@@ -677,13 +677,13 @@ float cpu_var(float *ptr, int size, int *map, bool unbiased){
     float sum = 0.0f;
 
     if(map == nullptr) {
-        #pragma omp parallel for reduction(+:sum)
+        #pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) {
             float tmp = ptr[i] - mean;
             sum += tmp * tmp;
         }
     }else{
-        #pragma omp parallel for reduction(+:sum)
+        #pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) {
             float tmp = ptr[map[i]] - mean;
             sum += tmp * tmp;
@@ -699,7 +699,7 @@ float cpu_std(Tensor *A, bool unbiased) {
 }
 
 void cpu_std(Tensor *A, Tensor *B, ReduceDescriptor2 *rd, bool unbiased){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = ::sqrtf(cpu_var(A->ptr, rd->index[i].size(), rd->index[i].data(), unbiased));
     }
@@ -712,7 +712,7 @@ int cpu_mode(Tensor *A) {
 
 
 void cpu_mode(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = cpu_mode(A->ptr, rd->index[i].size(), rd->index[i].data());
     }
@@ -749,7 +749,7 @@ float cpu_median(Tensor *A) {
 
 
 void cpu_median(Tensor *A, Tensor *B, ReduceDescriptor2 *rd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
     for(int i=0; i<rd->index.size(); i++){
         B->ptr[i] = cpu_median(A->ptr, rd->index[i].size(), rd->index[i].data());
     }
@@ -761,10 +761,10 @@ float cpu_median(float *ptr, int size, int *map) {
 
     // Copy data
     if(map == nullptr){
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads(size, CPU_COST_CHEAP))
         for (int i = 0; i < size; ++i) { sorted_data[i] = ptr[i]; }
     }else{
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads(size, CPU_COST_MEDIUM))
         for (int i = 0; i < size; ++i) { sorted_data[i] = ptr[map[i]]; }
     }
 
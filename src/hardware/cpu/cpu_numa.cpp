@@ -0,0 +1,170 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <omp.h>
+
+#include "eddl/hardware/cpu/cpu_numa.h"
+#include "eddl/hardware/cpu/cpu_parallel.h"
+#include "eddl/utils.h"
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define NUMA_MPOL_INTERLEAVE 3
+#define NUMA_MPOL_MF_MOVE (1 << 1)
+#endif
+
+#define NUMA_FIRST_TOUCH_MIN 65536  // Floats. Smaller buffers are not worth a parallel region
+
+static std::atomic<int> first_touch(0);  // Users, see cpu_numa_first_touch_acquire
+
+
+// "0-3,8,10-11" => {0, 1, 2, 3, 8, 10, 11}
+static vector<int> parse_list(const string &s) {
+    vector<int> v;
+    std::stringstream ss(s);
+    string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        size_t dash = item.find('-');
+        int a = std::stoi(item.substr(0, dash));
+        int b = dash == string::npos ? a : std::stoi(item.substr(dash + 1));
+        for (int i = a; i <= b; i++) v.push_back(i);
+    }
+    return v;
+}
+
+static string read_line(const string &path) {
+    std::ifstream ifs(path);
+    string line;
+    if (ifs.good()) std::getline(ifs, line);
+    return line;
+}
+
+static vector<vector<int>> discover_topology() {
+    vector<int> allowed;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; c++)
+            if (CPU_ISSET(c, &set)) allowed.push_back(c);
+    }
+#endif
+    if (allowed.empty()) {
+        int n = std::max(1, (int)std::thread::hardware_concurrency());
+        for (int c = 0; c < n; c++) allowed.push_back(c);
+    }
+
+    vector<vector<int>> topology;
+#if defined(__linux__)
+    try {
+        for (int node : parse_list(read_line("/sys/devices/system/node/online"))) {
+            vector<int> cpus;
+            for (int c : parse_list(read_line("/sys/devices/system/node/node" + to_string(node) + "/cpulist")))
+                if (std::find(allowed.begin(), allowed.end(), c) != allowed.end()) cpus.push_back(c);
+            if (!cpus.empty()) topology.push_back(cpus);
+        }
+    } catch (std::exception &e) {
+        topology.clear();  // Unexpected format
+    }
+#endif
+    if (topology.empty()) topology.push_back(allowed);
+    return topology;
+}
+
+const vector<vector<int>> &cpu_numa_topology() {
+    // Taken once: after pinning, the affinity of the main thread is a single CPU
+    static const vector<vector<int>> topology = discover_topology();
+    return topology;
+}
+
+vector<int> cpu_affinity_order(const vector<vector<int>> &topology, const string &policy) {
+    vector<int> order;
+    if (policy == "close") {
+        for (auto &node : topology) order.insert(order.end(), node.begin(), node.end());
+    } else if (policy == "spread") {
+        size_t longest = 0;
+        for (auto &node : topology) longest = std::max(longest, node.size());
+        for (size_t i = 0; i < longest; i++)
+            for (auto &node : topology)
+                if (i < node.size()) order.push_back(node[i]);
+    } else {
+        msg("Unknown affinity policy '" + policy + "'. Use \"close\" or \"spread\"", "cpu_affinity_order");
+    }
+    return order;
+}
+
+bool cpu_pin_threads(const string &policy) {
+    vector<int> order = cpu_affinity_order(cpu_numa_topology(), policy);
+    bool ok = true;
+#if defined(__linux__)
+    #pragma omp parallel reduction(&&:ok)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(order[omp_get_thread_num() % order.size()], &set);
+        ok = sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+#else
+    ok = false;
+#endif
+    return ok;
+}
+
+bool cpu_numa_interleave(void *ptr, size_t size) {
+#if defined(__linux__)
+    const vector<vector<int>> &topology = cpu_numa_topology();
+    if (ptr == nullptr || topology.size() < 2) return topology.size() == 1;  // Nothing to do with a single node
+
+    // mbind works on whole pages: leave out the partial pages of both ends
+    long page = sysconf(_SC_PAGESIZE);
+    uintptr_t begin = ((uintptr_t)ptr + page - 1) / page * page;
+    uintptr_t end = ((uintptr_t)ptr + size) / page * page;
+    if (end <= begin) return true;
+
+    vector<int> nodes = parse_list(read_line("/sys/devices/system/node/online"));
+    int max_node = nodes.empty() ? 0 : *std::max_element(nodes.begin(), nodes.end());
+    vector<unsigned long> mask(max_node / (8 * sizeof(unsigned long)) + 1, 0);
+    for (int n : nodes) mask[n / (8 * sizeof(unsigned long))] |= 1UL << (n % (8 * sizeof(unsigned long)));
+
+    long r = syscall(SYS_mbind, (void *)begin, (unsigned long)(end - begin), NUMA_MPOL_INTERLEAVE,
+                     mask.data(), (unsigned long)(mask.size() * 8 * sizeof(unsigned long) + 1), NUMA_MPOL_MF_MOVE);
+    return r == 0;
+#else
+    return false;
+#endif
+}
+
+void cpu_numa_first_touch_acquire() {
+    first_touch++;
+}
+
+void cpu_numa_first_touch_release() {
+    if (--first_touch < 0) msg("Unbalanced release", "cpu_numa_first_touch_release");
+}
+
+bool cpu_numa_first_touch_enabled() {
+    return first_touch > 0;
+}
+
+void cpu_numa_first_touch(float *ptr, long int n) {
+    if (first_touch <= 0 || ptr == nullptr || n < NUMA_FIRST_TOUCH_MIN) return;
+    // Same threads and chunks as the elementwise kernels on a tensor of this size
+    #pragma omp parallel for schedule(static) num_threads(cpu_threads(n, CPU_COST_CHEAP))
+    for (long int i = 0; i < n; i++) ptr[i] = 0.0f;
+}
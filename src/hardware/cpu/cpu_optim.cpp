@@ -0,0 +1,98 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cmath>
+
+#include "eddl/hardware/cpu/cpu_optim.h"
+#include "eddl/hardware/cpu/cpu_tensor.h"
+
+
+// Norms are reduced in double: layers can have millions of weights
+static float trust_ratio(double num, double den) {
+    return (num > 0.0 && den > 0.0) ? (float)(num / den) : 1.0f;
+}
+
+void cpu_lars_update(Tensor *W, Tensor *G, Tensor *V, Tensor *ACC, float lr, float mu, float weight_decay,
+                     float eta, float epsilon, bool adapt) {
+    float *w = W->ptr, *g = G->ptr, *v = V->ptr;
+    float *acc = ACC != nullptr ? ACC->ptr : nullptr;
+    long int size = W->size;
+    int threads = cpu_threads(size, CPU_COST_CHEAP);
+
+    float wd = adapt ? weight_decay : 0.0f;
+    float ratio = 1.0f;
+    if (adapt) {
+        double w2 = 0.0, g2 = 0.0;
+        #pragma omp parallel for simd reduction(+:w2, g2) num_threads(threads)
+        for (long int i = 0; i < size; i++) {
+            w2 += (double)w[i] * w[i];
+            g2 += (double)g[i] * g[i];
+        }
+        double wn = std::sqrt(w2), gn = std::sqrt(g2);
+        ratio = gn > 0.0 ? trust_ratio(eta * wn, gn + wd * wn + epsilon) : 1.0f;
+    }
+
+    float step = lr * ratio;
+    #pragma omp parallel for simd num_threads(threads)
+    for (long int i = 0; i < size; i++) {
+        float vi = mu * v[i] + step * (g[i] + wd * w[i]);
+        v[i] = vi;
+        w[i] -= vi;
+        if (acc != nullptr) acc[i] -= vi;
+    }
+}
+
+void cpu_lamb_update(Tensor *W, Tensor *G, Tensor *M, Tensor *V, Tensor *U, Tensor *ACC, float lr, float beta_1,
+                     float beta_2, float epsilon, float weight_decay, long t, bool adapt) {
+    float *w = W->ptr, *g = G->ptr, *m = M->ptr, *v = V->ptr, *u = U->ptr;
+    float *acc = ACC != nullptr ? ACC->ptr : nullptr;
+    long int size = W->size;
+    int threads = cpu_threads(size, CPU_COST_MEDIUM);
+
+    float wd = adapt ? weight_decay : 0.0f;
+    float c1 = 1.0f / (1.0f - std::pow(beta_1, (float)t));
+    float c2 = 1.0f / (1.0f - std::pow(beta_2, (float)t));
+
+    double w2 = 0.0, u2 = 0.0;
+    #pragma omp parallel for simd reduction(+:w2, u2) num_threads(threads)
+    for (long int i = 0; i < size; i++) {
+        float mi = beta_1 * m[i] + (1.0f - beta_1) * g[i];
+        float vi = beta_2 * v[i] + (1.0f - beta_2) * g[i] * g[i];
+        m[i] = mi;
+        v[i] = vi;
+        float ui = (mi * c1) / (std::sqrt(vi * c2) + epsilon) + wd * w[i];
+        u[i] = ui;
+        w2 += (double)w[i] * w[i];
+        u2 += (double)ui * ui;
+    }
+
+    float step = lr * (adapt ? trust_ratio(std::sqrt(w2), std::sqrt(u2)) : 1.0f);
+    #pragma omp parallel for simd num_threads(threads)
+    for (long int i = 0; i < size; i++) {
+        w[i] -= step * u[i];
+        if (acc != nullptr) acc[i] -= step * u[i];
+    }
+}
+
+void cpu_adam_update(float *w, const float *g, float *m, float *v, float *acc, long int size, float lr, float beta_1,
+                     float beta_2, float epsilon, long t) {
+    float d1 = 1.0f - std::pow(beta_1, (float)t);
+    float d2 = 1.0f - std::pow(beta_2, (float)t);
+
+    #pragma omp parallel for simd num_threads(cpu_threads(size, CPU_COST_MEDIUM))
+    for (long int i = 0; i < size; i++) {
+        float mi = beta_1 * m[i] + (1.0f - beta_1) * g[i];
+        float vi = beta_2 * v[i] + (1.0f - beta_2) * (g[i] * g[i]);
+        m[i] = mi;
+        v[i] = vi;
+        float step = lr * ((mi / d1) / std::sqrt(vi / d2 + epsilon));
+        w[i] -= step;
+        if (acc != nullptr) acc[i] -= step;
+    }
+}
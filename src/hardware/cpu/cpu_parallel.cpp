@@ -0,0 +1,93 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#include "eddl/hardware/cpu/cpu_parallel.h"
+#include "eddl/utils.h"
+
+static long int grain_from_env() {
+    const char *s = std::getenv("EDDL_CPU_GRAIN");
+    if (s == nullptr || *s == '\0') return CPU_GRAIN_DEFAULT;
+    if (std::strcmp(s, "auto") == 0) return -1;  // Calibrated after the static initialization
+    long int g = std::atol(s);
+    return g > 0 ? g : CPU_GRAIN_DEFAULT;
+}
+
+long int cpu_grain = CPU_GRAIN_DEFAULT;
+
+static struct GrainInit {
+    GrainInit() {
+        long int g = grain_from_env();
+        if (g < 0) cpu_calibrate_grain();
+        else cpu_grain = g;
+    }
+} grain_init;
+
+
+int cpu_threads(long int n, int cost) {
+    long int t = (n * cost) / cpu_grain;
+    if (t < 2) return 1;
+    int max_threads = omp_get_max_threads();
+    return t < max_threads ? (int)t : max_threads;
+}
+
+int cpu_set_threads(int threads) {
+    if (threads <= 0) msg("Threads must be > 0", "cpu_set_threads");
+    int previous = omp_get_max_threads();
+    omp_set_num_threads(threads);
+    return previous;
+}
+
+void cpu_set_grain(long int grain) {
+    if (grain <= 0) msg("The grain must be > 0", "cpu_set_grain");
+    cpu_grain = grain;
+}
+
+static double best_of(int reps, const std::function<void()> &f) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return best;
+}
+
+long int cpu_calibrate_grain() {
+    const int reps = 50;
+    const long int n = 1 << 16;
+    std::vector<float> a(n, 1.0f), b(n, 0.0f);
+    float *pa = a.data(), *pb = b.data();
+
+    // Fork/join of the full team (an empty region still synchronizes every thread)
+    volatile int sink = 0;
+    double fork = best_of(reps, [&]{
+        #pragma omp parallel
+        { if (omp_get_thread_num() == 0) sink = sink + 1; }
+    });
+
+    // Serial cheap elementwise operation
+    double elem = best_of(reps, [&]{
+        for (long int i = 0; i < n; i++) pb[i] = pa[i] * 2.0f + 1.0f;
+    }) / (double)n;
+
+    long int g = CPU_GRAIN_DEFAULT;
+    if (elem > 0.0) g = (long int)(10.0 * fork / elem);
+    cpu_grain = std::max(1024L, std::min(g, 1L << 22));
+    return cpu_grain;
+}
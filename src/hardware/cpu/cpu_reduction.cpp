@@ -54,22 +54,22 @@ void cpu_reduce_op(Tensor *A, Tensor *B,string op,int* map)
   int s=A->size/B->size;
 
   if (op=="sum") {
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for(unsigned long i=0;i<A->size;i++)
       B->ptr[map[i]]+=A->ptr[i];
   }
   else if (op=="diff"){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for(unsigned long i=0;i<A->size;i++)
       B->ptr[map[i]]-=A->ptr[i];
   }
   else if (op=="mult"){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for(unsigned long i=0;i<A->size;i++)
       B->ptr[map[i]]*=A->ptr[i];
   }
   else if (op=="div"){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(unsigned long i=0;i<A->size;i++)
       B->ptr[map[i]]/=A->ptr[i];
   }
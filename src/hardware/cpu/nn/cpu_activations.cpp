@@ -14,6 +14,7 @@
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 #include "eddl/hardware/cpu/cpu_tensor.h"
+#include "eddl/hardware/cpu/cpu_fastmath.h"
 
 void cpu_relu(Tensor *A, Tensor *B){
 #ifdef CPU_DEBUG
@@ -21,7 +22,7 @@ void cpu_relu(Tensor *A, Tensor *B){
     _profile_cpu_tensor(A);
 #endif  
     _profile(_CPU_RELU, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (int i = 0; i < A->size; i++) {
         if (A->ptr[i] > 0.0) B->ptr[i] = A->ptr[i];
         else B->ptr[i] = 0.0;
@@ -34,7 +35,7 @@ void cpu_relu(Tensor *A, Tensor *B){
 
 void cpu_d_relu(Tensor *D, Tensor *I, Tensor *PD){
     _profile(_CPU_D_RELU, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++) {
         if (I->ptr[i] > 0.0) PD->ptr[i] += D->ptr[i];
         else PD->ptr[i] += 0.0;
@@ -44,7 +45,7 @@ void cpu_d_relu(Tensor *D, Tensor *I, Tensor *PD){
 
 void cpu_thresholded_relu(Tensor *A, Tensor *B,float param){
     _profile(_CPU_THRESHOLDED_RELU, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (int i = 0; i < A->size; i++) {
         if (A->ptr[i] > param) B->ptr[i] = A->ptr[i];
         else B->ptr[i] = 0.0;
@@ -54,7 +55,7 @@ void cpu_thresholded_relu(Tensor *A, Tensor *B,float param){
 
 void cpu_d_thresholded_relu(Tensor *D, Tensor *I, Tensor *PD,float param){
     _profile(_CPU_D_THRESHOLDED_RELU, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++) {
         if (I->ptr[i] > param) PD->ptr[i] += D->ptr[i];
         else PD->ptr[i] += 0.0;
@@ -70,7 +71,7 @@ void cpu_leaky_relu(Tensor *A, Tensor *B,float param){
     printf(" input   : "); _profile_cpu_tensor(A);
 #endif
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (int i = 0; i < A->size; i++) {
         if (A->ptr[i] > 0.0) B->ptr[i] = A->ptr[i];
         else B->ptr[i] = param*A->ptr[i];;
@@ -84,7 +85,7 @@ void cpu_leaky_relu(Tensor *A, Tensor *B,float param){
 
 void cpu_d_leaky_relu(Tensor *D, Tensor *I, Tensor *PD,float param){
     _profile(_CPU_D_LEAKY_RELU, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++) {
         if (I->ptr[i] > 0.0) PD->ptr[i] += D->ptr[i];
         else PD->ptr[i] += param*D->ptr[i];
@@ -94,20 +95,20 @@ void cpu_d_leaky_relu(Tensor *D, Tensor *I, Tensor *PD,float param){
 
 void cpu_elu(Tensor *A, Tensor *B, float param){
     _profile(_CPU_ELU, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (int i = 0; i < A->size; i++) {
         if (A->ptr[i] > 0.0) B->ptr[i] = A->ptr[i];
-        else B->ptr[i] = param * (::expf(A->ptr[i]) - 1.0);
+        else B->ptr[i] = param * (fast_expf(A->ptr[i]) - 1.0f);
     }
     _profile(_CPU_ELU, 1);
 }
 
 void cpu_d_elu(Tensor *D, Tensor *I, Tensor *PD, float param){
     _profile(_CPU_D_ELU, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_MEDIUM))
     for (int i = 0; i < D->size; i++) {
         if (I->ptr[i] > 0.0) PD->ptr[i] += D->ptr[i];
-        else PD->ptr[i] += D->ptr[i] * (param * ::expf(I->ptr[i]));
+        else PD->ptr[i] += D->ptr[i] * (param * fast_expf(I->ptr[i]));
     }
     _profile(_CPU_D_ELU, 1);
 }
@@ -120,9 +121,12 @@ void cpu_softplus(Tensor *A, Tensor *B){
     printf(" A tensor: "); _profile_cpu_tensor(A);
 #endif
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (int i = 0; i < A->size; i++) {
-        B->ptr[i] = ::logf(1 + ::expf(A->ptr[i]));
+        // log(1 + exp(x)) = max(x, 0) + log(1 + exp(-|x|)), which does not overflow
+        float x = A->ptr[i];
+        float ax = x < 0.0f ? -x : x;
+        B->ptr[i] = (x > 0.0f ? x : 0.0f) + fast_logf(1.0f + fast_expf(-ax));
     }
 #ifdef CPU_DEBUG
     printf(" B tensor: "); _profile_cpu_tensor(B);
@@ -132,16 +136,16 @@ void cpu_softplus(Tensor *A, Tensor *B){
 
 void cpu_d_softplus(Tensor *D, Tensor *I, Tensor *PD){
     _profile(_CPU_D_SOFTPLUS, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_MEDIUM))
     for (int i = 0; i < D->size; i++) {
-        PD->ptr[i] += D->ptr[i] * 1/(1 + ::expf(-I->ptr[i]));
+        PD->ptr[i] += D->ptr[i] * fast_sigmoidf(I->ptr[i]);
     }
     _profile(_CPU_D_SOFTPLUS, 1);
 }
 
 void cpu_softsign(Tensor *A, Tensor *B){
     _profile(_CPU_SOFTSIGN, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (int i = 0; i < A->size; i++) {
         B->ptr[i] = A->ptr[i] / (1 + ::fabs(A->ptr[i]));
     }
@@ -150,7 +154,7 @@ void cpu_softsign(Tensor *A, Tensor *B){
 
 void cpu_d_softsign(Tensor *D, Tensor *I, Tensor *PD){
     _profile(_CPU_D_SOFTSIGN, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_MEDIUM))
     for (int i = 0; i < D->size; i++) {
         float denom = 1 + ::fabs(I->ptr[i]);
         PD->ptr[i] += D->ptr[i] * 1/(denom*denom);
@@ -160,7 +164,7 @@ void cpu_d_softsign(Tensor *D, Tensor *I, Tensor *PD){
 
 void cpu_linear(Tensor *A, Tensor *B, float param){
     _profile(_CPU_LINEAR, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (int i = 0; i < A->size; i++) {
         B->ptr[i] = param * A->ptr[i];
     }
@@ -169,24 +173,23 @@ void cpu_linear(Tensor *A, Tensor *B, float param){
 
 void cpu_d_linear(Tensor *D, Tensor *I, Tensor *PD, float param){
     _profile(_CPU_D_LINEAR, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++) {
         PD->ptr[i] += D->ptr[i] * param;
     }
     _profile(_CPU_D_LINEAR, 1);
 }
 
-//void cpu_sigmoid(Tensor *A, Tensor *B){
-//  _profile(_CPU_SIGMOID, 0);
-//  #pragma omp parallel for
-//  for (int i = 0; i < A->size; i++)
-//    B->ptr[i] = 1/(1+std::exp(-A->ptr[i]));
-//    _profile(_CPU_SIGMOID, 1);
-//}
+// The activations use the fast approximations (cpu_fastmath.h); Tensor::sigmoid, exp and tanh keep libm
+void cpu_sigmoid_nn(Tensor *A, Tensor *B){
+    _profile(_CPU_SIGMOID, 0);
+    cpu_fast_sigmoid(A->ptr, B->ptr, A->size);
+    _profile(_CPU_SIGMOID, 1);
+}
 
 void cpu_d_sigmoid(Tensor *D, Tensor *I, Tensor *PD){
     _profile(_CPU_D_SIGMOID, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++)
         PD->ptr[i] += D->ptr[i]*((1-I->ptr[i])*I->ptr[i]);
     _profile(_CPU_D_SIGMOID, 1);
@@ -194,7 +197,7 @@ void cpu_d_sigmoid(Tensor *D, Tensor *I, Tensor *PD){
 
 void cpu_hard_sigmoid(Tensor *A, Tensor *B){
     _profile(_CPU_HARD_SIGMOID, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
     for (int i = 0; i < A->size; i++) {
         if (A->ptr[i] > 2.5) B->ptr[i] = 1.0;
         else if (A->ptr[i] < -2.5) B->ptr[i] = 0.0;
@@ -205,44 +208,36 @@ void cpu_hard_sigmoid(Tensor *A, Tensor *B){
 
 void cpu_d_hard_sigmoid(Tensor *D, Tensor *I, Tensor *PD){
     _profile(_CPU_D_HARD_SIGMOID, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++)
         if (I->ptr[i] < -2.5 || I->ptr[i] > 2.5) PD->ptr[i] += 0;
         else PD->ptr[i] += D->ptr[i] * 0.2;
     _profile(_CPU_D_HARD_SIGMOID, 1);
 }
 
-//void cpu_exp(Tensor *A, Tensor *B){
-//  _profile(_CPU_EXP, 0);
-//  #pragma omp parallel for
-//  for (int i = 0; i < A->size; i++) {
-//    B->ptr[i] = std::exp(A->ptr[i]);
-//  }
-//    _profile(_CPU_EXP, 1);
-//}
+void cpu_exp_nn(Tensor *A, Tensor *B){
+    _profile(_CPU_EXP, 0);
+    cpu_fast_exp(A->ptr, B->ptr, A->size);
+    _profile(_CPU_EXP, 1);
+}
 
 void cpu_d_exp(Tensor *D, Tensor *I, Tensor *PD){
     _profile(_CPU_D_EXP, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++)
         PD->ptr[i] += D->ptr[i] * I->ptr[i];
     _profile(_CPU_D_EXP, 1);
 }
 
-//void cpu_tanh(Tensor *A, Tensor *B){
-//  _profile(_CPU_TANH, 0);
-//  #pragma omp parallel for
-//  for (int i = 0; i < A->size; i++) {
-//    float p=std::exp(A->ptr[i]);
-//    float n=std::exp(-A->ptr[i]);
-//    B->ptr[i] = (p-n)/(p+n);
-//  }
-//    _profile(_CPU_TANH, 1);
-//}
+void cpu_tanh_nn(Tensor *A, Tensor *B){
+    _profile(_CPU_TANH, 0);
+    cpu_fast_tanh(A->ptr, B->ptr, A->size);
+    _profile(_CPU_TANH, 1);
+}
 
 void cpu_d_tanh(Tensor *D, Tensor *I, Tensor *PD){
     _profile(_CPU_D_TANH, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++)
         PD->ptr[i] += D->ptr[i]*(1-(I->ptr[i]*I->ptr[i]));
     _profile(_CPU_D_TANH, 1);
@@ -251,15 +246,14 @@ void cpu_d_tanh(Tensor *D, Tensor *I, Tensor *PD){
 
 void cpu_softmax(Tensor *A, Tensor *B) {
     _profile(_CPU_SOFTMAX, 0);
-    float max, sum;
 
-    //#pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (int i = 0; i < A->shape[0]; i++) {
-        max = (*A->ptr2).col(i).maxCoeff();
+        float max = (*A->ptr2).col(i).maxCoeff();
         for (int j = 0; j < A->shape[1]; j++)
-            (*B->ptr2)(j, i) = std::exp((*A->ptr2)(j, i) - max);
+            (*B->ptr2)(j, i) = fast_expf((*A->ptr2)(j, i) - max);
 
-        sum = (*B->ptr2).col(i).sum();
+        float sum = (*B->ptr2).col(i).sum();
         for (int j = 0; j < B->shape[1]; j++)
             (*B->ptr2)(j, i) = (*B->ptr2)(j, i) / sum;
     }
@@ -270,7 +264,7 @@ void cpu_d_softmax(Tensor *D, Tensor *I, Tensor *PD) {
     _profile(_CPU_D_SOFTMAX, 0);
 
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
     for (int i = 0; i < D->size; i++)
         PD->ptr[i] += D->ptr[i] * (I->ptr[i] * (1.0 - I->ptr[i]));
 
@@ -295,7 +289,7 @@ void cpu_full_softmax_batched_2d(Tensor *A, Tensor *B, bool stable){
     int n_batches = A->shape[0];
     int n_features = A->shape[1];
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(int bi=0; bi<n_batches; bi++){
         // Contiguous data
         int start = bi*n_features;
@@ -313,7 +307,7 @@ void cpu_full_softmax_batched_2d(Tensor *A, Tensor *B, bool stable){
         // Numerator
         float denominator = CPU_EPS_FLOAT;
         for(int j=start; j<end; j++){
-            float value = ::expf(A->ptr[j] - max_value);
+            float value = fast_expf(A->ptr[j] - max_value);
             B->ptr[j] = value;
             denominator += value;
         }
@@ -334,7 +328,7 @@ void cpu_full_softmax_nd(Tensor *A, Tensor *B, int axis, bool stable){
     int k_stride = (chuck_size-1)*A->stride[axis];
 
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for(int si=0; si<n_samples; si++) {  // n chucks
             int start_b = si % inner_stride + si/inner_stride * sample_stride;
             int end_b = start_b + k_stride;
@@ -357,7 +351,7 @@ void cpu_full_softmax_nd(Tensor *A, Tensor *B, int axis, bool stable){
             // Numerator
             float denominator = CPU_EPS_FLOAT;
             for (int i = start_b; i <= end_b; i += inner_stride) {
-                float value = ::expf(A->ptr[i] - max_value);  // Highest number should be zero
+                float value = fast_expf(A->ptr[i] - max_value);  // Highest number should be zero
                 B->ptr[i] = value;
                 denominator += value;
             }
@@ -385,7 +379,7 @@ void cpu_d_full_softmax_batched_2d(Tensor *D, Tensor *I, Tensor *PD) {
     int n_batches = D->shape[0];
     int n_features = D->shape[1];
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads((long int)D->size * n_features, CPU_COST_CHEAP))
     for(int bi=0; bi<n_batches; bi++){
         // Contiguous data
         int start = bi*n_features;
@@ -414,7 +408,7 @@ void cpu_d_full_softmax_nd(Tensor *D, Tensor *I, Tensor *PD, int axis) {
     int sample_stride = chuck_size*D->stride[axis];
     int k_stride = (chuck_size-1)*D->stride[axis];
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads((long int)D->size * chuck_size, CPU_COST_CHEAP))
     for(int si=0; si<n_samples; si++) {  // n chucks
         int start_b = si % inner_stride + si/inner_stride * sample_stride;
         int end_b = start_b + k_stride;
@@ -27,7 +27,7 @@ void cpu_permute_channels_last(Tensor *A,Tensor *B)
   r=A->shape[2];
   c=A->shape[3];
 
-  #pragma omp parallel for
+  #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
   for (int i = 0; i < b; ++i) {
     int psrc=i*(z*r*c);
     for(int j=0;j<z;j++)
@@ -52,7 +52,7 @@ void cpu_permute_channels_first(Tensor *A,Tensor *B)
   c=B->shape[3];
 
 
-  #pragma omp parallel for
+  #pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_CHEAP))
   for (int i = 0; i < b; ++i) {
     int psrc=i*(z*r*c);
     for(int j=0;j<z;j++)
@@ -76,7 +76,7 @@ void cpu_permute_batch_last(Tensor *A,Tensor *B)
   r=A->shape[2];
   c=A->shape[3];
 
-  #pragma omp parallel for
+  #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_CHEAP))
   for (int i = 0; i < b; ++i) {
     int psrc=i*(z*r*c);
     for(int j=0;j<z;j++)
@@ -101,7 +101,7 @@ void cpu_permute_batch_first(Tensor *A,Tensor *B)
   c=B->shape[3];
 
 
-  #pragma omp parallel for
+  #pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_CHEAP))
   for (int i = 0; i < b; ++i) {
     int psrc=i*(z*r*c);
     for(int j=0;j<z;j++)
@@ -129,7 +129,7 @@ void cpu_batchnorm_forward(int b, int z, int rc,
         for (int j = 0; j < z; j++) mean[j] = variance[j] = 0.0;
         // warning: using omp in the next loop can lead to unstable computations of mean and variance
         // gpu version protects it with atomicAdd()
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads((long int)b * rcz, CPU_COST_CHEAP))
         for (int k = 0; k < rcz; k += block_size)
             for (int i = 0; i < b; i++) {
                 int p = k + i * rcz;
@@ -140,7 +140,7 @@ void cpu_batchnorm_forward(int b, int z, int rc,
                 }
             }
         float N = b * rc;
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads(z, CPU_COST_MEDIUM))
         for (int j = 0; j < z; j++) {
             mean[j] = mean[j] / N;
             variance[j] = variance[j] / N - mean[j] * mean[j];
@@ -156,13 +156,13 @@ void cpu_batchnorm_forward(int b, int z, int rc,
         // otherwise the mean and variance of the current batch are used, which are
         // computed in the previous block, that will be executed if in TRMODE or momemtum is zero
         mean = global_mean;
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads(z, CPU_COST_MEDIUM))
         for (int j = 0; j < z; j++) {
             variance[j] = sqrt(global_variance[j] + epsilon);
         }
     }
     // normalization
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads((long int)b * rcz, CPU_COST_MEDIUM))
     for (int k = 0; k < rcz; k += block_size)
         for (int i = 0; i < b; i++) {
             int p = k + i * rcz;
@@ -192,7 +192,7 @@ void cpu_batchnorm_backward(int b, int z, int rc,
         for (int j = 0; j < z; j++) mean1[j] = mean2[j] = 0.0;
         // warning: using omp in the next loop can lead to unstable computations of mean and variance
         // gpu version protects it with atomicAdd()
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads((long int)b * rcz, CPU_COST_CHEAP))
         for (int k = 0; k < rcz; k += block_size)
             for (int i = 0; i < b; i++) {
                 int p = k + i * rcz;
@@ -203,7 +203,7 @@ void cpu_batchnorm_backward(int b, int z, int rc,
                     delta[p] *= bn_g[j];
                 }
             }
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads(z, CPU_COST_MEDIUM))
         for (int j = 0; j < z; j++) {
             mean1[j] /= N;
             mean2[j] /= N;
@@ -217,7 +217,7 @@ void cpu_batchnorm_backward(int b, int z, int rc,
         for (int j = 0; j < z; j++) mean1[j] = mean2[j] = 0.0;
         // warning: using omp in the next loop can lead to unstable computations of mean and variance
         // gpu version protects it with atomicAdd()
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads((long int)b * rcz, CPU_COST_CHEAP))
         for (int k = 0; k < rcz; k += block_size)
             for (int i = 0; i < b; i++) {
                 int p = k + i * rcz;
@@ -227,13 +227,13 @@ void cpu_batchnorm_backward(int b, int z, int rc,
                     mean2[j] += delta[p]; // step 4
                 }
             }
-        #pragma omp parallel for
+        #pragma omp parallel for num_threads(cpu_threads(z, CPU_COST_MEDIUM))
         for (int j = 0; j < z; j++) {
             mean1[j] /= N;
             mean2[j] /= N;
         }
     }
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads((long int)b * rcz, CPU_COST_MEDIUM))
     for (int k = 0; k < rcz; k += block_size)
         for (int i = 0; i < b; i++) {
             int p = k + i * rcz;
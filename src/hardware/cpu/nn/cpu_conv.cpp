@@ -10,6 +10,8 @@
 #include <cstdio>      /* printf, scanf, NULL */
 #include <cstdlib>     /* malloc, free, rand */
 #include <iostream>
+#include <algorithm>
+#include <omp.h>
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 #include "eddl/hardware/cpu/cpu_tensor.h"
@@ -52,7 +54,8 @@ void add_pixel(int b,int px,int py,int pz,ConvolDescriptor *D,int isize,int irsi
 }
 
 
-void im2col(int b,ConvolDescriptor *D,float *ptrI,int col2im)
+// Lowering of group "g" of sample "b": ptrI is (r*c, kz*kr*kc), column-major. Dilation spreads the taps
+void im2col(int b,ConvolDescriptor *D,float *ptrI,int col2im,int g=0)
 {
   _profile(_CPU_IM2COL, 0);
   int i,j,k;
@@ -88,9 +91,9 @@ void im2col(int b,ConvolDescriptor *D,float *ptrI,int col2im)
 
     
     for(i=0;i<D->matI.cols();i++,k+=orsize) {
-      pz=i/ksize;
-      y=py+(i%ksize)/D->kc;
-      x=px+(i%D->kc);
+      pz=g*D->kz+i/ksize;
+      y=py+((i%ksize)/D->kc)*D->dilation_rate[0];
+      x=px+(i%D->kc)*D->dilation_rate[1];
 
       if(col2im)
       add_pixel(b,x,y,pz,D,isize,irsize,ptrI[k]);
@@ -119,7 +122,9 @@ void cpu_im2col_conv2D(ConvolDescriptor *D)
   //printf("            bias : "); _profile_cpu_tensor(D->bias);
 
    int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int gsize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int isize=gsize*D->groups;
+  int ng=D->nk/D->groups; // kernels per group
 
   float *ptrO=D->O->ptr;
   float *ptrI=D->ptrI;
@@ -215,12 +220,16 @@ void cpu_im2col_conv2D(ConvolDescriptor *D)
     float *ptrO=D->O->ptr+(b*osize);
     float *ptrI=D->ptrI+(b*isize);
 
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
     Eigen::Map<Eigen::MatrixXf> matO=Eigen::Map<Eigen::MatrixXf>(ptrO,D->r*D->c,D->z);
 
-    im2col(b,D,ptrI,0);
+    // Each group only sees its kz input channels and produces its ng output channels
+    for(int g=0;g<D->groups;g++) {
+      Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI+g*gsize,D->r*D->c,D->kz*D->kr*D->kc);
 
-    matO=matI*matK;
+      im2col(b,D,ptrI+g*gsize,0,g);
+
+      matO.middleCols(g*ng,ng).noalias()=matI*matK.middleCols(g*ng,ng);
+    }
   }// batch
     _profile(_CPU_CONV2D, 1);
 }
@@ -230,7 +239,9 @@ void cpu_im2col_conv2D_grad(ConvolDescriptor *D)
   _profile(_CPU_CONV2D_GRAD, 0);
   //return;
   int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int gsize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int isize=gsize*D->groups;
+  int ng=D->nk/D->groups; // kernels per group
 
 
   // Map memory to Eigen
@@ -242,10 +253,13 @@ void cpu_im2col_conv2D_grad(ConvolDescriptor *D)
     float *ptrD=D->D->ptr+(b*osize);
     float *ptrI=D->ptrI+(b*isize);
 
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
     Eigen::Map<Eigen::MatrixXf> matD=Eigen::Map<Eigen::MatrixXf>(ptrD,D->r*D->c,D->z);
 
-    matgK+=matI.transpose()*matD;
+    for(int g=0;g<D->groups;g++) {
+      Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI+g*gsize,D->r*D->c,D->kz*D->kr*D->kc);
+
+      matgK.middleCols(g*ng,ng).noalias()+=matI.transpose()*matD.middleCols(g*ng,ng);
+    }
   }// batch
     _profile(_CPU_CONV2D_GRAD, 1);
 }
@@ -254,7 +268,9 @@ void cpu_im2col_conv2D_back(ConvolDescriptor *D)
 {
   _profile(_CPU_CONV2D_BACK, 0);
   int osize=D->z*D->r*D->c;
-  int isize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int gsize=D->r*D->c*D->kc*D->kr*D->kz;//r*c,kr*kc*kz
+  int isize=gsize*D->groups;
+  int ng=D->nk/D->groups; // kernels per group
 
   float *ptrD=D->D->ptr;
   float *ptrI=D->ptrI;
@@ -268,13 +284,15 @@ void cpu_im2col_conv2D_back(ConvolDescriptor *D)
     float *ptrD=D->D->ptr+(b*osize);
     float *ptrI=D->ptrI+(b*isize);
 
-    Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI,D->r*D->c,D->kz*D->kr*D->kc);
     Eigen::Map<Eigen::MatrixXf> matD=Eigen::Map<Eigen::MatrixXf>(ptrD,D->r*D->c,D->z);
 
-    matI=matD*matK.transpose();
+    for(int g=0;g<D->groups;g++) {
+      Eigen::Map<Eigen::MatrixXf> matI=Eigen::Map<Eigen::MatrixXf>(ptrI+g*gsize,D->r*D->c,D->kz*D->kr*D->kc);
 
-    im2col(b,D,ptrI,1);
+      matI.noalias()=matD.middleCols(g*ng,ng)*matK.middleCols(g*ng,ng).transpose();
 
+      im2col(b,D,ptrI+g*gsize,1,g);
+    }
   }// batch
     _profile(_CPU_CONV2D_BACK, 1);
 }
@@ -284,27 +302,31 @@ void cpu_low_mem_conv3D(int batch_size,
         int num_kernels, int kernel_depth, int kernel_rows, int kernel_cols, const float *kernel,
         int out_depth, int out_rows, int out_cols, float *output,
         int pad_depth, int pad_row, int pad_col,
-        int stride_depth, int stride_rows, int stride_cols)
+        int stride_depth, int stride_rows, int stride_cols,
+        int groups=1, int dilation_depth=1, int dilation_rows=1, int dilation_cols=1)
 {
-    #pragma omp parallel for
+    int kchannels = channels / groups;      // channels seen by each kernel
+    int group_kernels = num_kernels / groups;
+    #pragma omp parallel for collapse(2)
     for (int b = 0; b < batch_size; b++)
     for (int nk = 0; nk < num_kernels; nk++)
     for (int k = 0; k < out_depth; k++)
     for (int i = 0; i < out_rows; i++)
     for (int j = 0; j < out_cols; j++) {
         float s = 0;
+        int c0 = (nk / group_kernels) * kchannels;
         for (int z = 0; z < kernel_depth; z++) {
-            int pz = k * stride_depth + z - pad_depth;
+            int pz = k * stride_depth + z * dilation_depth - pad_depth;
             if (pz >= 0 && pz < image_depth)
             for (int x = 0; x < kernel_rows; x++) {
-                int px = i * stride_rows + x - pad_row;
+                int px = i * stride_rows + x * dilation_rows - pad_row;
                 if (px >= 0 && px < image_rows)
                 for (int y = 0; y < kernel_cols; y++) {
-                    int py = j * stride_cols + y - pad_col;
+                    int py = j * stride_cols + y * dilation_cols - pad_col;
                     if (py >= 0 && py < image_cols) {
-                        for (int c = 0; c < channels; c++)
-                            s += kernel[(((nk * channels + c) * kernel_depth + z) * kernel_rows + x) * kernel_cols + y]
-                               * image[(((b * channels + c) * image_depth + pz) * image_rows + px) * image_cols + py];
+                        for (int c = 0; c < kchannels; c++)
+                            s += kernel[(((nk * kchannels + c) * kernel_depth + z) * kernel_rows + x) * kernel_cols + y]
+                               * image[(((b * channels + c0 + c) * image_depth + pz) * image_rows + px) * image_cols + py];
                     }
                 }
             }
@@ -313,6 +335,121 @@ void cpu_low_mem_conv3D(int batch_size,
     }
 }
 
+// Depthwise convolutions (one input channel per kernel: groups == iz) are not lowered: each kernel is
+// slid directly over its channel plane. The taps are the outer loops, so the inner loop runs along an
+// output row with a fixed weight and vectorizes; the borders are handled by clipping the column range.
+static bool is_depthwise(ConvolDescriptor *D) {
+    return D->groups > 1 && D->kz == 1;
+}
+
+// Output columns [x0, x1) whose input column x*sc + off falls inside the image
+static void depthwise_cols(ConvolDescriptor *D, int off, int &x0, int &x1) {
+    x0 = off < 0 ? (-off + D->sc - 1) / D->sc : 0;
+    x1 = off < D->ic ? std::min(D->c, (D->ic - 1 - off) / D->sc + 1) : 0;
+}
+
+void cpu_depthwise_conv2D(ConvolDescriptor *D)
+{
+    int mult = D->nk / D->groups;  // Kernels per input channel (depth multiplier)
+    int irsize = D->ir * D->ic;
+    int orsize = D->r * D->c;
+    int ksize = D->kr * D->kc;
+    int planes = D->I->shape[0] * D->nk;
+
+    #pragma omp parallel for num_threads(cpu_threads((long int)planes * orsize * ksize, CPU_COST_CHEAP))
+    for (int p = 0; p < planes; p++) {
+        int b = p / D->nk, o = p % D->nk;
+        const float *in = D->I->ptr + ((long int)b * D->iz + o / mult) * irsize;
+        const float *k = D->K->ptr + (long int)o * ksize;
+        float *out = D->O->ptr + (long int)p * orsize;
+
+        std::fill(out, out + orsize, 0.0f);
+        for (int ki = 0; ki < D->kr; ki++)
+        for (int kj = 0; kj < D->kc; kj++) {
+            float w = k[ki * D->kc + kj];
+            int off = kj * D->dilation_rate[1] - D->padcl;
+            int x0, x1;
+            depthwise_cols(D, off, x0, x1);
+            for (int y = 0; y < D->r; y++) {
+                int iy = y * D->sr + ki * D->dilation_rate[0] - D->padrt;
+                if (iy < 0 || iy >= D->ir) continue;
+                const float *irow = in + iy * D->ic;
+                float *orow = out + y * D->c;
+                #pragma omp simd
+                for (int x = x0; x < x1; x++) orow[x] += w * irow[x * D->sc + off];
+            }
+        }
+    }
+}
+
+void cpu_depthwise_conv2D_grad(ConvolDescriptor *D)
+{
+    int mult = D->nk / D->groups;
+    int irsize = D->ir * D->ic;
+    int orsize = D->r * D->c;
+    int ksize = D->kr * D->kc;
+    int batch = D->I->shape[0];
+
+    // A thread owns whole kernels: no reduction among threads
+    #pragma omp parallel for num_threads(cpu_threads((long int)batch * D->nk * orsize * ksize, CPU_COST_CHEAP))
+    for (int o = 0; o < D->nk; o++)
+    for (int ki = 0; ki < D->kr; ki++)
+    for (int kj = 0; kj < D->kc; kj++) {
+        int off = kj * D->dilation_rate[1] - D->padcl;
+        int x0, x1;
+        depthwise_cols(D, off, x0, x1);
+        float s = 0.0f;
+        for (int b = 0; b < batch; b++) {
+            const float *in = D->I->ptr + ((long int)b * D->iz + o / mult) * irsize;
+            const float *delta = D->D->ptr + ((long int)b * D->nk + o) * orsize;
+            for (int y = 0; y < D->r; y++) {
+                int iy = y * D->sr + ki * D->dilation_rate[0] - D->padrt;
+                if (iy < 0 || iy >= D->ir) continue;
+                const float *irow = in + iy * D->ic;
+                const float *drow = delta + y * D->c;
+                #pragma omp simd reduction(+:s)
+                for (int x = x0; x < x1; x++) s += drow[x] * irow[x * D->sc + off];
+            }
+        }
+        D->gK->ptr[o * ksize + ki * D->kc + kj] += s;
+    }
+}
+
+void cpu_depthwise_conv2D_back(ConvolDescriptor *D)
+{
+    int mult = D->nk / D->groups;
+    int irsize = D->ir * D->ic;
+    int orsize = D->r * D->c;
+    int ksize = D->kr * D->kc;
+    int planes = D->I->shape[0] * D->iz;
+
+    // A thread owns whole input planes (and the "mult" kernels that read each of them)
+    #pragma omp parallel for num_threads(cpu_threads((long int)planes * mult * orsize * ksize, CPU_COST_CHEAP))
+    for (int p = 0; p < planes; p++) {
+        int b = p / D->iz, ch = p % D->iz;
+        float *in = D->ID->ptr + (long int)p * irsize;
+        for (int o = ch * mult; o < (ch + 1) * mult; o++) {
+            const float *k = D->K->ptr + (long int)o * ksize;
+            const float *delta = D->D->ptr + ((long int)b * D->nk + o) * orsize;
+            for (int ki = 0; ki < D->kr; ki++)
+            for (int kj = 0; kj < D->kc; kj++) {
+                float w = k[ki * D->kc + kj];
+                int off = kj * D->dilation_rate[1] - D->padcl;
+                int x0, x1;
+                depthwise_cols(D, off, x0, x1);
+                for (int y = 0; y < D->r; y++) {
+                    int iy = y * D->sr + ki * D->dilation_rate[0] - D->padrt;
+                    if (iy < 0 || iy >= D->ir) continue;
+                    float *irow = in + iy * D->ic;
+                    const float *drow = delta + y * D->c;
+                    #pragma omp simd
+                    for (int x = x0; x < x1; x++) irow[x * D->sc + off] += w * drow[x];
+                }
+            }
+        }
+    }
+}
+
 void cpu_conv2D(ConvolDescriptor *D)
 {
 
@@ -324,12 +461,14 @@ void cpu_conv2D(ConvolDescriptor *D)
 	if (D->use_bias) {printf(" bias    : "); _profile_cpu_tensor(D->bias);}
 #endif	
 
-    if (D->mem_level > 1) cpu_low_mem_conv3D(D->I->shape[0],
+    if (is_depthwise(D)) cpu_depthwise_conv2D(D);
+    else if (D->mem_level > 1) cpu_low_mem_conv3D(D->I->shape[0],
         D->iz, 1, D->ir, D->ic, D->I->ptr,
         D->nk, 1, D->kr, D->kc, D->K->ptr,
         1, D->r, D->c, D->O->ptr,
         0, D->padrt, D->padcl,
-        1, D->sr, D->sc);
+        1, D->sr, D->sc,
+        D->groups, 1, D->dilation_rate[0], D->dilation_rate[1]);
     else cpu_im2col_conv2D(D);
 
   int osize=D->z*D->r*D->c;
@@ -415,55 +554,55 @@ void cpu_low_mem_conv3D_grad(int batch_size,
         int num_kernels, int kernel_depth, int kernel_rows, int kernel_cols, float *kernel,
         int out_depth, int out_rows, int out_cols, const float *delta,
         int pad_depth, int pad_row, int pad_col,
-        int stride_depth, int stride_rows, int stride_cols)
+        int stride_depth, int stride_rows, int stride_cols,
+        int groups=1, int dilation_depth=1, int dilation_rows=1, int dilation_cols=1)
 {
-    int kernel_size = num_kernels * channels * kernel_depth * kernel_rows * kernel_cols;
-    for (int b = 0; b < batch_size; b++) {
-        #pragma omp parallel for
-        /* for (int nk = 0; nk < num_kernels; nk++)
-        for (int c = 0; c < channels; c++)
-        for (int z = 0; z < kernel_depth; z++)
-        for (int x = 0; x < kernel_rows; x++)
-        for (int y = 0; y < kernel_cols; y++) { */
-        for (int tid = 0; tid < kernel_size; tid++) {
-            int nk = tid;
-            int y = nk % kernel_cols; nk /= kernel_cols;
-            int x = nk % kernel_rows; nk /= kernel_rows;
-            int z = nk % kernel_depth; nk /= kernel_depth;
-            int c = nk % channels; nk /= channels;
-
-            float s = 0.0;
-            for (int k = 0; k < out_depth; k++) {
-                int pz = k * stride_depth + z - pad_depth;
-                if (pz < 0) continue;
-                if (pz >= image_depth) continue;
-                for (int i = 0; i < out_rows; i++) {
-                    int px = i * stride_rows - pad_row + x;
-                    if (px < 0) continue;
-                    if (px >= image_rows) continue;
-                    for (int j = 0; j < out_cols; j++) {
-                        int py = j * stride_cols - pad_col + y;
-                        if (py < 0) continue;
-                        if (py >= image_cols) continue;
-                        s += image[(((b * channels + c) * image_depth + pz) * image_rows + px) * image_cols + py] *
-                            delta[(((b * num_kernels + nk) * out_depth + k) * out_rows + i) * out_cols + j];
-                    }
+    int kchannels = channels / groups;
+    int group_kernels = num_kernels / groups;
+    int kernel_size = num_kernels * kchannels * kernel_depth * kernel_rows * kernel_cols;
+    // One thread per kernel element, for the whole batch: no reduction, a single parallel region
+    #pragma omp parallel for
+    for (int tid = 0; tid < kernel_size; tid++) {
+        int nk = tid;
+        int y = nk % kernel_cols; nk /= kernel_cols;
+        int x = nk % kernel_rows; nk /= kernel_rows;
+        int z = nk % kernel_depth; nk /= kernel_depth;
+        int c = nk % kchannels; nk /= kchannels;
+        c += (nk / group_kernels) * kchannels;  // Image channel
+
+        float s = 0.0;
+        for (int b = 0; b < batch_size; b++)
+        for (int k = 0; k < out_depth; k++) {
+            int pz = k * stride_depth + z * dilation_depth - pad_depth;
+            if (pz < 0) continue;
+            if (pz >= image_depth) continue;
+            for (int i = 0; i < out_rows; i++) {
+                int px = i * stride_rows - pad_row + x * dilation_rows;
+                if (px < 0) continue;
+                if (px >= image_rows) continue;
+                for (int j = 0; j < out_cols; j++) {
+                    int py = j * stride_cols - pad_col + y * dilation_cols;
+                    if (py < 0) continue;
+                    if (py >= image_cols) continue;
+                    s += image[(((b * channels + c) * image_depth + pz) * image_rows + px) * image_cols + py] *
+                        delta[(((b * num_kernels + nk) * out_depth + k) * out_rows + i) * out_cols + j];
                 }
             }
-            // kernel[((((nk * channels + c) * kernel_depth + z) * kernel_rows + x) * kernel_cols) + y] = s;
-            kernel[tid] += s;
         }
+        kernel[tid] += s;
     }
 }
 
 void cpu_conv2D_grad(ConvolDescriptor *D)
 {
-    if (D->mem_level > 1) cpu_low_mem_conv3D_grad(D->I->shape[0],
+    if (is_depthwise(D)) cpu_depthwise_conv2D_grad(D);
+    else if (D->mem_level > 1) cpu_low_mem_conv3D_grad(D->I->shape[0],
         D->iz, 1, D->ir, D->ic, D->I->ptr,
         D->nk, 1, D->kr, D->kc, D->gK->ptr,
         1, D->r, D->c, D->D->ptr,
         0, D->padrt, D->padcl,
-        1, D->sr, D->sc);
+        1, D->sr, D->sc,
+        D->groups, 1, D->dilation_rate[0], D->dilation_rate[1]);
     else cpu_im2col_conv2D_grad(D);
 
   //bias
@@ -485,30 +624,34 @@ void cpu_low_mem_conv3D_back(int batch_size,
         int num_kernels, int kernel_depth, int kernel_rows, int kernel_cols, const float *kernel,
         int out_depth, int out_rows, int out_cols, const float *delta,
         int pad_depth, int pad_row, int pad_col,
-        int stride_depth, int stride_rows, int stride_cols)
+        int stride_depth, int stride_rows, int stride_cols,
+        int groups=1, int dilation_depth=1, int dilation_rows=1, int dilation_cols=1)
 {
-    #pragma omp parallel for
+    int kchannels = channels / groups;
+    int group_kernels = num_kernels / groups;
+    #pragma omp parallel for collapse(2)
     for (int b = 0; b < batch_size; b++)
     for (int c = 0; c < channels; c++)
     for (int k = 0; k < out_depth; k++)
     for (int i = 0; i < out_rows; i++)
     for (int j = 0; j < out_cols; j++)
         for (int z = 0; z < kernel_depth; z++) {
-            int pz = k * stride_depth + z - pad_depth;
+            int pz = k * stride_depth + z * dilation_depth - pad_depth;
             if (pz < 0) continue;
             if (pz >= image_depth) continue;
             for (int x = 0; x < kernel_rows; x++) {
-                int px = i * stride_rows - pad_row + x;
+                int px = i * stride_rows - pad_row + x * dilation_rows;
                 if (px < 0) continue;
                 if (px >= image_rows) continue;
                 for (int y = 0; y < kernel_cols; y++) {
-                    int py = j * stride_cols - pad_col + y;
+                    int py = j * stride_cols - pad_col + y * dilation_cols;
                     if (py < 0) continue;
                     if (py >= image_cols) continue;
                     float s = 0.0;
-                    for (int nk = 0; nk < num_kernels; nk++)
+                    int g = c / kchannels;  // Only the kernels of its group read this channel
+                    for (int nk = g * group_kernels; nk < (g + 1) * group_kernels; nk++)
                         s += delta[(((b * num_kernels + nk) * out_depth + k) * out_rows + i) * out_cols + j]
-                           * kernel[(((nk * channels + c) * kernel_depth + z) * kernel_rows + x) * kernel_cols + y];
+                           * kernel[(((nk * kchannels + c % kchannels) * kernel_depth + z) * kernel_rows + x) * kernel_cols + y];
                     image[(((b * channels + c) * image_depth + pz) * image_rows + px) * image_cols + py] += s;
                 }
             }
@@ -517,39 +660,492 @@ void cpu_low_mem_conv3D_back(int batch_size,
 
 void cpu_conv2D_back(ConvolDescriptor *D)
 {
-    if (D->mem_level > 1) cpu_low_mem_conv3D_back(D->I->shape[0],
+    if (is_depthwise(D)) cpu_depthwise_conv2D_back(D);
+    else if (D->mem_level > 1) cpu_low_mem_conv3D_back(D->I->shape[0],
         D->iz, 1, D->ir, D->ic, D->ID->ptr,
         D->nk, 1, D->kr, D->kc, D->K->ptr,
         1, D->r, D->c, D->D->ptr,
         0, D->padrt, D->padcl,
-        1, D->sr, D->sc);
+        1, D->sr, D->sc,
+        D->groups, 1, D->dilation_rate[0], D->dilation_rate[1]);
     else cpu_im2col_conv2D_back(D);
 }
 
 
+// Conv3D with mem_level < 2: tiled vol2col + GEMM. The output voxels of a sample are split in tiles of
+// CONV3D_TILE/kvol positions, so each thread only lowers a (tile x kvol) block, whatever the volume and
+// the batch size. The workspace (D->ptrI) holds one block per thread and grows as a high-water mark.
+#define CONV3D_TILE (1 << 17)  // Floats per lowering block (512 KB)
+
+static int conv3D_kvol(ConvolDescriptor3D *D) {
+    return D->kz * D->kd * D->kr * D->kc;
+}
+
+static int conv3D_tile(ConvolDescriptor3D *D) {
+    int osize = D->d * D->r * D->c;
+    return std::min(osize, std::max(16, CONV3D_TILE / conv3D_kvol(D)));
+}
+
+static float *conv3D_workspace(ConvolDescriptor3D *D, int threads, unsigned long int per_thread) {
+    unsigned long int size = (unsigned long int)threads * per_thread;
+    if (size > D->ptrI_size) {
+        eddl_free(D->ptrI);
+        D->ptrI = get_fmem(size, "cpu_conv3D");
+        D->ptrI_size = size;
+    }
+    return D->ptrI;
+}
+
+// Lowers (scatter=0) or accumulates back (scatter=1) the kernel elements [e0, e1) of the output positions
+// [p0, p0+n) of sample b. col is column-major (n x (e1-e0))
+static void vol2col(ConvolDescriptor3D *D, float *vol, int b, int p0, int n, int e0, int e1, float *col, int scatter) {
+    int isize = D->id * D->ir * D->ic;
+    float *img = vol + (long int)b * D->iz * isize;
+    for (int e = e0; e < e1; e++) {
+        int y = e % D->kc, x = (e / D->kc) % D->kr, z = (e / (D->kc * D->kr)) % D->kd;
+        int ch = e / (D->kc * D->kr * D->kd);
+        int oz = z * D->dilation_rate[0] - D->paddf;
+        int ox = x * D->dilation_rate[1] - D->padrt;
+        int oy = y * D->dilation_rate[2] - D->padcl;
+        float *plane = img + (long int)ch * isize;
+        float *dst = col + (long int)(e - e0) * n;
+
+        int k = p0 / (D->r * D->c), i = (p0 / D->c) % D->r, j = p0 % D->c;
+        for (int q = 0; q < n; q++) {
+            int pz = k * D->sd + oz, px = i * D->sr + ox, py = j * D->sc + oy;
+            bool inside = pz >= 0 && pz < D->id && px >= 0 && px < D->ir && py >= 0 && py < D->ic;
+            if (scatter) {
+                if (inside) plane[(pz * D->ir + px) * D->ic + py] += dst[q];
+            } else {
+                dst[q] = inside ? plane[(pz * D->ir + px) * D->ic + py] : 0.0f;
+            }
+            if (++j == D->c) { j = 0; if (++i == D->r) { i = 0; k++; } }
+        }
+    }
+}
+
+void cpu_tiled_conv3D(ConvolDescriptor3D *D)
+{
+    int batch = D->I->shape[0];
+    int kvol = conv3D_kvol(D);
+    int osize = D->d * D->r * D->c;
+    int tile = conv3D_tile(D);
+    int tiles = (osize + tile - 1) / tile;
+    int tasks = batch * tiles;
+    int threads = std::min(tasks, cpu_threads((long int)batch * osize * kvol * D->nk, CPU_COST_CHEAP));
+    float *ws = conv3D_workspace(D, threads, (unsigned long int)tile * kvol);
+
+    Eigen::Map<Eigen::MatrixXf> matK(D->K->ptr, kvol, D->nk);
+
+    #pragma omp parallel for num_threads(threads)
+    for (int t = 0; t < tasks; t++) {
+        int b = t / tiles, p0 = (t % tiles) * tile;
+        int n = std::min(tile, osize - p0);
+        float *col = ws + (long int)omp_get_thread_num() * tile * kvol;
+
+        vol2col(D, D->I->ptr, b, p0, n, 0, kvol, col, 0);
+
+        Eigen::Map<Eigen::MatrixXf> matCol(col, n, kvol);
+        Eigen::Map<Eigen::MatrixXf> matO(D->O->ptr + (long int)b * D->nk * osize, osize, D->nk);
+        matO.middleRows(p0, n).noalias() = matCol * matK;
+    }
+}
+
+void cpu_tiled_conv3D_grad(ConvolDescriptor3D *D)
+{
+    int batch = D->I->shape[0];
+    int kvol = conv3D_kvol(D);
+    int ksize = kvol * D->nk;
+    int osize = D->d * D->r * D->c;
+    int tile = conv3D_tile(D);
+    int tiles = (osize + tile - 1) / tile;
+    int tasks = batch * tiles;
+    int threads = std::min(tasks, cpu_threads((long int)batch * osize * ksize, CPU_COST_CHEAP));
+
+    // Every thread accumulates in its own copy of gK (after its lowering block), reduced at the end
+    unsigned long int per_thread = (unsigned long int)tile * kvol + ksize;
+    float *ws = conv3D_workspace(D, threads, per_thread);
+    for (int th = 0; th < threads; th++) std::fill(ws + th * per_thread + (long int)tile * kvol, ws + (th + 1) * per_thread, 0.0f);
+
+    #pragma omp parallel for num_threads(threads)
+    for (int t = 0; t < tasks; t++) {
+        int b = t / tiles, p0 = (t % tiles) * tile;
+        int n = std::min(tile, osize - p0);
+        float *col = ws + omp_get_thread_num() * per_thread;
+
+        vol2col(D, D->I->ptr, b, p0, n, 0, kvol, col, 0);
+
+        Eigen::Map<Eigen::MatrixXf> matCol(col, n, kvol);
+        Eigen::Map<Eigen::MatrixXf> matD(D->D->ptr + (long int)b * D->nk * osize, osize, D->nk);
+        Eigen::Map<Eigen::MatrixXf> matgK(col + (long int)tile * kvol, kvol, D->nk);
+        matgK.noalias() += matCol.transpose() * matD.middleRows(p0, n);
+    }
+
+    #pragma omp parallel for num_threads(cpu_threads((long int)ksize * threads, CPU_COST_CHEAP))
+    for (int e = 0; e < ksize; e++) {
+        float s = 0.0f;
+        for (int th = 0; th < threads; th++) s += ws[th * per_thread + (long int)tile * kvol + e];
+        D->gK->ptr[e] += s;
+    }
+}
+
+void cpu_tiled_conv3D_back(ConvolDescriptor3D *D)
+{
+    int batch = D->I->shape[0];
+    int kvol = conv3D_kvol(D);
+    int kvol_c = kvol / D->kz;  // Kernel elements per input channel
+    int osize = D->d * D->r * D->c;
+    int tile = conv3D_tile(D);
+    int threads = cpu_threads((long int)batch * osize * kvol * D->nk, CPU_COST_CHEAP);
+
+    // The tiles of a sample overlap in the input: a task owns a block of input channels of a sample
+    // (all its tiles), so the accumulation needs no synchronization
+    int blocks = std::min(D->kz, (threads + batch - 1) / batch);
+    int bsize = (D->kz + blocks - 1) / blocks;
+    blocks = (D->kz + bsize - 1) / bsize;
+    int tasks = batch * blocks;
+    threads = std::min(tasks, threads);
+    float *ws = conv3D_workspace(D, threads, (unsigned long int)tile * kvol);
+
+    Eigen::Map<Eigen::MatrixXf> matK(D->K->ptr, kvol, D->nk);
+
+    #pragma omp parallel for num_threads(threads)
+    for (int t = 0; t < tasks; t++) {
+        int b = t / blocks;
+        int e0 = (t % blocks) * bsize * kvol_c;
+        int e1 = std::min(kvol, e0 + bsize * kvol_c);
+        float *col = ws + (long int)omp_get_thread_num() * tile * kvol;
+        Eigen::Map<Eigen::MatrixXf> matD(D->D->ptr + (long int)b * D->nk * osize, osize, D->nk);
+
+        for (int p0 = 0; p0 < osize; p0 += tile) {
+            int n = std::min(tile, osize - p0);
+            Eigen::Map<Eigen::MatrixXf> matCol(col, n, e1 - e0);
+            matCol.noalias() = matD.middleRows(p0, n) * matK.middleRows(e0, e1 - e0).transpose();
+
+            vol2col(D, D->ID->ptr, b, p0, n, e0, e1, col, 1);
+        }
+    }
+}
+
 void cpu_conv3D(ConvolDescriptor3D *D){
-    cpu_low_mem_conv3D(D->I->shape[0],
+    if (D->mem_level > 1) cpu_low_mem_conv3D(D->I->shape[0],
         D->iz, D->id, D->ir, D->ic, D->I->ptr,
         D->nk, D->kd, D->kr, D->kc, D->K->ptr,
         D->d, D->r, D->c, D->O->ptr,
         D->paddf, D->padrt, D->padcl,
-        D->sd, D->sr, D->sc);
+        D->sd, D->sr, D->sc,
+        1, D->dilation_rate[0], D->dilation_rate[1], D->dilation_rate[2]);
+    else cpu_tiled_conv3D(D);
+
+    //bias
+    if (D->use_bias) {
+        int osize = D->d * D->r * D->c;
+        int planes = D->O->shape[0] * D->nk;
+        #pragma omp parallel for num_threads(cpu_threads((long int)planes * osize, CPU_COST_CHEAP))
+        for (int p = 0; p < planes; p++) {
+            float *ptrO = D->O->ptr + (long int)p * osize;
+            float v = D->bias->ptr[p % D->nk];
+            for (int i = 0; i < osize; i++) ptrO[i] += v;
+        }
+    }
 }
 
 void cpu_conv3D_grad(ConvolDescriptor3D *D){
-    cpu_low_mem_conv3D_grad(D->I->shape[0],
+    if (D->mem_level > 1) cpu_low_mem_conv3D_grad(D->I->shape[0],
         D->iz, D->id, D->ir, D->ic, D->I->ptr,
         D->nk, D->kd, D->kr, D->kc, D->gK->ptr,
         D->d, D->r, D->c, D->D->ptr,
         D->paddf, D->padrt, D->padcl,
-        D->sd, D->sr, D->sc);
+        D->sd, D->sr, D->sc,
+        1, D->dilation_rate[0], D->dilation_rate[1], D->dilation_rate[2]);
+    else cpu_tiled_conv3D_grad(D);
+
+    //bias
+    if (D->use_bias) {
+        int osize = D->d * D->r * D->c;
+        #pragma omp parallel for num_threads(cpu_threads((long int)D->D->shape[0] * D->nk * osize, CPU_COST_CHEAP))
+        for (int z = 0; z < D->nk; z++) {
+            float s = 0.0f;
+            for (int b = 0; b < D->D->shape[0]; b++) {
+                const float *ptrD = D->D->ptr + ((long int)b * D->nk + z) * osize;
+                for (int i = 0; i < osize; i++) s += ptrD[i];
+            }
+            D->gbias->ptr[z] += s;
+        }
+    }
 }
 
 void cpu_conv3D_back(ConvolDescriptor3D *D){
-    cpu_low_mem_conv3D_back(D->I->shape[0],
+    if (D->mem_level > 1) cpu_low_mem_conv3D_back(D->I->shape[0],
         D->iz, D->id, D->ir, D->ic, D->ID->ptr,
         D->nk, D->kd, D->kr, D->kc, D->K->ptr,
         D->d, D->r, D->c, D->D->ptr,
         D->paddf, D->padrt, D->padcl,
-        D->sd, D->sr, D->sc);
+        D->sd, D->sr, D->sc,
+        1, D->dilation_rate[0], D->dilation_rate[1], D->dilation_rate[2]);
+    else cpu_tiled_conv3D_back(D);
+}
+
+
+// ConvT2D by phases (sub-pixel decomposition). The output pixels with the same phase
+// ((y + padrt) % sr, (x + padcl) % sc) only receive the taps ki = py, py+sr... and kj = px, px+sc..., so every
+// phase is a dense stride-1 correlation of the input with its sub-kernel: a GEMM per tile of the phase and no
+// col2im scatter (each output pixel belongs to one phase). Kernels are (iz, z/groups, kr, kc), as in ONNX.
+#define CONVT_TILE (1 << 17)  // Floats per lowering block (512 KB)
+
+struct ConvTPhase {
+    int y0, nr, base_r, tr;  // First output row, rows, input row of (m=0, t=0) and taps of the phase
+    int x0, nc, base_c, tc;  // Same for the columns
+    long int koff;           // Offset of its packed sub-kernels
+};
+
+static vector<ConvTPhase> convT2D_phases(ConvolDescriptorT2D *D) {
+    vector<ConvTPhase> phases;
+    long int koff = 0;
+    for (int py = 0; py < D->sr; py++)
+    for (int px = 0; px < D->sc; px++) {
+        ConvTPhase p;
+        p.y0 = ((py - D->padrt) % D->sr + D->sr) % D->sr;
+        p.nr = p.y0 < D->r ? (D->r - p.y0 + D->sr - 1) / D->sr : 0;
+        p.base_r = (p.y0 + D->padrt - py) / D->sr;
+        p.tr = py < D->kr ? (D->kr - py + D->sr - 1) / D->sr : 0;
+        p.x0 = ((px - D->padcl) % D->sc + D->sc) % D->sc;
+        p.nc = p.x0 < D->c ? (D->c - p.x0 + D->sc - 1) / D->sc : 0;
+        p.base_c = (p.x0 + D->padcl - px) / D->sc;
+        p.tc = px < D->kc ? (D->kc - px + D->sc - 1) / D->sc : 0;
+        p.koff = koff;
+        koff += (long int)D->nk * D->kz * p.tr * p.tc;
+        phases.push_back(p);
+    }
+    return phases;
+}
+
+static float *convT2D_workspace(ConvolDescriptorT2D *D, unsigned long int size) {
+    if (size > D->ptrI_size) {
+        eddl_free(D->ptrI);
+        D->ptrI = get_fmem(size, "cpu_convT2D");
+        D->ptrI_size = size;
+    }
+    return D->ptrI;
+}
+
+// Sub-kernel of phase "ph" and group "g", column-major (ipg*tr*tc x zg). unpack=1 accumulates it back into K
+static void convT2D_pack(ConvolDescriptorT2D *D, const ConvTPhase &p, int ph, int g, float *K, float *Kp, int unpack) {
+    int ipg = D->nk / D->groups, zg = D->kz;
+    int py = ph / D->sc, px = ph % D->sc;
+    int rows = ipg * p.tr * p.tc;
+    for (int ol = 0; ol < zg; ol++)
+    for (int cil = 0; cil < ipg; cil++)
+    for (int ti = 0; ti < p.tr; ti++)
+    for (int tj = 0; tj < p.tc; tj++) {
+        int ki = py + ti * D->sr, kj = px + tj * D->sc;
+        long int k = (((long int)(g * ipg + cil) * zg + ol) * D->kr + ki) * D->kc + kj;
+        long int q = (long int)ol * rows + (cil * p.tr + ti) * p.tc + tj;
+        if (unpack) K[k] += Kp[q];
+        else Kp[q] = K[k];
+    }
+}
+
+// Input pixels read by the positions [p0, p0+n) of a phase (group g of sample b), column-major (n x ipg*tr*tc)
+static void convT2D_lower(ConvolDescriptorT2D *D, const ConvTPhase &p, int b, int g, int p0, int n, float *col) {
+    int ipg = D->nk / D->groups;
+    for (int cil = 0; cil < ipg; cil++) {
+        const float *plane = D->I->ptr + ((long int)b * D->iz + g * ipg + cil) * D->ir * D->ic;
+        for (int ti = 0; ti < p.tr; ti++)
+        for (int tj = 0; tj < p.tc; tj++) {
+            float *dst = col + (long int)((cil * p.tr + ti) * p.tc + tj) * n;
+            int m = p0 / p.nc, mm = p0 % p.nc;
+            for (int q = 0; q < n; q++) {
+                int i = m + p.base_r - ti, j = mm + p.base_c - tj;
+                dst[q] = (i >= 0 && i < D->ir && j >= 0 && j < D->ic) ? plane[i * D->ic + j] : 0.0f;
+                if (++mm == p.nc) { mm = 0; m++; }
+            }
+        }
+    }
+}
+
+// Copies a (n x zg) block between the positions [p0, p0+n) of a phase and the tensor T (O or D)
+static void convT2D_phase_copy(ConvolDescriptorT2D *D, const ConvTPhase &p, Tensor *T, int b, int g, int p0, int n, float *buf, int to_tensor) {
+    int zg = D->kz;
+    for (int ol = 0; ol < zg; ol++) {
+        float *plane = T->ptr + ((long int)b * D->z + g * zg + ol) * D->r * D->c;
+        float *src = buf + (long int)ol * n;
+        int m = p0 / p.nc, mm = p0 % p.nc;
+        for (int q = 0; q < n; q++) {
+            float *px = plane + (p.y0 + m * D->sr) * D->c + p.x0 + mm * D->sc;
+            if (to_tensor) *px = src[q];
+            else src[q] = *px;
+            if (++mm == p.nc) { mm = 0; m++; }
+        }
+    }
+}
+
+static int convT2D_tile(ConvolDescriptorT2D *D, const vector<ConvTPhase> &phases, int &max_cols, int &tiles) {
+    int ipg = D->nk / D->groups;
+    int max_pos = 1;
+    max_cols = 1;
+    for (auto &p : phases) {
+        max_cols = std::max(max_cols, ipg * p.tr * p.tc);
+        max_pos = std::max(max_pos, p.nr * p.nc);
+    }
+    int tile = std::min(max_pos, std::max(16, CONVT_TILE / std::max(max_cols, D->kz)));
+    tiles = (max_pos + tile - 1) / tile;
+    return tile;
+}
+
+void cpu_convT2D(ConvolDescriptorT2D *D)
+{
+    int batch = D->I->shape[0];
+    vector<ConvTPhase> phases = convT2D_phases(D);
+    int nph = phases.size();
+    int max_cols, tiles;
+    int tile = convT2D_tile(D, phases, max_cols, tiles);
+    int tasks = batch * nph * tiles;
+    int threads = std::min(tasks, cpu_threads((long int)D->O->size * D->nk / D->groups * D->kr * D->kc / (D->sr * D->sc) + 1, CPU_COST_CHEAP));
+
+    long int ksize = D->K->size;
+    unsigned long int per_thread = (unsigned long int)tile * (max_cols + D->kz);
+    float *ws = convT2D_workspace(D, ksize + threads * per_thread);
+    for (int ph = 0; ph < nph; ph++)
+        for (int g = 0; g < D->groups; g++)
+            convT2D_pack(D, phases[ph], ph, g, D->K->ptr, ws + phases[ph].koff + (long int)g * (D->nk / D->groups) * phases[ph].tr * phases[ph].tc * D->kz, 0);
+
+    #pragma omp parallel for num_threads(threads)
+    for (int t = 0; t < tasks; t++) {
+        int b = t / (nph * tiles), ph = (t / tiles) % nph;
+        const ConvTPhase &p = phases[ph];
+        int p0 = (t % tiles) * tile;
+        if (p0 >= p.nr * p.nc) continue;
+        int n = std::min(tile, p.nr * p.nc - p0);
+        int rows = (D->nk / D->groups) * p.tr * p.tc;
+        float *col = ws + ksize + omp_get_thread_num() * per_thread;
+        float *out = col + (long int)tile * max_cols;
+
+        for (int g = 0; g < D->groups; g++) {
+            Eigen::Map<Eigen::MatrixXf> matO(out, n, D->kz);
+            if (rows == 0) {
+                matO.setZero();  // No tap reaches this phase
+            } else {
+                convT2D_lower(D, p, b, g, p0, n, col);
+                Eigen::Map<Eigen::MatrixXf> matCol(col, n, rows);
+                Eigen::Map<Eigen::MatrixXf> matK(ws + p.koff + (long int)g * rows * D->kz, rows, D->kz);
+                matO.noalias() = matCol * matK;
+            }
+            convT2D_phase_copy(D, p, D->O, b, g, p0, n, out, 1);
+        }
+    }
+
+    //bias
+    if (D->use_bias) {
+        int osize = D->r * D->c;
+        int planes = D->O->shape[0] * D->z;
+        #pragma omp parallel for num_threads(cpu_threads((long int)planes * osize, CPU_COST_CHEAP))
+        for (int p = 0; p < planes; p++) {
+            float *ptrO = D->O->ptr + (long int)p * osize;
+            float v = D->bias->ptr[p % D->z];
+            for (int i = 0; i < osize; i++) ptrO[i] += v;
+        }
+    }
+}
+
+void cpu_convT2D_grad(ConvolDescriptorT2D *D)
+{
+    int batch = D->I->shape[0];
+    vector<ConvTPhase> phases = convT2D_phases(D);
+    int nph = phases.size();
+    int max_cols, tiles;
+    int tile = convT2D_tile(D, phases, max_cols, tiles);
+    int tasks = batch * nph * tiles;
+    int threads = std::min(tasks, cpu_threads((long int)D->O->size * D->nk / D->groups * D->kr * D->kc / (D->sr * D->sc) + 1, CPU_COST_CHEAP));
+
+    // Every thread accumulates the packed sub-kernel gradients in its own buffer, reduced at the end
+    long int ksize = D->K->size;
+    unsigned long int per_thread = (unsigned long int)tile * (max_cols + D->kz) + ksize;
+    float *ws = convT2D_workspace(D, threads * per_thread);
+    for (int th = 0; th < threads; th++) std::fill(ws + th * per_thread, ws + th * per_thread + ksize, 0.0f);
+
+    #pragma omp parallel for num_threads(threads)
+    for (int t = 0; t < tasks; t++) {
+        int b = t / (nph * tiles), ph = (t / tiles) % nph;
+        const ConvTPhase &p = phases[ph];
+        int p0 = (t % tiles) * tile;
+        int rows = (D->nk / D->groups) * p.tr * p.tc;
+        if (p0 >= p.nr * p.nc || rows == 0) continue;
+        int n = std::min(tile, p.nr * p.nc - p0);
+        float *gk = ws + omp_get_thread_num() * per_thread;
+        float *col = gk + ksize;
+        float *delta = col + (long int)tile * max_cols;
+
+        for (int g = 0; g < D->groups; g++) {
+            convT2D_lower(D, p, b, g, p0, n, col);
+            convT2D_phase_copy(D, p, D->D, b, g, p0, n, delta, 0);
+            Eigen::Map<Eigen::MatrixXf> matCol(col, n, rows);
+            Eigen::Map<Eigen::MatrixXf> matD(delta, n, D->kz);
+            Eigen::Map<Eigen::MatrixXf> matgK(gk + p.koff + (long int)g * rows * D->kz, rows, D->kz);
+            matgK.noalias() += matCol.transpose() * matD;
+        }
+    }
+
+    for (int th = 1; th < threads; th++) {
+        float *src = ws + th * per_thread;
+        #pragma omp parallel for num_threads(cpu_threads(ksize, CPU_COST_CHEAP))
+        for (long int e = 0; e < ksize; e++) ws[e] += src[e];
+    }
+    for (int ph = 0; ph < nph; ph++)
+        for (int g = 0; g < D->groups; g++)
+            convT2D_pack(D, phases[ph], ph, g, D->gK->ptr, ws + phases[ph].koff + (long int)g * (D->nk / D->groups) * phases[ph].tr * phases[ph].tc * D->kz, 1);
+
+    //bias
+    if (D->use_bias) {
+        int osize = D->r * D->c;
+        #pragma omp parallel for num_threads(cpu_threads((long int)D->D->size, CPU_COST_CHEAP))
+        for (int z = 0; z < D->z; z++) {
+            float s = 0.0f;
+            for (int b = 0; b < D->D->shape[0]; b++) {
+                const float *ptrD = D->D->ptr + ((long int)b * D->z + z) * osize;
+                for (int i = 0; i < osize; i++) s += ptrD[i];
+            }
+            D->gbias->ptr[z] += s;
+        }
+    }
+}
+
+// The delta of the input is a plain strided convolution of the delta with the kernels
+void cpu_convT2D_back(ConvolDescriptorT2D *D)
+{
+    int batch = D->I->shape[0];
+    int ipg = D->nk / D->groups, zg = D->kz;
+    int cols = zg * D->kr * D->kc;
+    int isize = D->ir * D->ic;
+    int tile = std::min(isize, std::max(16, CONVT_TILE / cols));
+    int tiles = (isize + tile - 1) / tile;
+    int tasks = batch * tiles;
+    int threads = std::min(tasks, cpu_threads((long int)batch * isize * ipg * cols, CPU_COST_CHEAP));
+    float *ws = convT2D_workspace(D, (unsigned long int)threads * tile * cols);
+
+    Eigen::Map<Eigen::MatrixXf> matK(D->K->ptr, cols, D->nk);
+
+    #pragma omp parallel for num_threads(threads)
+    for (int t = 0; t < tasks; t++) {
+        int b = t / tiles, p0 = (t % tiles) * tile;
+        int n = std::min(tile, isize - p0);
+        float *col = ws + (long int)omp_get_thread_num() * tile * cols;
+        Eigen::Map<Eigen::MatrixXf> matID(D->ID->ptr + (long int)b * D->iz * isize, isize, D->iz);
+
+        for (int g = 0; g < D->groups; g++) {
+            for (int e = 0; e < cols; e++) {
+                int kj = e % D->kc, ki = (e / D->kc) % D->kr, ol = e / (D->kc * D->kr);
+                const float *plane = D->D->ptr + ((long int)b * D->z + g * zg + ol) * D->r * D->c;
+                float *dst = col + (long int)e * n;
+                int i = p0 / D->ic, j = p0 % D->ic;
+                for (int q = 0; q < n; q++) {
+                    int y = i * D->sr - D->padrt + ki, x = j * D->sc - D->padcl + kj;
+                    dst[q] = (y >= 0 && y < D->r && x >= 0 && x < D->c) ? plane[y * D->c + x] : 0.0f;
+                    if (++j == D->ic) { j = 0; i++; }
+                }
+            }
+            Eigen::Map<Eigen::MatrixXf> matCol(col, n, cols);
+            matID.block(p0, g * ipg, n, ipg).noalias() += matCol * matK.middleCols(g * ipg, ipg);
+        }
+    }
 }
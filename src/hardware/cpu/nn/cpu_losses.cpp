@@ -13,11 +13,12 @@
 #include <iostream>
 
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
+#include "eddl/hardware/cpu/cpu_parallel.h"
 
 
 void cpu_cent(Tensor *A, Tensor *B, Tensor *C){
   _profile(_CPU_CENT, 0);
-  #pragma omp parallel for
+  #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_HEAVY))
   for (int i = 0; i < A->size; i++) {
     C->ptr[i] = 0;
     if (A->ptr[i] != 0.0) C->ptr[i] -= A->ptr[i] * std::log(B->ptr[i]+0.00001);
@@ -30,7 +31,7 @@ float cpu_categorical_cross_entropy(Tensor* y_true, Tensor* y_pred){
     float sum = 0.0f;
     float eps = 10e-8;
 
-    #pragma omp parallel for reduction(+:sum)
+    #pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(y_true->size, CPU_COST_HEAVY))
     for (int bi = 0; bi<y_true->shape[0]; bi++) {  // Batches
         unsigned int step_i = bi * y_true->stride[0];
 
@@ -50,17 +51,57 @@ float cpu_categorical_cross_entropy(Tensor* y_true, Tensor* y_pred){
 void cpu_d_categorical_cross_entropy(Tensor* y_true, Tensor* y_pred, Tensor* delta){
     float eps = 10e-8;
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(y_true->size, CPU_COST_MEDIUM))
     for (int i = 0; i<y_true->size; i++) {
         delta->ptr[i] = -y_true->ptr[i] * (1.0f/ (y_pred->ptr[i]+eps) );
     }
 }
 
+float cpu_softmax_cross_entropy(Tensor* y_true, Tensor* logits, Tensor* y_pred, Tensor* delta){
+    int n = y_true->shape[y_true->ndim - 1];
+    int rows = (int)(y_true->size / n);
+    float scale = 1.0f / (float)y_true->shape[0];  // Same normalization as the loss deltas
+    float sum = 0.0f;
+
+    #pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(y_true->size, CPU_COST_MEDIUM))
+    for (int r = 0; r < rows; r++) {
+        const float *z = logits->ptr + (size_t)r * n;
+        const float *p = y_pred->ptr + (size_t)r * n;
+        const float *t = y_true->ptr + (size_t)r * n;
+
+        // log(sum(exp(z))) from the largest probability, which cannot underflow. Then log(p_j) = z_j - lse,
+        // without the "eps" of the unfused loss
+        int jmax = 0;
+        for (int j = 1; j < n; j++) {
+            if (p[j] > p[jmax]) jmax = j;
+        }
+        float lse = z[jmax] - ::logf(p[jmax]);
+
+        float row_sum = 0.0f;
+        if (delta != nullptr) {
+            float *d = delta->ptr + (size_t)r * n;
+            #pragma omp simd reduction(+:row_sum)
+            for (int j = 0; j < n; j++) {
+                row_sum += t[j] * (z[j] - lse);
+                d[j] = (p[j] - t[j]) * scale;
+            }
+        } else {
+            #pragma omp simd reduction(+:row_sum)
+            for (int j = 0; j < n; j++) {
+                row_sum += t[j] * (z[j] - lse);
+            }
+        }
+        sum += row_sum;
+    }
+
+    return -sum;
+}
+
 float cpu_binary_cross_entropy(Tensor* y_true, Tensor* y_pred){
     float sum = 0.0f;
     float eps = 10e-8;
 
-    #pragma omp parallel for reduction(+:sum)
+    #pragma omp parallel for reduction(+:sum) num_threads(cpu_threads(y_true->size, CPU_COST_HEAVY))
     for (int i = 0; i < y_true->size; i++) {
         sum += y_true->ptr[i] * ::logf(y_pred->ptr[i]+eps) + (1.0-y_true->ptr[i]) * ::logf(1.0f-y_pred->ptr[i]+eps);
     }
@@ -73,7 +114,7 @@ float cpu_binary_cross_entropy(Tensor* y_true, Tensor* y_pred){
 void cpu_d_binary_cross_entropy(Tensor* y_true, Tensor* y_pred, Tensor* delta){
     float eps = 10e-8;
 
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(y_true->size, CPU_COST_MEDIUM))
     for (int i = 0; i<y_true->size; i++) {
         delta->ptr[i] = -( y_true->ptr[i] * 1.0f/(y_pred->ptr[i]+eps) + (1.0-y_true->ptr[i]) * 1.0f/(1.0f-y_pred->ptr[i]+eps) * -1.0f );
     }
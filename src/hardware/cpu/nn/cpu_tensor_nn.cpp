@@ -7,12 +7,14 @@
 * All rights reserved
 */
 
+#include <algorithm>
+
 #include "eddl/hardware/cpu/nn/cpu_tensor_nn.h"
 #include "eddl/hardware/cpu/cpu_tensor.h" 
 
 void cpu_repeat_nn(Tensor *A, Tensor *B, vector<int> size){  // Deprecated. Used in UpSampling2D
     _profile(_CPU_REPEAT_NN, 0);
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_MEDIUM))
     for(int i=0; i<B->size; i++){
         // Get row/col of Tensor B
         int row_b = i/B->shape[2+1];  // (batch, channels, rows), cols
@@ -32,7 +34,7 @@ void cpu_repeat_nn(Tensor *A, Tensor *B, vector<int> size){  // Deprecated. Used
 void cpu_d_repeat_nn(Tensor *D, Tensor *A, vector<int> size){ // Deprecated. Used in UpSampling2D
     _profile(_CPU_D_REPEAT_NN, 0);
 
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_MEDIUM))
     for(int i=0; i<D->size; i++){
         // Get row/col of Tensor B
         int row_d = i/D->shape[2+1];  // (batch, channels, rows), cols
@@ -50,8 +52,124 @@ void cpu_d_repeat_nn(Tensor *D, Tensor *A, vector<int> size){ // Deprecated. Use
 }
 
 
+// Source rows/cols and weights of a half-pixel linear upsampling by an integer factor (align_corners=false)
+static void upsampling_coords(int out, int in, int scale, vector<int> &i0, vector<int> &i1, vector<float> &w){
+    i0.resize(out); i1.resize(out); w.resize(out);
+    for(int o=0; o<out; o++){
+        float src = std::max(((float)o + 0.5f) / (float)scale - 0.5f, 0.0f);
+        i0[o] = std::min((int)src, in - 1);
+        i1[o] = std::min(i0[o] + 1, in - 1);
+        w[o] = src - (float)i0[o];
+    }
+}
+
+// B = upsample(A) by size=(rows, cols). Nearest replicates every input row once and copies it to the other
+// output rows; bilinear interpolates the input rows horizontally and blends pairs of them vertically
+void cpu_upsampling2D(Tensor *A, Tensor *B, vector<int> size, bool bilinear){
+    int planes = A->shape[0] * A->shape[1];
+    int ar = A->shape[2], ac = A->shape[3];
+    int br = B->shape[2], bc = B->shape[3];
+
+    if (!bilinear) {
+        #pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_CHEAP))
+        for(int t=0; t<planes*ar; t++){
+            const float *src = A->ptr + (long int)t * ac;
+            float *dst = B->ptr + (long int)t * size[0] * bc;
+            for(int j=0; j<ac; j++)
+                for(int k=0; k<size[1]; k++) dst[j*size[1] + k] = src[j];
+            for(int k=1; k<size[0]; k++) std::copy(dst, dst + bc, dst + k*bc);
+        }
+        return;
+    }
+
+    vector<int> y0, y1, x0, x1;
+    vector<float> wy, wx;
+    upsampling_coords(br, ar, size[0], y0, y1, wy);
+    upsampling_coords(bc, ac, size[1], x0, x1, wx);
+
+    #pragma omp parallel num_threads(cpu_threads((long int)B->size * 4, CPU_COST_CHEAP))
+    {
+        vector<float> rows((long int)ar * bc);  // Input rows interpolated to the output width
+        #pragma omp for
+        for(int p=0; p<planes; p++){
+            const float *src = A->ptr + (long int)p * ar * ac;
+            float *dst = B->ptr + (long int)p * br * bc;
+            for(int i=0; i<ar; i++){
+                const float *a = src + i*ac;
+                float *h = rows.data() + (long int)i * bc;
+                for(int x=0; x<bc; x++) h[x] = a[x0[x]] + wx[x] * (a[x1[x]] - a[x0[x]]);
+            }
+            for(int y=0; y<br; y++){
+                const float *h0 = rows.data() + (long int)y0[y] * bc;
+                const float *h1 = rows.data() + (long int)y1[y] * bc;
+                float w = wy[y];
+                float *o = dst + (long int)y * bc;
+                #pragma omp simd
+                for(int x=0; x<bc; x++) o[x] = h0[x] + w * (h1[x] - h0[x]);
+            }
+        }
+    }
+}
+
+// A += upsample^T(D): the fused backward of cpu_upsampling2D (each input pixel gathers its window)
+void cpu_d_upsampling2D(Tensor *D, Tensor *A, vector<int> size, bool bilinear){
+    int planes = A->shape[0] * A->shape[1];
+    int ar = A->shape[2], ac = A->shape[3];
+    int dr = D->shape[2], dc = D->shape[3];
+
+    if (!bilinear) {
+        #pragma omp parallel for num_threads(cpu_threads(D->size, CPU_COST_CHEAP))
+        for(int t=0; t<planes*ar; t++){
+            const float *src = D->ptr + (long int)t * size[0] * dc;
+            float *dst = A->ptr + (long int)t * ac;
+            for(int j=0; j<ac; j++){
+                float s = 0.0f;
+                for(int k=0; k<size[0]; k++)
+                    for(int l=0; l<size[1]; l++) s += src[k*dc + j*size[1] + l];
+                dst[j] += s;
+            }
+        }
+        return;
+    }
+
+    vector<int> y0, y1, x0, x1;
+    vector<float> wy, wx;
+    upsampling_coords(dr, ar, size[0], y0, y1, wy);
+    upsampling_coords(dc, ac, size[1], x0, x1, wx);
+
+    #pragma omp parallel num_threads(cpu_threads((long int)D->size * 4, CPU_COST_CHEAP))
+    {
+        vector<float> rows((long int)ar * dc);  // Delta folded back to the input rows (still at the output width)
+        #pragma omp for
+        for(int p=0; p<planes; p++){
+            const float *src = D->ptr + (long int)p * dr * dc;
+            float *dst = A->ptr + (long int)p * ar * ac;
+            std::fill(rows.begin(), rows.end(), 0.0f);
+            for(int y=0; y<dr; y++){
+                const float *d = src + (long int)y * dc;
+                float *h0 = rows.data() + (long int)y0[y] * dc;
+                float *h1 = rows.data() + (long int)y1[y] * dc;
+                float w = wy[y];
+                #pragma omp simd
+                for(int x=0; x<dc; x++) h0[x] += (1.0f - w) * d[x];
+                #pragma omp simd
+                for(int x=0; x<dc; x++) h1[x] += w * d[x];
+            }
+            for(int i=0; i<ar; i++){
+                const float *h = rows.data() + (long int)i * dc;
+                float *a = dst + i*ac;
+                for(int x=0; x<dc; x++){
+                    a[x0[x]] += (1.0f - wx[x]) * h[x];
+                    a[x1[x]] += wx[x] * h[x];
+                }
+            }
+        }
+    }
+}
+
+
 void cpu_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_CHEAP))
     for (int b = 0; b < B->shape[0]; b++) {
         for (int i = 0; i < B->stride[0]; i++) {
             B->ptr[b*B->stride[0] + i] = A->ptr[b*A->stride[0] + sd->cpu_addresses[i]];
@@ -62,7 +180,7 @@ void cpu_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
 }
 
 void cpu_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (int b = 0; b < A->shape[0]; b++) {
         for (int i = 0; i < A->stride[0]; i++) {  // walk stride
             B->ptr[b*B->stride[0] + sd->cpu_addresses[i]] += A->ptr[b*A->stride[0] + i];  // delta_parent += delta
@@ -71,7 +189,7 @@ void cpu_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
 }
 
 void cpu_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
-   #pragma omp parallel for
+   #pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_CHEAP))
     for (int b = 0; b < B->shape[0]; b++) {
         for (int i = 0; i < B->stride[0]; i++) {
             A->ptr[b*A->stride[0] + sd->cpu_addresses[i]] = B->ptr[b*B->stride[0] + i];
@@ -80,7 +198,7 @@ void cpu_set_select_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
 }
 
 void cpu_set_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
-   #pragma omp parallel for
+   #pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_CHEAP))
     for (int b = 0; b < B->shape[0]; b++) {
         for (int i = 0; i < B->stride[0]; i++) {
             B->ptr[b*B->stride[0] + i] += A->ptr[b*A->stride[0] + sd->cpu_addresses[i]];
@@ -89,7 +207,7 @@ void cpu_set_select_back_nn(Tensor *A, Tensor *B, SelDescriptor *sd){
 }
 
 void cpu_expand_nn(Tensor *A, Tensor *B, ExpandDescriptor *sd){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_CHEAP))
     for (int b = 0; b < B->shape[0]; b++) {
         for (int i = 0; i < B->stride[0]; i++) {
             B->ptr[b*B->stride[0] + i] = A->ptr[b*A->stride[0] + sd->cpu_addresses[i]];
@@ -98,7 +216,7 @@ void cpu_expand_nn(Tensor *A, Tensor *B, ExpandDescriptor *sd){
 }
 
 void cpu_expand_back_nn(Tensor *A, Tensor *B, ExpandDescriptor *sd){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(A->size, CPU_COST_MEDIUM))
     for (int b = 0; b < A->shape[0]; b++) {
         for (int i = 0; i < A->stride[0]; i++) {  // walk stride
             B->ptr[b*B->stride[0] + sd->cpu_addresses[i]] += A->ptr[b*A->stride[0] + i];  // delta_parent += delta
@@ -107,7 +225,7 @@ void cpu_expand_back_nn(Tensor *A, Tensor *B, ExpandDescriptor *sd){
 }
 
 void cpu_repeat_batch(Tensor *A, Tensor *B){
-#pragma omp parallel for
+#pragma omp parallel for num_threads(cpu_threads(B->size, CPU_COST_MEDIUM))
     for (int b = 0; b < B->shape[0]; b++) {
         for (int i = 0; i < B->stride[0]; i++) {  // "A" must have batch of size 1
             B->ptr[b*B->stride[0] + i] = A->ptr[i];
@@ -167,36 +285,8 @@ void cpu_topK(Tensor *A, Tensor *B, int axis, int largest, int sorted, int K) {
 	printf("topK:\n");
 	printf(" input    : "); _profile_cpu_tensor(A);
 #endif
-	if (axis == -1) {
-	  if (A->ndim == 2) {
-	    if (K == 1) {
-	      if (largest) {
-	        for (int b = 0; b < A->shape[0]; b++) {
-	          float largest = A->ptr[b*A->stride[0]];
-		  int pos_largest = 0;
-		  for (int i = 0; i < A->shape[1]; i++) {
-		    float value = A->ptr[b*A->stride[0] + i];
-		    printf("topK: value %f (pos %d)\n", value, i);
-		    if (value > largest) {
-		      largest = value;
-		      pos_largest = i;
-		    }
-		  }
-		  B->ptr[b*B->stride[0]] = largest;
-		  printf("largest %f, position %d\n", largest, pos_largest);
-		}
-              } else {
-	        printf("!largest not supported in topK\n"); exit(1);
-              }
-	    } else {
-	      printf("K value not supported in topK\n"); exit(1);
-	    }
-	  } else {
-	    printf("A tensor shape not supported in topK\n"); exit(1);
-	  }
-	} else {
-	  printf("axis not supported in topK\n"); exit(1);
-	}
+	if (axis < 0) axis += A->ndim;
+	cpu_topk(A, B, nullptr, axis, K, largest, sorted);
 
 #ifdef CPU_DEBUG
 	printf(" output   : "); _profile_cpu_tensor(B);
@@ -46,7 +46,7 @@ void LTopK::forward() {
 }
 
 void LTopK::backward() {
-    printf("Error, topk layer does not support backward\n"); exit(1);
+    msg("TopK layer does not support backward", "LTopK::backward");
 }
 
 
@@ -238,6 +238,11 @@ Layer *LConv1D::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LConv1D::get_cost() {
+    return conv_cost(input, output, cd->K, false);
+}
+
+
 string LConv1D::plot(int c) {
     string s;
 
@@ -227,6 +227,25 @@ Layer *LConv::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost conv_cost(Tensor *input, Tensor *output, Tensor *K, bool transposed) {
+    // Each output (input, if transposed) element is a dot product with a filter of K->size/channels elements
+    double macs;
+    if (transposed) macs = (double)input->size * ((double)K->size / input->shape[1]);
+    else macs = (double)output->size * ((double)K->size / output->shape[1]);
+
+    LayerCost cost;
+    cost.fwd_flops = 2.0 * macs + (double)output->size;  // + bias
+    cost.bwd_flops = 4.0 * macs + (double)output->size;  // grad (gK, gbias) + back (parent delta)
+    cost.fwd_bytes = ((double)input->size + (double)K->size + (double)output->size) * sizeof(float);
+    cost.bwd_bytes = (3.0 * (double)input->size + 2.0 * (double)K->size + (double)output->size) * sizeof(float);
+    return cost;
+}
+
+LayerCost LConv::get_cost() {
+    return conv_cost(input, output, cd->K, false);
+}
+
+
 string LConv::plot(int c) {
     string s;
 
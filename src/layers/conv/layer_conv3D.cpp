@@ -215,6 +215,11 @@ Layer *LConv3D::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LConv3D::get_cost() {
+    return conv_cost(input, output, cd->K, false);
+}
+
+
 string LConv3D::plot(int c) {
     string s;
 
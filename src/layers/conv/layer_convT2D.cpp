@@ -213,6 +213,11 @@ Layer *LConvT2D::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LConvT2D::get_cost() {
+    return conv_cost(input, output, cd->K, true);
+}
+
+
 string LConvT2D::plot(int c) {
     string s;
 
@@ -213,6 +213,11 @@ Layer *LConvT3D::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LConvT3D::get_cost() {
+    return conv_cost(input, output, cd->K, true);
+}
+
+
 string LConvT3D::plot(int c) {
     string s;
 
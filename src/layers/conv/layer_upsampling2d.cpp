@@ -21,6 +21,10 @@ int LUpSampling::total_layers = 0;
 
 LUpSampling::LUpSampling(Layer *parent, const vector<int> &size, string interpolation, string name, int dev, int mem) : LinLayer(name, dev, mem) {
     this->size = size;
+    if (interpolation.empty()) interpolation = "nearest";  // ONNX default
+    if (interpolation == "linear") interpolation = "bilinear";  // ONNX name
+    if (interpolation != "nearest" && interpolation != "bilinear")
+        msg("Unknown interpolation \"" + interpolation + "\" (\"nearest\" or \"bilinear\")", "LUpSampling::LUpSampling");
     this->interpolation = interpolation;
 
     if(name.empty()) this->name = "upsampling2d" + to_string(++total_layers);
@@ -35,12 +39,12 @@ LUpSampling::LUpSampling(Layer *parent, const vector<int> &size, string interpol
 
 
 void LUpSampling::forward() {
-    //Repeats the rows and columns of the data by size[0] and size[1] respectively.
-    tensorNN::repeat_nn(this->input, this->output, this->size);
+    //Repeats (or interpolates) the rows and columns of the data by size[0] and size[1] respectively.
+    tensorNN::upsampling2D(this->input, this->output, this->size, this->interpolation == "bilinear");
 }
 
 void LUpSampling::backward() {
-    tensorNN::d_repeat_nn(delta, parent[0]->delta, this->size);
+    tensorNN::d_upsampling2D(delta, parent[0]->delta, this->size, this->interpolation == "bilinear");
 }
 
 Layer *LUpSampling::share(int c, int bs, vector<Layer *> p) {
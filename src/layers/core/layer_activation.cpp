@@ -365,6 +365,20 @@ Layer *LActivation::clone(int c, int bs, vector<Layer *> p, int todev){
 }
 
 
+LayerCost LActivation::get_cost(){
+    // Ops per element: piecewise-linear activations are 1, softmax (max, sub, exp, sum, div) is 5
+    // and the rest count the transcendental function as a few ops
+    double ops = 4.0;
+    if (act == "relu" || act == "leaky_relu" || act == "thresholded_relu" || act == "linear" || act == "hard_sigmoid") ops = 1.0;
+    else if (act == "softmax" || act == "full_softmax") ops = 5.0;
+
+    LayerCost cost = Layer::get_cost();
+    cost.fwd_flops = ops * (double)output->size;
+    cost.bwd_flops = 2.0 * ops * (double)output->size;
+    return cost;
+}
+
+
 string LActivation::plot(int c){
     string s;
 
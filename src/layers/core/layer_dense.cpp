@@ -204,6 +204,18 @@ Layer *LDense::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LDense::get_cost() {
+    double macs = (double)input->shape[0] * (double)W->size;
+
+    LayerCost cost;
+    cost.fwd_flops = 2.0 * macs + (use_bias ? (double)output->size : 0.0);
+    cost.bwd_flops = 4.0 * macs + (use_bias ? (double)output->size : 0.0);
+    cost.fwd_bytes = ((double)input->size + (double)W->size + (double)output->size) * sizeof(float);
+    cost.bwd_bytes = (3.0 * (double)input->size + 2.0 * (double)W->size + (double)output->size) * sizeof(float);
+    return cost;
+}
+
+
 string LDense::plot(int c) {
     string s;
 
@@ -43,8 +43,7 @@ LDropout::~LDropout(){
 // virtual
 void LDropout::resize(int batch){
     Layer::resize(batch);
-    delete mask;
-    mask = new Tensor(input->shape, dev);
+    mask->resize(batch);
 }
 
 void LDropout::forward() {
@@ -33,6 +33,11 @@ LInput::~LInput(){
 }
 
 
+LayerCost LInput::get_cost() {
+    return LayerCost();
+}
+
+
 string LInput::plot(int c) {
     string s;
 
@@ -163,6 +163,11 @@ Layer *LReshape::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LReshape::get_cost() {
+    return LayerCost();  // The output is a view of the input
+}
+
+
 string LReshape::plot(int c) {
     string s;
 
@@ -11,6 +11,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <algorithm>
 
 #include "eddl/layers/layer.h"
 #include "eddl/layers/operators/layer_operators.h"
@@ -132,6 +133,7 @@ void Layer::mem_delta(){
         this->delta = Tensor::zeros(this->output->shape, this->output->device);
     } else if (this->delta->shape[0] != this->output->shape[0]) {
         this->delta->resize(this->output->shape[0]);
+        this->delta->fill_(0.0f);  // The contents are not preserved by resize
     }
 }
 
@@ -178,6 +180,24 @@ int Layer::get_trainable_params_count()
         return params.size();
 }
 
+LayerCost Layer::get_cost(){
+    // Default: element-wise layer. One op per output element and parent, reads the parents and
+    // writes the output. Backward reads the delta and updates the delta of the parents
+    LayerCost cost;
+    if (output == nullptr) return cost;
+
+    double in_size = 0.0;
+    for (auto *p : parent) in_size += (double)p->output->size;
+    if (parent.empty() && input != nullptr) in_size = (double)input->size;
+    double nparents = std::max<double>(1.0, (double)parent.size());
+
+    cost.fwd_flops = (double)output->size * nparents;
+    cost.bwd_flops = (double)output->size * nparents;
+    cost.fwd_bytes = (in_size + (double)output->size) * sizeof(float);
+    cost.bwd_bytes = ((double)output->size + 2.0 * in_size) * sizeof(float);
+    return cost;
+}
+
 void Layer::detach(Layer *l){
     for(int i=0;i<child.size();i++){
         if(child[i]==l) {
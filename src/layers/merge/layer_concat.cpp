@@ -121,6 +121,14 @@ Layer *LConcat::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LConcat::get_cost() {
+    LayerCost cost = Layer::get_cost();  // Only data movement
+    cost.fwd_flops = 0.0;
+    cost.bwd_flops = 0.0;
+    return cost;
+}
+
+
 string LConcat::plot(int c) {
     string s;
 
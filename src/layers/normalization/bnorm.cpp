@@ -242,3 +242,14 @@ void BN_backward(Tensor *delta,Tensor *bn_var, Tensor *opa)
   delete A;
 
 }
+
+LayerCost normalization_cost(Tensor *input, Tensor *output) {
+    // Forward: mean (1), variance (2), normalize (2), scale and shift (2). Three passes over the input
+    // Backward: gradients of the affine params, variance and mean (~10 ops), four passes
+    LayerCost cost;
+    cost.fwd_flops = 7.0 * (double)input->size;
+    cost.bwd_flops = 10.0 * (double)input->size;
+    cost.fwd_bytes = (3.0 * (double)input->size + (double)output->size) * sizeof(float);
+    cost.bwd_bytes = (4.0 * (double)input->size + 2.0 * (double)output->size) * sizeof(float);
+    return cost;
+}
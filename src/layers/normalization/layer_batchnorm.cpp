@@ -419,6 +419,11 @@ Layer *LBatchNorm::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LBatchNorm::get_cost() {
+    return normalization_cost(input, output);
+}
+
+
 string LBatchNorm::plot(int c) {
     string s;
 
@@ -285,6 +285,11 @@ Layer *LGroupNorm::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LGroupNorm::get_cost() {
+    return normalization_cost(input, output);
+}
+
+
 string LGroupNorm::plot(int c) {
     string s;
 
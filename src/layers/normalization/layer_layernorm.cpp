@@ -283,6 +283,11 @@ Layer *LLayerNorm::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LLayerNorm::get_cost() {
+    return normalization_cost(input, output);
+}
+
+
 string LLayerNorm::plot(int c) {
     string s;
 
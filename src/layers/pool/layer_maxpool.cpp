@@ -55,8 +55,8 @@ LMaxPool::LMaxPool(Layer *parent, PoolDescriptor *D, const string& name, int dev
 void LMaxPool::resize(int batch){
   LPool::resize(batch);
 
-  delete pd->indX; pd->indX = new Tensor(pd->O->shape, dev);
-  delete pd->indY; pd->indY = new Tensor(pd->O->shape, dev);
+  pd->indX->resize(batch);
+  pd->indY->resize(batch);
 }
 
 void LMaxPool::forward() {
@@ -52,8 +52,8 @@ LMaxPool1D::LMaxPool1D(Layer *parent, PoolDescriptor *D, const string& name, int
 void LMaxPool1D::resize(int batch){
   LPool1D::resize(batch);
 
-  delete pd->indX; pd->indX = new Tensor(pd->O->shape, dev);
-  delete pd->indY; pd->indY = new Tensor(pd->O->shape, dev);
+  pd->indX->resize(batch);
+  pd->indY->resize(batch);
 }
 
 void LMaxPool1D::forward() {
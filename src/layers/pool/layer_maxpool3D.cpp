@@ -49,9 +49,9 @@ LMaxPool3D::LMaxPool3D(Layer *parent, PoolDescriptor3D *D, const string& name, i
 void LMaxPool3D::resize(int batch){
   LPool3D::resize(batch);
 
-  delete pd->indX; pd->indX = new Tensor(pd->O->shape, dev);
-  delete pd->indY; pd->indY = new Tensor(pd->O->shape, dev);
-  delete pd->indZ; pd->indZ = new Tensor(pd->O->shape, dev);
+  pd->indX->resize(batch);
+  pd->indY->resize(batch);
+  pd->indZ->resize(batch);
 }
 
 void LMaxPool3D::forward() {
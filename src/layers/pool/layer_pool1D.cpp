@@ -74,3 +74,16 @@ void LPool1D::resize(int batch){
     // Resize but keeping the pointer to the output of the descriptor
     output->resize(batch, pd->O->ptr);
 }
+
+LayerCost LPool1D::get_cost(){
+    // One op per element of the window. Backward scatters each delta into the parent delta
+    double window = 1.0;
+    for (int k : pd->ksize) window *= k;
+
+    LayerCost cost;
+    cost.fwd_flops = window * (double)output->size;
+    cost.bwd_flops = window * (double)output->size;
+    cost.fwd_bytes = ((double)input->size + (double)output->size) * sizeof(float);
+    cost.bwd_bytes = (2.0 * (double)input->size + (double)output->size) * sizeof(float);
+    return cost;
+}
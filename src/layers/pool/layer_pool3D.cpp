@@ -59,3 +59,16 @@ void LPool3D::resize(int batch){
     pd->resize(batch);
     
 }
+
+LayerCost LPool3D::get_cost(){
+    // One op per element of the window. Backward scatters each delta into the parent delta
+    double window = 1.0;
+    for (int k : pd->ksize) window *= k;
+
+    LayerCost cost;
+    cost.fwd_flops = window * (double)output->size;
+    cost.bwd_flops = window * (double)output->size;
+    cost.fwd_bytes = ((double)input->size + (double)output->size) * sizeof(float);
+    cost.bwd_bytes = (2.0 * (double)input->size + (double)output->size) * sizeof(float);
+    return cost;
+}
@@ -608,6 +608,11 @@ Layer *LGRU::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LGRU::get_cost() {
+    return recurrent_cost(this, 3, 10.0);
+}
+
+
 string LGRU::plot(int c) {
     string s;
 
@@ -660,6 +660,11 @@ Layer *LLSTM::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost LLSTM::get_cost() {
+    return recurrent_cost(this, 4, 12.0);
+}
+
+
 string LLSTM::plot(int c) {
     string s;
 
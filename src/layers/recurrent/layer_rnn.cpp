@@ -258,6 +258,26 @@ Layer *LRNN::clone(int c, int bs, vector<Layer *> p, int todev) {
 }
 
 
+LayerCost recurrent_cost(Layer *l, int gates, double elementwise_ops) {
+    // Every weight (input and hidden matrices, one per gate) is used once per sample
+    double weights = 0.0;
+    for (auto *p : l->params) weights += (double)p->size;
+    double batch = (double)l->output->shape[0];
+    double units = (double)l->output->size;
+
+    LayerCost cost;
+    cost.fwd_flops = 2.0 * batch * weights + elementwise_ops * units;
+    cost.bwd_flops = 4.0 * batch * weights + 2.0 * elementwise_ops * units;
+    cost.fwd_bytes = ((double)l->input->size + weights + gates * units) * sizeof(float);
+    cost.bwd_bytes = (3.0 * (double)l->input->size + 2.0 * weights + 2.0 * gates * units) * sizeof(float);
+    return cost;
+}
+
+LayerCost LRNN::get_cost() {
+    return recurrent_cost(this, 1, 2.0);
+}
+
+
 string LRNN::plot(int c) {
     string s;
 
@@ -11,8 +11,13 @@
 //#define _GNU_SOURCE
 
 #include "eddl/mpi_distributed/mpi_distributed.h"
+#include "eddl/hardware/cpu/cpu_optim.h"
+#include "eddl/hardware/cpu/cpu_parallel.h"
 
+#include <algorithm>
+#include <climits>
 #include <chrono>
+#include <cstring>
 
 #include <sys/types.h>
 
@@ -104,6 +109,91 @@ int cuda_aware_allreduce = 1; // Default: use Cuda aware AllReduce
 float prev_losses = 1e10;
 float prev_metrics = 0;
 
+// Hierarchical (two-level) reduction. The ranks of a node (node_comm) reduce-scatter through an MPI-3
+// shared window, every rank allreduces its 1/node_size slice with the ranks of the same local index
+// on the other nodes (cross_comm), and the node gathers the slices back from the window
+int hierarchical = 0;
+int node_rank = 0;
+int node_size = 1;
+int cross_size = 1;
+#ifdef cMPI
+MPI_Comm node_comm = MPI_COMM_NULL;
+MPI_Comm cross_comm = MPI_COMM_NULL;
+MPI_Win node_win = MPI_WIN_NULL;
+vector<float*> node_seg; // Input segment of every rank of the node
+float* node_res = nullptr; // Reduced data, shared by the node (after the segment of node rank 0)
+long int node_cap = 0;
+#endif
+vector<float> avg_buffer; // All the params of the net, packed for a single reduction
+
+#ifdef cMPI
+// Communicator of the training processes: MPI_COMM_WORLD, then the survivors of failures (elastic training)
+MPI_Comm eddl_comm = MPI_COMM_WORLD;
+
+// Elastic training (see set_elastic_distributed). The collectives of eddl_comm are nonblocking and wait
+// at most elastic_timeout secs: a collective that does not complete in time means a failed process, and
+// throws ProcessFailure up to a point where the processes can recover (elastic_recover)
+struct ProcessFailure {};
+Net* elastic_net = nullptr;
+double elastic_timeout = 60.0;
+int elastic_failed = 0; // Failure detected where it can not be recovered (ZeroAdam::applygrads)
+static void elastic_recover();
+static void elastic_snapshot(Net* net);
+
+static void wait_distributed(MPI_Request* req) {
+    if (elastic_net == nullptr) {
+        MPICHECK(MPI_Wait(req, MPI_STATUS_IGNORE));
+        return;
+    }
+    double start = MPI_Wtime();
+    int done = 0;
+    while (!done) {
+        // On failure the request is abandoned: it can not be completed nor cancelled
+        if (MPI_Test(req, &done, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            throw ProcessFailure();
+        if (!done && MPI_Wtime() - start > elastic_timeout)
+            throw ProcessFailure();
+    }
+}
+
+#define ELASTIC_CHECK(cmd) do {                     \
+  if ((cmd) != MPI_SUCCESS) throw ProcessFailure(); \
+} while(0)
+
+static void allreduce_distributed(void* buf, int count, MPI_Datatype type, MPI_Op op) {
+    if (elastic_net == nullptr) {
+        MPICHECK(MPI_Allreduce(MPI_IN_PLACE, buf, count, type, op, eddl_comm));
+        return;
+    }
+    MPI_Request req;
+    ELASTIC_CHECK(MPI_Iallreduce(MPI_IN_PLACE, buf, count, type, op, eddl_comm, &req));
+    wait_distributed(&req);
+}
+
+static void bcast_distributed(void* buf, int count, MPI_Datatype type, int root) {
+    if (elastic_net == nullptr) {
+        MPICHECK(MPI_Bcast(buf, count, type, root, eddl_comm));
+        return;
+    }
+    MPI_Request req;
+    ELASTIC_CHECK(MPI_Ibcast(buf, count, type, root, eddl_comm, &req));
+    wait_distributed(&req);
+}
+
+// Runs the collectives of f. After a failure, the survivors recover and run them again
+template <typename F>
+static void elastic_retry(F f) {
+    while (true) {
+        try {
+            f();
+            return;
+        } catch (ProcessFailure &) {
+            elastic_recover();
+        }
+    }
+}
+#endif
+
 #define SILENT 1
 
 #define check_MPI(action) \
@@ -222,6 +312,7 @@ int init_MPI(int *argc, char ***argv) {
     if (id == 0)
         fprintf(stdout, "[DISTR] setting default batch avg method\n");
     set_avg_method_distributed(FIXED, AVG_DEFAULT);
+    set_hierarchical_distributed(1);
 
     // Initalize a different seed per proc
     srand((id + 1) * time(NULL));
@@ -335,7 +426,7 @@ void end_distributed() {
         return;
     }
 #ifdef cMPI 
-    MPICHECK(MPI_Barrier(MPI_COMM_WORLD));
+    barrier_distributed();
     //  Get the individual process ID.
     //MPI_Comm_rank(MPI_COMM_WORLD, &id);
 #endif
@@ -350,6 +441,8 @@ void end_distributed() {
 #endif
 
 #ifdef cMPI
+    set_pipeline_distributed(nullptr, 0);
+    set_hierarchical_distributed(0);
     if (id == 0)
         fprintf(stdout, "[DISTR] End\n");
     MPI_Finalize();
@@ -533,7 +626,7 @@ int set_NBPP_distributed(int ds_size, int local_batch, bool method) {
 void fn_mpi_AllReduce(float* myptr, int count) {
 #ifdef cMPI
     if (count > 0) {
-        MPICHECK(MPI_Allreduce(MPI_IN_PLACE, myptr, count, MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD));
+        allreduce_distributed(myptr, count, MPI_FLOAT, MPI_SUM);
     }
 #else
     msg("invalid call. MPI library is not linked", __func__);
@@ -543,7 +636,7 @@ void fn_mpi_AllReduce(float* myptr, int count) {
 void fn_mpi_Bcast(float* myptr, int count) {
 #ifdef cMPI
     if (count > 0) {
-        MPICHECK(MPI_Bcast(myptr, count, MPI_FLOAT, 0, MPI_COMM_WORLD));
+        bcast_distributed(myptr, count, MPI_FLOAT, 0);
         //printf("======fn_mpi_Bcast\n");
     }
 #else
@@ -551,6 +644,158 @@ void fn_mpi_Bcast(float* myptr, int count) {
 #endif
 }
 
+#ifdef cMPI
+static void free_node_window() {
+    if (node_win != MPI_WIN_NULL) {
+        MPICHECK(MPI_Win_unlock_all(node_win));
+        MPICHECK(MPI_Win_free(&node_win));
+    }
+    node_seg.clear();
+    node_res = nullptr;
+    node_cap = 0;
+}
+
+// Collective over node_comm: every rank of the node reduces the same count
+static void reserve_node_window(long int count) {
+    if (count <= node_cap) return;
+    free_node_window();
+    node_cap = count;
+
+    float* base;
+    MPI_Aint bytes = (MPI_Aint) node_cap * sizeof (float) * (node_rank == 0 ? 2 : 1);
+    MPICHECK(MPI_Win_allocate_shared(bytes, sizeof (float), MPI_INFO_NULL, node_comm, &base, &node_win));
+    MPICHECK(MPI_Win_lock_all(MPI_MODE_NOCHECK, node_win));
+
+    node_seg.resize(node_size);
+    for (int r = 0; r < node_size; r++) {
+        MPI_Aint size;
+        int disp;
+        MPICHECK(MPI_Win_shared_query(node_win, r, &size, &disp, &node_seg[r]));
+    }
+    node_res = node_seg[0] + node_cap;
+}
+
+// Makes the stores to the window visible to the whole node
+static void sync_node_window() {
+    MPICHECK(MPI_Win_sync(node_win));
+    MPICHECK(MPI_Barrier(node_comm));
+    MPICHECK(MPI_Win_sync(node_win));
+}
+#endif
+
+void set_hierarchical_distributed(int enable, int ranks_per_node) {
+#ifdef cMPI
+    free_node_window();
+    if (node_comm != MPI_COMM_NULL) MPICHECK(MPI_Comm_free(&node_comm));
+    if (cross_comm != MPI_COMM_NULL) MPICHECK(MPI_Comm_free(&cross_comm));
+    hierarchical = 0;
+    node_rank = 0;
+    node_size = 1;
+    cross_size = 1;
+    if (!enable || !use_mpi) return;
+    if (elastic_net != nullptr)
+        msg("The hierarchical reduction is not available with elastic training", __func__);
+
+    // Ranks sharing memory, optionally split in smaller groups (world rank 0 stays node rank 0)
+    MPI_Comm shared_comm;
+    int shared_rank;
+    MPICHECK(MPI_Comm_split_type(eddl_comm, MPI_COMM_TYPE_SHARED, id, MPI_INFO_NULL, &shared_comm));
+    MPICHECK(MPI_Comm_rank(shared_comm, &shared_rank));
+    MPICHECK(MPI_Comm_split(shared_comm, ranks_per_node > 0 ? shared_rank / ranks_per_node : 0, id, &node_comm));
+    MPICHECK(MPI_Comm_free(&shared_comm));
+    MPICHECK(MPI_Comm_rank(node_comm, &node_rank));
+    MPICHECK(MPI_Comm_size(node_comm, &node_size));
+
+    // The slices must match among nodes: every node needs the same nr of ranks
+    int min_size, max_size;
+    MPICHECK(MPI_Allreduce(&node_size, &min_size, 1, MPI_INT, MPI_MIN, eddl_comm));
+    MPICHECK(MPI_Allreduce(&node_size, &max_size, 1, MPI_INT, MPI_MAX, eddl_comm));
+    if (min_size != max_size || node_size == 1) {
+        if (id == 0)
+            fprintf(stdout, "[DISTR] %s. Flat allreduce (%d to %d ranks per node)\n", __func__, min_size, max_size);
+        MPICHECK(MPI_Comm_free(&node_comm));
+        node_rank = 0;
+        node_size = 1;
+        return;
+    }
+
+    MPICHECK(MPI_Comm_split(eddl_comm, node_rank, id, &cross_comm));
+    MPICHECK(MPI_Comm_size(cross_comm, &cross_size));
+    hierarchical = 1;
+    if (id == 0)
+        fprintf(stdout, "[DISTR] %s. Hierarchical allreduce: %d nodes x %d ranks\n", __func__, cross_size, node_size);
+#endif
+}
+
+void fn_mpi_hier_AllReduce(float* myptr, size_t count) {
+#ifdef cMPI
+    // MPI counts are int: the flat reduction goes in chunks of INT_MAX
+    if (!hierarchical) {
+        for (size_t off = 0; off < count; off += INT_MAX)
+            fn_mpi_AllReduce(myptr + off, (int) std::min(count - off, (size_t) INT_MAX));
+        return;
+    }
+    if (count == 0) return;
+
+    reserve_node_window(count);
+    memcpy(node_seg[node_rank], myptr, count * sizeof (float));
+    sync_node_window();
+
+    // Reduce-scatter in the node: every rank sums its slice of all the segments
+    long int lo = (long int) count * node_rank / node_size;
+    long int hi = (long int) count * (node_rank + 1) / node_size;
+    const long int block = 4096;
+    long int nblocks = (hi - lo + block - 1) / block;
+    #pragma omp parallel for num_threads(cpu_threads((hi - lo) * node_size, CPU_COST_CHEAP))
+    for (long int b = 0; b < nblocks; b++) {
+        long int b0 = lo + b * block, b1 = std::min(hi, b0 + block);
+        float* res = node_res;
+        memcpy(res + b0, node_seg[0] + b0, (b1 - b0) * sizeof (float));
+        for (int r = 1; r < node_size; r++) {
+            const float* seg = node_seg[r];
+            #pragma omp simd
+            for (long int i = b0; i < b1; i++) res[i] += seg[i];
+        }
+    }
+
+    // Allreduce among the nodes, 1/node_size of the data per rank (in chunks of INT_MAX)
+    if (cross_size > 1)
+        for (long int c0 = lo; c0 < hi; c0 += INT_MAX)
+            MPICHECK(MPI_Allreduce(MPI_IN_PLACE, node_res + c0, (int) std::min(hi - c0, (long int) INT_MAX), MPI_FLOAT, MPI_SUM, cross_comm));
+    sync_node_window();
+
+    // Allgather in the node
+    memcpy(myptr, node_res, count * sizeof (float));
+#else
+    msg("invalid call. MPI library is not linked", __func__);
+#endif
+}
+
+void fn_mpi_hier_Bcast(float* myptr, int count) {
+#ifdef cMPI
+    if (!hierarchical) {
+        fn_mpi_Bcast(myptr, count);
+        return;
+    }
+    if (count <= 0) return;
+
+    // Among the first ranks of the nodes (rank 0 is the first one of its node), then through the segment
+    // of node rank 0. Not through node_res: the node may still be copying out the last reduction
+    reserve_node_window(count);
+    if (node_rank == 0) {
+        if (cross_size > 1)
+            MPICHECK(MPI_Bcast(myptr, count, MPI_FLOAT, 0, cross_comm));
+        memcpy(node_seg[0], myptr, count * sizeof (float));
+    }
+    sync_node_window();
+    if (node_rank != 0)
+        memcpy(myptr, node_seg[0], count * sizeof (float));
+    sync_node_window(); // The segment is overwritten by the next call
+#else
+    msg("invalid call. MPI library is not linked", __func__);
+#endif
+}
+
 void fn_nccl_AllReduce(float* myptr, int count) {
 #ifdef cNCCL
     if (count > 0) {
@@ -635,7 +880,7 @@ void fn_Bcast_CPU_weights(Net* net) {
             for (j = 0; j < layers[i]->get_trainable_params_count(); j++) {
                 float* myptr = layers[i]->params[j]->ptr;
                 size = layers[i]->params[j]->size;
-                fn_mpi_Bcast(myptr, size);
+                fn_mpi_hier_Bcast(myptr, size);
             }
         }
     }
@@ -658,7 +903,7 @@ void fn_Bcast_GPU_weights(Net* net) {
                         // CUDA-aware Bcast cause segmentation fault
                         //printf("############ BROADCAST ############\n");
                         Tensor::copy(net->snets[0]->layers[i]->params[j], net->layers[i]->params[j]);
-                        fn_mpi_Bcast(net->layers[i]->params[j]->ptr, count);
+                        fn_mpi_hier_Bcast(net->layers[i]->params[j]->ptr, count);
                         Tensor::copy(net->layers[i]->params[j], net->snets[0]->layers[i]->params[j]);
                     } else {
                         fn_mpi_Bcast(myptr, count);
@@ -675,12 +920,20 @@ void bcast_weights_distributed(Net * net) {
     if (id == 0)
         printf("[DISTR] %s.\n", __func__);
 
-    if (net->cs->hw == "gpu")
-        fn_Bcast_GPU_weights(net);
-    else if (net->cs->hw == "cpu")
-        fn_Bcast_CPU_weights(net);
-    else
-        msg("Error unsupported device", __func__); // Exits
+#ifdef cMPI
+    elastic_retry([&]() {
+#endif
+        if (net->cs->hw == "gpu")
+            fn_Bcast_GPU_weights(net);
+        else if (net->cs->hw == "cpu")
+            fn_Bcast_CPU_weights(net);
+        else
+            msg("Error unsupported device", __func__); // Exits
+#ifdef cMPI
+        // The same weights everywhere: a consistent snapshot
+        if (net == elastic_net) elastic_snapshot(net);
+    });
+#endif
 }
 
 void avg_GPU_weights_distributed(Net* net, int curr_batch, int batches_per_proc) {
@@ -713,7 +966,7 @@ void avg_GPU_weights_distributed(Net* net, int curr_batch, int batches_per_proc)
                                 // CUDA-aware Bcast cause segmentation fault
                                 //printf("############ BROADCAST ############\n");
                                 Tensor::copy(net->snets[0]->layers[i]->params[j], net->layers[i]->params[j]);
-                                fn_mpi_AllReduce(net->layers[i]->params[j]->ptr, count);
+                                fn_mpi_hier_AllReduce(net->layers[i]->params[j]->ptr, count);
                                 Tensor::copy(net->layers[i]->params[j], net->snets[0]->layers[i]->params[j]);
                             } else {
                                 fn_mpi_AllReduce(myptr, count);
@@ -738,20 +991,40 @@ void avg_CPU_weights_distributed(Net* net, int curr_batch, int batches_per_proc)
 
     if ((((curr_batch) % batches_avg) == 0) || ((curr_batch) == batches_per_proc)) {
         // printf("Proc %d Sincronizando \n", id);
+        // All the params in a single reduction: one round of synchronization instead of one per tensor
+        long int total = 0;
+        for (int i = 0; i < net->layers.size(); i++)
+            if (net->layers[i]->trainable)
+                for (int j = 0; j < net->layers[i]->get_trainable_params_count(); j++)
+                    total += net->layers[i]->params[j]->size;
+        if (total == 0) return;
+        avg_buffer.resize(total);
+
+        long int offset = 0;
         for (int i = 0; i < net->layers.size(); i++) {
             if (net->layers[i]->trainable) {
                 for (int j = 0; j < net->layers[i]->get_trainable_params_count(); j++) {
-                    //for (int ii = 0; ii < net->snets[0]->layers.size(); ii++) {
-                    //    for (int jj = 0; jj < net->snets[0]->layers[ii]->params.size(); jj++) {
                     myptr = net->layers[i]->params[j]->ptr;
                     count = net->layers[i]->params[j]->size;
-                    //printf("\n===== Proc %d Batch %d Bucle ii=%d jj=%d size=%d\n", id, j, ii,jj,count );
-                    if (count != 0) {
-                        // AllReduce params
-                        fn_mpi_AllReduce(myptr, count);
-                        // Average params
-                        net->layers[i]->params[j]->div_(n_procs);
-                    }
+                    memcpy(avg_buffer.data() + offset, myptr, count * sizeof (float));
+                    offset += count;
+                }
+            }
+        }
+
+        // AllReduce params
+        fn_mpi_hier_AllReduce(avg_buffer.data(), total);
+
+        // Average params
+        float scale = 1.0f / n_procs;
+        offset = 0;
+        for (int i = 0; i < net->layers.size(); i++) {
+            if (net->layers[i]->trainable) {
+                for (int j = 0; j < net->layers[i]->get_trainable_params_count(); j++) {
+                    myptr = net->layers[i]->params[j]->ptr;
+                    count = net->layers[i]->params[j]->size;
+                    for (int k = 0; k < count; k++) myptr[k] = avg_buffer[offset + k] * scale;
+                    offset += count;
                 }
             }
         }
@@ -766,13 +1039,21 @@ void avg_metrics_distributed(Net* net) {
     for (int k = 0; k < net->lout.size(); k += net->decsize) {
         if (net->losses.size() >= (k + 1)) {
 #ifdef cMPI       
-            MPICHECK(MPI_Allreduce(MPI_IN_PLACE, &net->total_loss[k], 1, MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD));
+            float loss = net->total_loss[k];
+            elastic_retry([&]() {
+                net->total_loss[k] = loss;
+                allreduce_distributed(&net->total_loss[k], 1, MPI_FLOAT, MPI_SUM);
+            });
             net->total_loss[k] = net->total_loss[k] / n_procs;
 #endif
         }
         if (net->metrics.size() >= (k + 1)) {
 #ifdef cMPI                                     
-            MPICHECK(MPI_Allreduce(MPI_IN_PLACE, &net->total_metric[k], 1, MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD));
+            float metric = net->total_metric[k];
+            elastic_retry([&]() {
+                net->total_metric[k] = metric;
+                allreduce_distributed(&net->total_metric[k], 1, MPI_FLOAT, MPI_SUM);
+            });
             net->total_metric[k] = net->total_metric[k] / n_procs;
 #endif                    
         }
@@ -786,7 +1067,11 @@ void avg_float_distributed(float* pvar) {
     check_MPI(return)
 
 #ifdef cMPI       
-            MPICHECK(MPI_Allreduce(MPI_IN_PLACE, pvar, 1, MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD));
+    float var = *pvar;
+    elastic_retry([&]() {
+        *pvar = var;
+        allreduce_distributed(pvar, 1, MPI_FLOAT, MPI_SUM);
+    });
     *pvar = *pvar / n_procs;
 #endif
 }
@@ -798,13 +1083,586 @@ void barrier_distributed() {
 
     if (is_mpi_distributed()) {
 #ifdef cMPI       
-        MPICHECK(MPI_Barrier(MPI_COMM_WORLD));
+        elastic_retry([]() {
+            if (elastic_net == nullptr) {
+                MPICHECK(MPI_Barrier(eddl_comm));
+                return;
+            }
+            MPI_Request req;
+            ELASTIC_CHECK(MPI_Ibarrier(eddl_comm, &req));
+            wait_distributed(&req);
+        });
 #endif
     }
 }
 
+// ZeRO-style sharding (optimizer state and update) of Adam among the processes. The trainable params
+// are seen as one flat array split in n_procs chunks: the gradients are reduce-scattered (averaged), every
+// process updates its chunk with the moments of that chunk only, and the new weights are allgathered. It
+// takes the place of the optimizer of the net, so the weights are in sync after every batch. Both
+// collectives go in buckets (the same slice of every chunk), so only a bucket of the flat array is
+// ever built
+#define ZERO_BUCKET (1 << 20)  // Floats of a bucket, among all the processes
+
+class ZeroAdam : public Optimizer {
+public:
+    Adam *adam;
+    bool do_adam_delete;
+    vtensor params;         // Trainable params and their gradients, in the order of Adam::setlayers
+    vtensor grads;
+    vector<Layer*> owner;
+    vector<long int> offset;
+    long int total, chunk, lo;
+    long int slice;         // Elements of every chunk in a bucket
+    vector<float> bucket;   // slice * n_procs
+    Tensor *g, *m, *v;      // Chunk of this process
+
+    ZeroAdam(Adam *adam, bool do_adam_delete) : Optimizer() {
+        name = "zero_" + adam->name;
+        this->adam = adam;
+        this->do_adam_delete = do_adam_delete;
+        layers = adam->layers;
+
+        total = 0;
+        for (auto l : layers)
+            for (int j = 0; j < l->get_trainable_params_count(); j++) {
+                params.push_back(l->params[j]);
+                grads.push_back(l->gradients[j]);
+                owner.push_back(l);
+                offset.push_back(total);
+                total += l->params[j]->size;
+            }
+        chunk = (total + n_procs - 1) / n_procs;
+        lo = chunk * id;
+        slice = std::max(1L, std::min(chunk, (long int) (ZERO_BUCKET / n_procs)));
+        bucket.assign(slice * n_procs, 0.0f);
+
+        // Moments of the chunk, from the full ones
+        g = new Tensor({(int) chunk}, DEV_CPU);
+        m = new Tensor({(int) chunk}, DEV_CPU);
+        v = new Tensor({(int) chunk}, DEV_CPU);
+        gather_chunk(adam->mT, m->ptr);
+        gather_chunk(adam->vT, v->ptr);
+
+        drop_state(adam);
+    }
+
+    // Drops the full state
+    static void drop_state(Adam *adam) {
+        for (auto t : adam->mT) delete t;
+        for (auto t : adam->vT) delete t;
+        for (auto t : adam->mCap) delete t;
+        for (auto t : adam->vCap) delete t;
+        adam->mT.clear();
+        adam->vT.clear();
+        adam->mCap.clear();
+        adam->vCap.clear();
+    }
+
+    ~ZeroAdam() override {
+        delete g;
+        delete m;
+        delete v;
+        if (adam != nullptr && do_adam_delete) delete adam;
+    }
+
+    // Applies F(k, first, count, position in [a, b)) to the overlap of every param with [a, b) of the flat array
+    template <typename F>
+    void for_range(long int a, long int b, F f) {
+        int k = (int) (std::upper_bound(offset.begin(), offset.end(), a) - offset.begin()) - 1;
+        for (k = std::max(k, 0); k < params.size() && offset[k] < b; k++) {
+            long int a1 = std::max(a, offset[k]);
+            long int b1 = std::min(b, offset[k] + (long int) params[k]->size);
+            if (a1 < b1) f(k, a1 - offset[k], b1 - a1, a1 - a);
+        }
+    }
+
+    // The same, with the chunk of this process
+    template <typename F>
+    void for_chunk(F f) { for_range(lo, lo + chunk, f); }
+
+    void gather_chunk(const vtensor &full, float *dst) {
+        for_chunk([&](int k, long int first, long int count, long int pos) {
+            memcpy(dst + pos, full[k]->ptr + first, count * sizeof (float));
+        });
+    }
+
+    // [a, a + count) of the flat array of tensors to dst, zeros past the end
+    void to_flat(const vtensor &full, long int a, long int count, float *dst) {
+        if (a + count > total) std::fill(dst + std::max(0L, total - a), dst + count, 0.0f);
+        for_range(a, a + count, [&](int k, long int first, long int n, long int pos) {
+            memcpy(dst + pos, full[k]->ptr + first, n * sizeof (float));
+        });
+    }
+
+    void from_flat(const vtensor &full, long int a, long int count, const float *src) {
+        for_range(a, a + count, [&](int k, long int first, long int n, long int pos) {
+            memcpy(full[k]->ptr + first, src + pos, n * sizeof (float));
+        });
+    }
+
+    // Sums the gradients of all the processes into g (the chunk of this process), bucket by bucket
+    void reduce_scatter() {
+        for (long int b0 = 0; b0 < chunk; b0 += slice) {
+            long int n = std::min(slice, chunk - b0);
+            for (int p = 0; p < n_procs; p++)
+                to_flat(grads, p * chunk + b0, n, bucket.data() + p * n);
+#ifdef cMPI
+            if (elastic_net == nullptr) {
+                MPICHECK(MPI_Reduce_scatter_block(MPI_IN_PLACE, bucket.data(), (int) n, MPI_FLOAT, MPI_SUM, eddl_comm));
+            } else {
+                MPI_Request req;
+                ELASTIC_CHECK(MPI_Ireduce_scatter_block(MPI_IN_PLACE, bucket.data(), (int) n, MPI_FLOAT, MPI_SUM,
+                                                        eddl_comm, &req));
+                wait_distributed(&req);
+            }
+#endif
+            memcpy(g->ptr + b0, bucket.data(), n * sizeof (float));
+        }
+    }
+
+    // Allgathers the chunk of every process, that is in its tensors, bucket by bucket
+    void allgather(const vtensor &full) {
+        for (long int b0 = 0; b0 < chunk; b0 += slice) {
+            long int n = std::min(slice, chunk - b0);
+            to_flat(full, lo + b0, n, bucket.data() + id * n);
+#ifdef cMPI
+            if (elastic_net == nullptr) {
+                MPICHECK(MPI_Allgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, bucket.data(), (int) n, MPI_FLOAT, eddl_comm));
+            } else {
+                MPI_Request req;
+                ELASTIC_CHECK(MPI_Iallgather(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, bucket.data(), (int) n, MPI_FLOAT,
+                                             eddl_comm, &req));
+                wait_distributed(&req);
+            }
+#endif
+            for (int p = 0; p < n_procs; p++)
+                if (p != id) from_flat(full, p * chunk + b0, n, bucket.data() + p * n);
+        }
+    }
+
+    void applygrads(int batch) override {
+#ifdef cMPI
+        // Elastic training: the processes recover in avg_weights_distributed
+        if (elastic_failed) return;
+        try {
+#endif
+            adam->clip();
+            adam->t++;
+
+            reduce_scatter();
+            g->div_(n_procs);
+
+            for_chunk([&](int k, long int first, long int count, long int pos) {
+                if (owner[k]->trainable)
+                    cpu_adam_update(params[k]->ptr + first, g->ptr + pos, m->ptr + pos, v->ptr + pos, nullptr, count,
+                                    adam->lr, adam->beta_1, adam->beta_2, adam->epsilon, adam->t);
+            });
+            allgather(params);
+#ifdef cMPI
+        } catch (ProcessFailure &) {
+            elastic_failed = 1;
+        }
+#endif
+    }
+
+    Optimizer *clone() override { return adam->clone(); }
+    Optimizer *share() override { return adam->share(); }
+    void change(vector<float> p) override { adam->change(p); }
+    long get_step() override { return adam->get_step(); }
+    void set_step(long step) override { adam->set_step(step); }
+
+    void get_state(vector<string> &names, vtensor &tensors) override {
+        names.push_back("optimizer/zero/mT/" + to_string(id) + "_of_" + to_string(n_procs));
+        tensors.push_back(m);
+        names.push_back("optimizer/zero/vT/" + to_string(id) + "_of_" + to_string(n_procs));
+        tensors.push_back(v);
+    }
+};
+
+void set_zero_distributed(Net* net, int enable) {
+    check_MPI(return);
+    auto *zero = dynamic_cast<ZeroAdam*>(net->optimizer);
+    if ((zero != nullptr) == (enable != 0)) return;
+
+    if (enable) {
+        auto *adam = dynamic_cast<Adam*>(net->optimizer);
+        if (adam == nullptr)
+            msg("Only the Adam optimizer can be sharded", __func__);
+        if (net->snets.size() != 1 || net->snets[0] != net || net->dev != DEV_CPU)
+            msg("Only nets on CPU can shard the optimizer", __func__);
+        for (auto l : net->layers)
+            if (l->acc_gradients.size() > 0)
+                msg("The accumulated gradients are not supported", __func__);
+
+        net->optimizer = new ZeroAdam(adam, net->do_optimizer_delete);
+        net->do_optimizer_delete = true;
+        if (id == 0)
+            fprintf(stdout, "[DISTR] %s. Adam state sharded among %d processes\n", __func__, n_procs);
+    } else {
+        // Back to the full state of every process
+#ifdef cMPI
+        elastic_retry([&]() {
+            if (elastic_failed) throw ProcessFailure();
+            zero = dynamic_cast<ZeroAdam*>(net->optimizer); // Sharded again by a recovery
+#endif
+            ZeroAdam::drop_state(zero->adam);
+            zero->adam->setlayers(zero->adam->layers);
+            zero->for_chunk([&](int k, long int first, long int count, long int pos) {
+                memcpy(zero->adam->mT[k]->ptr + first, zero->m->ptr + pos, count * sizeof (float));
+                memcpy(zero->adam->vT[k]->ptr + first, zero->v->ptr + pos, count * sizeof (float));
+            });
+            zero->allgather(zero->adam->mT);
+            zero->allgather(zero->adam->vT);
+#ifdef cMPI
+        });
+#endif
+
+        net->optimizer = zero->adam;
+        net->do_optimizer_delete = zero->do_adam_delete;
+        zero->adam = nullptr;
+        delete zero;
+    }
+}
+
+#ifdef cMPI
+// Elastic training. Every process keeps its last two snapshots (params of the net, optimizer state and
+// step) and the last two of the previous process of the ring, its buddy. The snapshots are taken at sync
+// points (same params in all the processes) and a version counts as done when the replicas are exchanged,
+// so the versions of the processes differ by one at most. After a failure, the survivors agree on who is
+// alive with two rounds of messages on elastic_ctl, build a new eddl_comm and roll back to the last version
+// all of them have. The sharded Adam state of the failed processes comes from the replicas of their buddies
+struct ElasticSnapshot {
+    int64_t info[2] = {-1, 0};  // Version and optimizer step
+    vector<int> ranks;      // World ranks of the ring (eddl_comm) of the snapshot
+    vector<float> data;
+};
+
+static int elastic_every = 0;                   // Batches between snapshots
+static int elastic_batches = 0;                 // Batches since the last snapshot
+static int elastic_version = 0;                 // Last version done
+static int elastic_round = 0;                   // Nr of recoveries
+static int elastic_me = 0;                      // World rank
+static MPI_Comm elastic_ctl = MPI_COMM_NULL;    // Dup of MPI_COMM_WORLD for the agreement on the survivors
+static vector<int> elastic_ranks;               // World rank of every process of eddl_comm
+static ElasticSnapshot elastic_own[2], elastic_buddy[2];
+static vector<Optimizer*> elastic_orphans;      // Their buffers may still be in abandoned requests
+
+#define ELASTIC_TAG 7
+
+static vtensor elastic_params(Net* net) {
+    vtensor ts;
+    for (auto l : net->snets[0]->layers)
+        for (auto p : l->params) ts.push_back(p);
+    return ts;
+}
+
+static vtensor elastic_state(Net* net) {
+    vtensor ts;
+    vector<string> names;
+    net->snets[0]->optimizer->get_state(names, ts);
+    return ts;
+}
+
+static void elastic_save(vtensor ts, float* dst) {
+    for (auto t : ts) {
+        if (t->isCPU()) {
+            memcpy(dst, t->ptr, t->size * sizeof (float));
+        } else {
+            Tensor* h = new Tensor(t->getShape(), DEV_CPU);
+            Tensor::copy(t, h);
+            memcpy(dst, h->ptr, t->size * sizeof (float));
+            delete h;
+        }
+        dst += t->size;
+    }
+}
+
+static void elastic_load(vtensor ts, const float* src) {
+    for (auto t : ts) {
+        if (t->isCPU()) {
+            memcpy(t->ptr, src, t->size * sizeof (float));
+        } else {
+            Tensor* h = new Tensor(t->getShape(), DEV_CPU);
+            memcpy(h->ptr, src, t->size * sizeof (float));
+            Tensor::copy(h, t);
+            delete h;
+        }
+        src += t->size;
+    }
+}
+
+static long int elastic_size(vtensor ts) {
+    long int size = 0;
+    for (auto t : ts) size += t->size;
+    return size;
+}
+
+static void elastic_snapshot(Net* net) {
+    int version = elastic_version + 1;
+    ElasticSnapshot &own = elastic_own[version % 2], &buddy = elastic_buddy[version % 2];
+    vtensor params = elastic_params(net), state = elastic_state(net);
+    long int size = elastic_size(params) + elastic_size(state);
+
+    buddy.info[0] = -1;
+    own.info[0] = version; // Done once replicated (elastic_version)
+    own.info[1] = net->snets[0]->optimizer->get_step();
+    own.ranks = elastic_ranks;
+    own.data.resize(size);
+    elastic_save(params, own.data.data());
+    elastic_save(state, own.data.data() + elastic_size(params));
+
+    // Replica to the next process, from the previous one
+    if (n_procs > 1) {
+        int next = (id + 1) % n_procs, prev = (id + n_procs - 1) % n_procs;
+        buddy.ranks = elastic_ranks;
+        buddy.data.resize(size);
+        // The data in chunks of INT_MAX floats (MPI counts), matched in order (same source and tag)
+        vector<MPI_Request> req(2, MPI_REQUEST_NULL);
+        ELASTIC_CHECK(MPI_Irecv(buddy.info, 2, MPI_INT64_T, prev, ELASTIC_TAG, eddl_comm, &req[0]));
+        ELASTIC_CHECK(MPI_Isend(own.info, 2, MPI_INT64_T, next, ELASTIC_TAG, eddl_comm, &req[1]));
+        for (long int off = 0; off < size; off += INT_MAX) {
+            int count = (int) std::min(size - off, (long int) INT_MAX);
+            req.push_back(MPI_REQUEST_NULL);
+            ELASTIC_CHECK(MPI_Irecv(buddy.data.data() + off, count, MPI_FLOAT, prev, ELASTIC_TAG, eddl_comm, &req.back()));
+            req.push_back(MPI_REQUEST_NULL);
+            ELASTIC_CHECK(MPI_Isend(own.data.data() + off, count, MPI_FLOAT, next, ELASTIC_TAG, eddl_comm, &req.back()));
+        }
+        for (auto &r : req) wait_distributed(&r);
+    }
+    elastic_version = version;
+    elastic_batches = 0;
+}
+
+// Sends msg to every peer (world ranks) and receives theirs, within elastic_timeout. Empty: not heard from
+static vector<vector<int>> elastic_exchange(const vector<int> &peers, vector<int> &msg, int tag) {
+    vector<vector<int>> recv(peers.size());
+    vector<MPI_Request> rreq(peers.size(), MPI_REQUEST_NULL), sreq(peers.size(), MPI_REQUEST_NULL);
+    int pending = 0;
+    for (int i = 0; i < peers.size(); i++) {
+        if (peers[i] == elastic_me) continue;
+        recv[i].resize(msg.size());
+        if (MPI_Irecv(recv[i].data(), (int) msg.size(), MPI_INT, peers[i], tag, elastic_ctl, &rreq[i]) == MPI_SUCCESS)
+            pending++;
+        else
+            rreq[i] = MPI_REQUEST_NULL;
+        if (MPI_Isend(msg.data(), (int) msg.size(), MPI_INT, peers[i], tag, elastic_ctl, &sreq[i]) != MPI_SUCCESS)
+            sreq[i] = MPI_REQUEST_NULL;
+    }
+
+    vector<int> heard(peers.size(), 0);
+    double start = MPI_Wtime();
+    while (pending > 0 && MPI_Wtime() - start < elastic_timeout) {
+        for (int i = 0; i < peers.size(); i++) {
+            if (rreq[i] == MPI_REQUEST_NULL) continue;
+            int done = 0;
+            int err = MPI_Test(&rreq[i], &done, MPI_STATUS_IGNORE);
+            if (err != MPI_SUCCESS || done) {
+                heard[i] = (err == MPI_SUCCESS);
+                rreq[i] = MPI_REQUEST_NULL;
+                pending--;
+            }
+        }
+    }
+
+    for (int i = 0; i < peers.size(); i++) {
+        if (rreq[i] != MPI_REQUEST_NULL) {
+            MPI_Cancel(&rreq[i]);
+            MPI_Request_free(&rreq[i]);
+        }
+        if (sreq[i] != MPI_REQUEST_NULL) MPI_Request_free(&sreq[i]);
+        if (!heard[i]) recv[i].clear();
+    }
+    return recv;
+}
+
+// World ranks of the survivors. Every process of eddl_comm tells the others it is alive, then who it has
+// heard from. A process survives if all the ones it has heard from have heard from it
+static vector<int> elastic_survivors() {
+    int world;
+    MPI_Comm_size(MPI_COMM_WORLD, &world);
+    static vector<int> hello, heard; // The sends to failed processes never complete
+
+    hello.assign(1, elastic_me);
+    vector<vector<int>> recv = elastic_exchange(elastic_ranks, hello, 2 * elastic_round);
+    heard.assign(world, 0);
+    vector<int> peers;
+    for (int i = 0; i < elastic_ranks.size(); i++)
+        if (elastic_ranks[i] == elastic_me || !recv[i].empty()) {
+            heard[elastic_ranks[i]] = 1;
+            peers.push_back(elastic_ranks[i]);
+        }
+
+    recv = elastic_exchange(peers, heard, 2 * elastic_round + 1);
+    vector<int> alive;
+    for (int i = 0; i < peers.size(); i++) {
+        bool keep = peers[i] == elastic_me || !recv[i].empty();
+        for (int j = 0; j < peers.size() && keep; j++)
+            if (!recv[j].empty() && !recv[j][peers[i]]) keep = false;
+        if (keep) alive.push_back(peers[i]);
+    }
+    return alive;
+}
+
+// Adam moments of the snapshot: the chunk of every process of the ring of the snapshot, the ones of
+// the failed processes from their buddies, sharded again among the survivors
+static void elastic_reshard(Net* net, ZeroAdam* zero, ElasticSnapshot &own, ElasticSnapshot &buddy, long int pos) {
+    int ring = own.ranks.size();
+    int me = (int) (std::find(own.ranks.begin(), own.ranks.end(), elastic_me) - own.ranks.begin());
+    int prev = (me + ring - 1) % ring;
+    long int total = zero->total;
+    long int chunk = (total + ring - 1) / ring;
+
+    vector<float> m(chunk * ring, 0.0f), v(chunk * ring, 0.0f);
+    vector<int> have(ring, 0);
+    auto put = [&](ElasticSnapshot &s, int r) {
+        memcpy(m.data() + r * chunk, s.data.data() + pos, chunk * sizeof (float));
+        memcpy(v.data() + r * chunk, s.data.data() + pos + chunk, chunk * sizeof (float));
+        have[r] = 1;
+    };
+    put(own, me);
+    bool prev_failed = std::find(elastic_ranks.begin(), elastic_ranks.end(), own.ranks[prev]) == elastic_ranks.end();
+    if (prev_failed && buddy.info[0] == own.info[0]) put(buddy, prev);
+    allreduce_distributed(m.data(), (int) m.size(), MPI_FLOAT, MPI_SUM);
+    allreduce_distributed(v.data(), (int) v.size(), MPI_FLOAT, MPI_SUM);
+    allreduce_distributed(have.data(), ring, MPI_INT, MPI_SUM);
+    for (int r = 0; r < ring; r++)
+        if (!have[r])
+            msg("The optimizer state of a failed process and of its buddy is lost", "elastic_recover");
+
+    Adam* adam = zero->adam;
+    ZeroAdam::drop_state(adam);
+    adam->setlayers(adam->layers);
+    for (int k = 0; k < zero->params.size(); k++) {
+        memcpy(adam->mT[k]->ptr, m.data() + zero->offset[k], zero->params[k]->size * sizeof (float));
+        memcpy(adam->vT[k]->ptr, v.data() + zero->offset[k], zero->params[k]->size * sizeof (float));
+    }
+    net->optimizer = new ZeroAdam(adam, zero->do_adam_delete);
+    zero->adam = nullptr;
+    elastic_orphans.push_back(zero);
+}
+
+static void elastic_restore(Net* net, int version) {
+    ElasticSnapshot &own = elastic_own[version % 2], &buddy = elastic_buddy[version % 2];
+    if (own.info[0] != version)
+        msg("Snapshot " + to_string(version) + " is lost", "elastic_recover");
+
+    vtensor params = elastic_params(net);
+    elastic_load(params, own.data.data());
+    net->snets[0]->optimizer->set_step(own.info[1]);
+    auto *zero = dynamic_cast<ZeroAdam*>(net->optimizer);
+    if (zero != nullptr)
+        elastic_reshard(net, zero, own, buddy, elastic_size(params));
+    else
+        elastic_load(elastic_state(net), own.data.data() + elastic_size(params));
+}
+
+static void elastic_recover() {
+    Net* net = elastic_net;
+    int before = elastic_ranks.size();
+    while (true) {
+        try {
+            vector<int> alive = elastic_survivors();
+            elastic_round++;
+
+            // The previous communicator is not freed: it has abandoned requests
+            MPI_Group world_group, group;
+            MPI_Comm comm;
+            MPICHECK(MPI_Comm_group(elastic_ctl, &world_group));
+            MPICHECK(MPI_Group_incl(world_group, (int) alive.size(), alive.data(), &group));
+            ELASTIC_CHECK(MPI_Comm_create_group(elastic_ctl, group, elastic_round, &comm));
+            MPICHECK(MPI_Group_free(&group));
+            MPICHECK(MPI_Group_free(&world_group));
+            MPICHECK(MPI_Comm_set_errhandler(comm, MPI_ERRORS_RETURN));
+            eddl_comm = comm;
+            elastic_ranks = alive;
+            MPICHECK(MPI_Comm_rank(eddl_comm, &id));
+            MPICHECK(MPI_Comm_size(eddl_comm, &n_procs));
+
+            // Back to the last version of all the survivors, replicated again in the new ring
+            int version = elastic_version;
+            allreduce_distributed(&version, 1, MPI_INT, MPI_MIN);
+            elastic_restore(net, version);
+            elastic_version = version;
+            elastic_failed = 0;
+            if (id == 0)
+                fprintf(stdout, "[DISTR] %s. %d process(es) failed. Going on with %d processes from snapshot %d\n",
+                        __func__, before - n_procs, n_procs, version);
+            elastic_snapshot(net);
+            return;
+        } catch (ProcessFailure &) {
+            // Another failure while recovering
+        }
+    }
+}
+
+static void elastic_avg_weights(Net* net, int curr_batch, int batches_per_proc) {
+    try {
+        if (elastic_failed) throw ProcessFailure();
+        bool synced = true; // Sharded optimizer: the weights are in sync after every batch
+        if (dynamic_cast<ZeroAdam*>(net->optimizer) == nullptr) {
+            synced = ((curr_batch % batches_avg) == 0) || (curr_batch == batches_per_proc);
+            if (net->cs->hw == "gpu")
+                avg_GPU_weights_distributed(net, curr_batch, batches_per_proc);
+            else
+                avg_CPU_weights_distributed(net, curr_batch, batches_per_proc);
+        }
+        elastic_batches++;
+        if (synced && elastic_batches >= elastic_every)
+            elastic_snapshot(net);
+    } catch (ProcessFailure &) {
+        elastic_recover();
+    }
+}
+#endif
+
+void set_elastic_distributed(Net* net, int snapshot_batches, float timeout) {
+    check_MPI(return);
+#ifdef cMPI
+    if (snapshot_batches <= 0) {
+        elastic_net = nullptr;
+        for (int i = 0; i < 2; i++) {
+            elastic_own[i] = ElasticSnapshot();
+            elastic_buddy[i] = ElasticSnapshot();
+        }
+        return;
+    }
+    if (lib == "NCCL")
+        msg("NCCL communicators can not be rebuilt. Use MPI", __func__);
+    if (net->snets.size() != 1)
+        msg("Elastic training needs one device per process", __func__);
+    set_hierarchical_distributed(0);
+
+    if (elastic_ctl == MPI_COMM_NULL) {
+        MPI_Comm comm;
+        MPICHECK(MPI_Comm_dup(MPI_COMM_WORLD, &elastic_ctl));
+        MPICHECK(MPI_Comm_set_errhandler(elastic_ctl, MPI_ERRORS_RETURN));
+        MPICHECK(MPI_Comm_dup(eddl_comm, &comm));
+        MPICHECK(MPI_Comm_set_errhandler(comm, MPI_ERRORS_RETURN));
+        eddl_comm = comm;
+        MPICHECK(MPI_Comm_rank(MPI_COMM_WORLD, &elastic_me));
+        elastic_ranks.resize(n_procs);
+        MPICHECK(MPI_Allgather(&elastic_me, 1, MPI_INT, elastic_ranks.data(), 1, MPI_INT, eddl_comm));
+    }
+    elastic_net = net;
+    elastic_every = snapshot_batches;
+    elastic_timeout = timeout;
+    elastic_retry([&]() { elastic_snapshot(net); });
+    if (id == 0)
+        fprintf(stdout, "[DISTR] %s. Snapshot every %d batches, %.1f secs timeout\n", __func__, snapshot_batches, timeout);
+#endif
+}
+
 void avg_weights_distributed(Net* net, int curr_batch, int batches_per_proc) {
     check_MPI(return);
+#ifdef cMPI
+    if (net == elastic_net) {
+        elastic_avg_weights(net, curr_batch, batches_per_proc);
+        return;
+    }
+#endif
+    // Sharded optimizer: the weights are already in sync
+    if (dynamic_cast<ZeroAdam*>(net->optimizer) != nullptr) return;
     if (net->cs->hw == "gpu")
         avg_GPU_weights_distributed(net, curr_batch, batches_per_proc);
     else if (net->cs->hw == "cpu")
@@ -871,7 +1729,7 @@ void update_batch_avg_distributed(int epoch_id, double secs_epoch, int max_batch
         }
     }
 #ifdef cMPI
-    MPICHECK(MPI_Bcast(&batches_avg, 1, MPI_INT, 0, MPI_COMM_WORLD));
+    elastic_retry([]() { bcast_distributed(&batches_avg, 1, MPI_INT, 0); });
 #endif  
 }
 
@@ -898,7 +1756,7 @@ void set_batch_avg_overhead_distributed(double secs_train, double secs_comm, int
             printf("[DISTR] method LIMIT OVERHEAD %2.1f%%, batches_avg %d -->  %d \n", overhead * 100.0, prev_ba, batches_avg);
         }
 #ifdef cMPI
-        MPICHECK(MPI_Bcast(&batches_avg, 1, MPI_INT, 0, MPI_COMM_WORLD));
+        elastic_retry([]() { bcast_distributed(&batches_avg, 1, MPI_INT, 0); });
 #endif  
     } else
         printf("[DISTR] method LIMIT OVERHEAD is not selected. batches_avg unchanged\n");
@@ -936,7 +1794,7 @@ void gpu_layer_print(Net* net, int ii) {
 bool early_stopping_on_loss_var(Net* net, int index, float delta, int patience, int epoch) {
     // int id = get_id_distributed();
     float losses = net->get_losses()[index];
-    bool result;
+    bool result = false;
 
     if (id == 0)
         if (epoch > patience) {
@@ -957,7 +1815,7 @@ bool early_stopping_on_loss_var(Net* net, int index, float delta, int patience,
 
     if (is_mpi_distributed()) {
 #ifdef cMPI       
-        MPICHECK(MPI_Bcast(&result, 1, MPI_BYTE, 0, MPI_COMM_WORLD));
+        elastic_retry([&]() { bcast_distributed(&result, 1, MPI_BYTE, 0); });
 #endif    
     }
     return result;
@@ -966,7 +1824,7 @@ bool early_stopping_on_loss_var(Net* net, int index, float delta, int patience,
 bool early_stopping_on_metric_var(Net* net, int index, float delta, int patience, int epoch) {
     //int id = get_id_distributed();
     float metrics = net->get_metrics()[index];
-    bool result;
+    bool result = false;
 
     if (id == 0)
         if (epoch > patience) {
@@ -989,7 +1847,7 @@ bool early_stopping_on_metric_var(Net* net, int index, float delta, int patience
 
     if (is_mpi_distributed()) {
 #ifdef cMPI
-        MPICHECK(MPI_Bcast(&result, 1, MPI_BYTE, 0, MPI_COMM_WORLD));
+        elastic_retry([&]() { bcast_distributed(&result, 1, MPI_BYTE, 0); });
 #endif    
     }
     return result;
@@ -998,7 +1856,7 @@ bool early_stopping_on_metric_var(Net* net, int index, float delta, int patience
 bool early_stopping_on_metric(Net* net, int index, float goal, int patience, int epoch) {
     //int id=get_id_distributed();
     float metrics = net->get_metrics()[index];
-    bool result;
+    bool result = false;
 
     if (id == 0)
         if (epoch > patience) {
@@ -1014,7 +1872,7 @@ bool early_stopping_on_metric(Net* net, int index, float goal, int patience, int
 
     if (is_mpi_distributed()) {
 #ifdef cMPI
-        MPICHECK(MPI_Bcast(&result, 1, MPI_BYTE, 0, MPI_COMM_WORLD));
+        elastic_retry([&]() { bcast_distributed(&result, 1, MPI_BYTE, 0); });
 #endif
     }
     return result;
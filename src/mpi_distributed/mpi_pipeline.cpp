@@ -0,0 +1,430 @@
+/*
+ * MPI support for EDDL Library - European Distributed Deep Learning Library.
+ * Version:
+ * copyright (c) 2021, Universidad Politécnica de Valencia (UPV), GAP research group
+ * Date: July 2021
+ * Author: GAP Research Group (UPV), contact: plopez@disca.upv.es
+ * All rights reserved
+ */
+
+#include "eddl/mpi_distributed/mpi_distributed.h"
+
+#include <algorithm>
+
+// Pipeline model parallelism. The layers of the net (vfts order) are split in contiguous stages, one per
+// process. Every stage runs its layers on micro-batches: it receives the outputs of the earlier stages it
+// consumes, sends its outputs to the later stages that consume them and, backwards, the deltas the other
+// way round. The micro-batches follow a 1F1B schedule (after a warm-up, one forward and one backward in
+// turn), so a stage keeps at most (nr of later stages + 1) micro-batches in flight.
+//
+// Every micro-batch in flight owns a context: a copy of the stage layers built with Layer::share, that
+// shares the params and gradients of the net and owns its activations and deltas (as the unrolled
+// recurrent nets do). The gradients of all the micro-batches accumulate in the shared gradients and the
+// stage applies them once per batch. Only the contexts hold batch activations: the layers of the other
+// stages keep the size they were built with.
+
+#ifdef cMPI
+struct PipeContext {
+    int batch = 0;
+    vlayer layers;  // Stage layers, vfts order
+    vlayer bin;     // Outputs of earlier stages (received), as in pipe_recv
+    vlayer in;      // Net inputs, as in pipe_in
+    vlayer out;     // Net outputs, as in pipe_out
+    vlayer send;    // Layers consumed by later stages, as in pipe_send
+};
+
+static Net* pipe_net = nullptr;
+static MPI_Comm pipe_comm = MPI_COMM_NULL;
+static int pipe_micro = 0;
+static int pipe_stage = 0;
+static int pipe_stages = 1;
+static vector<int> pipe_first;                 // First vfts index of every stage (and vfts.size())
+static vector<int> pipe_recv;                  // vfts index of the layers of earlier stages read by this stage
+static vector<int> pipe_send;                  // vfts index of the layers of this stage read by later stages
+static vector<vector<int>> pipe_send_to;       // Stages reading each pipe_send layer
+static vector<int> pipe_in;                    // Index in lin of the inputs of this stage
+static vector<int> pipe_out;                   // Index in lout of the outputs of this stage
+static vlayer pipe_layers;                     // Layers of this stage
+static Optimizer* pipe_opt = nullptr;          // Updates only the layers of this stage
+static vector<PipeContext> pipe_ctx;
+static vector<MPI_Request> pipe_requests;      // Pending sends and their buffers
+static vector<Tensor*> pipe_buffers;
+
+static int pipe_stage_of(int i) {
+    return (int) (std::upper_bound(pipe_first.begin(), pipe_first.end(), i) - pipe_first.begin()) - 1;
+}
+
+static int pipe_index(Net* sn, Layer* l) {
+    int ind;
+    if (!isIn(l, sn->vfts, ind))
+        msg("Layer " + l->name + " is not in the net", "set_pipeline_distributed");
+    return ind;
+}
+
+static void pipe_wait_sends() {
+    if (pipe_requests.empty()) return;
+    MPICHECK(MPI_Waitall((int) pipe_requests.size(), pipe_requests.data(), MPI_STATUSES_IGNORE));
+    for (auto t : pipe_buffers) delete t;
+    pipe_requests.clear();
+    pipe_buffers.clear();
+}
+
+// The tensor is copied to a host buffer, so the context can go on while the message is in flight
+static void pipe_isend(Tensor* t, int stage, int tag) {
+    Tensor* buf = new Tensor(t->getShape(), DEV_CPU);
+    Tensor::copy(t, buf);
+    MPI_Request req;
+    MPICHECK(MPI_Isend(buf->ptr, (int) buf->size, MPI_FLOAT, stage, tag, pipe_comm, &req));
+    pipe_requests.push_back(req);
+    pipe_buffers.push_back(buf);
+
+    // Release the buffers already sent
+    int done = 0;
+    for (int i = 0; i < pipe_requests.size(); i++) {
+        int flag;
+        MPICHECK(MPI_Test(&pipe_requests[i], &flag, MPI_STATUS_IGNORE));
+        if (flag) delete pipe_buffers[i];
+        else {
+            pipe_requests[done] = pipe_requests[i];
+            pipe_buffers[done++] = pipe_buffers[i];
+        }
+    }
+    pipe_requests.resize(done);
+    pipe_buffers.resize(done);
+}
+
+static void pipe_recv_tensor(Tensor* t, int stage, int tag, bool add) {
+    if (t->isCPU() && !add) {
+        MPICHECK(MPI_Recv(t->ptr, (int) t->size, MPI_FLOAT, stage, tag, pipe_comm, MPI_STATUS_IGNORE));
+        return;
+    }
+    Tensor* buf = new Tensor(t->getShape(), DEV_CPU);
+    MPICHECK(MPI_Recv(buf->ptr, (int) buf->size, MPI_FLOAT, stage, tag, pipe_comm, MPI_STATUS_IGNORE));
+    if (!add) Tensor::copy(buf, t);
+    else if (t->isCPU()) Tensor::inc(buf, t);
+    else {
+        Tensor* dev = new Tensor(t->getShape(), t->device);
+        Tensor::copy(buf, dev);
+        Tensor::inc(dev, t);
+        delete dev;
+    }
+    delete buf;
+}
+
+// Rows [start, start + B->shape[0]) of A into B
+static void pipe_select(Tensor* A, Tensor* B, int start) {
+    vector<int> sind(A->shape[0]);
+    for (int i = 0; i < sind.size(); i++) sind[i] = i;
+    if (B->isCPU()) {
+        Tensor::select(A, B, sind, start, start + B->shape[0]);
+    } else {
+        Tensor* buf = new Tensor(B->getShape(), DEV_CPU);
+        Tensor::select(A, buf, sind, start, start + B->shape[0]);
+        Tensor::copy(buf, B);
+        delete buf;
+    }
+}
+
+static void pipe_free_context(PipeContext& c) {
+    for (int i = c.layers.size() - 1; i >= 0; i--) delete c.layers[i];
+    for (auto l : c.bin) delete l;
+    c = PipeContext();
+}
+
+static void pipe_build_context(PipeContext& c, int slot, int bs) {
+    Net* sn = pipe_net->snets[0];
+    vlayer map(sn->vfts.size(), nullptr);
+
+    for (int r : pipe_recv) {
+        Layer* p = sn->vfts[r];
+        vector<int> shape = p->output->getShape();
+        shape[0] = bs;
+        Layer* b = new LInput(new Tensor(shape, p->dev), "pipe_" + p->name, p->dev, p->mem_level);
+        b->setmode(TRMODE);
+        map[r] = b;
+        c.bin.push_back(b);
+    }
+
+    for (int i = pipe_first[pipe_stage]; i < pipe_first[pipe_stage + 1]; i++) {
+        Layer* l = sn->vfts[i];
+        vlayer par;
+        for (auto p : l->parent) par.push_back(map[pipe_index(sn, p)]);
+
+        Layer* n = l->share(slot, bs, par);
+        if (n == nullptr) msg("Layer " + l->name + " can not be shared", "set_pipeline_distributed");
+        n->name = l->name;
+        n->orig = l;
+        n->isdecoder = l->isdecoder;
+        n->delta_bp = l->delta_bp;
+        n->set_mem_level(l->mem_level);
+        n->setmode(TRMODE);
+        map[i] = n;
+        c.layers.push_back(n);
+    }
+
+    for (int j : pipe_in) c.in.push_back(map[pipe_index(sn, sn->lin[j])]);
+    for (int j : pipe_out) c.out.push_back(map[pipe_index(sn, sn->lout[j])]);
+    for (int k : pipe_send) c.send.push_back(map[k]);
+    c.batch = bs;
+}
+
+static void pipe_context_batch(PipeContext& c, int slot, int bs) {
+    if (c.layers.empty()) pipe_build_context(c, slot, bs);
+    if (c.batch == bs) return;
+    for (auto l : c.bin) l->resize(bs);
+    for (auto l : c.layers) l->resize(bs);
+    c.batch = bs;
+}
+
+static void pipe_forward(PipeContext& c, const vtensor& X, int start) {
+    for (auto l : c.bin)
+        if (l->delta != nullptr) l->delta->fill_(0.0);
+    for (auto l : c.layers) l->reset();
+
+    for (int k = 0; k < pipe_recv.size(); k++)
+        pipe_recv_tensor(c.bin[k]->output, pipe_stage_of(pipe_recv[k]), 2 * pipe_recv[k], false);
+    for (int j = 0; j < pipe_in.size(); j++)
+        pipe_select(X[pipe_in[j]], c.in[j]->input, start);
+
+    for (auto l : c.layers) l->forward();
+
+    for (int k = 0; k < pipe_send.size(); k++)
+        for (int s : pipe_send_to[k])
+            pipe_isend(c.send[k]->output, s, 2 * pipe_send[k]);
+}
+
+static void pipe_backward(PipeContext& c, const vtensor& Y, int start, int batch, verr& fiterr) {
+    Net* sn = pipe_net->snets[0];
+
+    // Loss of the net outputs in this stage. The deltas are normalized by the micro-batch: scaled to the
+    // batch, the accumulated gradients are the ones of the whole batch
+    for (int j = 0; j < pipe_out.size(); j++) {
+        int k = pipe_out[j];
+        Layer* l = c.out[j];
+        l->check_target();
+        pipe_select(Y[k], l->target, start);
+        l->mem_delta();
+        if (sn->losses.size() >= (k + 1)) {
+            if (sn->fused_loss[k]) {
+                fiterr[2 * k] += tensorNN::softmax_cross_entropy(l->target, l->input, l->output, l->delta);
+            } else {
+                fiterr[2 * k] += sn->losses[k]->value(l->target, l->output);
+                sn->losses[k]->delta(l->target, l->output, l->delta);
+            }
+            l->delta->mult_((float) c.batch / batch);
+        }
+        if (sn->metrics.size() >= (k + 1))
+            fiterr[2 * k + 1] += sn->metrics[k]->value(l->target, l->output);
+    }
+
+    // Deltas of the later stages
+    for (int k = 0; k < pipe_send.size(); k++) {
+        c.send[k]->mem_delta();
+        for (int s : pipe_send_to[k])
+            pipe_recv_tensor(c.send[k]->delta, s, 2 * pipe_send[k] + 1, true);
+    }
+
+    for (auto l : c.bin) l->mem_delta();
+    for (int i = c.layers.size() - 1; i >= 0; i--) {
+        Layer* l = c.layers[i];
+        l->mem_delta_parent();
+        l->backward();
+        if (l->mem_level) l->free_delta();
+    }
+
+    for (int k = 0; k < pipe_recv.size(); k++)
+        pipe_isend(c.bin[k]->delta, pipe_stage_of(pipe_recv[k]), 2 * pipe_recv[k] + 1);
+}
+
+static void free_pipeline() {
+    pipe_wait_sends();
+    for (auto& c : pipe_ctx) pipe_free_context(c);
+    pipe_ctx.clear();
+    if (pipe_opt != nullptr) { delete pipe_opt; pipe_opt = nullptr; }
+    if (pipe_comm != MPI_COMM_NULL) MPICHECK(MPI_Comm_free(&pipe_comm));
+    pipe_first.clear();
+    pipe_recv.clear();
+    pipe_send.clear();
+    pipe_send_to.clear();
+    pipe_in.clear();
+    pipe_out.clear();
+    pipe_layers.clear();
+    pipe_net = nullptr;
+    pipe_micro = 0;
+}
+#endif
+
+void set_pipeline_distributed(Net* net, int micro_batches, vector<int> stage_layers) {
+#ifdef cMPI
+    free_pipeline();
+    if (net == nullptr || micro_batches <= 0) return;
+
+    if (!is_mpi_distributed())
+        msg("Distributed mode is not initialized (see init_distributed)", "set_pipeline_distributed");
+    if (!net->isbuild)
+        msg("The net must be built", "set_pipeline_distributed");
+    if (net->isrecurrent || net->isdecoder)
+        msg("Recurrent nets are not supported", "set_pipeline_distributed");
+    if (net->snets.size() != 1)
+        msg("Every stage runs on one device (one CPU or one GPU per process)", "set_pipeline_distributed");
+
+    Net* sn = net->snets[0];
+    int n = sn->vfts.size();
+    pipe_stages = get_n_procs_distributed();
+    pipe_stage = get_id_distributed();
+    if (n < pipe_stages)
+        msg("The net has fewer layers (" + to_string(n) + ") than processes (" + to_string(pipe_stages) + ")",
+            "set_pipeline_distributed");
+
+    // Stages: consecutive layers with a similar cost, or the given nr of layers per stage
+    pipe_first.assign(pipe_stages + 1, 0);
+    pipe_first[pipe_stages] = n;
+    if (!stage_layers.empty()) {
+        if (stage_layers.size() != pipe_stages)
+            msg("One nr of layers per process is expected", "set_pipeline_distributed");
+        for (int s = 0; s < pipe_stages; s++) {
+            if (stage_layers[s] <= 0) msg("Every stage needs layers", "set_pipeline_distributed");
+            pipe_first[s + 1] = pipe_first[s] + stage_layers[s];
+        }
+        if (pipe_first[pipe_stages] != n)
+            msg("The stages have " + to_string(pipe_first[pipe_stages]) + " layers, the net " + to_string(n),
+                "set_pipeline_distributed");
+    } else {
+        vector<double> cost(n);
+        double total = 0.0;
+        for (int i = 0; i < n; i++) {
+            LayerCost lc = sn->vfts[i]->get_cost();
+            cost[i] = lc.fwd_flops + lc.bwd_flops + 1.0;
+            total += cost[i];
+        }
+        int i = 0;
+        double acc = 0.0;
+        for (int s = 1; s < pipe_stages; s++) {
+            double target = total * s / pipe_stages;
+            while (i < n - (pipe_stages - s) && (i <= pipe_first[s - 1] || acc + cost[i] / 2 <= target)) {
+                acc += cost[i];
+                i++;
+            }
+            pipe_first[s] = i;
+        }
+    }
+
+    // Traffic among the stages
+    for (int i = 0; i < n; i++) {
+        int si = pipe_stage_of(i);
+        vector<int> to;
+        for (auto c : sn->vfts[i]->child) {
+            int ind;
+            if (!isIn(c, sn->vfts, ind)) continue;
+            int sc = pipe_stage_of(ind);
+            if (si == pipe_stage && sc != pipe_stage && std::find(to.begin(), to.end(), sc) == to.end())
+                to.push_back(sc);
+            if (si < pipe_stage && sc == pipe_stage && std::find(pipe_recv.begin(), pipe_recv.end(), i) == pipe_recv.end())
+                pipe_recv.push_back(i);
+        }
+        if (!to.empty()) {
+            pipe_send.push_back(i);
+            pipe_send_to.push_back(to);
+        }
+    }
+    for (int j = 0; j < sn->lin.size(); j++)
+        if (pipe_stage_of(pipe_index(sn, sn->lin[j])) == pipe_stage) pipe_in.push_back(j);
+    for (int j = 0; j < sn->lout.size(); j++)
+        if (pipe_stage_of(pipe_index(sn, sn->lout[j])) == pipe_stage) pipe_out.push_back(j);
+
+    for (int i = pipe_first[pipe_stage]; i < pipe_first[pipe_stage + 1]; i++) pipe_layers.push_back(sn->vfts[i]);
+    pipe_opt = sn->optimizer->clone();
+    pipe_opt->setlayers(pipe_layers);
+
+    MPICHECK(MPI_Comm_dup(MPI_COMM_WORLD, &pipe_comm));
+    pipe_net = net;
+    pipe_micro = micro_batches;
+    // Micro-batches in flight: the warm-up forwards plus the current one
+    pipe_ctx.resize(std::min(pipe_stages - pipe_stage, pipe_micro));
+
+    if (pipe_stage == 0) {
+        fprintf(stdout, "[DISTR] %s. %d stages, %d micro-batches\n", __func__, pipe_stages, pipe_micro);
+        for (int s = 0; s < pipe_stages; s++)
+            fprintf(stdout, "[DISTR]   stage %d: layers %d-%d (%s ... %s)\n", s, pipe_first[s], pipe_first[s + 1] - 1,
+                    sn->vfts[pipe_first[s]]->name.c_str(), sn->vfts[pipe_first[s + 1] - 1]->name.c_str());
+    }
+#else
+    msg("invalid call. MPI library is not linked", __func__);
+#endif
+}
+
+void train_batch_pipeline_distributed(Net* net, vtensor X, vtensor Y) {
+#ifdef cMPI
+    if (net != pipe_net || pipe_net == nullptr)
+        msg("The pipeline is not set for this net (see set_pipeline_distributed)", __func__);
+    Net* sn = net->snets[0];
+    if (X.size() != sn->lin.size() || Y.size() != sn->lout.size())
+        msg("One tensor per input and per output is expected", __func__);
+
+    int batch = X[0]->shape[0];
+    if (batch < pipe_micro) msg("batch_size lower than the nr of micro-batches", __func__);
+
+    for (auto l : pipe_layers) l->zeroGrads();
+    verr fiterr(2 * sn->lout.size(), 0.0f);
+
+    // 1F1B. Micro-batch m uses the context m % slots: it is released by B(m) before F(m + slots)
+    int slots = pipe_ctx.size();
+    int warmup = std::min(pipe_stages - 1 - pipe_stage, pipe_micro);
+    int bs = batch / pipe_micro, rest = batch % pipe_micro;
+    auto mb_size = [&](int m) { return bs + (m < rest ? 1 : 0); };
+    auto mb_start = [&](int m) { return m * bs + std::min(m, rest); };
+
+    auto forward = [&](int m) {
+        PipeContext& c = pipe_ctx[m % slots];
+        pipe_context_batch(c, m % slots, mb_size(m));
+        pipe_forward(c, X, mb_start(m));
+    };
+    auto backward = [&](int m) {
+        pipe_backward(pipe_ctx[m % slots], Y, mb_start(m), batch, fiterr);
+    };
+
+    for (int m = 0; m < warmup; m++) forward(m);
+    for (int m = 0; m < pipe_micro; m++) {
+        if (m + warmup < pipe_micro) forward(m + warmup);
+        backward(m);
+    }
+    pipe_wait_sends();
+
+    pipe_opt->applygrads(batch);
+
+    // Losses and metrics are computed by the stages with outputs: every process gets them (see print_loss)
+    MPICHECK(MPI_Allreduce(MPI_IN_PLACE, fiterr.data(), (int) fiterr.size(), MPI_FLOAT, MPI_SUM, pipe_comm));
+    for (int k = 0; k < sn->lout.size(); k++) {
+        net->total_loss[k] += fiterr[2 * k];
+        net->total_metric[k] += fiterr[2 * k + 1];
+    }
+    net->inferenced_samples += batch;
+    net->tr_batches++;
+#else
+    msg("invalid call. MPI library is not linked", __func__);
+#endif
+}
+
+void gather_pipeline_weights_distributed(Net* net) {
+#ifdef cMPI
+    if (net != pipe_net || pipe_net == nullptr)
+        msg("The pipeline is not set for this net (see set_pipeline_distributed)", __func__);
+    Net* sn = net->snets[0];
+    for (int i = 0; i < sn->vfts.size(); i++) {
+        int root = pipe_stage_of(i);
+        for (auto p : sn->vfts[i]->params) {
+            if (p->isCPU()) {
+                MPICHECK(MPI_Bcast(p->ptr, (int) p->size, MPI_FLOAT, root, pipe_comm));
+            } else {
+                Tensor* buf = new Tensor(p->getShape(), DEV_CPU);
+                if (root == pipe_stage) Tensor::copy(p, buf);
+                MPICHECK(MPI_Bcast(buf->ptr, (int) buf->size, MPI_FLOAT, root, pipe_comm));
+                Tensor::copy(buf, p);
+                delete buf;
+            }
+        }
+    }
+#else
+    msg("invalid call. MPI library is not linked", __func__);
+#endif
+}
@@ -83,10 +83,14 @@ CompServ::CompServ(int threads, const vector<int>& gpus, const vector<int> &fpga
 CompServ* CompServ::share() {
     auto *n = new CompServ(threads_arg,local_gpus,local_fpgas,lsb,mem_level);
     n->isshared = true;
+    n->affinity = affinity;
+    n->numa = numa;
     return n;
 }
 CompServ* CompServ::clone() {
     auto *n = new CompServ(threads_arg,local_gpus,local_fpgas,lsb,mem_level);
+    n->affinity = affinity;
+    n->numa = numa;
     return n;
 }
 
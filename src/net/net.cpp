@@ -18,6 +18,7 @@
 #include <chrono>
 #include "eddl/net/net.h"
 #include "eddl/utils.h"
+#include "eddl/hardware/cpu/cpu_numa.h"
 #include "eddl/random.h"
 
 #include "eddl/layers/core/layer_core.h"
@@ -63,6 +64,12 @@ Net::Net() {
     has_to_close_flog_ts = false;
     trmode = TRMODE;
     rnet=nullptr;
+    ckpt_writer=nullptr;
+    layer_timing=false;
+    numa_first_touch=false;
+    timed_forwards=0;
+    timed_backwards=0;
+    ridge_point=RIDGE_POINT;
     isbuild=false;
     isdecoder=false;
     isencoder=false;
@@ -119,6 +126,11 @@ Net::~Net(){
     // IF CPU : net = snets[0]
     // IF GPU: net , snets[0]= clone on GPU
 
+    // Flush pending checkpoints
+    if (ckpt_writer != nullptr) { delete ckpt_writer; ckpt_writer = nullptr; }
+
+    if (numa_first_touch) { cpu_numa_first_touch_release(); numa_first_touch = false; }
+
     if (this->has_to_close_flog_tr && this->flog_tr != nullptr) {
         fclose(this->flog_tr);
         this->flog_tr = nullptr;
@@ -330,6 +342,69 @@ string Net::summary(bool print_stdout) {
     ss << "Trainable params: " << trainable_params_acc << std::endl;
     ss << "Non-trainable params: " << nontrainable_params_acc << std::endl;
 
+    // Analytical cost per layer (at the current batch size), combined with the measured times if available
+    if (isbuild) {
+        Net *snet = snets.empty() ? this : snets[0];  // Costs and times of one device
+        bool timed = snet->timed_forwards > 0 && snet->vfts_time.size() == snet->vfts.size();
+        bool timed_bwd = timed && snet->timed_backwards > 0 && snet->vbts_time.size() == snet->vbts.size();
+
+        ss << "-------------------------------------------------------------------------------" << std::endl;
+        ss << "Cost (batch=" << snet->batch_size << ", ridge point=" << ridge_point << " FLOPs/byte)" << std::endl;
+        ss << setw(maxl) << left << "" << "|  ";
+        ss << setw(12) << left << "MFLOPs fwd" << setw(12) << left << "MFLOPs bwd";
+        ss << setw(10) << left << "MB fwd" << setw(10) << left << "MB bwd";
+        ss << setw(10) << left << "FLOPs/B" << setw(9) << left << "bound";
+        if (timed) ss << setw(10) << left << "ms fwd" << setw(10) << left << "ms bwd" << setw(10) << left << "GFLOP/s";
+        ss << endl;
+
+        double total_flops = 0.0, total_bytes = 0.0, total_time = 0.0;
+        ss << std::fixed;
+        for (int i = 0; i < snet->vfts.size(); i++) {
+            Layer *l = snet->vfts[i];
+            LayerCost cost = l->get_cost();
+
+            double t_fwd = 0.0, t_bwd = 0.0;
+            if (timed) t_fwd = snet->vfts_time[i] / snet->timed_forwards;
+            if (timed_bwd) {
+                for (int j = 0; j < snet->vbts.size(); j++) {
+                    if (snet->vbts[j] == l) { t_bwd = snet->vbts_time[j] / snet->timed_backwards; break; }
+                }
+            }
+
+            // Training (fwd+bwd) when the backward has been measured, inference otherwise
+            double flops = cost.fwd_flops + (timed_bwd ? cost.bwd_flops : 0.0);
+            double bytes = cost.fwd_bytes + (timed_bwd ? cost.bwd_bytes : 0.0);
+            double intensity = bytes > 0.0 ? flops / bytes : 0.0;
+            string bound = bytes > 0.0 ? (intensity >= ridge_point ? "compute" : "memory") : "-";
+            total_flops += flops;
+            total_bytes += bytes;
+            total_time += t_fwd + t_bwd;
+
+            ss << setw(maxl) << left << l->name << "|  ";
+            ss << setw(12) << left << setprecision(3) << cost.fwd_flops / 1e6;
+            ss << setw(12) << left << setprecision(3) << cost.bwd_flops / 1e6;
+            ss << setw(10) << left << setprecision(3) << cost.fwd_bytes / 1e6;
+            ss << setw(10) << left << setprecision(3) << cost.bwd_bytes / 1e6;
+            ss << setw(10) << left << setprecision(3) << intensity;
+            ss << setw(9) << left << bound;
+            if (timed) {
+                ss << setw(10) << left << setprecision(3) << t_fwd * 1e3;
+                ss << setw(10) << left << setprecision(3) << t_bwd * 1e3;
+                ss << setw(10) << left << setprecision(3) << ((t_fwd + t_bwd) > 0.0 ? flops / (t_fwd + t_bwd) / 1e9 : 0.0);
+            }
+            ss << endl;
+        }
+        ss.unsetf(std::ios_base::floatfield);
+        ss << "-------------------------------------------------------------------------------" << std::endl;
+        ss << "Total GFLOPs: " << setprecision(4) << total_flops / 1e9 << (timed_bwd ? " (fwd+bwd)" : " (fwd)") << std::endl;
+        ss << "Total GB moved: " << setprecision(4) << total_bytes / 1e9 << std::endl;
+        if (timed && total_time > 0.0) {
+            ss << "Achieved: " << setprecision(4) << total_flops / total_time / 1e9 << " GFLOP/s, ";
+            ss << setprecision(4) << total_bytes / total_time / 1e9 << " GB/s" << std::endl;
+        }
+        ss << std::setprecision(6);
+    }
+
     // Print to the standard output
     if(print_stdout){
         std::cout << ss.str() << std::endl;
@@ -448,6 +523,82 @@ void Net::load(const string& filename, const string& format){
     ifs.close();
 }
 
+void Net::get_checkpoint_tensors(vector<string> &names, vtensor &tensors, bool with_optimizer){
+    // Params (includes the running statistics of the normalization layers)
+    for (auto l : layers) {
+        for (int j = 0; j < l->params.size(); j++) {
+            names.push_back(l->name + "/params/" + to_string(j));
+            tensors.push_back(l->params[j]);
+        }
+    }
+
+    // Optimizer state lives in the devices (snets)
+    if (with_optimizer) {
+        Optimizer *opt = snets.empty() ? optimizer : snets[0]->optimizer;
+        if (opt != nullptr) opt->get_state(names, tensors);
+    }
+}
+
+void Net::save_checkpoint(const string& filename, bool async){
+    if (!isbuild) msg("The model must be built", "Net::save_checkpoint");
+
+    // Copy from CS devices to layers
+    if (snets[0]->dev!=DEV_CPU)
+        sync_weights();
+
+    vector<string> names;
+    vtensor tensors;
+    get_checkpoint_tensors(names, tensors, true);
+
+    Optimizer *opt = snets[0]->optimizer;
+    int64_t step = (opt != nullptr) ? opt->get_step() : 0;
+
+    if (ckpt_writer == nullptr) ckpt_writer = new CheckpointWriter();
+    ckpt_writer->save(filename, names, tensors, step, async);
+}
+
+void Net::load_checkpoint(const string& filename){
+    if (!isbuild) msg("The model must be built", "Net::load_checkpoint");
+
+    // Do not read a file that is still being written
+    wait_checkpoint();
+
+    CheckpointReader reader(filename);
+
+    vector<string> names;
+    vtensor tensors;
+    get_checkpoint_tensors(names, tensors, false);
+    // Layer names are auto-generated, so if a name is not found we fall back to the position (same
+    // order as in save_checkpoint) as Net::load does
+    for (int i = 0; i < tensors.size(); i++) {
+        if (!reader.copy_to(names[i], tensors[i], i)) {
+            msg("Tensor '" + names[i] + "' not found in checkpoint '" + filename + "'", "Net::load_checkpoint");
+        }
+    }
+
+    // Copy to CS devices layers
+    if (snets[0]->dev!=DEV_CPU) {
+        for(int i=0; i!=snets.size(); i++)
+            for(int j=0;j<layers.size();j++)
+                layers[j]->copy(snets[i]->layers[j]);
+    }
+
+    // Optimizer state is optional (e.g. weights-only checkpoints or a different optimizer)
+    Optimizer *opt = snets[0]->optimizer;
+    if (opt != nullptr) {
+        int offset = (int)tensors.size();
+        names.clear(); tensors.clear();
+        opt->get_state(names, tensors);
+        bool found = !tensors.empty() && reader.entries.size() == offset + tensors.size();
+        for (int i = 0; found && i < tensors.size(); i++) found &= reader.copy_to(names[i], tensors[i], offset + i);
+        if (found) opt->set_step((long)reader.step);
+    }
+}
+
+void Net::wait_checkpoint(){
+    if (ckpt_writer != nullptr) ckpt_writer->wait();
+}
+
 void Net::reset_accumulated_gradients(){
     for(Layer* l : layers){
         l->reset_accumulated_gradients();
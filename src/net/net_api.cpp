@@ -16,12 +16,14 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <chrono>
 #include <stdexcept>
 #include "eddl/layers/core/layer_core.h"
+#include "eddl/data/dataloader.h"
 #include "eddl/net/net.h"
 #include "eddl/random.h"
 #include "eddl/system_info.h"
@@ -198,6 +200,20 @@ void Net::setmode(int m) {
   }
 }
 
+// Enables (and resets) the per-layer timers of every snet.
+// Note: on GPU the times only include the kernel launches unless the device is synchronized
+void Net::set_layer_timing(bool enable) {
+  layer_timing=enable;
+  vfts_time.assign(vfts.size(), 0.0);
+  vbts_time.assign(vbts.size(), 0.0);
+  timed_forwards=0;
+  timed_backwards=0;
+  for (int i = 0; i < snets.size(); i++){
+      if (snets[i] == this) continue;
+      snets[i]->set_layer_timing(enable);
+  }
+}
+
 void Net::clamp(float min,float max)
 {
   for (int i = 0; i < snets.size(); i++)
@@ -1033,6 +1049,58 @@ void Net::fit(vtensor tin, vtensor tout, int batch, int epochs) {
 }
 
 
+void Net::fit(DataLoader *loader, int epochs) {
+    // Check current optimizer
+    if (optimizer == nullptr)
+        msg("Net is not build", "Net.fit");
+    if (isrecurrent)
+        msg("Recurrent nets can not be trained with a DataLoader", "Net.fit");
+    if (is_mpi_distributed())
+        msg("Distributed training with a DataLoader is not supported", "Net.fit");
+
+    if (loader->num_inputs() != lin.size())
+        msg("input tensor list does not match with defined input layers", "Net.fit");
+    if (loader->num_outputs() != lout.size())
+        msg("output tensor list does not match with defined output layers", "Net.fit");
+
+    int num_batches = loader->num_batches();
+    if (num_batches == 0)
+        msg("The dataset has fewer samples than the batch size", "Net.fit");
+    if (loader->dropped_samples() > 0)
+        fprintf(stdout, "%d samples left out of every epoch (the last partial batch is dropped)\n", loader->dropped_samples());
+
+    setmode(TRMODE);
+
+    vtensor X, Y;
+    for (int i = 0; i < epochs; i++) {
+        high_resolution_clock::time_point e1 = high_resolution_clock::now();
+        fprintf(stdout, "Epoch %d\n", i + 1);
+        reset_loss();
+
+        // The workers prepare the next batches while this one is being computed
+        loader->start_epoch();
+        for (int j = 0; loader->next(X, Y); j++) {
+            tr_batches++;
+            train_loaded_batch(X, Y);
+
+            print_loss(j + 1, num_batches, false);
+
+            high_resolution_clock::time_point e2 = high_resolution_clock::now();
+            duration<double> epoch_time_span = e2 - e1;
+            fprintf(stdout, "%1.4f secs/batch\r", epoch_time_span.count() / (j + 1));
+            fflush(stdout);
+        }
+        print_loss(num_batches, num_batches, false);
+        fprintf(stdout, "\n");
+
+        high_resolution_clock::time_point e2 = high_resolution_clock::now();
+        duration<double> epoch_time_span = e2 - e1;
+        fprintf(stdout, "\n%1.4f secs/epoch\n", epoch_time_span.count());
+        fflush(stdout);
+    }
+}
+
+
 void Net::prepare_recurrent_dec(vtensor tin, vtensor tout, int &inl, int &outl, vtensor &xt, vtensor &xtd,vtensor &yt,vtensor &tinr,vtensor &toutr, Tensor *Z)
 {
   int i, j, k, n;
@@ -1448,6 +1516,62 @@ void Net::train_batch(vtensor X, vtensor Y, vind sind, int eval) {
 
 
 
+// Trains with a batch already assembled (and shuffled) by a DataLoader: each snet
+// gets a contiguous range of rows, so there is no select
+void Net::train_loaded_batch(vtensor X, vtensor Y) {
+  if (X.empty() || Y.empty()) msg("error void batch","Net::train_loaded_batch");
+
+  if (batch_size!=X[0]->shape[0]) resize(X[0]->shape[0]);
+
+  int comp=snets.size();
+
+  if (batch_size<comp) {
+    msg("batch_size lower than computing service parallelism","Net::train_loaded_batch");
+  }
+
+  int thread_batch_size=batch_size / comp;
+
+  setmode(TRMODE);
+
+  for (int i = 0; i < comp; i++) {
+    int start = i * thread_batch_size;
+    int rows = Xs[i][0]->shape[0];
+    // Copy samples
+    for (int j = 0; j < X.size(); j++) {
+      long int row = X[j]->size / X[j]->shape[0];
+      Tensor *input = snets[i]->lin[j]->input;
+      if (input->isCPU()) {
+        memcpy(input->ptr, X[j]->ptr + start * row, rows * row * sizeof(float));
+      } else {
+        memcpy(Xs[i][j]->ptr, X[j]->ptr + start * row, rows * row * sizeof(float));
+        Tensor::copy(Xs[i][j], input);
+      }
+    }
+    // Copy targets
+    for (int j = 0; j < Y.size(); j++) {
+      long int row = Y[j]->size / Y[j]->shape[0];
+      snets[i]->lout[j]->check_target();
+      Tensor *target = snets[i]->lout[j]->target;
+      if (target->isCPU()) {
+        memcpy(target->ptr, Y[j]->ptr + start * row, rows * row * sizeof(float));
+      } else {
+        memcpy(Ys[i][j]->ptr, Y[j]->ptr + start * row, rows * row * sizeof(float));
+        Tensor::copy(Ys[i][j], target);
+      }
+    }
+  }
+
+  run_snets(train_batch_t);
+
+  // In case of multiple GPUS or FPGA synchronize params
+  if ((snets[0]->dev != DEV_CPU) && (comp > 1) && (tr_batches%cs->lsb==0)) {
+    sync_weights();
+  }
+
+  compute_loss();
+}
+
+
 ///////////////////////////////////////////
 void Net::evaluate(vtensor tin, vtensor tout, int bs) {
 
@@ -14,6 +14,7 @@
 #include <fstream>
 #include <string>
 #include <chrono>
+#include <mutex>
 #include "eddl/net/net.h"
 #include "eddl/utils.h"
 #include "eddl/random.h"
@@ -21,6 +22,7 @@
 
 #include "eddl/layers/core/layer_core.h"
 #include "eddl/layers/conv/layer_conv.h"
+#include "eddl/hardware/cpu/cpu_numa.h"
 
 #ifdef cGPU
 #include "eddl/hardware/gpu/gpu_tensor.h"
@@ -210,9 +212,20 @@ void Net::make_graph(Optimizer *opt, vloss lo, vmetrics me, bool initialize) {
         for(auto _l_ : lo) losses.push_back(_l_);
     }
 
+    fused_loss.assign(lout.size(), false);
+    fused_delta.assign(lout.size(), false);
     for (int i = 0; i < losses.size(); i++) {
         if (losses[i]->name == "softmax_cross_entropy") lout[i]->delta_bp = 1;
         lout[i]->target = new Tensor(lout[i]->output->getShape(), dev);
+
+        // Softmax (last axis) followed by a cross-entropy: the loss and the delta w.r.t. the logits
+        // are computed together, and the softmax backward is skipped (delta_bp)
+        auto *act = dynamic_cast<LActivation *>(lout[i]);
+        if (act != nullptr && act->act == "softmax" && (int)act->params[0] == act->output->ndim - 1 && act->output->isCPU() &&
+            (losses[i]->name == "softmax_cross_entropy" || losses[i]->name == "categorical_cross_entropy")) {
+            fused_loss[i] = true;
+            lout[i]->delta_bp = 1;
+        }
     }
     // set metrics
     if (isdecoder) {
@@ -243,23 +256,47 @@ void Net::check_compserv_compatibility(CompServ *cs) {
         // If we are using CuDNN all the features are available
         return;
 #endif
-    // Check if there are CuDNN only features
-    if (cs->local_gpus.size() == 0)
-        for (Layer *l : layers)
-            if (LConv *aux_l = dynamic_cast<LConv*>(l)) {
-                // Look for grouped convolutions
-                if (aux_l->cd->groups != 1)
-                    msg("Grouped convolutions are only available with CuDNN. "
-                        "In layer " + aux_l->name + " received groups=" + to_string(aux_l->cd->groups),
+    // The CPU kernels support them too
+    if (cs->local_gpus.size() == 0 && cs->local_fpgas.size() == 0)
+        return;
+
+    // Check if there are CPU/CuDNN only features
+    for (Layer *l : layers)
+        if (LConv *aux_l = dynamic_cast<LConv*>(l)) {
+            // Look for grouped convolutions
+            if (aux_l->cd->groups != 1)
+                msg("Grouped convolutions are only available on CPU and with CuDNN. "
+                    "In layer " + aux_l->name + " received groups=" + to_string(aux_l->cd->groups),
+                    "Net::check_compserv_compatibility");
+
+            // Look for dilated convolutions
+            for (int d : aux_l->cd->dilation_rate)
+                if (d != 1)
+                    msg("Dilated convolutions are only available on CPU and with CuDNN. "
+                        "In layer " + aux_l->name + " received dilation=" + to_string(d),
                         "Net::check_compserv_compatibility");
+        }
+}
 
-                // Look for dilated convolutions
-                for (int d : aux_l->cd->dilation_rate)
-                    if (d != 1)
-                        msg("Dilated convolutions are only available with CuDNN. "
-                            "In layer " + aux_l->name + " received dilation=" + to_string(d),
-                            "Net::check_compserv_compatibility");
-            }
+void Net::set_numa_placement(){
+    // Shared by all the threads: interleaved. Snets are not involved, on CPU the net computes itself
+    vector<string> names;
+    vtensor tensors;
+    get_checkpoint_tensors(names, tensors, true);
+    for (auto l : layers)
+        for (auto g : l->gradients) tensors.push_back(g);
+
+    bool ok = true;
+    for (auto t : tensors)
+        if (t->isCPU()) ok = cpu_numa_interleave(t->ptr, t->size * sizeof(float)) && ok;
+    if (!ok) std::cerr << "Could not interleave the weights among the NUMA nodes" << std::endl;
+
+    // Activations, deltas and workspaces are (re)allocated by resize(): first touched by their threads
+    // while this net (or another placed one) is alive
+    if (!numa_first_touch) {
+        cpu_numa_first_touch_acquire();
+        numa_first_touch = true;
+    }
 }
 
 void Net::set_compserv(CompServ *cs, bool do_compserv_delete){
@@ -287,6 +324,11 @@ void Net::set_compserv(CompServ *cs, bool do_compserv_delete){
                 Eigen::initParallel();
                 Eigen::setNbThreads(nthreads);
 
+                // Eigen runs on the OpenMP team, so pinning the team covers both
+                if (cs->affinity != "none" && !cpu_pin_threads(cs->affinity))
+                    std::cerr << "Could not set the thread affinity (" << cs->affinity << ")" << std::endl;
+                if (cs->numa) set_numa_placement();
+
                 snets.push_back(this);
 
             } else {
@@ -411,6 +453,61 @@ void Net::split(int c, int todev) {
 }
 
 
+// Inference contexts share the parameters of the net (read-only) but own their activations,
+// so several threads can run forward at the same time, each one on its own context
+static std::mutex context_mtx;
+
+Net *Net::create_context() {
+    if (!isbuild) msg("The net must be built before creating contexts", "Net.create_context");
+    if (isrecurrent) msg("Recurrent nets are not supported", "Net.create_context");
+
+    std::lock_guard<std::mutex> lock(context_mtx);
+
+    // Share the layers placed on the computing device (on CPU snets[0] == this)
+    Net *src = snets[0];
+    vlayer nlayers;
+    vlayer nin;
+    vlayer nout;
+    int ind;
+
+    for (auto l : src->vfts) {
+        vlayer par;
+        for (auto p : l->parent)
+            if (isInorig(p, nlayers, ind)) par.push_back(nlayers[ind]);
+
+        Layer *n = l->share(0, src->batch_size, par);
+        if (n == nullptr) msg("Layer " + l->name + " can not be shared", "Net.create_context");
+        n->name = l->name;
+        n->orig = l;
+        n->isdecoder = l->isdecoder;
+        nlayers.push_back(n);
+    }
+
+    // Keep the order of the inputs and outputs
+    for (auto l : src->lin)
+        if (isInorig(l, nlayers, ind)) nin.push_back(nlayers[ind]);
+    for (auto l : src->lout)
+        if (isInorig(l, nlayers, ind)) nout.push_back(nlayers[ind]);
+
+    Net *ctx = new Net(nin, nout);
+    ctx->name = name + "_context";
+    ctx->dev = src->dev;
+    ctx->mem_level = src->mem_level;
+    ctx->batch_size = src->batch_size;
+    ctx->fts();
+
+    // The context is its own (single) computing service
+    ctx->snets.push_back(ctx);
+    for (auto l : ctx->lin) ctx->Xs[0].push_back(new Tensor(l->input->shape));
+    for (auto l : ctx->lout) ctx->Ys[0].push_back(new Tensor(l->output->shape));
+
+    ctx->isbuild = true;
+    ctx->setmode(TSMODE);
+
+    return ctx;
+}
+
+
 void Net::resize(int b)
 {
   int i,j;
@@ -442,22 +539,28 @@ void Net::resize(int b)
       layers[j]->resize(batch_size);
 
   for(i=0; i<c; i++) {
-    for (unsigned int j = 0; j < Xs[i].size(); ++j) delete Xs[i][j];
-    for (unsigned int j = 0; j < Ys[i].size(); ++j) delete Ys[i][j];
-    Xs[i].clear();
-    Ys[i].clear();
-
     if (i==c-1) bs+=m;
     snets[i]->batch_size=bs;
     for (j = 0; j < snets[i]->layers.size(); j++) {
         snets[i]->layers[j]->resize(bs);
       }
 
-    for (j = 0; j < snets[i]->lin.size(); j++)
-        Xs[i].push_back(new Tensor(snets[i]->lin[j]->input->shape));
+    // Xs/Ys keep their allocation (see Tensor::resize), so alternating batch sizes does not reallocate
+    if (Xs[i].size()==snets[i]->lin.size() && Ys[i].size()==snets[i]->lout.size()) {
+      for (j = 0; j < Xs[i].size(); j++) Xs[i][j]->resize(bs);
+      for (j = 0; j < Ys[i].size(); j++) Ys[i][j]->resize(bs);
+    } else {
+      for (unsigned int j = 0; j < Xs[i].size(); ++j) delete Xs[i][j];
+      for (unsigned int j = 0; j < Ys[i].size(); ++j) delete Ys[i][j];
+      Xs[i].clear();
+      Ys[i].clear();
+
+      for (j = 0; j < snets[i]->lin.size(); j++)
+          Xs[i].push_back(new Tensor(snets[i]->lin[j]->input->shape));
 
-    for (j = 0; j < snets[i]->lout.size(); j++)
-        Ys[i].push_back(new Tensor(snets[i]->lout[j]->output->shape));
+      for (j = 0; j < snets[i]->lout.size(); j++)
+          Ys[i].push_back(new Tensor(snets[i]->lout[j]->output->shape));
+    }
   }
 
   reset();
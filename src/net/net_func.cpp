@@ -18,7 +18,9 @@
 #include "eddl/utils.h"
 #include "eddl/random.h"
 #include "eddl/layers/core/layer_core.h"
+#include "eddl/tensor/nn/tensor_nn.h"
 #include "eddl/profiling.h"
+#include "eddl/profiler.h"
 
 
 using namespace std;
@@ -46,31 +48,71 @@ void Net::do_reset_grads() {
     }
 }
 
+// Registers the profiler zones of the layers the first time they are profiled
+static void profiler_layer_zones(vlayer &layers, vector<int> &zones, int category) {
+    if (zones.size() == layers.size()) return;
+    zones.resize(layers.size());
+    for (int i = 0; i < layers.size(); i++) zones[i] = profiler_register(layers[i]->name.c_str(), category);
+}
+
 void Net::do_forward() {
-    PROFILING_HEADER_EXTERN(forward);
-    for (int i = 0; i < vfts.size(); i++)
-        vfts[i]->forward();
-    PROFILING_FOOTER(forward);
+    PROFILER_ZONE("forward", PROFILER_NET);
+    // A delta computed with the loss of the previous forward is stale from now on
+    fused_delta.assign(fused_delta.size(), false);
+    bool profiled = profiler_is_enabled();
+    if (profiled) profiler_layer_zones(vfts, vfts_zone, PROFILER_FORWARD);
+    if (layer_timing) {
+        if (vfts_time.size() != vfts.size()) vfts_time.assign(vfts.size(), 0.0);
+        for (int i = 0; i < vfts.size(); i++) {
+            PROFILER_ZONE_ID(profiled ? vfts_zone[i] : -1);
+            auto t0 = high_resolution_clock::now();
+            vfts[i]->forward();
+            vfts_time[i] += duration<double>(high_resolution_clock::now() - t0).count();
+        }
+        timed_forwards++;
+    } else {
+        for (int i = 0; i < vfts.size(); i++) {
+            PROFILER_ZONE_ID(profiled ? vfts_zone[i] : -1);
+            vfts[i]->forward();
+        }
+    }
 
 }
 
 void Net::do_backward() {
+    PROFILER_ZONE("backward", PROFILER_NET);
+    bool profiled = profiler_is_enabled();
+    if (profiled) profiler_layer_zones(vbts, vbts_zone, PROFILER_BACKWARD);
+    if (layer_timing && vbts_time.size() != vbts.size()) vbts_time.assign(vbts.size(), 0.0);
+
     for (int i = 0; i < vbts.size(); i++) {
         //if (!vbts[i]->trainable) return;
+        PROFILER_ZONE_ID(profiled ? vbts_zone[i] : -1);
+
+        high_resolution_clock::time_point t0;
+        if (layer_timing) t0 = high_resolution_clock::now();
 
         vbts[i]->mem_delta_parent();
 
         vbts[i]->backward();
 
         if(vbts[i]->mem_level) { vbts[i]->free_delta(); }
+
+        if (layer_timing) vbts_time[i] += duration<double>(high_resolution_clock::now() - t0).count();
     }
+    if (layer_timing) timed_backwards++;
 }
 
 void Net::do_delta() {
     for (int i = 0; i < lout.size(); i++) {
         lout[i]->mem_delta();
         if (losses.size()>=(i+1)) {
-            losses[i]->delta(lout[i]->target, lout[i]->output, lout[i]->delta);
+            if (fused_loss[i]) {
+                if (!fused_delta[i]) tensorNN::softmax_cross_entropy(lout[i]->target, lout[i]->input, lout[i]->output, lout[i]->delta);
+                fused_delta[i] = false;
+            } else {
+                losses[i]->delta(lout[i]->target, lout[i]->output, lout[i]->delta);
+            }
         }
     }
 }
@@ -80,7 +122,18 @@ void Net::do_compute_loss() {
     for (int i = 0; i < lout.size(); i++, p += 2) {
         // loss value
         if (losses.size()>=(i+1)){
-            fiterr[p] = losses[i]->value(lout[i]->target, lout[i]->output);
+            if (fused_loss[i]) {
+                // When training, the delta is computed in the same sweep (do_delta comes next)
+                Tensor *delta = nullptr;
+                if (lout[i]->mode == TRMODE) {
+                    lout[i]->mem_delta();
+                    delta = lout[i]->delta;
+                }
+                fiterr[p] = tensorNN::softmax_cross_entropy(lout[i]->target, lout[i]->input, lout[i]->output, delta);
+                fused_delta[i] = (delta != nullptr);
+            } else {
+                fiterr[p] = losses[i]->value(lout[i]->target, lout[i]->output);
+            }
         }
         // metric value
         if (this->metrics.size()>=(i+1)){
@@ -90,6 +143,7 @@ void Net::do_compute_loss() {
 }
 
 void Net::do_applygrads() {
+    PROFILER_ZONE("applygrads", PROFILER_NET);
     optimizer->applygrads(batch_size);
 }
 
@@ -135,7 +189,7 @@ void collectTensor(Layer *l,string tname, int p){
     //      collectTensor(net, "output") => net (CPU) => 100% outputs
 
     Net *sn=l->net;
-    if (sn->snets[0]->dev==DEV_CPU) return;
+    if ((sn->snets[0]->dev==DEV_CPU)||(sn->snets[0]==sn)) return;  // Nothing to collect (e.g. inference contexts)
 
     int i,j,comp;
 
@@ -196,7 +250,7 @@ void distributeTensor(Layer *l,string tname, int p)
 {
     Net *sn=l->net;
 
-    if (sn->snets[0]->dev==DEV_CPU) return;
+    if ((sn->snets[0]->dev==DEV_CPU)||(sn->snets[0]==sn)) return;  // Nothing to distribute (e.g. inference contexts)
 
     int i,j,comp;
     vector<int> sind(sn->batch_size);
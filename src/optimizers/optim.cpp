@@ -38,3 +38,14 @@ void Optimizer::clip()
       layers[i]->gradients[j]->clamp_(-clip_val,clip_val);
 
 }
+
+void Optimizer::add_state(const string &slot, const vtensor &state, vector<string> &names, vtensor &tensors)
+{
+  // State tensors are stored per trainable param, in the same order as in setlayers()
+  int p = 0;
+  for (int i = 0; i < layers.size(); i++)
+    for (int j = 0; j < layers[i]->get_trainable_params_count() && p < state.size(); j++, p++) {
+      names.push_back("optimizer/" + layers[i]->name + "/" + slot + "/" + to_string(j));
+      tensors.push_back(state[p]);
+    }
+}
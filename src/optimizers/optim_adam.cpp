@@ -12,6 +12,7 @@
 #include <iostream>
 
 #include "eddl/optimizers/optim.h"
+#include "eddl/hardware/cpu/cpu_optim.h"
 
 using namespace std;
 
@@ -61,23 +62,14 @@ void Adam::setlayers(vlayer l) {
 
     if (isshared) return;
 
-    // create momemtum tensors
+    // create momemtum tensors. mCap and vCap are only needed by the tensor ops path (not CPU)
     for (int i = 0; i < layers.size(); i++)
         for (int j = 0; j < layers[i]->get_trainable_params_count(); j++) {
-            mT.push_back(  Tensor::zeros_like(layers[i]->gradients[j]));
-            vT.push_back(  Tensor::zeros_like(layers[i]->gradients[j]));
-            mCap.push_back(Tensor::zeros_like(layers[i]->gradients[j]));
-            vCap.push_back(Tensor::zeros_like(layers[i]->gradients[j]));
-            /*
-            mT.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
-            mT.back()->fill_(0.0);
-            vT.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
-            vT.back()->fill_(0.0);
-            mCap.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
-            mCap.back()->fill_(0.0);
-            vCap.push_back(new Tensor(layers[i]->gradients[j]->getShape(), layers[i]->dev));
-            vCap.back()->fill_(0.0);
-            */
+            Tensor *g = layers[i]->gradients[j];
+            mT.push_back(Tensor::zeros_like(g));
+            vT.push_back(Tensor::zeros_like(g));
+            mCap.push_back(g->isCPU() ? nullptr : Tensor::zeros_like(g));
+            vCap.push_back(g->isCPU() ? nullptr : Tensor::zeros_like(g));
         }
 
 }
@@ -93,6 +85,14 @@ void Adam::applygrads(int batch) {
     for (int i = 0; i < layers.size(); i++)
       if (layers[i]->trainable) {
         for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
+            Tensor *w = layers[i]->params[j];
+            if (w->isCPU()) {
+              float *acc = layers[i]->acc_gradients.size() > 0 ? layers[i]->acc_gradients[j]->ptr : nullptr;
+              cpu_adam_update(w->ptr, layers[i]->gradients[j]->ptr, mT[p]->ptr, vT[p]->ptr, acc, w->size,
+                              lr, beta_1, beta_2, epsilon, t);
+              continue;
+            }
+
             Tensor::add(beta_1,mT[p],(1-beta_1),layers[i]->gradients[j],mT[p],0);
             layers[i]->gradients[j]->sqr_();
             Tensor::add(beta_2,vT[p],(1-beta_2),layers[i]->gradients[j],vT[p],0);
@@ -118,3 +118,19 @@ void Adam::applygrads(int batch) {
   }
 
 }
+
+void Adam::get_state(vector<string> &names, vtensor &tensors) {
+    if (isshared) { orig->get_state(names, tensors); return; }
+    // mCap and vCap are temporaries of applygrads()
+    add_state("mT", mT, names, tensors);
+    add_state("vT", vT, names, tensors);
+}
+
+long Adam::get_step() {
+    return isshared ? orig->get_step() : t;
+}
+
+void Adam::set_step(long step) {
+    if (isshared) orig->set_step(step);
+    else t = step;
+}
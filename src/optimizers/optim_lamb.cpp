@@ -0,0 +1,137 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <cmath>
+
+#include "eddl/optimizers/optim.h"
+#include "eddl/hardware/cpu/cpu_optim.h"
+
+using namespace std;
+
+
+LAMB::LAMB(float lr, float beta_1, float beta_2, float epsilon, float weight_decay) : Optimizer() {
+    this->lr = lr;
+    this->beta_1 = beta_1;
+    this->beta_2 = beta_2;
+    this->epsilon = epsilon;
+    this->weight_decay = weight_decay;
+
+    t=0;
+}
+
+LAMB::~LAMB() {
+    if (! this->isshared) {
+        for(int i=0; i<mT.size(); i++){ delete mT[i]; }
+        for(int i=0; i<vT.size(); i++){ delete vT[i]; }
+        for(int i=0; i<uT.size(); i++){ delete uT[i]; }
+    }
+}
+
+void LAMB::change(vector<float> p) {
+  if (p.size()>0) lr = p[0];
+  cout<<"Optimizer LAMB set new lr="<<lr<<"\n";
+}
+
+Optimizer *LAMB::clone() {
+    LAMB *n=new LAMB(lr, beta_1, beta_2, epsilon, weight_decay);
+    n->clip_val=clip_val;
+
+    return n;
+}
+
+Optimizer *LAMB::share() {
+    LAMB *n=new LAMB(lr, beta_1, beta_2, epsilon, weight_decay);
+    n->orig=this;
+    n->isshared=true;
+    n->clip_val=clip_val;
+    return n;
+}
+
+void LAMB::setlayers(vlayer l) {
+    layers.clear();
+    for (auto _ : l) layers.push_back(_);
+
+    if (isshared) return;
+
+    // create moment tensors (and the update direction, needed before the trust ratio is known)
+    for (int i = 0; i < layers.size(); i++)
+        for (int j = 0; j < layers[i]->get_trainable_params_count(); j++) {
+            mT.push_back(Tensor::zeros_like(layers[i]->gradients[j]));
+            vT.push_back(Tensor::zeros_like(layers[i]->gradients[j]));
+            uT.push_back(Tensor::zeros_like(layers[i]->gradients[j]));
+        }
+}
+
+void LAMB::applygrads(int batch) {
+  if (isshared) {
+    orig->applygrads(batch);
+  }
+  else {
+    clip();
+    int p = 0;
+    t++;
+    for (int i = 0; i < layers.size(); i++)
+      if (layers[i]->trainable) {
+        for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
+            Tensor *w = layers[i]->params[j];
+            Tensor *g = layers[i]->gradients[j];
+            Tensor *acc = layers[i]->acc_gradients.size() > 0 ? layers[i]->acc_gradients[j] : nullptr;
+            bool adapt = w->ndim > 1;  // Biases and normalization params keep the global learning rate
+
+            if (w->isCPU()) {
+                cpu_lamb_update(w, g, mT[p], vT[p], uT[p], acc, lr, beta_1, beta_2, epsilon, weight_decay, t, adapt);
+                continue;
+            }
+
+            Tensor::add(beta_1,mT[p],(1-beta_1),g,mT[p],0);
+            g->sqr_();
+            Tensor::add(beta_2,vT[p],(1-beta_2),g,vT[p],0);
+
+            Tensor::copy(vT[p],uT[p]);
+            uT[p]->div_(1-pow(beta_2,t));
+            uT[p]->sqrt_();
+            uT[p]->add_(epsilon);
+            Tensor::el_div(mT[p],uT[p],uT[p],0);
+            uT[p]->div_(1-pow(beta_1,t));
+            if (adapt && weight_decay != 0.0f) Tensor::add(1.0, uT[p], weight_decay, w, uT[p], 0);
+
+            float ratio = 1.0f;
+            if (adapt) {
+                float wn = w->norm(), un = uT[p]->norm();
+                if (wn > 0.0f && un > 0.0f) ratio = wn / un;
+            }
+            Tensor::add(1.0, w, -lr * ratio, uT[p], w, 0);
+
+            // Distributed training: Accumulation of gradients
+            if (acc != nullptr)
+              Tensor::add(1.0, acc, -lr * ratio, uT[p], acc, 0);
+        }
+    }
+    else p+=layers[i]->get_trainable_params_count();
+  }
+}
+
+void LAMB::get_state(vector<string> &names, vtensor &tensors) {
+    if (isshared) { orig->get_state(names, tensors); return; }
+    // uT is a temporary of applygrads()
+    add_state("mT", mT, names, tensors);
+    add_state("vT", vT, names, tensors);
+}
+
+long LAMB::get_step() {
+    return isshared ? orig->get_step() : t;
+}
+
+void LAMB::set_step(long step) {
+    if (isshared) orig->set_step(step);
+    else t = step;
+}
@@ -0,0 +1,105 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/optimizers/optim.h"
+#include "eddl/hardware/cpu/cpu_optim.h"
+
+using namespace std;
+
+
+LARS::LARS(float lr, float momentum, float weight_decay, float eta, float epsilon) : Optimizer() {
+    this->lr = lr;
+    this->mu = momentum;
+    this->weight_decay = weight_decay;
+    this->eta = eta;
+    this->epsilon = epsilon;
+}
+
+LARS::~LARS() {
+    for(int i=0; i<mT.size(); i++){ delete mT[i]; }
+}
+
+void LARS::change(vector<float> p) {
+    if (p.size()>0) lr = p[0];
+    if (p.size()>1) mu = p[1];
+}
+
+Optimizer *LARS::clone() {
+    LARS *n=new LARS(lr, mu, weight_decay, eta, epsilon);
+    n->clip_val=clip_val;
+
+    return n;
+}
+
+Optimizer *LARS::share() {
+    LARS *n=new LARS(lr, mu, weight_decay, eta, epsilon);
+    n->orig=this;
+    n->isshared=true;
+    n->clip_val=clip_val;
+    return n;
+}
+
+void LARS::setlayers(vlayer l) {
+    layers = l;
+
+    if (isshared) return;
+
+    // create momemtum tensors
+    for (int i = 0; i < layers.size(); i++)
+        for (int j = 0; j < layers[i]->get_trainable_params_count(); j++)
+            mT.push_back(Tensor::zeros_like(layers[i]->gradients[j]));
+}
+
+void LARS::applygrads(int batch) {
+    if (isshared) {
+      orig->applygrads(batch);
+    }
+    else {
+      clip();
+      int p = 0;
+      for (int i = 0; i < layers.size(); i++) {
+        if (layers[i]->trainable) {
+          for (int j = 0; j < layers[i]->get_trainable_params_count(); j++, p++) {
+            Tensor *w = layers[i]->params[j];
+            Tensor *g = layers[i]->gradients[j];
+            Tensor *acc = layers[i]->acc_gradients.size() > 0 ? layers[i]->acc_gradients[j] : nullptr;
+            bool adapt = w->ndim > 1;  // Biases and normalization params keep the global learning rate
+
+            if (w->isCPU()) {
+              cpu_lars_update(w, g, mT[p], acc, lr, mu, weight_decay, eta, epsilon, adapt);
+              continue;
+            }
+
+            float ratio = 1.0f;
+            if (adapt) {
+              float wn = w->norm(), gn = g->norm();
+              if (wn > 0.0f && gn > 0.0f) ratio = eta * wn / (gn + weight_decay * wn + epsilon);
+              if (weight_decay != 0.0f) Tensor::add(1.0, g, weight_decay, w, g, 0);
+            }
+            Tensor::add(lr * ratio, g, mu, mT[p], mT[p], 0);
+            Tensor::add(1.0, w, -1.0, mT[p], w, 0);
+
+            // Distributed training: Accumulation of gradients
+            if (acc != nullptr)
+              Tensor::add(1.0, acc, -1.0, mT[p], acc, 0);
+          }
+        }
+        else p+=layers[i]->get_trainable_params_count();
+      }
+    }
+}
+
+void LARS::get_state(vector<string> &names, vtensor &tensors) {
+    if (isshared) { orig->get_state(names, tensors); return; }
+    add_state("mT", mT, names, tensors);
+}
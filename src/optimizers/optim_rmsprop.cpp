@@ -102,3 +102,9 @@ void RMSProp::applygrads(int batch) {
   }
 
 }
+
+void RMSProp::get_state(vector<string> &names, vtensor &tensors) {
+    if (isshared) { orig->get_state(names, tensors); return; }
+    // gT1 keeps the previous gradient, gT is a temporary of applygrads()
+    add_state("gT1", gT1, names, tensors);
+}
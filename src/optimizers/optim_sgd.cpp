@@ -87,3 +87,8 @@ void SGD::applygrads(int batch) {
       }
     }
 }
+
+void SGD::get_state(vector<string> &names, vtensor &tensors) {
+    if (isshared) { orig->get_state(names, tensors); return; }
+    add_state("mT", mT, names, tensors);
+}
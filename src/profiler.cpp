@@ -0,0 +1,294 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "eddl/profiler.h"
+
+#if defined(_WIN32)
+#include <chrono>
+#else
+#include <time.h>
+#endif
+
+
+std::atomic<bool> profiler_enabled(false);
+
+static const char *profiler_category_names[PROFILER_NUM_CATEGORIES] = {"net", "forward", "backward", "kernel"};
+
+struct ProfilerFrame {
+    int zone;
+    uint64_t begin;
+    uint64_t child;  // Time spent in nested zones
+};
+
+struct ProfilerZoneInfo {
+    string name;
+    int category;
+};
+
+struct ProfilerStats {
+    string name;
+    int category;
+    uint64_t calls;
+    uint64_t total;
+    uint64_t self;
+};
+
+// Only written by the owner thread (load + store, no read-modify-write), read by the reports
+struct ProfilerCounters {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> self;
+};
+
+struct ProfilerThread {
+    int tid;
+
+    // Written by the owner thread, read by the exporters
+    vector<ProfilerEvent> events;     // Ring buffer
+    std::atomic<uint64_t> count{0};   // Number of events ever pushed (next position = count % size)
+    ProfilerCounters counters[PROFILER_MAX_ZONES];
+
+    // Only accessed by the owner thread
+    ProfilerFrame stack[PROFILER_MAX_DEPTH];
+    int depth = 0;
+    int skipped = 0;  // Zones ignored because the stack was full
+};
+
+// Buffers are never released: threads may finish before the trace is exported
+static std::mutex profiler_registry_mtx;
+static vector<ProfilerThread *> profiler_threads;
+static vector<ProfilerZoneInfo> profiler_zones;
+static map<pair<int, string>, int> profiler_zone_ids;
+static thread_local ProfilerThread *profiler_local = nullptr;
+static std::atomic<uint64_t> profiler_origin(0);
+
+
+static inline uint64_t profiler_now(){
+#if defined(_WIN32)
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline void profiler_add(std::atomic<uint64_t> &counter, uint64_t value){
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static ProfilerThread *profiler_thread(){
+    if (profiler_local == nullptr) {
+        auto *t = new ProfilerThread();
+        t->events.resize(PROFILER_BUFFER_SIZE);
+        for (auto &c : t->counters) { c.calls = 0; c.total = 0; c.self = 0; }
+        std::lock_guard<std::mutex> lock(profiler_registry_mtx);
+        t->tid = (int)profiler_threads.size();
+        profiler_threads.push_back(t);
+        profiler_local = t;
+    }
+    return profiler_local;
+}
+
+void profiler_enable(bool enable){
+    uint64_t unset = 0;
+    if (enable) profiler_origin.compare_exchange_strong(unset, profiler_now());
+    profiler_enabled.store(enable, std::memory_order_relaxed);
+}
+
+void profiler_reset(){
+    std::lock_guard<std::mutex> lock(profiler_registry_mtx);
+    for (auto *t : profiler_threads) {
+        t->count.store(0);
+        for (auto &c : t->counters) { c.calls = 0; c.total = 0; c.self = 0; }
+    }
+    profiler_origin.store(profiler_now());
+}
+
+int profiler_register(const char *name, int category){
+    std::lock_guard<std::mutex> lock(profiler_registry_mtx);
+    auto key = std::make_pair(category, string(name));
+    auto it = profiler_zone_ids.find(key);
+    if (it != profiler_zone_ids.end()) return it->second;
+    if (profiler_zones.size() >= PROFILER_MAX_ZONES) return -1;
+
+    int zone = (int)profiler_zones.size();
+    profiler_zones.push_back({key.second, category});
+    profiler_zone_ids.emplace(key, zone);
+    return zone;
+}
+
+void profiler_begin(int zone){
+    ProfilerThread *t = profiler_thread();
+    if (t->depth >= PROFILER_MAX_DEPTH) {
+        t->skipped++;
+        return;
+    }
+
+    ProfilerFrame &f = t->stack[t->depth++];
+    f.zone = zone;
+    f.child = 0;
+    f.begin = profiler_now();  // Last, so the bookkeeping is not measured
+}
+
+void profiler_end(int zone){
+    // Cheap checks first: this is also called (unconditionally) when the profiler is disabled
+    ProfilerThread *t = profiler_local;
+    if (t == nullptr || t->depth == 0) return;  // Nothing open (e.g. enabled inside this zone)
+    if (t->skipped > 0) {
+        t->skipped--;
+        return;
+    }
+    if (t->stack[t->depth - 1].zone != zone) return;  // Unmatched end (e.g. enabled between begin and end)
+
+    uint64_t end = profiler_now();
+
+    ProfilerFrame &f = t->stack[--t->depth];
+    uint64_t elapsed = end - f.begin;
+    uint64_t self = elapsed > f.child ? elapsed - f.child : 0;
+    if (t->depth > 0) t->stack[t->depth - 1].child += elapsed;
+
+    uint64_t count = t->count.load(std::memory_order_relaxed);
+    ProfilerEvent &e = t->events[count % t->events.size()];
+    e.zone = zone;
+    e.depth = (uint8_t)t->depth;
+    e.begin = f.begin;
+    e.end = end;
+    e.self = self;
+    t->count.store(count + 1, std::memory_order_release);
+
+    ProfilerCounters &c = t->counters[zone];
+    profiler_add(c.calls, 1);
+    profiler_add(c.total, elapsed);
+    profiler_add(c.self, self);
+}
+
+
+// Reports ******************************************
+
+static vector<ProfilerStats> profiler_collect_stats(){
+    vector<ProfilerStats> stats;
+    {
+        std::lock_guard<std::mutex> lock(profiler_registry_mtx);
+        for (auto &z : profiler_zones) stats.push_back({z.name, z.category, 0, 0, 0});
+        for (auto *t : profiler_threads) {
+            for (size_t i = 0; i < stats.size(); i++) {
+                stats[i].calls += t->counters[i].calls.load(std::memory_order_relaxed);
+                stats[i].total += t->counters[i].total.load(std::memory_order_relaxed);
+                stats[i].self += t->counters[i].self.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    stats.erase(std::remove_if(stats.begin(), stats.end(), [](const ProfilerStats &s){ return s.calls == 0; }), stats.end());
+    std::sort(stats.begin(), stats.end(), [](const ProfilerStats &a, const ProfilerStats &b){ return a.total > b.total; });
+    return stats;
+}
+
+void profiler_show_summary(){
+    vector<ProfilerStats> stats = profiler_collect_stats();
+    if (stats.empty()) return;
+
+    // Layers: merge forward and backward
+    struct LayerStats { string name; uint64_t calls; uint64_t fwd; uint64_t bwd; uint64_t self; };
+    vector<LayerStats> layers;
+    uint64_t layers_total = 0;
+    for (auto &s : stats) {
+        if (s.category != PROFILER_FORWARD && s.category != PROFILER_BACKWARD) continue;
+        auto it = std::find_if(layers.begin(), layers.end(), [&s](const LayerStats &l){ return l.name == s.name; });
+        if (it == layers.end()) {
+            layers.push_back({s.name, 0, 0, 0, 0});
+            it = layers.end() - 1;
+        }
+        if (s.category == PROFILER_FORWARD) { it->calls += s.calls; it->fwd += s.total; }
+        else it->bwd += s.total;
+        it->self += s.self;
+        layers_total += s.total;
+    }
+    std::sort(layers.begin(), layers.end(), [](const LayerStats &a, const LayerStats &b){ return a.fwd + a.bwd > b.fwd + b.bwd; });
+
+    printf("==============================================================================================================\n");
+    printf("| Profiler (net)                                                                                             |\n");
+    printf("-------------------------------------------------------------------------------------------------------------|\n");
+    for (auto &s : stats) {
+        if (s.category != PROFILER_NET) continue;
+        printf("| %-50s: %8llu calls, %12.3f ms , %12.4f ms/call |\n", s.name.c_str(), (unsigned long long)s.calls,
+               s.total / 1e6, s.total / 1e6 / s.calls);
+    }
+
+    if (!layers.empty()) {
+        printf("==============================================================================================================\n");
+        printf("| Profiler (layers)                   calls     forward (ms)    backward (ms)   self (ms)          total (%%) |\n");
+        printf("-------------------------------------------------------------------------------------------------------------|\n");
+        for (auto &l : layers) {
+            printf("| %-30s %10llu %16.3f %16.3f %11.3f %17.2f |\n", l.name.c_str(), (unsigned long long)l.calls,
+                   l.fwd / 1e6, l.bwd / 1e6, l.self / 1e6, 100.0 * (l.fwd + l.bwd) / std::max<uint64_t>(layers_total, 1));
+        }
+    }
+
+    printf("==============================================================================================================\n");
+    printf("| Profiler (kernels)                                                                                         |\n");
+    printf("-------------------------------------------------------------------------------------------------------------|\n");
+    for (auto &s : stats) {
+        if (s.category != PROFILER_KERNEL) continue;
+        printf("| %-50s: %8llu calls, %12.3f ms , %12.4f us/call |\n", s.name.c_str(), (unsigned long long)s.calls,
+               s.total / 1e6, s.total / 1e3 / s.calls);
+    }
+    printf("==============================================================================================================\n");
+}
+
+static void profiler_write_escaped(std::ofstream &ofs, const char *s){
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') ofs << '\\' << *s;
+        else if ((unsigned char)*s < 0x20) ofs << ' ';
+        else ofs << *s;
+    }
+}
+
+bool profiler_export_chrome_trace(const string &filename){
+    std::ofstream ofs(filename);
+    if (!ofs.good()) return false;
+
+    ofs << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    uint64_t origin = profiler_origin.load();
+    char num[64];
+
+    // Events being recorded meanwhile may overwrite the oldest ones, export while the threads are idle
+    std::lock_guard<std::mutex> lock(profiler_registry_mtx);
+    for (auto *t : profiler_threads) {
+        uint64_t size = t->events.size();
+        uint64_t count = t->count.load(std::memory_order_acquire);
+        uint64_t start = count > size ? count - size : 0;
+        for (uint64_t i = start; i < count; i++) {
+            const ProfilerEvent &e = t->events[i % size];
+            if (e.begin < origin) continue;  // Recorded before the last reset
+            const ProfilerZoneInfo &z = profiler_zones[e.zone];
+            if (!first) ofs << ",\n";
+            first = false;
+
+            ofs << "{\"name\": \"";
+            profiler_write_escaped(ofs, z.name.c_str());
+            snprintf(num, sizeof(num), "%.3f", (e.begin - origin) / 1e3);
+            ofs << "\", \"cat\": \"" << profiler_category_names[z.category] << "\", \"ph\": \"X\", \"ts\": " << num;
+            snprintf(num, sizeof(num), "%.3f", (e.end - e.begin) / 1e3);
+            ofs << ", \"dur\": " << num << ", \"pid\": 0, \"tid\": " << t->tid << "}";
+        }
+    }
+    ofs << "\n]}\n";
+    return ofs.good();
+}
@@ -10,6 +10,7 @@
 #include <stdio.h>
 
 #include "eddl/profiling.h"
+#include "eddl/profiler.h"
 
 #ifdef EDDL_WINDOWS
 int gettimeofday(struct timeval* tp, struct timezone* tzp)
@@ -175,6 +176,8 @@ PROFILING_ENABLE(permute_batch_first);
 // core_nn
 PROFILING_ENABLE(repeat_nn);
 PROFILING_ENABLE(d_repeat_nn);
+PROFILING_ENABLE(upsampling2D);
+PROFILING_ENABLE(d_upsampling2D);
 PROFILING_ENABLE(select);
 PROFILING_ENABLE(select_back);
 PROFILING_ENABLE(set_select);
@@ -194,17 +197,10 @@ PROFILING_ENABLE(Precision_Conversion);
 PROFILING_ENABLE(FPGA_READ);
 PROFILING_ENABLE(FPGA_WRITE);
 
-// training-inference-specific
-PROFILING_ENABLE(forward);
-
 void __show_profile() {
 
-  // training-inference-specific
-  printf("==============================================================================================================\n");
-  printf("| Profiling (model)                                                                                          |\n");
-  printf("-------------------------------------------------------------------------------------------------------------|\n");
-  
-  PROFILING_PRINTF(forward);
+  // training-inference-specific (net, layers and kernels)
+  profiler_show_summary();
 
   printf("==============================================================================================================\n");
   printf("| Profiling (functions)                                                                                      |\n");
@@ -360,6 +356,8 @@ void __show_profile() {
   // core_nn
   PROFILING_PRINTF(repeat_nn);
   PROFILING_PRINTF(d_repeat_nn);
+  PROFILING_PRINTF(upsampling2D);
+  PROFILING_PRINTF(d_upsampling2D);
   PROFILING_PRINTF(select);
   PROFILING_PRINTF(select_back);
   PROFILING_PRINTF(set_select);
@@ -385,8 +383,8 @@ void __show_profile() {
 
 void __reset_profile() {
 
-  // training-inference-specific
-  PROFILING_RESET(forward);
+  // training-inference-specific (net, layers and kernels)
+  profiler_reset();
 
   // profiling declarations
   PROFILING_RESET(maximum);
@@ -538,6 +536,8 @@ void __reset_profile() {
   // core_nn
   PROFILING_RESET(repeat_nn);
   PROFILING_RESET(d_repeat_nn);
+  PROFILING_RESET(upsampling2D);
+  PROFILING_RESET(d_upsampling2D);
   PROFILING_RESET(select);
   PROFILING_RESET(select_back);
   PROFILING_RESET(set_select);
@@ -0,0 +1,330 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "eddl/serialization/checkpoint/checkpoint.h"
+#include "eddl/utils.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_entries;
+    int64_t step;
+    uint64_t data_offset;
+    uint64_t file_size;
+};
+
+static inline uint64_t align_up(uint64_t x){
+    return (x + CKPT_ALIGNMENT - 1) / CKPT_ALIGNMENT * CKPT_ALIGNMENT;
+}
+
+template <typename T>
+static inline void put(vector<char> &buf, uint64_t &pos, const T &v){
+    memcpy(buf.data() + pos, &v, sizeof(T));
+    pos += sizeof(T);
+}
+
+template <typename T>
+static inline T get(const char *base, uint64_t &pos, uint64_t length){
+    if (pos + sizeof(T) > length) {
+        throw std::runtime_error("Truncated checkpoint index (CheckpointReader)");
+    }
+    T v;
+    memcpy(&v, base + pos, sizeof(T));
+    pos += sizeof(T);
+    return v;
+}
+
+
+////////////////////////////////////
+///// CHECKPOINT WRITER
+////////////////////////////////////
+
+CheckpointWriter::CheckpointWriter(){
+    stop = false;
+    worker = std::thread(&CheckpointWriter::run, this);
+}
+
+CheckpointWriter::~CheckpointWriter(){
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]{ return pending.empty(); });
+        stop = true;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+void CheckpointWriter::snapshot(Buffer &buffer, const vector<string> &names, const vector<Tensor *> &tensors, int64_t step){
+    if (names.size() != tensors.size()) {
+        msg("The number of names and tensors must match", "CheckpointWriter::save");
+    }
+
+    // Index size
+    uint64_t index_size = 0;
+    for (int i = 0; i < tensors.size(); i++) {
+        index_size += sizeof(uint32_t) + names[i].size() + sizeof(uint32_t) + tensors[i]->ndim * sizeof(int32_t) + 2 * sizeof(uint64_t);
+    }
+
+    // Data layout
+    uint64_t data_offset = align_up(sizeof(CheckpointHeader) + index_size);
+    vector<uint64_t> offsets(tensors.size());
+    uint64_t file_size = data_offset;
+    for (int i = 0; i < tensors.size(); i++) {
+        offsets[i] = file_size;
+        file_size = align_up(file_size + tensors[i]->size * sizeof(float));
+    }
+
+    // Reuses the capacity of the previous snapshots (no allocation in steady state)
+    buffer.data.resize(file_size);
+
+    CheckpointHeader header{};
+    memcpy(header.magic, CKPT_MAGIC, sizeof(header.magic));
+    header.version = CKPT_VERSION;
+    header.num_entries = (uint32_t)tensors.size();
+    header.step = step;
+    header.data_offset = data_offset;
+    header.file_size = file_size;
+
+    uint64_t pos = 0;
+    put(buffer.data, pos, header);
+    for (int i = 0; i < tensors.size(); i++) {
+        put(buffer.data, pos, (uint32_t)names[i].size());
+        memcpy(buffer.data.data() + pos, names[i].data(), names[i].size());
+        pos += names[i].size();
+        put(buffer.data, pos, (uint32_t)tensors[i]->ndim);
+        for (int d : tensors[i]->shape) put(buffer.data, pos, (int32_t)d);
+        put(buffer.data, pos, offsets[i]);
+        put(buffer.data, pos, (uint64_t)(tensors[i]->size * sizeof(float)));
+    }
+    memset(buffer.data.data() + pos, 0, data_offset - pos);
+
+    // Copy the tensors (this works for any device since the destination is a CPU tensor)
+    for (int i = 0; i < tensors.size(); i++) {
+        auto *dst = (float *)(buffer.data.data() + offsets[i]);
+        if (tensors[i]->isCPU()) {
+            memcpy(dst, tensors[i]->ptr, tensors[i]->size * sizeof(float));
+        } else {
+            Tensor view(tensors[i]->shape, dst, DEV_CPU);
+            Tensor::copy(tensors[i], &view);
+        }
+    }
+}
+
+void CheckpointWriter::save(const string &filename, const vector<string> &names, const vector<Tensor *> &tensors, int64_t step, bool async){
+    int b;
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!last_error.empty()) {
+            string e = last_error;
+            last_error.clear();
+            msg(e, "CheckpointWriter::save");
+        }
+
+        // Wait for a free buffer (only blocks if both buffers are still being written)
+        cv.wait(lock, [this]{
+            for (auto &buf : buffers) if (!buf.busy) return true;
+            return false;
+        });
+        for (b = 0; buffers[b].busy; b++);
+        buffers[b].busy = true;
+    }
+
+    try {
+        snapshot(buffers[b], names, tensors, step);
+    } catch (...) {
+        std::unique_lock<std::mutex> lock(mtx);
+        buffers[b].busy = false;
+        cv.notify_all();
+        throw;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        buffers[b].filename = filename;
+        pending.push_back(b);
+    }
+    cv.notify_all();
+
+    if (!async) wait();
+}
+
+void CheckpointWriter::wait(){
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this]{
+        if (!pending.empty()) return false;
+        for (auto &buf : buffers) if (buf.busy) return false;
+        return true;
+    });
+    if (!last_error.empty()) {
+        string e = last_error;
+        last_error.clear();
+        lock.unlock();
+        msg(e, "CheckpointWriter::wait");
+    }
+}
+
+void CheckpointWriter::run(){
+    while (true) {
+        int b;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]{ return stop || !pending.empty(); });
+            if (pending.empty()) return;  // stop requested and nothing left to write
+            b = pending.front();
+        }
+
+        // Write to a temporary file and rename it, so a crash never leaves a truncated checkpoint
+        Buffer &buf = buffers[b];
+        string tmp = buf.filename + ".tmp";
+        string error;
+        std::ofstream ofs(tmp, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs.good()) {
+            error = "Unable to open '" + tmp + "' for writing";
+        } else {
+            ofs.write(buf.data.data(), (std::streamsize)buf.data.size());
+            ofs.close();
+            if (!ofs.good()) {
+                error = "Error writing '" + tmp + "'";
+            } else if (std::rename(tmp.c_str(), buf.filename.c_str()) != 0) {
+                std::remove(buf.filename.c_str());  // Windows does not overwrite on rename
+                if (std::rename(tmp.c_str(), buf.filename.c_str()) != 0) {
+                    error = "Unable to rename '" + tmp + "' to '" + buf.filename + "'";
+                }
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (!error.empty()) last_error = error;
+            pending.pop_front();
+            buf.busy = false;
+        }
+        cv.notify_all();
+    }
+}
+
+
+////////////////////////////////////
+///// CHECKPOINT READER
+////////////////////////////////////
+
+CheckpointReader::CheckpointReader(const string &filename){
+    base = nullptr;
+    length = 0;
+    mapped = false;
+    step = 0;
+
+#if !defined(_WIN32)
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("File not found. Check the file name and try again (CheckpointReader)");
+    }
+    struct stat st{};
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        length = (size_t)st.st_size;
+        void *p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            base = (char *)p;
+            mapped = true;
+        }
+    }
+    close(fd);
+#endif
+
+    if (!mapped) {
+        std::ifstream ifs(filename, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!ifs.good()) {
+            throw std::runtime_error("File not found. Check the file name and try again (CheckpointReader)");
+        }
+        length = (size_t)ifs.tellg();
+        fallback.resize(length);
+        ifs.seekg(0);
+        ifs.read(fallback.data(), (std::streamsize)length);
+        base = fallback.data();
+    }
+
+    // Parse header
+    uint64_t pos = 0;
+    auto header = get<CheckpointHeader>(base, pos, length);
+    if (memcmp(header.magic, CKPT_MAGIC, sizeof(header.magic)) != 0) {
+        msg("Not an EDDL checkpoint file", "CheckpointReader");
+    }
+    if (header.version > CKPT_VERSION) {
+        msg("Unsupported checkpoint version (" + to_string(header.version) + ")", "CheckpointReader");
+    }
+    if (header.file_size != length) {
+        msg("Truncated checkpoint file", "CheckpointReader");
+    }
+    step = header.step;
+
+    // Parse index
+    for (uint32_t i = 0; i < header.num_entries; i++) {
+        CheckpointEntry e;
+        auto name_len = get<uint32_t>(base, pos, length);
+        if (pos + name_len > length) msg("Truncated checkpoint index", "CheckpointReader");
+        e.name = string(base + pos, name_len);
+        pos += name_len;
+        auto ndim = get<uint32_t>(base, pos, length);
+        for (uint32_t d = 0; d < ndim; d++) e.shape.push_back(get<int32_t>(base, pos, length));
+        e.offset = get<uint64_t>(base, pos, length);
+        e.nbytes = get<uint64_t>(base, pos, length);
+        if (e.offset + e.nbytes > length) msg("Corrupted checkpoint entry: " + e.name, "CheckpointReader");
+        entries.push_back(e);
+    }
+}
+
+CheckpointReader::~CheckpointReader(){
+#if !defined(_WIN32)
+    if (mapped) munmap(base, length);
+#endif
+}
+
+int CheckpointReader::find(const string &name){
+    for (int i = 0; i < entries.size(); i++) {
+        if (entries[i].name == name) return i;
+    }
+    return -1;
+}
+
+const float *CheckpointReader::data(int i){
+    return (const float *)(base + entries[i].offset);
+}
+
+bool CheckpointReader::copy_to(const string &name, Tensor *t, int position){
+    int i = find(name);
+    if (i < 0) {
+        if (position < 0 || position >= entries.size()) return false;
+        i = position;
+    }
+
+    if (entries[i].nbytes != t->size * sizeof(float)) {
+        msg("Size mismatch for '" + name + "': checkpoint (" + printVector(entries[i].shape) + ") vs tensor (" + printVector(t->shape) + ")", "CheckpointReader::copy_to");
+    }
+
+    if (t->isCPU()) {
+        memcpy(t->ptr, data(i), entries[i].nbytes);
+    } else {
+        Tensor view(t->shape, (float *)data(i), DEV_CPU);
+        Tensor::copy(&view, t);
+    }
+    return true;
+}
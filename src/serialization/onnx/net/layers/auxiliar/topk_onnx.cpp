@@ -12,14 +12,9 @@ Layer* build_topk_layer(onnx::NodeProto *node,
   string parent_name;
   Layer *parent;
   vector<int> parent_shape;
-  string k_name;
   int K = 1;
-  vector<int> dims;
 
-  string shape_name = node->input(1);
-  vector<float> shape_values = map_init_values[shape_name];
-
-  // inputs
+  // inputs: data and K (an initializer with a single value)
   for (int i = 0; i < 2; i++) {
     string input = node->input(i);
     if (!map_init_values.count(input)) {
@@ -29,10 +24,9 @@ Layer* build_topk_layer(onnx::NodeProto *node,
       parent_shape = parent->output->getShape();
     } else {
       // K
-      k_name = node->input(i);
-     //K = (int)*(map_init_values[input]);
-      printf(" K = %d\n", K);
-      dims = map_init_dims[input];
+      vector<float> k_values = map_init_values[input];
+      if (k_values.empty()) msg("Error: TopK without a value for K", "ONNX::ImportNet");
+      K = (int)k_values[0];
     }
   }
 
@@ -57,6 +51,11 @@ Layer* build_topk_layer(onnx::NodeProto *node,
 
   string name = node->name();
 
+  // Output: the input shape with K elements along the axis (only the "Values" output is produced)
+  vector<int> dims = parent_shape;
+  int dims_axis = axis < 0 ? axis + (int)dims.size() : axis;
+  dims[dims_axis] = K;
+
   return new LTopK(parent, dims, name, dev, mem, axis, largest, sorted, K);
 }
 
@@ -97,7 +97,7 @@ void build_upsample_node(LUpSampling *layer, onnx::GraphProto *graph)
   onnx::AttributeProto *mode_attr = node->add_attribute();
   mode_attr->set_name("mode");
   mode_attr->set_type(onnx::AttributeProto::STRING);
-  mode_attr->set_s("nearest");
+  mode_attr->set_s(layer->interpolation == "bilinear" ? "linear" : "nearest");
 
   // roi input
   onnx::TensorProto *roi = graph->add_initializer();
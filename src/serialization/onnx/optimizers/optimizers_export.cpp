@@ -106,6 +106,72 @@ void prepare_nodeproto_from_rmsprop(onnx::NodeProto *node_opt, RMSProp *optimize
   weight_decay_attr->set_f(optimizer->weight_decay);
 }
 
+void prepare_nodeproto_from_lars(onnx::NodeProto *node_opt, LARS *optimizer) {
+  node_opt->set_name("Optimizer");
+  node_opt->set_op_type("LARS");
+
+  /*
+   * Store optimizer attributes
+   */
+  onnx::AttributeProto *lr_attr = node_opt->add_attribute();
+  lr_attr->set_name("learning_rate");
+  lr_attr->set_type(onnx::AttributeProto::FLOAT);
+  lr_attr->set_f(optimizer->lr);
+
+  onnx::AttributeProto *momentum_attr = node_opt->add_attribute();
+  momentum_attr->set_name("momentum");
+  momentum_attr->set_type(onnx::AttributeProto::FLOAT);
+  momentum_attr->set_f(optimizer->mu);
+
+  onnx::AttributeProto *weight_decay_attr = node_opt->add_attribute();
+  weight_decay_attr->set_name("weight_decay");
+  weight_decay_attr->set_type(onnx::AttributeProto::FLOAT);
+  weight_decay_attr->set_f(optimizer->weight_decay);
+
+  onnx::AttributeProto *eta_attr = node_opt->add_attribute();
+  eta_attr->set_name("eta");
+  eta_attr->set_type(onnx::AttributeProto::FLOAT);
+  eta_attr->set_f(optimizer->eta);
+
+  onnx::AttributeProto *epsilon_attr = node_opt->add_attribute();
+  epsilon_attr->set_name("epsilon");
+  epsilon_attr->set_type(onnx::AttributeProto::FLOAT);
+  epsilon_attr->set_f(optimizer->epsilon);
+}
+
+void prepare_nodeproto_from_lamb(onnx::NodeProto *node_opt, LAMB *optimizer) {
+  node_opt->set_name("Optimizer");
+  node_opt->set_op_type("LAMB");
+
+  /*
+   * Store optimizer attributes
+   */
+  onnx::AttributeProto *lr_attr = node_opt->add_attribute();
+  lr_attr->set_name("learning_rate");
+  lr_attr->set_type(onnx::AttributeProto::FLOAT);
+  lr_attr->set_f(optimizer->lr);
+
+  onnx::AttributeProto *beta_1_attr = node_opt->add_attribute();
+  beta_1_attr->set_name("beta_1");
+  beta_1_attr->set_type(onnx::AttributeProto::FLOAT);
+  beta_1_attr->set_f(optimizer->beta_1);
+
+  onnx::AttributeProto *beta_2_attr = node_opt->add_attribute();
+  beta_2_attr->set_name("beta_2");
+  beta_2_attr->set_type(onnx::AttributeProto::FLOAT);
+  beta_2_attr->set_f(optimizer->beta_2);
+
+  onnx::AttributeProto *epsilon_attr = node_opt->add_attribute();
+  epsilon_attr->set_name("epsilon");
+  epsilon_attr->set_type(onnx::AttributeProto::FLOAT);
+  epsilon_attr->set_f(optimizer->epsilon);
+
+  onnx::AttributeProto *weight_decay_attr = node_opt->add_attribute();
+  weight_decay_attr->set_name("weight_decay");
+  weight_decay_attr->set_type(onnx::AttributeProto::FLOAT);
+  weight_decay_attr->set_f(optimizer->weight_decay);
+}
+
 // Helper functions
 //--------------------------------------------------------------------------------------------
 
@@ -116,6 +182,10 @@ void build_nodeproto_from_optimizer(onnx::NodeProto *node_opt, Optimizer *optimi
     prepare_nodeproto_from_sgd(node_opt, aux_opt);
   else if (RMSProp *aux_opt = dynamic_cast<RMSProp *>(optimizer))
     prepare_nodeproto_from_rmsprop(node_opt, aux_opt);
+  else if (LARS *aux_opt = dynamic_cast<LARS *>(optimizer))
+    prepare_nodeproto_from_lars(node_opt, aux_opt);
+  else if (LAMB *aux_opt = dynamic_cast<LAMB *>(optimizer))
+    prepare_nodeproto_from_lamb(node_opt, aux_opt);
   else
     msg("The optimizer type can't be recognized.", 
         "ONNX::get_optimizer_type_name");
@@ -145,6 +145,98 @@ RMSProp *get_rmsprop_from_nodeproto(onnx::NodeProto *node_opt) {
   return new RMSProp(lr, rho, epsilon, weight_decay);
 }
 
+LARS *get_lars_from_nodeproto(onnx::NodeProto *node_opt) {
+  // initialize the optimizer params and the found check variables
+  //   Note: We require all the params to be in the node
+  float lr; bool lr_found = false;
+  float momentum; bool momentum_found = false;
+  float weight_decay; bool weight_decay_found = false;
+  float eta; bool eta_found = false;
+  float epsilon; bool epsilon_found = false;
+
+  // Collect all the node attributes
+  for (int i = 0; i < node_opt->attribute_size(); i++) {
+    onnx::AttributeProto attribute = node_opt->attribute(i);
+    string attr_name = attribute.name();
+    if (!attr_name.compare("learning_rate")) {
+      lr = attribute.f();
+      lr_found = true;
+    } else if (!attr_name.compare("momentum")) {
+      momentum = attribute.f();
+      momentum_found = true;
+    } else if (!attr_name.compare("weight_decay")) {
+      weight_decay = attribute.f();
+      weight_decay_found = true;
+    } else if (!attr_name.compare("eta")) {
+      eta = attribute.f();
+      eta_found = true;
+    } else if (!attr_name.compare("epsilon")) {
+      epsilon = attribute.f();
+      epsilon_found = true;
+    }
+  }
+
+  // Check that we got all the parameters
+  if (!lr_found)
+    msg("\"learning_rate\" was not found.", "ONNX::get_lars_from_nodeproto");
+  else if (!momentum_found)
+    msg("\"momentum\" was not found.", "ONNX::get_lars_from_nodeproto");
+  else if (!weight_decay_found)
+    msg("\"weight_decay\" was not found.", "ONNX::get_lars_from_nodeproto");
+  else if (!eta_found)
+    msg("\"eta\" was not found.", "ONNX::get_lars_from_nodeproto");
+  else if (!epsilon_found)
+    msg("\"epsilon\" was not found.", "ONNX::get_lars_from_nodeproto");
+
+  return new LARS(lr, momentum, weight_decay, eta, epsilon);
+}
+
+LAMB *get_lamb_from_nodeproto(onnx::NodeProto *node_opt) {
+  // initialize the optimizer params and the found check variables
+  //   Note: We require all the params to be in the node
+  float lr; bool lr_found = false;
+  float beta_1; bool beta_1_found = false;
+  float beta_2; bool beta_2_found = false;
+  float epsilon; bool epsilon_found = false;
+  float weight_decay; bool weight_decay_found = false;
+
+  // Collect all the node attributes
+  for (int i = 0; i < node_opt->attribute_size(); i++) {
+    onnx::AttributeProto attribute = node_opt->attribute(i);
+    string attr_name = attribute.name();
+    if (!attr_name.compare("learning_rate")) {
+      lr = attribute.f();
+      lr_found = true;
+    } else if (!attr_name.compare("beta_1")) {
+      beta_1 = attribute.f();
+      beta_1_found = true;
+    } else if (!attr_name.compare("beta_2")) {
+      beta_2 = attribute.f();
+      beta_2_found = true;
+    } else if (!attr_name.compare("epsilon")) {
+      epsilon = attribute.f();
+      epsilon_found = true;
+    } else if (!attr_name.compare("weight_decay")) {
+      weight_decay = attribute.f();
+      weight_decay_found = true;
+    }
+  }
+
+  // Check that we got all the parameters
+  if (!lr_found)
+    msg("\"learning_rate\" was not found.", "ONNX::get_lamb_from_nodeproto");
+  else if (!beta_1_found)
+    msg("\"beta_1\" was not found.", "ONNX::get_lamb_from_nodeproto");
+  else if (!beta_2_found)
+    msg("\"beta_2\" was not found.", "ONNX::get_lamb_from_nodeproto");
+  else if (!epsilon_found)
+    msg("\"epsilon\" was not found.", "ONNX::get_lamb_from_nodeproto");
+  else if (!weight_decay_found)
+    msg("\"weight_decay\" was not found.", "ONNX::get_lamb_from_nodeproto");
+
+  return new LAMB(lr, beta_1, beta_2, epsilon, weight_decay);
+}
+
 // Helper functions
 //--------------------------------------------------------------------------------------------
 
@@ -164,6 +256,10 @@ Optimizer *build_optimizer_from_node(onnx::NodeProto *node_opt) {
     return get_sgd_from_nodeproto(node_opt);
   else if (!node_type.compare("RMSProp"))
     return get_rmsprop_from_nodeproto(node_opt);
+  else if (!node_type.compare("LARS"))
+    return get_lars_from_nodeproto(node_opt);
+  else if (!node_type.compare("LAMB"))
+    return get_lamb_from_nodeproto(node_opt);
   else {
     msg("The optimizer type \"" + node_type + "\" is not valid",
         "ONNX::build_optimizer_from_node");
@@ -0,0 +1,198 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "eddl/serving/batcher.h"
+#include "eddl/utils.h"
+
+
+InferenceBatcher::InferenceBatcher(Net *net, int max_batch, int max_delay_us, int num_workers, bool pad) :
+        num_requests(0), num_batches(0) {
+    if (net == nullptr || !net->isbuild) msg("The net must be built", "InferenceBatcher");
+    if (max_batch <= 0) msg("max_batch must be > 0", "InferenceBatcher");
+    if (max_delay_us < 0) msg("max_delay_us must be >= 0", "InferenceBatcher");
+    if (num_workers <= 0) msg("num_workers must be > 0", "InferenceBatcher");
+
+    this->net = net;
+    this->max_batch = max_batch;
+    this->max_delay_us = max_delay_us;
+    this->pad = pad;
+    this->stop = false;
+
+    for (auto l : net->lin) {
+        Tensor *t = l->output;
+        sample_sizes.push_back((int)(t->size / t->shape[0]));
+    }
+
+    for (int w = 0; w < num_workers; w++) contexts.push_back(net->create_context());
+    for (int w = 0; w < num_workers; w++) workers.emplace_back(&InferenceBatcher::run, this, w);
+}
+
+InferenceBatcher::~InferenceBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+    cv.notify_all();
+    for (auto &w : workers) w.join();  // Pending requests are served before leaving
+    for (auto c : contexts) delete c;
+}
+
+std::future<vtensor> InferenceBatcher::submit(const vtensor &input) {
+    if (input.size() != sample_sizes.size()) msg("Expected one tensor per input layer", "InferenceBatcher.submit");
+
+    auto *r = new Request();
+    r->inputs.resize(input.size());
+    for (int i = 0; i < input.size(); i++) {
+        if (input[i]->size != sample_sizes[i])
+            msg("Expected a single sample of " + to_string(sample_sizes[i]) + " values in input " + to_string(i) +
+                " but got " + to_string(input[i]->size), "InferenceBatcher.submit");
+
+        r->inputs[i].resize(sample_sizes[i]);
+        if (input[i]->isCPU()) {
+            memcpy(r->inputs[i].data(), input[i]->ptr, sample_sizes[i] * sizeof(float));
+        } else {
+            Tensor *aux = input[i]->clone();
+            aux->toCPU();
+            memcpy(r->inputs[i].data(), aux->ptr, sample_sizes[i] * sizeof(float));
+            delete aux;
+        }
+    }
+
+    std::future<vtensor> result = r->result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (stop) {
+            delete r;
+            msg("The batcher is stopped", "InferenceBatcher.submit");
+        }
+        r->arrival = std::chrono::steady_clock::now();
+        queue.push_back(r);
+    }
+    cv.notify_one();
+    return result;
+}
+
+vtensor InferenceBatcher::predict(const vtensor &input) {
+    return submit(input).get();
+}
+
+float InferenceBatcher::average_batch_size() {
+    uint64_t b = num_batches.load();
+    return b == 0 ? 0.0f : (float)num_requests.load() / (float)b;
+}
+
+void InferenceBatcher::run(int w) {
+    Net *ctx = contexts[w];
+    vtensor batch;    // Staging buffers (only used when the net is not on CPU)
+    vtensor outputs;
+    vector<Request *> requests;
+
+    while (true) {
+        bool more;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]{ return stop || !queue.empty(); });
+            if (queue.empty()) break;  // Stopped and drained
+
+            // Wait for more requests until the batch is full or the oldest request expires
+            auto deadline = queue.front()->arrival + std::chrono::microseconds(max_delay_us);
+            cv.wait_until(lock, deadline, [this]{ return stop || queue.size() >= (size_t)max_batch; });
+            if (queue.empty()) continue;  // Taken by another worker
+
+            int n = std::min((int)queue.size(), max_batch);
+            for (int i = 0; i < n; i++) {
+                requests.push_back(queue.front());
+                queue.pop_front();
+            }
+            more = !queue.empty();
+        }
+        if (more) cv.notify_one();
+
+        process(ctx, batch, outputs, requests);
+        requests.clear();
+    }
+
+    for (auto t : batch) delete t;
+    for (auto t : outputs) delete t;
+}
+
+void InferenceBatcher::process(Net *ctx, vtensor &batch, vtensor &outputs, vector<Request *> &requests) {
+    int n = (int)requests.size();
+    // Padding to powers of two bounds both the wasted rows and the number of different batch sizes (resizes)
+    int bs = n;
+    if (pad) {
+        bs = 1;
+        while (bs < n) bs *= 2;
+        bs = std::min(bs, max_batch);
+    }
+
+    int answered = 0;  // Requests whose promise has been satisfied
+    try {
+        ctx->resize(bs);
+
+        // Gather. With padding, the rows after "n" keep stale samples: their outputs are discarded
+        for (int i = 0; i < ctx->lin.size(); i++) {
+            Tensor *dst = ctx->lin[i]->output;
+            Tensor *buf = dst;
+            if (!dst->isCPU()) {
+                if (batch.size() <= i) batch.push_back(nullptr);
+                if (batch[i] == nullptr || batch[i]->shape[0] != bs) {
+                    delete batch[i];
+                    batch[i] = new Tensor(dst->getShape(), DEV_CPU);
+                }
+                buf = batch[i];
+            }
+            for (int r = 0; r < n; r++)
+                memcpy(buf->ptr + (size_t)r * sample_sizes[i], requests[r]->inputs[i].data(), sample_sizes[i] * sizeof(float));
+            if (buf != dst) Tensor::copy(buf, dst);
+        }
+
+        ctx->forward();
+
+        // Scatter
+        vector<vtensor> results(n);
+        for (int j = 0; j < ctx->lout.size(); j++) {
+            Tensor *out = ctx->lout[j]->output;
+            if (!out->isCPU()) {
+                if (outputs.size() <= j) outputs.push_back(nullptr);
+                if (outputs[j] == nullptr || outputs[j]->shape[0] != bs) {
+                    delete outputs[j];
+                    outputs[j] = new Tensor(out->getShape(), DEV_CPU);
+                }
+                Tensor::copy(out, outputs[j]);
+                out = outputs[j];
+            }
+
+            vector<int> shape = out->getShape();
+            shape[0] = 1;
+            int osize = (int)(out->size / out->shape[0]);
+            for (int r = 0; r < n; r++) {
+                auto *t = new Tensor(shape, DEV_CPU);
+                memcpy(t->ptr, out->ptr + (size_t)r * osize, osize * sizeof(float));
+                results[r].push_back(t);
+            }
+        }
+
+        for (; answered < n; answered++) requests[answered]->result.set_value(results[answered]);
+    } catch (...) {
+        // Only the requests that have not been answered yet
+        for (int r = answered; r < n; r++) {
+            try {
+                requests[r]->result.set_exception(std::current_exception());
+            } catch (std::future_error &) {}  // set_value() failed after satisfying it
+        }
+    }
+
+    for (auto r : requests) delete r;
+    num_requests += n;
+    num_batches++;
+}
@@ -0,0 +1,298 @@
+/*
+* EDDL Library - European Distributed Deep Learning Library.
+* Version: 1.1
+* copyright (c) 2022, Universitat Politècnica de València (UPV), PRHLT Research Centre
+* Date: March 2022
+* Author: PRHLT Research Centre, UPV, (rparedes@prhlt.upv.es), (jon@prhlt.upv.es)
+* All rights reserved
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "eddl/serving/server.h"
+#include "eddl/utils.h"
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+
+#if !defined(_WIN32)
+
+static bool read_all(int fd, void *data, size_t size) {
+    char *p = (char *)data;
+    while (size > 0) {
+        ssize_t r = recv(fd, p, size, 0);
+        if (r <= 0) return false;  // Closed or error
+        p += r;
+        size -= r;
+    }
+    return true;
+}
+
+// Reads and drops "size" bytes without allocating them (the size comes from the client)
+static bool discard_all(int fd, size_t size) {
+    char buffer[65536];
+    while (size > 0) {
+        size_t n = std::min(size, sizeof(buffer));
+        if (!read_all(fd, buffer, n)) return false;
+        size -= n;
+    }
+    return true;
+}
+
+static bool write_all(int fd, const void *data, size_t size) {
+    const char *p = (const char *)data;
+    while (size > 0) {
+        ssize_t r = send(fd, p, size, MSG_NOSIGNAL);
+        if (r <= 0) return false;
+        p += r;
+        size -= r;
+    }
+    return true;
+}
+
+static int unix_socket(const string &path, struct sockaddr_un &addr) {
+    if (path.size() >= sizeof(addr.sun_path)) msg("Socket path too long: " + path, "InferenceServer");
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) msg("Could not create the socket", "InferenceServer");
+    return fd;
+}
+
+
+// Server ******************************************
+
+InferenceServer::InferenceServer(InferenceBatcher *batcher, const string &path, int max_connections) : running(false) {
+    if (max_connections < 1) msg("max_connections must be at least 1", "InferenceServer");
+    this->batcher = batcher;
+    this->path = path;
+    this->max_connections = max_connections;
+
+    struct sockaddr_un addr;
+    socket_fd = unix_socket(path, addr);
+    unlink(path.c_str());
+    if (bind(socket_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(socket_fd, 128) < 0) {
+        close(socket_fd);
+        msg("Could not listen on " + path, "InferenceServer");
+    }
+
+    running = true;
+    acceptor_thread = std::thread(&InferenceServer::acceptor, this);
+}
+
+InferenceServer::~InferenceServer() {
+    stop();
+}
+
+void InferenceServer::stop() {
+    if (!running.exchange(false)) return;
+
+    // Unblock the acceptor (waiting for a free connection or in accept()) and the pending recv() calls
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        connection_done.notify_all();
+    }
+    shutdown(socket_fd, SHUT_RDWR);
+    close(socket_fd);
+    acceptor_thread.join();  // No new connections from now on
+    {
+        // Only open fds are in the list, a connection removes its fd before closing it
+        std::lock_guard<std::mutex> lock(mtx);
+        for (int fd : connection_fds) shutdown(fd, SHUT_RDWR);
+    }
+    for (auto &t : connection_threads) t.join();
+    connection_threads.clear();
+    finished_threads.clear();
+    unlink(path.c_str());
+}
+
+void InferenceServer::acceptor() {
+    while (running) {
+        {
+            // At the limit, the next connection stays in the listen backlog until one of them closes
+            std::unique_lock<std::mutex> lock(mtx);
+            connection_done.wait(lock, [this]{ return !running || connection_fds.size() < (size_t)max_connections; });
+            join_finished();
+        }
+        if (!running) break;
+
+        int fd = accept(socket_fd, nullptr, nullptr);
+        if (fd < 0) {
+            // Out of descriptors or memory: wait for some connection to finish instead of spinning
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;  // Stopped (the loop condition ends it) or interrupted
+        }
+        if (!running) {
+            close(fd);
+            break;
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        connection_fds.push_back(fd);
+        connection_threads.emplace_back(&InferenceServer::serve, this, fd);
+    }
+}
+
+// Under mtx. A finished thread does not take mtx again, so joining it here does not block on the lock
+void InferenceServer::join_finished() {
+    for (auto id : finished_threads) {
+        auto it = std::find_if(connection_threads.begin(), connection_threads.end(),
+                               [id](const std::thread &t){ return t.get_id() == id; });
+        it->join();
+        connection_threads.erase(it);
+    }
+    finished_threads.clear();
+}
+
+void InferenceServer::serve(int fd) {
+    vector<Tensor *> input;
+    for (int i = 0; i < batcher->num_inputs(); i++) input.push_back(new Tensor({batcher->sample_size(i)}, DEV_CPU));
+
+    while (running) {
+        uint32_t ninputs;
+        if (!read_all(fd, &ninputs, sizeof(ninputs))) break;
+
+        // Read the whole request even if it is wrong, so the connection stays in sync
+        string error;
+        for (uint32_t i = 0; i < ninputs; i++) {
+            uint32_t size;
+            if (!read_all(fd, &size, sizeof(size))) { error = "closed"; break; }
+            if (i < input.size() && size == (uint32_t)batcher->sample_size(i)) {
+                if (!read_all(fd, input[i]->ptr, size * sizeof(float))) { error = "closed"; break; }
+            } else {
+                if (!discard_all(fd, (size_t)size * sizeof(float))) { error = "closed"; break; }
+                if (error.empty()) error = "Wrong size of input " + to_string(i);
+            }
+        }
+        if (error == "closed") break;
+        if (error.empty() && ninputs != input.size()) error = "Expected " + to_string(input.size()) + " inputs";
+
+        vtensor output;
+        if (error.empty()) {
+            try {
+                output = batcher->predict(input);
+            } catch (std::exception &e) {
+                error = e.what();
+            }
+        }
+
+        bool ok;
+        if (error.empty()) {
+            uint32_t header[2] = {SERVER_OK, (uint32_t)output.size()};
+            ok = write_all(fd, header, sizeof(header));
+            for (auto t : output) {
+                uint32_t ndim = t->ndim;
+                vector<int32_t> shape(t->shape.begin(), t->shape.end());
+                ok = ok && write_all(fd, &ndim, sizeof(ndim));
+                ok = ok && write_all(fd, shape.data(), ndim * sizeof(int32_t));
+                ok = ok && write_all(fd, t->ptr, t->size * sizeof(float));
+                delete t;
+            }
+        } else {
+            uint32_t header[2] = {SERVER_ERROR, (uint32_t)error.size()};
+            ok = write_all(fd, header, sizeof(header)) && write_all(fd, error.data(), error.size());
+        }
+        if (!ok) break;
+    }
+
+    for (auto t : input) delete t;
+
+    // Last access to the server: the acceptor (or stop()) joins the thread from now on
+    std::lock_guard<std::mutex> lock(mtx);
+    connection_fds.erase(std::find(connection_fds.begin(), connection_fds.end(), fd));
+    close(fd);
+    finished_threads.push_back(std::this_thread::get_id());
+    connection_done.notify_all();
+}
+
+
+// Client ******************************************
+
+InferenceClient::InferenceClient(const string &path) {
+    struct sockaddr_un addr;
+    socket_fd = unix_socket(path, addr);
+    if (connect(socket_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(socket_fd);
+        msg("Could not connect to " + path, "InferenceClient");
+    }
+}
+
+InferenceClient::~InferenceClient() {
+    close(socket_fd);
+}
+
+vtensor InferenceClient::predict(const vtensor &input) {
+    bool ok = true;
+    uint32_t ninputs = input.size();
+    ok = ok && write_all(socket_fd, &ninputs, sizeof(ninputs));
+    for (auto t : input) {
+        Tensor *aux = t->isCPU() ? t : t->clone();
+        if (aux != t) aux->toCPU();
+        uint32_t size = aux->size;
+        ok = ok && write_all(socket_fd, &size, sizeof(size));
+        ok = ok && write_all(socket_fd, aux->ptr, size * sizeof(float));
+        if (aux != t) delete aux;
+    }
+
+    uint32_t header[2];
+    ok = ok && read_all(socket_fd, header, sizeof(header));
+    if (!ok) msg("Connection lost", "InferenceClient.predict");
+
+    if (header[0] != SERVER_OK) {
+        string error(header[1], ' ');
+        read_all(socket_fd, &error[0], header[1]);
+        msg("Server error: " + error, "InferenceClient.predict");
+    }
+
+    vtensor output;
+    for (uint32_t j = 0; j < header[1]; j++) {
+        uint32_t ndim;
+        ok = ok && read_all(socket_fd, &ndim, sizeof(ndim));
+        vector<int32_t> shape(ok ? ndim : 0);
+        ok = ok && read_all(socket_fd, shape.data(), ndim * sizeof(int32_t));
+        if (!ok) break;
+
+        auto *t = new Tensor(vector<int>(shape.begin(), shape.end()), DEV_CPU);
+        output.push_back(t);
+        ok = read_all(socket_fd, t->ptr, t->size * sizeof(float));
+    }
+    if (!ok) {
+        for (auto t : output) delete t;
+        msg("Connection lost", "InferenceClient.predict");
+    }
+    return output;
+}
+
+#else
+
+InferenceServer::InferenceServer(InferenceBatcher *batcher, const string &path, int max_connections) : running(false) {
+    msg("Unix domain sockets are not supported on this platform", "InferenceServer");
+}
+InferenceServer::~InferenceServer() {}
+void InferenceServer::stop() {}
+void InferenceServer::acceptor() {}
+void InferenceServer::serve(int fd) {}
+void InferenceServer::join_finished() {}
+
+InferenceClient::InferenceClient(const string &path) {
+    msg("Unix domain sockets are not supported on this platform", "InferenceClient");
+}
+InferenceClient::~InferenceClient() {}
+vtensor InferenceClient::predict(const vtensor &input) { return {}; }
+
+#endif
@@ -350,7 +350,7 @@ namespace tensorNN {
 
 
         if (A->isCPU()) {
-            cpu_sigmoid(A, B);
+            cpu_sigmoid_nn(A, B);
         }
 #ifdef cGPU
         else if (A->isGPU())
@@ -434,7 +434,7 @@ namespace tensorNN {
 
 
         if (A->isCPU()) {
-            cpu_exp(A, B);
+            cpu_exp_nn(A, B);
         }
 #ifdef cGPU
         else if (A->isGPU())
@@ -475,7 +475,7 @@ namespace tensorNN {
 
 
         if (A->isCPU()) {
-            cpu_tanh(A, B);
+            cpu_tanh_nn(A, B);
         }
 #ifdef cGPU
         else if (A->isGPU())
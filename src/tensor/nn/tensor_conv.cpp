@@ -46,8 +46,6 @@ void Conv2D(ConvolDescriptor *D) {
         }
 
     if (D->I->isCPU()) {
-        if (is_dilated)
-            msg("Dilated convolutions are only supported using GPU with CUDNN." "Tensor::Conv2D");
         cpu_conv2D(D);
     }
 #ifdef cGPU
@@ -55,7 +53,7 @@ void Conv2D(ConvolDescriptor *D) {
       {
 #ifndef cCUDNN
         if (is_dilated)
-            msg("Dilated convolutions are only supported using GPU with CUDNN." "Tensor::Conv2D");
+            msg("Dilated convolutions are only supported on CPU and using GPU with CUDNN.", "Tensor::Conv2D");
 #endif
          //gpu_conv2D_old(D);
          gpu_conv2D(D);
@@ -133,8 +131,6 @@ void Conv3D(ConvolDescriptor3D *D) {
         }
 
     if (D->I->isCPU()) {
-        if (is_dilated)
-            msg("Dilated convolutions are only supported using GPU with CUDNN." "Tensor::Conv3D");
         cpu_conv3D(D);
     }
 #ifdef cGPU
@@ -142,7 +138,7 @@ void Conv3D(ConvolDescriptor3D *D) {
     {
 #ifndef cCUDNN
         if (is_dilated)
-            msg("Dilated convolutions are only supported using GPU with CUDNN." "Tensor::Conv3D");
+            msg("Dilated convolutions are only supported on CPU and using GPU with CUDNN.", "Tensor::Conv3D");
 #endif
         gpu_conv3D(D);
     }
@@ -216,7 +212,7 @@ void Conv3D_back(ConvolDescriptor3D *D) {
 
 
         if (D->I->isCPU()) {
-            msg("NotImplementedError", "Tensor::ConvT2D");
+            cpu_convT2D(D);
         }
 #ifdef cGPU
         else if (D->I->isGPU())
@@ -240,7 +236,7 @@ void Conv3D_back(ConvolDescriptor3D *D) {
 
 
         if (D->I->isCPU()) {
-            msg("NotImplementedError", "Tensor::ConvT2D");
+            cpu_convT2D_grad(D);
         }
 #ifdef cGPU
         else if (D->I->isGPU())
@@ -264,7 +260,7 @@ void Conv3D_back(ConvolDescriptor3D *D) {
 
 
         if (D->I->isCPU()) {
-            msg("NotImplementedError", "Tensor::ConvT2D");
+            cpu_convT2D_back(D);
         }
 #ifdef cGPU
         else if (D->I->isGPU())
@@ -25,6 +25,8 @@
 
 PROFILING_ENABLE_EXTERN(repeat_nn);
 PROFILING_ENABLE_EXTERN(d_repeat_nn);
+PROFILING_ENABLE_EXTERN(upsampling2D);
+PROFILING_ENABLE_EXTERN(d_upsampling2D);
 PROFILING_ENABLE_EXTERN(select);
 PROFILING_ENABLE_EXTERN(select_back);
 PROFILING_ENABLE_EXTERN(set_select);
@@ -76,6 +78,47 @@ namespace tensorNN {
     }
 
 
+    // UpSampling2D: nearest (repeats the rows and columns by size[0] and size[1]) or bilinear (half-pixel)
+    void upsampling2D(Tensor *A, Tensor *B, vector<int> size, bool bilinear) {
+        if ((A->device != B->device)) msg("Tensors in different devices", "Tensor::UpSampling2D");
+        if (A->ndim != 4 || B->ndim != 4) msg("Tensors are not 4D", "Tensor::UpSampling2D");
+        for (int i = 2; i < 4; i++) {
+            if (A->shape[i] * size[i - 2] != B->shape[i]) {
+                msg("Incompatible dimensions (size)", "Tensor::UpSampling2D");
+            }
+        }
+
+        PROFILING_HEADER(upsampling2D);
+
+        if (A->isCPU() && B->isCPU()) {
+            cpu_upsampling2D(A, B, size, bilinear);
+        }
+#ifdef cGPU
+        else if (A->isGPU() && B->isGPU()) {
+            if (bilinear) msg("Bilinear upsampling is only available on CPU", "Tensor::UpSampling2D");
+            gpu_repeat_nn(A, B, size);
+        }
+#endif
+        PROFILING_FOOTER(upsampling2D);
+    }
+
+    void d_upsampling2D(Tensor *D, Tensor *A, vector<int> size, bool bilinear) {
+        if ((D->device != A->device)) msg("Tensors in different devices", "Tensor::D_UpSampling2D");
+
+        PROFILING_HEADER(d_upsampling2D);
+
+        if (D->isCPU() && A->isCPU()) {
+            cpu_d_upsampling2D(D, A, size, bilinear);
+        }
+#ifdef cGPU
+        else if (D->isGPU() && A->isGPU()) {
+            if (bilinear) msg("Bilinear upsampling is only available on CPU", "Tensor::D_UpSampling2D");
+            gpu_d_repeat_nn(D, A, size);
+        }
+#endif
+        PROFILING_FOOTER(d_upsampling2D);
+    }
+
     void select(Tensor *A, Tensor* B, SelDescriptor *sd){
 
         PROFILING_HEADER(select);
@@ -220,12 +263,11 @@ namespace tensorNN {
     void topK(Tensor *A, Tensor *B, int axis, int largest, int sorted, int K) {
 
             if (A->isCPU() && B->isCPU()) {
-              cpu_topK(A, B, axis, largest, sorted, K);
+              Tensor::topk(A, B, nullptr, K, axis, largest, sorted);  // Checks the shapes
             }
 #ifdef cGPU
             else if (A->isGPU() && B->isGPU()) {
-              printf("topK not supported for GPU\n");
-              exit(1);
+              msg("topK not supported for GPU", "TensorNN::topK");
             }
 #endif
     }
@@ -84,6 +84,21 @@ namespace tensorNN {
 #endif
     }
 
+    float softmax_cross_entropy(Tensor* y_true, Tensor* logits, Tensor* y_pred, Tensor* delta){
+        if (!Tensor::sameDevice(y_true, y_pred) || !Tensor::sameDevice(y_true, logits) || (delta != nullptr && !Tensor::sameDevice(y_true, delta))) {
+            msg("Tensors in different devices", "TensorNN::softmax_cross_entropy");
+        }
+        if (!Tensor::sameShape(y_true, y_pred) || !Tensor::sameShape(y_true, logits) || (delta != nullptr && !Tensor::sameShape(y_true, delta))) {
+            msg("Incompatible dims", "TensorNN::softmax_cross_entropy");
+        }
+
+        if (y_true->isCPU()) {
+            return cpu_softmax_cross_entropy(y_true, logits, y_pred, delta);
+        }
+        msg("Only implemented for CPU tensors", "TensorNN::softmax_cross_entropy");
+        return std::nanf("");
+    }
+
     float binary_cross_entropy(Tensor* y_true, Tensor* y_pred){
         if (!Tensor::sameDevice(y_true, y_pred)) {
             msg("Tensors in different devices", "TensorNN::binary_cross_entropy");
@@ -9,10 +9,12 @@
 
 #include <iostream>
 #include <iomanip>
+#include <new>
 #include <stdexcept>
 
 #include "eddl/tensor/tensor.h"
 #include "eddl/utils.h"
+#include "eddl/hardware/cpu/cpu_numa.h"
 
 #ifdef cGPU
 #include "eddl/hardware/gpu/gpu_tensor.h"
@@ -173,6 +175,7 @@ void Tensor::updateData(float *fptr, void *fptr2, bool setshared){
         if (fptr==nullptr) {
             if (false == was_shared && this->ptr != nullptr) eddl_free(this->ptr);
             this->ptr = get_fmem(this->size,"Tensor::updateData");
+            cpu_numa_first_touch(this->ptr, this->size);
         } else {
             this->ptr = fptr; isshared=setshared;
         };
@@ -202,6 +205,7 @@ void Tensor::updateData(float *fptr, void *fptr2, bool setshared){
         else { this->ptr = fptr; isshared=setshared;}
     }
 #endif
+    this->capacity = isshared ? 0 : this->size;
 }
 
 void Tensor::toCPU(int dev){
@@ -249,6 +253,7 @@ void Tensor::toGPU(int dev){
         }
 
         this->ptr = gpu_ptr;
+        this->capacity = isshared ? 0 : this->size;
         gpu_copy_to_gpu(cpu_ptr, this);
         eddl_free(cpu_ptr); // because currently memory for tensor data is allocated by means of posix_memalign()
         if (/*this->ndim == 2 &&*/ this->ptr2 != nullptr){
@@ -499,6 +504,16 @@ void Tensor::resize(int b, float *fptr, void *fptr2, bool delete_data) {
     updateShape(new_shape);
     updateSize();
     updateStrides();
+
+    // Keep the current allocation if the new batch fits in it (only the metadata changes)
+    if (fptr == nullptr && !isshared && ptr != nullptr && size <= capacity && (isCPU() || isGPU())) {
+        if (this->ptr2 != nullptr) {
+            // Rebuild the Eigen map in place (Map is trivially destructible)
+            new (this->ptr2) Eigen::Map<Eigen::MatrixXf>(this->ptr, this->shape[1], this->shape[0]);
+        }
+        return;
+    }
+
     if (!isshared && delete_data) deleteData();  // Potential error on layers such as Reshape (passed pointer)
     updateData(fptr, fptr2);
 }
@@ -409,6 +409,45 @@ void Tensor::argsort(Tensor* A, Tensor* B, bool descending, bool stable){
 #endif
 }
 
+void Tensor::topk(Tensor* A, Tensor* values, Tensor* indices, int k, int axis, bool largest, bool sorted){
+    if (axis < 0) axis += A->ndim;
+    if (axis < 0 || axis >= A->ndim) {
+        msg("Invalid axis (" + to_string(axis) + ")", "Tensor::topk");
+    }
+    if (k <= 0 || k > A->shape[axis]) {
+        msg("'k' must be in [1, " + to_string(A->shape[axis]) + "] (" + to_string(k) + ")", "Tensor::topk");
+    }
+
+    vector<int> shape = A->shape;
+    shape[axis] = k;
+    for (auto t : {values, indices}) {
+        if (t == nullptr) continue;
+        if (t->shape != shape) {
+            msg("The output tensors must have the shape of the input with 'k' elements along the axis", "Tensor::topk");
+        }
+        if (t->device != A->device) {
+            msg("The output tensors and the input one must be on the same device", "Tensor::topk");
+        }
+    }
+
+    if (A->isCPU()){
+        cpu_topk(A, values, indices, axis, k, largest, sorted);
+    }
+    else {
+        msg("Only implemented for CPU tensors", "Tensor::topk");
+    }
+}
+
+void Tensor::sort(Tensor* A, Tensor* values, Tensor* indices, int axis, bool descending){
+    if (axis < 0) axis += A->ndim;
+    if (axis < 0 || axis >= A->ndim) {
+        msg("Invalid axis (" + to_string(axis) + ")", "Tensor::sort");
+    }
+
+    // A full top-k: ties are resolved by position, as in a stable sort
+    Tensor::topk(A, values, indices, A->shape[axis], axis, descending, true);
+}
+
 Tensor* Tensor::concat(const vector<Tensor*> A, unsigned int axis, Tensor* output){
     // Check number of vectors to concat
     if(A.size()<2){
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "eddl/distributed/eddl_parameter_server.h"
+
+
+using namespace eddl;
+
+
+// Pushes of ps_encode, decoded by ps_accumulate into zeros
+static std::vector<float> ps_round_trip(std::vector<float> &values, uint32_t codec){
+    std::vector<unsigned char> buffer(ps_encoded_size(values.size(), codec));
+    ps_encode(values.data(), values.size(), codec, buffer.data());
+
+    std::vector<float> decoded(values.size(), 0.0f);
+    ps_accumulate(buffer.data(), values.size(), codec, 1.0f, decoded.data());
+    return decoded;
+}
+
+static std::vector<float> ps_random_values(size_t count, float stddev){
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> dist(0.0f, stddev);
+    std::vector<float> values(count);
+    for (auto &v : values) v = dist(rng);
+    return values;
+}
+
+
+TEST(DistributedTestSuite, ps_encoded_size){
+    ASSERT_EQ(ps_encoded_size(1000, PS_FLOAT32), 1000 * sizeof(float));
+    ASSERT_EQ(ps_encoded_size(ps_block, PS_INT8), sizeof(float) + ps_block);
+    ASSERT_EQ(ps_encoded_size(2 * ps_block + 37, PS_INT8), 3 * sizeof(float) + 2 * ps_block + 37);
+    ASSERT_EQ(ps_encoded_size(0, PS_INT8), (size_t)0);
+    ASSERT_THROW(ps_encoded_size(10, 0x7f), std::runtime_error);
+}
+
+TEST(DistributedTestSuite, ps_float32_round_trip){
+    std::vector<float> values = ps_random_values(1000, 1.0f);
+    std::vector<float> original = values;
+
+    std::vector<float> decoded = ps_round_trip(values, PS_FLOAT32);
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(decoded[i], original[i]);
+        ASSERT_EQ(values[i], 0.0f);  // Nothing left for the next push
+    }
+}
+
+TEST(DistributedTestSuite, ps_int8_error_feedback){
+    // Two full blocks and a tail of 37 values, much smaller than the rest
+    const size_t count = 2 * ps_block + 37;
+    std::vector<float> values = ps_random_values(count, 1.0f);
+    for (size_t i = 2 * ps_block; i < count; i++) values[i] *= 1e-3f;
+    std::vector<float> original = values;
+
+    std::vector<float> decoded = ps_round_trip(values, PS_INT8);
+    for (size_t b = 0; b < 3; b++) {
+        size_t first = b * ps_block, last = std::min(first + ps_block, count);
+        float max_abs = 0.0f;
+        for (size_t i = first; i < last; i++) max_abs = std::max(max_abs, std::fabs(original[i]));
+
+        // The residual is the exact quantization error, at most half a step of the scale of its own block
+        for (size_t i = first; i < last; i++) {
+            ASSERT_EQ(values[i], original[i] - decoded[i]) << "value " << i;
+            ASSERT_LE(std::fabs(values[i]), 0.5f * max_abs / 127.0f * (1.0f + 1e-5f)) << "value " << i;
+        }
+    }
+
+    // The residual goes into the next push: over both, the decoded sum stays within the last error
+    std::vector<float> next = values;
+    std::vector<float> decoded_next = ps_round_trip(next, PS_INT8);
+    for (size_t i = 0; i < count; i++)
+        ASSERT_NEAR(decoded[i] + decoded_next[i] + next[i], original[i], 1e-5f) << "value " << i;
+}
+
+TEST(DistributedTestSuite, ps_int8_zero_block){
+    // A block of zeros between two non-zero ones, and a zero tail
+    const size_t count = 3 * ps_block + 5;
+    std::vector<float> values = ps_random_values(count, 1.0f);
+    for (size_t i = ps_block; i < 2 * ps_block; i++) values[i] = 0.0f;
+    for (size_t i = 3 * ps_block; i < count; i++) values[i] = 0.0f;
+
+    std::vector<float> decoded = ps_round_trip(values, PS_INT8);
+    for (size_t i = ps_block; i < 2 * ps_block; i++) {
+        ASSERT_EQ(decoded[i], 0.0f);
+        ASSERT_EQ(values[i], 0.0f);
+    }
+    for (size_t i = 3 * ps_block; i < count; i++) {
+        ASSERT_EQ(decoded[i], 0.0f);
+        ASSERT_EQ(values[i], 0.0f);
+    }
+    for (size_t i = 0; i < ps_block; i++) ASSERT_TRUE(std::isfinite(decoded[i]));
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "eddl/distributed/eddl_queue.h"
+#include "eddl/distributed/eddl_packet.h"
+
+
+using namespace eddl;
+
+
+// Messages without data, tagged with the producer (source addr) and a sequence number (target addr)
+static eddl_message * queue_message(uint32_t type, uint32_t producer, uint32_t seq){
+    return new eddl_message(type, producer, seq, 0, 0, nullptr);
+}
+
+static bool queue_is_ack(eddl_message * m){
+    return m->get_type() == eddl_message_types::MSG_ACK_WEIGHTS;
+}
+
+
+TEST(DistributedTestSuite, ring_wraparound_full_empty){
+    ASSERT_THROW(eddl_ring<int> bad(6), std::runtime_error);
+
+    eddl_ring<int> ring(4);
+    int v = -1;
+    ASSERT_FALSE(ring.try_pop(v));
+    ASSERT_FALSE(ring.peek(v));
+    ASSERT_TRUE(ring.empty());
+
+    // Many laps, so the positions wrap around the cells
+    int next = 0, expected = 0;
+    for (int lap = 0; lap < 50; lap++) {
+        int n = 1 + lap % 4;
+        for (int i = 0; i < n; i++) ASSERT_TRUE(ring.try_push(next++));
+        if (n == 4) ASSERT_FALSE(ring.try_push(-1));  // Full
+        ASSERT_TRUE(ring.peek(v));
+        ASSERT_EQ(v, expected);
+        for (int i = 0; i < n; i++) {
+            ASSERT_TRUE(ring.try_pop(v));
+            ASSERT_EQ(v, expected++);
+        }
+        ASSERT_FALSE(ring.try_pop(v));  // Empty
+        ASSERT_TRUE(ring.empty());
+    }
+}
+
+TEST(DistributedTestSuite, queue_overflow_keeps_the_order){
+    // Rings of 4 (normal) and 2 (priority) values, most messages go through the overflow
+    eddl_queue queue(4);
+    eddl_message * m = nullptr;
+    ASSERT_FALSE(queue.try_pop(m));
+
+    uint32_t pushed = 0, popped = 0, acks_pushed = 0, acks_popped = 0;
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 13; i++) queue.push(queue_message(eddl_message_types::DATA_SAMPLES, 0, pushed++));
+        for (int i = 0; i < 5; i++) queue.push(queue_message(eddl_message_types::MSG_ACK_WEIGHTS, 0, acks_pushed++));
+        ASSERT_EQ(queue.size(), (pushed - popped) + (acks_pushed - acks_popped));
+
+        // The acknowledgements first, then the data, every lane in order
+        for (int i = 0; i < 9; i++) {
+            eddl_message * next = queue.front();
+            m = queue.pop();
+            ASSERT_EQ(m, next);
+            if (acks_popped < acks_pushed) {
+                ASSERT_TRUE(queue_is_ack(m));
+                ASSERT_EQ(m->get_target_addr(), acks_popped++);
+            } else {
+                ASSERT_FALSE(queue_is_ack(m));
+                ASSERT_EQ(m->get_target_addr(), popped++);
+            }
+            delete m;
+        }
+    }
+    while (queue.try_pop(m)) {
+        ASSERT_EQ(m->get_target_addr(), queue_is_ack(m) ? acks_popped++ : popped++);
+        delete m;
+    }
+    ASSERT_EQ(popped, pushed);
+    ASSERT_EQ(acks_popped, acks_pushed);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(DistributedTestSuite, queue_stop_commands_stay_behind_the_data){
+    eddl_queue queue(8);
+    queue.push(queue_message(eddl_message_types::DATA_WEIGHTS, 0, 0));
+    queue.push(eddl_message::stop_command(0));
+    queue.push(queue_message(eddl_message_types::DATA_WEIGHTS, 0, 1));
+    queue.push(eddl_message::shutdown_command(0));
+    queue.push(eddl_message::start_command(0));
+    queue.push(queue_message(eddl_message_types::MSG_ACK_WEIGHTS, 0, 0));
+
+    // START and the acknowledgement overtake the data, STOP and SHUTDOWN do not
+    std::vector<uint32_t> types, commands;
+    eddl_message * m = nullptr;
+    while (queue.try_pop(m)) {
+        types.push_back(m->get_type());
+        commands.push_back(m->get_type() == eddl_message_types::COMMAND ? m->get_command() : 0);
+        delete m;
+    }
+    std::vector<uint32_t> expected_types = {eddl_message_types::COMMAND, eddl_message_types::MSG_ACK_WEIGHTS,
+                                            eddl_message_types::DATA_WEIGHTS, eddl_message_types::COMMAND,
+                                            eddl_message_types::DATA_WEIGHTS, eddl_message_types::COMMAND};
+    std::vector<uint32_t> expected_commands = {eddl_command_types::START, 0, 0, eddl_command_types::STOP,
+                                               0, eddl_command_types::SHUTDOWN};
+    ASSERT_EQ(types, expected_types);
+    ASSERT_EQ(commands, expected_commands);
+}
+
+TEST(DistributedTestSuite, queue_producers_keep_their_order){
+    // Small rings, so the producers go back and forth between the rings and the overflow queues
+    const int producers = 4, n = 20000;
+    eddl_queue queue(8);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+        threads.emplace_back([&queue, p, n]() {
+            for (int i = 0; i < n; i++) {
+                uint32_t type = (i % 7 == 0) ? eddl_message_types::MSG_ACK_WEIGHTS : eddl_message_types::DATA_GRADIENTS;
+                queue.push(queue_message(type, p, i));
+                if (i % 1000 == 0) std::this_thread::yield();
+            }
+        });
+
+    // A single consumer sees the order of every producer in every lane
+    std::vector<int64_t> last_data(producers, -1), last_ack(producers, -1);
+    bool in_order = true;
+    for (int i = 0; i < producers * n; i++) {
+        eddl_message * popped = queue.pop();
+        int64_t &last = queue_is_ack(popped) ? last_ack[popped->get_source_addr()] : last_data[popped->get_source_addr()];
+        if ((int64_t) popped->get_target_addr() <= last) in_order = false;
+        last = popped->get_target_addr();
+        delete popped;
+    }
+    for (auto &t : threads) t.join();
+    ASSERT_TRUE(in_order);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(DistributedTestSuite, queue_consumers_get_every_message_once){
+    const int producers = 3, consumers = 3, n = 10000;
+    eddl_queue queue(16);
+
+    std::vector<std::vector<uint32_t>> received(consumers);
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; c++)
+        threads.emplace_back([&queue, &received, c]() {
+            for (;;) {
+                eddl_message * m = queue.pop();
+                if (m == nullptr) break;  // One nullptr per consumer ends the test
+                received[c].push_back(m->get_source_addr() * n + m->get_target_addr());
+                delete m;
+            }
+        });
+    std::vector<std::thread> pushers;
+    for (int p = 0; p < producers; p++)
+        pushers.emplace_back([&queue, p, n]() {
+            for (int i = 0; i < n; i++)
+                queue.push(queue_message((i % 3) ? eddl_message_types::DATA_SAMPLES : eddl_message_types::PKG_ACK, p, i));
+        });
+    for (auto &t : pushers) t.join();
+    while (! queue.empty()) std::this_thread::yield();
+    for (int c = 0; c < consumers; c++) queue.push(nullptr);
+    for (auto &t : threads) t.join();
+
+    std::set<uint32_t> all;
+    size_t total = 0;
+    for (auto &r : received) {
+        all.insert(r.begin(), r.end());
+        total += r.size();
+    }
+    ASSERT_EQ(total, (size_t) producers * n);
+    ASSERT_EQ(all.size(), (size_t) producers * n);
+}
+
+TEST(DistributedTestSuite, packet_pool_reuses_the_blocks){
+    std::string id(eddl_msg_id_len, '0');
+
+    // Taking as many packets as the pool can keep empties it, and releasing them fills it with their blocks
+    std::vector<eddl_packet *> packets;
+    std::set<void *> blocks;
+    for (size_t i = 0; i < eddl_packet_pool_size + 16; i++) {
+        packets.push_back(new eddl_packet(eddl_message_types::COMMAND, 0, 0, id, i, 1, eddl_command_types::START));
+        blocks.insert(packets.back());
+    }
+    ASSERT_EQ(blocks.size(), packets.size());
+    for (auto p : packets) delete p;  // The last 16 do not fit and go back to the heap
+
+    // The next packets come from the pool, from threads at the same time
+    const int threads_count = 4;
+    std::vector<std::vector<eddl_packet *>> taken(threads_count);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threads_count; t++)
+        threads.emplace_back([&taken, &id, t]() {
+            for (size_t i = 0; i < eddl_packet_pool_size / threads_count; i++)
+                taken[t].push_back(new eddl_packet(eddl_message_types::COMMAND, 0, 0, id, i, 1, eddl_command_types::STOP));
+        });
+    for (auto &t : threads) t.join();
+
+    std::set<void *> reused;
+    for (auto &v : taken)
+        for (auto p : v) {
+            ASSERT_EQ(p->get_command(), (uint32_t) eddl_command_types::STOP);
+            ASSERT_EQ(blocks.count(p), (size_t) 1);
+            reused.insert(p);
+        }
+    ASSERT_EQ(reused.size(), (size_t) eddl_packet_pool_size);
+    for (auto &v : taken)
+        for (auto p : v) delete p;
+}
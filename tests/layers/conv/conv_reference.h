@@ -0,0 +1,142 @@
+#ifndef EDDL_TESTS_CONV_REFERENCE_H
+#define EDDL_TESTS_CONV_REFERENCE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/descriptors/descriptors.h"
+
+// Direct (naive) references of the convolution kernels, shared by the conv tests: forward, gradient of
+// the kernels and delta of the input, computed with the descriptor tensors (I, K, bias, D)
+
+
+// Grouped and dilated 2D convolution (without bias)
+inline void conv2d_reference(ConvolDescriptor *cd, Tensor *O, Tensor *gK, Tensor *ID){
+    int ng = cd->nk / cd->groups;
+    O->fill_(0.0f); gK->fill_(0.0f); ID->fill_(0.0f);
+    for(int b=0; b<cd->I->shape[0]; b++)
+    for(int o=0; o<cd->nk; o++)
+    for(int y=0; y<cd->r; y++)
+    for(int x=0; x<cd->c; x++)
+    for(int kz=0; kz<cd->kz; kz++)
+    for(int ki=0; ki<cd->kr; ki++)
+    for(int kj=0; kj<cd->kc; kj++){
+        int ch = (o / ng) * cd->kz + kz;
+        int iy = y*cd->sr + ki*cd->dilation_rate[0] - cd->padrt;
+        int ix = x*cd->sc + kj*cd->dilation_rate[1] - cd->padcl;
+        if (iy < 0 || iy >= cd->ir || ix < 0 || ix >= cd->ic) continue;
+        int pi = ((b*cd->iz + ch)*cd->ir + iy)*cd->ic + ix;
+        int pk = ((o*cd->kz + kz)*cd->kr + ki)*cd->kc + kj;
+        int po = ((b*cd->nk + o)*cd->r + y)*cd->c + x;
+        O->ptr[po] += cd->K->ptr[pk] * cd->I->ptr[pi];
+        gK->ptr[pk] += cd->D->ptr[po] * cd->I->ptr[pi];
+        ID->ptr[pi] += cd->D->ptr[po] * cd->K->ptr[pk];
+    }
+}
+
+// 3D convolution with bias
+inline void conv3d_reference(ConvolDescriptor3D *cd, Tensor *O, Tensor *gK, Tensor *gbias, Tensor *ID){
+    O->fill_(0.0f); gK->fill_(0.0f); gbias->fill_(0.0f); ID->fill_(0.0f);
+    for(int b=0; b<cd->I->shape[0]; b++)
+    for(int o=0; o<cd->nk; o++)
+    for(int k=0; k<cd->d; k++)
+    for(int y=0; y<cd->r; y++)
+    for(int x=0; x<cd->c; x++){
+        int po = (((b*cd->nk + o)*cd->d + k)*cd->r + y)*cd->c + x;
+        O->ptr[po] += cd->bias->ptr[o];
+        gbias->ptr[o] += cd->D->ptr[po];
+        for(int ch=0; ch<cd->kz; ch++)
+        for(int kd=0; kd<cd->kd; kd++)
+        for(int ki=0; ki<cd->kr; ki++)
+        for(int kj=0; kj<cd->kc; kj++){
+            int iz = k*cd->sd + kd*cd->dilation_rate[0] - cd->paddf;
+            int iy = y*cd->sr + ki*cd->dilation_rate[1] - cd->padrt;
+            int ix = x*cd->sc + kj*cd->dilation_rate[2] - cd->padcl;
+            if (iz < 0 || iz >= cd->id || iy < 0 || iy >= cd->ir || ix < 0 || ix >= cd->ic) continue;
+            int pi = (((b*cd->iz + ch)*cd->id + iz)*cd->ir + iy)*cd->ic + ix;
+            int pk = (((o*cd->kz + ch)*cd->kd + kd)*cd->kr + ki)*cd->kc + kj;
+            O->ptr[po] += cd->K->ptr[pk] * cd->I->ptr[pi];
+            gK->ptr[pk] += cd->D->ptr[po] * cd->I->ptr[pi];
+            ID->ptr[pi] += cd->D->ptr[po] * cd->K->ptr[pk];
+        }
+    }
+}
+
+// Transposed 2D convolution with bias, kernels (in_channels, filters/groups, kr, kc): every input pixel
+// scatters its kernel window over the output
+inline void convT2d_reference(ConvolDescriptorT2D *cd, Tensor *O, Tensor *gK, Tensor *ID){
+    int ipg = cd->iz / cd->groups;
+    O->fill_(0.0f); gK->fill_(0.0f); ID->fill_(0.0f);
+    for(int b=0; b<cd->I->shape[0]; b++)
+    for(int ci=0; ci<cd->iz; ci++)
+    for(int i=0; i<cd->ir; i++)
+    for(int j=0; j<cd->ic; j++)
+    for(int ol=0; ol<cd->kz; ol++)
+    for(int ki=0; ki<cd->kr; ki++)
+    for(int kj=0; kj<cd->kc; kj++){
+        int o = (ci / ipg) * cd->kz + ol;
+        int y = i*cd->sr + ki - cd->padrt;
+        int x = j*cd->sc + kj - cd->padcl;
+        if (y < 0 || y >= cd->r || x < 0 || x >= cd->c) continue;
+        int pi = ((b*cd->iz + ci)*cd->ir + i)*cd->ic + j;
+        int pk = ((ci*cd->kz + ol)*cd->kr + ki)*cd->kc + kj;
+        int po = ((b*cd->z + o)*cd->r + y)*cd->c + x;
+        O->ptr[po] += cd->K->ptr[pk] * cd->I->ptr[pi];
+        gK->ptr[pk] += cd->D->ptr[po] * cd->I->ptr[pi];
+        ID->ptr[pi] += cd->D->ptr[po] * cd->K->ptr[pk];
+    }
+    for(int p=0; p<O->size; p++) O->ptr[p] += cd->bias->ptr[(p / (cd->r*cd->c)) % cd->z];
+}
+
+// Nearest and half-pixel bilinear upsampling, per output pixel
+inline float upsampling2d_source(int o, int in, int scale, int &i0, int &i1){
+    float src = ((float)o + 0.5f) / (float)scale - 0.5f;
+    if (src < 0.0f) src = 0.0f;
+    i0 = std::min((int)src, in - 1);
+    i1 = std::min(i0 + 1, in - 1);
+    return src - (float)i0;
+}
+
+inline void upsampling2d_reference(Tensor *A, Tensor *B, const vector<int> &size, bool bilinear){
+    int ar = A->shape[2], ac = A->shape[3], br = B->shape[2], bc = B->shape[3];
+    for(int p=0; p<A->shape[0]*A->shape[1]; p++)
+    for(int y=0; y<br; y++)
+    for(int x=0; x<bc; x++){
+        const float *a = A->ptr + p*ar*ac;
+        float v;
+        if (bilinear) {
+            int y0, y1, x0, x1;
+            float wy = upsampling2d_source(y, ar, size[0], y0, y1);
+            float wx = upsampling2d_source(x, ac, size[1], x0, x1);
+            v = (1-wy)*((1-wx)*a[y0*ac+x0] + wx*a[y0*ac+x1]) + wy*((1-wx)*a[y1*ac+x0] + wx*a[y1*ac+x1]);
+        } else {
+            v = a[(y/size[0])*ac + x/size[1]];
+        }
+        B->ptr[(p*br + y)*bc + x] = v;
+    }
+}
+
+
+// Random kernels and bias, zeroed gradients, a random output delta and a zeroed input delta. The
+// parameters built by the descriptor are filled in place
+template <typename Descriptor>
+inline void conv_reference_init(Descriptor *cd){
+    cd->K->fill_rand_normal_(0.0f, 1.0f);
+    cd->bias->fill_rand_normal_(0.0f, 1.0f);
+    cd->gK->fill_(0.0f);
+    cd->gbias->fill_(0.0f);
+    cd->ID = Tensor::zeros(cd->I->getShape());
+    cd->D = Tensor::randu(cd->O->getShape());
+}
+
+// Deletes the descriptor and what its layer would own (output, parameters, gradients and deltas). The
+// descriptor goes first: its destructor reads O
+template <typename Descriptor>
+inline void conv_reference_free(Descriptor *cd){
+    Tensor *owned[] = {cd->O, cd->K, cd->bias, cd->gK, cd->gbias, cd->ID, cd->D};
+    delete cd;
+    for (Tensor *t : owned) delete t;
+}
+
+#endif //EDDL_TESTS_CONV_REFERENCE_H
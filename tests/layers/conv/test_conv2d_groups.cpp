@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/descriptors/descriptors.h"
+
+#include "conv_reference.h"
+
+
+static void check_conv2d(int channels, int filters, int groups, const vector<int> &kernel, const vector<int> &strides,
+                         const string &padding, const vector<int> &dilation, int mem){
+    Tensor* t_image = Tensor::randu({2, channels, 9, 8});
+
+    auto *cd = new ConvolDescriptor(filters, kernel, strides, padding, {}, groups, dilation, false, mem);
+    cd->build(t_image);
+    conv_reference_init(cd);
+
+    Tensor *O = cd->O->clone(), *gK = cd->gK->clone(), *ID = cd->ID->clone();
+    conv2d_reference(cd, O, gK, ID);
+
+    tensorNN::Conv2D(cd);
+    tensorNN::Conv2D_grad(cd);
+    tensorNN::Conv2D_back(cd);
+
+    ASSERT_TRUE((bool) Tensor::equivalent(O, cd->O, 1e-4f, 1e-4f, true, true));
+    ASSERT_TRUE((bool) Tensor::equivalent(gK, cd->gK, 1e-4f, 1e-4f, true, true));
+    ASSERT_TRUE((bool) Tensor::equivalent(ID, cd->ID, 1e-4f, 1e-4f, true, true));
+
+    delete O; delete gK; delete ID;
+    conv_reference_free(cd);
+    delete t_image;
+}
+
+TEST(Conv2DTestSuite, conv2d_grouped){
+    for(int mem : {0, 2}) {
+        check_conv2d(4, 6, 2, {3, 3}, {1, 1}, "same", {1, 1}, mem);
+        check_conv2d(6, 3, 3, {3, 2}, {2, 2}, "valid", {1, 1}, mem);
+    }
+}
+
+TEST(Conv2DTestSuite, conv2d_depthwise){
+    for(int mem : {0, 2}) {
+        check_conv2d(3, 3, 3, {3, 3}, {1, 1}, "same", {1, 1}, mem);
+        check_conv2d(3, 6, 3, {5, 3}, {2, 1}, "same", {1, 1}, mem);  // Depth multiplier 2
+        check_conv2d(4, 4, 4, {3, 3}, {2, 2}, "valid", {2, 2}, mem);
+    }
+}
+
+TEST(Conv2DTestSuite, conv2d_dilated){
+    for(int mem : {0, 2}) {
+        check_conv2d(3, 2, 1, {3, 3}, {1, 1}, "same", {2, 2}, mem);
+        check_conv2d(3, 2, 1, {3, 2}, {2, 1}, "valid", {2, 3}, mem);
+        check_conv2d(4, 4, 2, {3, 3}, {1, 1}, "same", {1, 2}, mem);
+    }
+}
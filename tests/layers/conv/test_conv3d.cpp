@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/descriptors/descriptors.h"
+#include "eddl/hardware/cpu/cpu_parallel.h"
+
+#include "conv_reference.h"
+
+
+static void check_conv3d(const vector<int> &shape, int filters, const vector<int> &kernel, const vector<int> &strides,
+                         const string &padding, const vector<int> &dilation, int mem){
+    Tensor* t_image = Tensor::randu(shape);
+
+    auto *cd = new ConvolDescriptor3D(filters, kernel, strides, padding, {}, dilation, true, mem);
+    cd->build(t_image);
+    conv_reference_init(cd);
+
+    Tensor *O = cd->O->clone(), *gK = cd->gK->clone(), *gbias = cd->gbias->clone(), *ID = cd->ID->clone();
+    conv3d_reference(cd, O, gK, gbias, ID);
+
+    tensorNN::Conv3D(cd);
+    tensorNN::Conv3D_grad(cd);
+    tensorNN::Conv3D_back(cd);
+
+    ASSERT_TRUE((bool) Tensor::equivalent(O, cd->O, 1e-3f, 1e-4f, true, true));
+    ASSERT_TRUE((bool) Tensor::equivalent(gK, cd->gK, 1e-3f, 1e-4f, true, true));
+    ASSERT_TRUE((bool) Tensor::equivalent(gbias, cd->gbias, 1e-3f, 1e-4f, true, true));
+    ASSERT_TRUE((bool) Tensor::equivalent(ID, cd->ID, 1e-3f, 1e-4f, true, true));
+
+    delete O; delete gK; delete gbias; delete ID;
+    conv_reference_free(cd);
+    delete t_image;
+}
+
+TEST(Conv3DTestSuite, conv3d_tiled_and_direct){
+    for(int mem : {0, 2}) {
+        check_conv3d({2, 3, 6, 7, 5}, 4, {3, 3, 3}, {1, 1, 1}, "same", {1, 1, 1}, mem);
+        check_conv3d({1, 2, 9, 8, 8}, 3, {3, 2, 3}, {2, 2, 1}, "valid", {1, 1, 1}, mem);
+        check_conv3d({2, 2, 8, 8, 8}, 2, {3, 3, 3}, {1, 1, 1}, "same", {2, 1, 2}, mem);
+    }
+}
+
+TEST(Conv3DTestSuite, conv3d_tiled_large_volume){
+    // Several tiles per sample. The backward splits the input channels of a sample among the threads, so
+    // the team is enlarged (on a single core too) and the work is well above the grain: 7 channels in 4
+    // blocks of 2, 2, 2 and 1
+    int threads = cpu_set_threads(4);
+    ASSERT_EQ(cpu_threads(12L * 24 * 24 * (7 * 27) * 4, CPU_COST_CHEAP), 4);
+    check_conv3d({1, 7, 12, 24, 24}, 4, {3, 3, 3}, {1, 1, 1}, "same", {1, 1, 1}, 0);
+    cpu_set_threads(threads);
+}
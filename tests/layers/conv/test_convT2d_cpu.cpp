@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+#include "eddl/descriptors/descriptors.h"
+
+#include "conv_reference.h"
+
+
+static void check_convT2d(int channels, int filters, int groups, const vector<int> &kernel, const vector<int> &strides,
+                          const string &padding){
+    Tensor* t_image = Tensor::randu({2, channels, 5, 6});
+
+    auto *cd = new ConvolDescriptorT2D(filters, kernel, strides, padding, {}, groups, {1, 1}, true);
+    cd->build(t_image);
+    ASSERT_EQ(cd->O->shape[1], filters);
+    conv_reference_init(cd);
+
+    Tensor *O = cd->O->clone(), *gK = cd->gK->clone(), *ID = cd->ID->clone();
+    convT2d_reference(cd, O, gK, ID);
+
+    tensorNN::ConvT2D(cd);
+    tensorNN::ConvT2D_grad(cd);
+    tensorNN::ConvT2D_back(cd);
+
+    ASSERT_TRUE((bool) Tensor::equivalent(O, cd->O, 1e-4f, 1e-4f, true, true));
+    ASSERT_TRUE((bool) Tensor::equivalent(gK, cd->gK, 1e-4f, 1e-4f, true, true));
+    ASSERT_TRUE((bool) Tensor::equivalent(ID, cd->ID, 1e-4f, 1e-4f, true, true));
+    ASSERT_NEAR(cd->gbias->sum(), cd->D->sum(), 1e-2f);
+
+    delete O; delete gK; delete ID;
+    conv_reference_free(cd);
+    delete t_image;
+}
+
+TEST(ConvT2DTestSuite, convt2d_cpu_strided){
+    check_convT2d(3, 2, 1, {3, 3}, {1, 1}, "same");
+    check_convT2d(3, 4, 1, {3, 3}, {2, 2}, "same");
+    check_convT2d(2, 3, 1, {4, 4}, {2, 2}, "valid");
+    check_convT2d(2, 2, 1, {2, 3}, {3, 2}, "none");  // Kernel smaller than the stride: phases without taps
+}
+
+TEST(ConvT2DTestSuite, convt2d_cpu_grouped){
+    check_convT2d(4, 6, 2, {3, 3}, {2, 2}, "same");
+    check_convT2d(3, 3, 3, {5, 3}, {1, 2}, "valid");
+}
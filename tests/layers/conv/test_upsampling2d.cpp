@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "eddl/tensor/tensor.h"
+#include "eddl/tensor/nn/tensor_nn.h"
+
+#include "conv_reference.h"
+
+
+static void check_upsampling2d(const vector<int> &size, bool bilinear){
+    Tensor *A = Tensor::randu({2, 3, 5, 4});
+    Tensor *B = Tensor::zeros({2, 3, 5*size[0], 4*size[1]});
+    Tensor *B_ref = B->clone();
+
+    upsampling2d_reference(A, B_ref, size, bilinear);
+    tensorNN::upsampling2D(A, B, size, bilinear);
+    ASSERT_TRUE((bool) Tensor::equivalent(B, B_ref, 1e-5f, 1e-5f, true, true));
+
+    // The backward is the adjoint of the forward: <up(A), D> = <A, up^T(D)>
+    Tensor *D = Tensor::randu(B->getShape());
+    Tensor *gA = Tensor::zeros(A->getShape());
+    tensorNN::d_upsampling2D(D, gA, size, bilinear);
+    Tensor *BD = Tensor::mult(B, D), *AgA = Tensor::mult(A, gA);
+    ASSERT_NEAR(BD->sum(), AgA->sum(), 1e-3f);
+    ASSERT_NEAR(gA->sum(), D->sum(), 1e-3f);  // Every output pixel is a convex combination
+
+    delete A; delete B; delete B_ref; delete D; delete gA; delete BD; delete AgA;
+}
+
+TEST(UpSampling2DTestSuite, upsampling2d_nearest){
+    check_upsampling2d({2, 2}, false);
+    check_upsampling2d({3, 1}, false);
+}
+
+TEST(UpSampling2DTestSuite, upsampling2d_bilinear){
+    check_upsampling2d({2, 2}, true);
+    check_upsampling2d({1, 3}, true);
+    check_upsampling2d({4, 2}, true);
+}
@@ -155,3 +155,70 @@ TEST(NetTestSuite, losses_binary_cross_entropy){
 #endif
 
 }
+
+
+TEST(NetTestSuite, losses_softmax_cross_entropy_fused){
+    // Fused kernel vs. softmax + categorical cross-entropy + their derivatives
+    Tensor* logits = Tensor::randn({8, 5});
+    logits->mult_(3.0f);
+    Tensor* y_pred = Tensor::empty_like(logits);
+    tensorNN::FullSoftmax(logits, y_pred, 1);
+    Tensor* y_true = Tensor::zeros({8, 5});
+    for(int i=0; i<8; i++){ y_true->ptr[i * 5 + (i % 5)] = 1.0f; }
+
+    auto loss = LCategoricalCrossEntropy();
+    Tensor* d_pred = Tensor::zeros_like(y_true);
+    loss.delta(y_true, y_pred, d_pred);
+    Tensor* d_ref = Tensor::zeros_like(y_true);
+    tensorNN::D_FullSoftmax(d_pred, y_pred, d_ref, 1);
+
+    Tensor* d_fused = Tensor::zeros_like(y_true);
+    float value = tensorNN::softmax_cross_entropy(y_true, logits, y_pred, d_fused);
+    ASSERT_NEAR(value, loss.value(y_true, y_pred), 1e-3f);
+    ASSERT_NEAR(value, tensorNN::softmax_cross_entropy(y_true, logits, y_pred, nullptr), 1e-6f);
+    ASSERT_TRUE(Tensor::equivalent(d_fused, d_ref, 1e-4f, 1e-4f));
+
+    // Saturated rows: no "eps" bound on the loss
+    Tensor* big = new Tensor({100.0f, 0.0f, 0.0f}, {1, 3});
+    Tensor* p_big = Tensor::empty_like(big);
+    tensorNN::FullSoftmax(big, p_big, 1);
+    Tensor* t_big = new Tensor({0.0f, 1.0f, 0.0f}, {1, 3});
+    ASSERT_NEAR(tensorNN::softmax_cross_entropy(t_big, big, p_big, nullptr), 100.0f, 1e-3f);
+
+    delete big; delete p_big; delete t_big;
+    delete logits; delete y_pred; delete y_true;
+    delete d_pred; delete d_ref; delete d_fused;
+}
+
+
+TEST(NetTestSuite, losses_softmax_cross_entropy_fused_stale_delta){
+    // The loss of a batch is computed (delta included) but there is no backward: the delta of
+    // the next batch must not be taken from it
+    layer in = Input({4});
+    layer out = Softmax(Dense(in, 3));
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+    build(net, sgd(0.01), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(1), true);
+
+    Tensor* x1 = Tensor::randn({6, 4});
+    Tensor* x2 = Tensor::randn({6, 4});
+    x2->mult_(5.0f);
+    Tensor* y = Tensor::zeros({6, 3});
+    for(int i=0; i<6; i++){ y->ptr[i * 3 + (i % 3)] = 1.0f; }
+
+    Net* sn = net->snets[0];
+    net->setmode(TRMODE);
+    net->forward({x1});
+    sn->lout[0]->check_target();
+    Tensor::copy(y, sn->lout[0]->target);
+    net->compute_loss();
+
+    net->forward({x2});
+    net->delta();
+    Tensor* d_ref = Tensor::zeros_like(y);
+    tensorNN::softmax_cross_entropy(sn->lout[0]->target, sn->lout[0]->input, sn->lout[0]->output, d_ref);
+    ASSERT_TRUE(Tensor::equivalent(sn->lout[0]->delta, d_ref, 1e-6f, 1e-6f));
+
+    delete d_ref; delete x1; delete x2; delete y;
+    delete net;
+}
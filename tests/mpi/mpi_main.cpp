@@ -0,0 +1,16 @@
+#include <gtest/gtest.h>
+
+#include "eddl/mpi_distributed/mpi_distributed.h"
+
+// Run with several processes, e.g. mpirun -np 4 --oversubscribe mpi_unit_tests (see tests/CMakeLists.txt).
+// Every process runs the same tests in the same order, so the collectives match
+
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    init_distributed("MPI");
+    int result = RUN_ALL_TESTS();
+    end_distributed();
+    return result;
+}
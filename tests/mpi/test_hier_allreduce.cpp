@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <mpi.h>
+#include <vector>
+
+#include "eddl/mpi_distributed/mpi_distributed.h"
+
+// The hierarchical reduction (with "nodes" of ranks_per_node processes) against a flat MPI_Allreduce. The
+// values are small multiples of 1/4, so both sums are exact whatever the order
+static void check_hier_allreduce(int ranks_per_node, size_t count) {
+    int id, n_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &id);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_procs);
+
+    std::vector<float> x(count), ref(count);
+    for (size_t i = 0; i < count; i++) x[i] = 0.25f * (float)((i * 7 + id * 13) % 64) - 3.0f;
+    MPI_Allreduce(x.data(), ref.data(), (int)count, MPI_FLOAT, MPI_SUM, MPI_COMM_WORLD);
+
+    set_hierarchical_distributed(1, ranks_per_node);
+    fn_mpi_hier_AllReduce(x.data(), count);
+    set_hierarchical_distributed(0);
+
+    for (size_t i = 0; i < count; i++) ASSERT_EQ(x[i], ref[i]) << "element " << i << " of " << count;
+}
+
+TEST(MPITestSuite, hier_allreduce_matches_flat){
+    for (int ranks_per_node : {0, 2, 1}) {  // Whole machine, pairs (cross-node step), flat fallback
+        check_hier_allreduce(ranks_per_node, 1);
+        check_hier_allreduce(ranks_per_node, 7);  // Fewer elements than ranks in some slices
+        check_hier_allreduce(ranks_per_node, 100003);  // Uneven slices, several blocks
+    }
+    // A larger buffer after a smaller one grows the shared window
+    check_hier_allreduce(2, 1 << 20);
+}
+
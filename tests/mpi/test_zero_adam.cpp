@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <mpi.h>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/mpi_distributed/mpi_distributed.h"
+
+
+using namespace eddl;
+
+
+// Over 2^20 params: the chunk of every process takes several buckets, the last one shorter
+static model zero_mlp(){
+    layer in = Input({1024});
+    layer l = ReLu(Dense(in, 1100));
+    layer out = Dense(l, 4);
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+
+    build(net, adam(0.01), {"mse"}, {"mse"}, CS_CPU(), true);
+    return net;
+}
+
+// Every process trains on the same batches, so the sharded Adam must follow the plain one
+TEST(MPITestSuite, zero_adam_matches_adam){
+    model zero = zero_mlp();
+    model ref = zero_mlp();
+    for (int i = 0; i < zero->layers.size(); i++)
+        for (int j = 0; j < zero->layers[i]->params.size(); j++) {
+            Tensor *p = zero->layers[i]->params[j];
+            MPI_Bcast(p->ptr, p->size, MPI_FLOAT, 0, MPI_COMM_WORLD);
+            Tensor::copy(p, ref->layers[i]->params[j]);
+        }
+    set_zero_distributed(zero, 1);
+
+    Tensor* x = Tensor::randn({8, 1024});
+    Tensor* y = Tensor::randn({8, 4});
+    MPI_Bcast(x->ptr, x->size, MPI_FLOAT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(y->ptr, y->size, MPI_FLOAT, 0, MPI_COMM_WORLD);
+    for (int i = 0; i < 3; i++) {
+        zero->train_batch({x}, {y}, {0, 1, 2, 3, 4, 5, 6, 7});
+        ref->train_batch({x}, {y}, {0, 1, 2, 3, 4, 5, 6, 7});
+    }
+    ASSERT_TRUE(Net::compare_params(zero, ref));
+
+    // Back to the full moments, gathered from the chunks
+    set_zero_distributed(zero, 0);
+    auto *opt1 = (Adam*)zero->optimizer;
+    auto *opt2 = (Adam*)ref->optimizer;
+    for (int i = 0; i < opt1->mT.size(); i++) {
+        ASSERT_TRUE(Tensor::equivalent(opt1->mT[i], opt2->mT[i], 1e-6f, 1e-4f));
+        ASSERT_TRUE(Tensor::equivalent(opt1->vT[i], opt2->vT[i], 1e-6f, 1e-4f));
+    }
+
+    delete x;
+    delete y;
+    delete zero;
+    delete ref;
+}
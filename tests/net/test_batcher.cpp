@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/serving/batcher.h"
+#include "eddl/serving/server.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+
+static model batcher_mlp(){
+    layer in = Input({10});
+    layer l = ReLu(BatchNormalization(Dense(in, 16)));
+    layer out = Softmax(Dense(l, 3));
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+    build(net, sgd(0.01), {"categorical_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(), true);
+    return net;
+}
+
+
+TEST(NetTestSuite, batcher_coalesces_requests){
+    model net = batcher_mlp();
+
+    const int n = 12;
+    Tensor *x = Tensor::randn({n, 10});
+    Tensor *expected = predict(net, {x})[0];
+
+    // Long deadline: requests are only released when the batch is full (or at shutdown)
+    auto *batcher = new InferenceBatcher(net, 4, 1000000, 2);
+    vector<std::future<vtensor>> futures(n);
+    vector<std::thread> clients;
+    for (int i = 0; i < n; i++) {
+        clients.emplace_back([&, i](){
+            Tensor *sample = x->select({to_string(i), ":"});
+            futures[i] = batcher->submit({sample});
+            delete sample;
+        });
+    }
+    for (auto &c : clients) c.join();
+
+    for (int i = 0; i < n; i++) {
+        vtensor out = futures[i].get();
+        ASSERT_EQ(out.size(), 1);
+        ASSERT_EQ(out[0]->shape, vector<int>({1, 3}));
+        for (int j = 0; j < 3; j++) ASSERT_NEAR(out[0]->ptr[j], expected->ptr[i * 3 + j], 1e-5f);
+        delete out[0];
+    }
+    ASSERT_EQ(batcher->num_requests.load(), n);
+    ASSERT_EQ(batcher->num_batches.load(), n / 4);
+
+    // Wrong sample size
+    Tensor *wrong = Tensor::zeros({1, 7});
+    ASSERT_THROW(batcher->submit({wrong}), std::runtime_error);
+
+    delete batcher;
+    delete wrong;
+    delete expected;
+    delete x;
+    delete net;
+}
+
+
+TEST(NetTestSuite, batcher_unix_socket){
+    string path = "test_batcher.sock";
+    model net = batcher_mlp();
+
+    Tensor *x = Tensor::randn({1, 10});
+    Tensor *expected = predict(net, {x})[0];
+
+    auto *batcher = new InferenceBatcher(net, 8, 100);
+    auto *server = new InferenceServer(batcher, path);
+    {
+        InferenceClient client(path);
+        for (int k = 0; k < 3; k++) {
+            vtensor out = client.predict({x});
+            ASSERT_EQ(out.size(), 1);
+            ASSERT_TRUE(Tensor::equivalent(out[0], expected, 1e-5f));
+            delete out[0];
+        }
+
+        // Errors are reported without closing the connection
+        Tensor *wrong = Tensor::zeros({1, 7});
+        ASSERT_THROW(client.predict({wrong}), std::runtime_error);
+        vtensor out = client.predict({x});
+        delete out[0];
+        delete wrong;
+
+        // Oversized inputs are drained in chunks, the connection stays in sync
+        Tensor *large = Tensor::zeros({1, 100000});
+        ASSERT_THROW(client.predict({large}), std::runtime_error);
+        out = client.predict({x});
+        delete out[0];
+        delete large;
+    }
+
+    // Short-lived connections finish on their own (the acceptor joins their threads)
+    for (int k = 0; k < 8; k++) {
+        InferenceClient client(path);
+        vtensor out = client.predict({x});
+        delete out[0];
+    }
+    InferenceClient idle(path);  // Still open: stop() must shut it down
+
+    delete server;
+    delete batcher;
+    delete expected;
+    delete x;
+    delete net;
+}
+
+TEST(NetTestSuite, batcher_unix_socket_max_connections){
+    string path = "test_batcher_max.sock";
+    model net = batcher_mlp();
+    Tensor *x = Tensor::randn({1, 10});
+
+    auto *batcher = new InferenceBatcher(net, 8, 100);
+    auto *server = new InferenceServer(batcher, path, 2);
+    auto *first = new InferenceClient(path);
+    InferenceClient second(path);
+    delete first->predict({x})[0];
+    delete second.predict({x})[0];
+
+    // A third connection waits in the backlog until one of the first two closes
+    std::atomic<bool> served(false);
+    std::thread third([&]() {
+        InferenceClient client(path);
+        delete client.predict({x})[0];
+        served = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    bool served_early = served;
+    delete first;
+    third.join();
+    ASSERT_FALSE(served_early);
+    ASSERT_TRUE(served);
+
+    delete server;
+    delete batcher;
+    delete x;
+    delete net;
+}
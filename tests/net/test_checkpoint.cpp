@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+
+static model checkpoint_mlp(){
+    layer in = Input({16});
+    layer l = in;
+    l = ReLu(BatchNormalization(Dense(l, 32)));
+    layer out = Softmax(Dense(l, 4));
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+
+    build(net, adam(0.01), {"categorical_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(), true);
+    return net;
+}
+
+
+TEST(NetTestSuite, checkpoint_save_load){
+    string fname = "test_checkpoint.ckpt";
+
+    model net1 = checkpoint_mlp();
+    model net2 = checkpoint_mlp();
+
+    // Train a few batches to have non-trivial params and optimizer state
+    Tensor* x = Tensor::randn({8, 16});
+    Tensor* y = Tensor::zeros({8, 4});
+    for (int i = 0; i < 8; i++) y->ptr[i * 4 + (i % 4)] = 1.0f;
+    for (int i = 0; i < 3; i++) net1->train_batch({x}, {y}, {0, 1, 2, 3, 4, 5, 6, 7});
+
+    save_checkpoint(net1, fname, true);
+    net1->wait_checkpoint();
+    load_checkpoint(net2, fname);
+
+    ASSERT_TRUE(Net::compare_params(net1, net2));
+    auto *opt1 = (Adam*)net1->optimizer;
+    auto *opt2 = (Adam*)net2->optimizer;
+    ASSERT_EQ(opt1->t, opt2->t);
+    for (int i = 0; i < opt1->mT.size(); i++) {
+        ASSERT_TRUE(Tensor::equivalent(opt1->mT[i], opt2->mT[i]));
+        ASSERT_TRUE(Tensor::equivalent(opt1->vT[i], opt2->vT[i]));
+    }
+
+    // Both nets must evolve identically after restoring the optimizer state
+    net1->train_batch({x}, {y}, {0, 1, 2, 3, 4, 5, 6, 7});
+    net2->train_batch({x}, {y}, {0, 1, 2, 3, 4, 5, 6, 7});
+    ASSERT_TRUE(Net::compare_params(net1, net2));
+
+    std::remove(fname.c_str());
+    delete x;
+    delete y;
+    delete net1;
+    delete net2;
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+
+TEST(NetTestSuite, context_concurrent_predict){
+    layer in = Input({3, 8, 8});
+    layer l = in;
+    l = ReLu(BatchNormalization(Conv2D(l, 4, {3, 3})));
+    l = MaxPool2D(l, {2, 2});
+    l = Reshape(l, {-1});
+    layer out = Softmax(Dense(l, 5));
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+    build(net, sgd(0.01), {"categorical_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(), true);
+
+    const int nthreads = 4;
+    vector<Tensor*> x;
+    vector<Tensor*> expected;
+    for (int i = 0; i < nthreads; i++) {
+        x.push_back(Tensor::randn({2 + i, 3, 8, 8}));
+        expected.push_back(predict(net, {x[i]})[0]);
+    }
+
+    vector<model> contexts;
+    for (int i = 0; i < nthreads; i++) contexts.push_back(create_context(net));
+
+    // Parameters are shared, activations are not
+    for (int i = 0; i < net->layers.size(); i++) {
+        Layer *orig = net->layers[i];
+        Layer *shared = contexts[0]->getLayer(orig->name);
+        ASSERT_NE(shared, nullptr);
+        ASSERT_EQ(shared->params.size(), orig->params.size());
+        for (int j = 0; j < orig->params.size(); j++) ASSERT_EQ(shared->params[j], orig->params[j]);
+        ASSERT_NE(shared->output, orig->output);
+    }
+
+    vector<Tensor*> results(nthreads, nullptr);
+    vector<std::thread> workers;
+    for (int i = 0; i < nthreads; i++) {
+        workers.emplace_back([&, i](){
+            for (int k = 0; k < 3; k++) {
+                if (results[i] != nullptr) delete results[i];
+                results[i] = predict(contexts[i], {x[i]})[0];
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+
+    for (int i = 0; i < nthreads; i++) {
+        ASSERT_TRUE(Tensor::equivalent(results[i], expected[i], 1e-5f));
+        delete results[i];
+        delete expected[i];
+        delete x[i];
+    }
+
+    for (auto c : contexts) delete c;
+    delete net;
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <vector>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/data/dataloader.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+
+TEST(NetTestSuite, dataloader_epochs_and_stages){
+    const int n = 50;
+    Tensor *x = Tensor::zeros({n, 2, 3});
+    Tensor *y = Tensor::zeros({n, 1});
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 6; j++) x->ptr[i * 6 + j] = (float)i;
+        y->ptr[i] = (float)i;
+    }
+
+    TensorDataSource source({x}, {y});
+    DataLoader loader(&source, 8, true, 3, 2);
+    loader.add_stage([](const vtensor &bx, const vtensor &by){ bx[0]->add_(1000.0f); });
+    ASSERT_EQ(loader.num_batches(), n / 8);
+
+    for (int epoch = 0; epoch < 3; epoch++) {
+        vector<int> seen(n, 0);
+        vtensor bx, by;
+        int batches = 0;
+        while (loader.next(bx, by)) {
+            ASSERT_EQ(bx[0]->shape, vector<int>({8, 2, 3}));
+            for (int k = 0; k < 8; k++) {
+                int s = (int)by[0]->ptr[k];
+                seen[s]++;
+                for (int j = 0; j < 6; j++) ASSERT_EQ(bx[0]->ptr[k * 6 + j], s + 1000.0f);
+            }
+            batches++;
+        }
+        ASSERT_EQ(batches, n / 8);
+        int total = 0;
+        for (int c : seen) {
+            ASSERT_LE(c, 1);  // Without replacement
+            total += c;
+        }
+        ASSERT_EQ(total, (n / 8) * 8);
+    }
+
+    delete x;
+    delete y;
+}
+
+
+TEST(NetTestSuite, dataloader_tail_batch_and_seed){
+    const int n = 20;
+    Tensor *x = Tensor::zeros({n, 1});
+    Tensor *y = Tensor::zeros({n, 1});
+    for (int i = 0; i < n; i++) x->ptr[i] = y->ptr[i] = (float)i;
+    TensorDataSource source({x}, {y});
+
+    // Dropped by default
+    {
+        DataLoader loader(&source, 8);
+        ASSERT_EQ(loader.num_batches(), 2);
+        ASSERT_EQ(loader.dropped_samples(), 4);
+    }
+
+    // Kept: every sample is seen once per epoch, the last batch has the remaining 4
+    DataLoader a(&source, 8, true, 2, 2, false, 7);
+    DataLoader b(&source, 8, true, 1, 3, false, 7);
+    ASSERT_EQ(a.num_batches(), 3);
+    ASSERT_EQ(a.dropped_samples(), 0);
+    for (int epoch = 0; epoch < 2; epoch++) {
+        vector<int> seen(n, 0);
+        vtensor ax, ay, bx, by;
+        vector<int> rows;
+        while (a.next(ax, ay)) {
+            ASSERT_TRUE(b.next(bx, by));
+            rows.push_back(ax[0]->shape[0]);
+            // Same seed, same order
+            ASSERT_TRUE(Tensor::equivalent(ax[0], bx[0], 0.0f));
+            for (int k = 0; k < ax[0]->shape[0]; k++) seen[(int)ay[0]->ptr[k]]++;
+        }
+        ASSERT_FALSE(b.next(bx, by));
+        ASSERT_EQ(rows, vector<int>({8, 8, 4}));
+        for (int c : seen) ASSERT_EQ(c, 1);
+    }
+
+    delete x;
+    delete y;
+}
+
+
+TEST(NetTestSuite, dataloader_binary_files_fit){
+    const int n = 64;
+    Tensor *x = Tensor::randn({n, 10});
+    Tensor *y = Tensor::zeros({n, 3});
+    for (int i = 0; i < n; i++) y->ptr[i * 3 + (i % 3)] = 1.0f;
+    x->save("test_dataloader_x.bin", "bin");
+    y->save("test_dataloader_y.bin", "bin");
+
+    BinaryFileDataSource source({"test_dataloader_x.bin"}, {"test_dataloader_y.bin"});
+    ASSERT_EQ(source.num_samples(), n);
+
+    // In order: the batches are the rows of the files
+    {
+        DataLoader loader(&source, 16, false);
+        vtensor bx, by;
+        for (int b = 0; loader.next(bx, by); b++) {
+            Tensor *rows = x->select({to_string(b * 16) + ":" + to_string((b + 1) * 16)});
+            ASSERT_TRUE(Tensor::equivalent(bx[0], rows, 0.0f));
+            delete rows;
+        }
+    }
+
+    layer in = Input({10});
+    layer out = Softmax(Dense(ReLu(Dense(in, 16)), 3));
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+    build(net, sgd(0.01), {"categorical_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(), true);
+
+    DataLoader loader(&source, 8);
+    fit(net, &loader, 2);
+    ASSERT_EQ(net->batch_size, 8);
+    ASSERT_EQ(net->tr_batches, 2 * (n / 8));
+
+    // 64 = 6 * 10 + 4: the tail batch resizes the net
+    DataLoader tail_loader(&source, 10, true, DATALOADER_WORKERS, DATALOADER_BUFFERS, false);
+    fit(net, &tail_loader, 2);
+    ASSERT_EQ(net->tr_batches, 2 * (n / 8) + 2 * 7);
+    ASSERT_EQ(net->batch_size, 4);
+
+    delete net;
+    delete x;
+    delete y;
+    std::remove("test_dataloader_x.bin");
+    std::remove("test_dataloader_y.bin");
+}
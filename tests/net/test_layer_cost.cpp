@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include "eddl/apis/eddl.h"
+
+
+using namespace eddl;
+
+
+TEST(NetTestSuite, layer_cost){
+    layer in = Input({3, 8, 8});
+    layer conv = Conv2D(in, 4, {3, 3});
+    layer pool = MaxPool2D(conv, {2, 2}, {2, 2});
+    layer dense = Dense(Flatten(pool), 5);
+    model net = Model({in}, {dense});
+    net->verbosity_level = 0;
+    build(net, sgd(0.01f), {"mse"}, {"mse"}, CS_CPU(), true);
+    net->resize(2);
+
+    // Conv: 2*4*8*8 outputs, each one a dot product of 3*3*3 elements (+bias)
+    LayerCost c = conv->get_cost();
+    ASSERT_DOUBLE_EQ(c.fwd_flops, 2.0 * (2 * 4 * 8 * 8) * 27 + (2 * 4 * 8 * 8));
+
+    // MaxPool: 2*4*4*4 outputs, 2x2 window
+    LayerCost p = pool->get_cost();
+    ASSERT_DOUBLE_EQ(p.fwd_flops, (2 * 4 * 4 * 4) * 4.0);
+
+    // Dense: batch(2) x in(64) x out(5) MACs (+bias)
+    LayerCost d = dense->get_cost();
+    ASSERT_DOUBLE_EQ(d.fwd_flops, 2.0 * 2 * 64 * 5 + 2 * 5);
+    ASSERT_DOUBLE_EQ(d.fwd_bytes, (2 * 64 + 64 * 5 + 2 * 5) * sizeof(float));
+
+    // The summary includes the cost section once built
+    string s = net->summary(false);
+    ASSERT_NE(s.find("Cost (batch=2"), string::npos);
+
+    delete net;
+}
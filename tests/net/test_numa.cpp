@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/hardware/cpu/cpu_numa.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+
+TEST(NetTestSuite, numa_affinity_order){
+    vector<vector<int>> topology = {{0, 1, 2, 3}, {4, 5, 6, 7}};
+    ASSERT_TRUE(cpu_affinity_order(topology, "close") == vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+    ASSERT_TRUE(cpu_affinity_order(topology, "spread") == vector<int>({0, 4, 1, 5, 2, 6, 3, 7}));
+
+    // Uneven nodes (e.g. some CPUs not allowed to the process)
+    topology = {{0, 1}, {4, 5, 6}};
+    ASSERT_TRUE(cpu_affinity_order(topology, "spread") == vector<int>({0, 4, 1, 5, 6}));
+    ASSERT_THROW(cpu_affinity_order(topology, "compact"), std::runtime_error);
+
+    ASSERT_FALSE(cpu_numa_topology().empty());
+    ASSERT_THROW(CS_CPU(-1, "full_mem", "compact"), std::runtime_error);
+}
+
+
+TEST(NetTestSuite, numa_placement_keeps_values){
+    Tensor *t = Tensor::randn({1 << 20});
+    Tensor *ref = t->clone();
+    cpu_numa_interleave(t->ptr, t->size * sizeof(float));  // May be refused (containers): the data must not change anyway
+    ASSERT_TRUE(Tensor::equivalent(t, ref, 0.0f, 0.0f, true, true));
+
+    // Nets placed with NUMA awareness compute the same
+    auto make = [](bool numa) {
+        layer in = Input({16});
+        layer out = Softmax(Dense(ReLu(Dense(in, 32)), 4));
+        model net = Model({in}, {out});
+        net->verbosity_level = 0;
+        build(net, adam(0.01), {"softmax_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(-1, "full_mem", "none", numa), true);
+        return net;
+    };
+    ASSERT_FALSE(cpu_numa_first_touch_enabled());
+    model a = make(false);
+    model b = make(true);
+    model c = make(true);
+    ASSERT_TRUE(cpu_numa_first_touch_enabled());
+    for (int i = 0; i < a->layers.size(); i++)
+        for (int j = 0; j < a->layers[i]->params.size(); j++)
+            Tensor::copy(a->layers[i]->params[j], b->layers[i]->params[j]);
+
+    Tensor *x = Tensor::randn({64, 16});
+    Tensor *y = Tensor::zeros({64, 4});
+    for (int i = 0; i < 64; i++) y->ptr[i * 4 + i % 4] = 1.0f;
+    for (int k = 0; k < 3; k++) {
+        train_batch(a, {x}, {y});
+        train_batch(b, {x}, {y});
+    }
+    for (int i = 0; i < a->layers.size(); i++)
+        for (int j = 0; j < a->layers[i]->params.size(); j++)
+            ASSERT_TRUE(Tensor::equivalent(a->layers[i]->params[j], b->layers[i]->params[j], 1e-5f));
+
+    // Enabled while some placed net is alive
+    delete b;
+    ASSERT_TRUE(cpu_numa_first_touch_enabled());
+    delete c;
+    ASSERT_FALSE(cpu_numa_first_touch_enabled());
+
+    delete a;
+    delete x; delete y;
+    delete t; delete ref;
+}
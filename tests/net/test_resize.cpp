@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "eddl/apis/eddl.h"
+
+#include "eddl/tensor/tensor.h"
+
+
+using namespace eddl;
+
+
+TEST(NetTestSuite, net_resize_reuses_buffers){
+    layer in = Input({3, 8, 8});
+    layer l = ReLu(Conv2D(in, 4, {3, 3}));
+    l = MaxPool2D(l, {2, 2});
+    l = Dropout(l, 0.5);
+    layer out = Softmax(Dense(Reshape(l, {-1}), 5));
+    model net = Model({in}, {out});
+    net->verbosity_level = 0;
+    build(net, sgd(0.01), {"categorical_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(), true);
+
+    Tensor *x8 = Tensor::randn({8, 3, 8, 8});
+    Tensor *x3 = x8->select({"0:3"});
+    Tensor *y8 = predict(net, {x8})[0];
+    Tensor *y3 = predict(net, {x3})[0];
+
+    // Alternating batch sizes keeps the largest allocation and gives the same results
+    Tensor *conv_out = net->layers[1]->output;
+    float *conv_ptr = conv_out->ptr;
+    for (int k = 0; k < 3; k++) {
+        Tensor *a = predict(net, {x8})[0];
+        ASSERT_TRUE(Tensor::equivalent(a, y8, 1e-5f));
+        Tensor *b = predict(net, {x3})[0];
+        ASSERT_TRUE(Tensor::equivalent(b, y3, 1e-5f));
+        ASSERT_EQ(conv_out->ptr, conv_ptr);
+        delete a;
+        delete b;
+    }
+
+    delete y3;
+    delete y8;
+    delete x3;
+    delete x8;
+    delete net;
+}
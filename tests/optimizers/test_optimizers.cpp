@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "eddl/apis/eddl.h"
+#include "eddl/tensor/tensor.h"
+#include "eddl/hardware/cpu/cpu_optim.h"
+
+
+using namespace eddl;
+
+
+// Norm of the step applied by the optimizer: || W_before - W_after ||
+static float step_norm(Tensor *before, Tensor *after){
+    Tensor *d = Tensor::sub(before, after);
+    float n = d->norm();
+    delete d;
+    return n;
+}
+
+TEST(OptimizerTestSuite, lars_trust_ratio){
+    // Without momentum and weight decay, the step of a weight tensor is lr*eta*||w||, whatever ||g|| is
+    for (float gscale : {1e-3f, 1.0f, 1e3f}) {
+        Tensor *W = Tensor::randn({16, 8});
+        Tensor *G = Tensor::randn({16, 8}); G->mult_(gscale);
+        Tensor *V = Tensor::zeros({16, 8});
+        Tensor *W0 = W->clone();
+
+        cpu_lars_update(W, G, V, nullptr, 0.1f, 0.0f, 0.0f, 0.001f, 0.0f, true);
+        ASSERT_NEAR(step_norm(W0, W), 0.1f * 0.001f * W0->norm(), 1e-6f);
+
+        delete W; delete G; delete V; delete W0;
+    }
+
+    // Not adapted (biases): plain SGD
+    Tensor *b = Tensor::randn({8}), *g = Tensor::randn({8}), *v = Tensor::zeros({8});
+    Tensor *b0 = b->clone();
+    cpu_lars_update(b, g, v, nullptr, 0.1f, 0.9f, 0.5f, 0.001f, 0.0f, false);
+    ASSERT_NEAR(step_norm(b0, b), 0.1f * g->norm(), 1e-5f);
+    delete b; delete g; delete v; delete b0;
+}
+
+TEST(OptimizerTestSuite, lamb_reference){
+    float lr = 0.01f, beta_1 = 0.9f, beta_2 = 0.999f, eps = 1e-6f, wd = 0.01f;
+    Tensor *W = Tensor::randn({12, 10});
+    Tensor *M = Tensor::zeros(W->getShape()), *V = Tensor::zeros(W->getShape()), *U = Tensor::zeros(W->getShape());
+    Tensor *ACC = Tensor::zeros(W->getShape());
+    Tensor *W0 = W->clone();
+    vector<double> w(W->ptr, W->ptr + W->size), m(W->size, 0.0), v(W->size, 0.0), u(W->size);
+
+    for (int t = 1; t <= 3; t++) {
+        Tensor *G = Tensor::randn(W->getShape());
+
+        double w2 = 0.0, u2 = 0.0;
+        for (int i = 0; i < W->size; i++) {
+            m[i] = beta_1 * m[i] + (1 - beta_1) * G->ptr[i];
+            v[i] = beta_2 * v[i] + (1 - beta_2) * G->ptr[i] * G->ptr[i];
+            u[i] = (m[i] / (1 - std::pow(beta_1, t))) / (std::sqrt(v[i] / (1 - std::pow(beta_2, t))) + eps) + wd * w[i];
+            w2 += w[i] * w[i]; u2 += u[i] * u[i];
+        }
+        double ratio = std::sqrt(w2) / std::sqrt(u2);
+        for (int i = 0; i < W->size; i++) w[i] -= lr * ratio * u[i];
+
+        cpu_lamb_update(W, G, M, V, U, ACC, lr, beta_1, beta_2, eps, wd, t, true);
+        delete G;
+    }
+
+    for (int i = 0; i < W->size; i++) ASSERT_NEAR(W->ptr[i], w[i], 1e-5);
+    // The accumulated gradients receive the same steps as the weights
+    Tensor *steps = Tensor::sub(W, W0);
+    ASSERT_TRUE((bool) Tensor::equivalent(steps, ACC, 1e-5f, 1e-5f));
+    delete steps; delete W0;
+
+    delete W; delete M; delete V; delete U; delete ACC;
+}
+
+TEST(OptimizerTestSuite, adam_reference){
+    float lr = 0.01f, beta_1 = 0.9f, beta_2 = 0.999f, eps = 1e-8f;
+    Tensor *W = Tensor::randn({12, 10});
+    Tensor *M = Tensor::zeros(W->getShape()), *V = Tensor::zeros(W->getShape());
+    Tensor *ACC = Tensor::zeros(W->getShape());
+    Tensor *W0 = W->clone();
+    vector<double> w(W->ptr, W->ptr + W->size), m(W->size, 0.0), v(W->size, 0.0);
+
+    for (int t = 1; t <= 3; t++) {
+        Tensor *G = Tensor::randn(W->getShape());
+
+        for (int i = 0; i < W->size; i++) {
+            m[i] = beta_1 * m[i] + (1 - beta_1) * G->ptr[i];
+            v[i] = beta_2 * v[i] + (1 - beta_2) * G->ptr[i] * G->ptr[i];
+            w[i] -= lr * (m[i] / (1 - std::pow(beta_1, t))) / std::sqrt(v[i] / (1 - std::pow(beta_2, t)) + eps);
+        }
+
+        cpu_adam_update(W->ptr, G->ptr, M->ptr, V->ptr, ACC->ptr, W->size, lr, beta_1, beta_2, eps, t);
+        delete G;
+    }
+
+    for (int i = 0; i < W->size; i++) ASSERT_NEAR(W->ptr[i], w[i], 1e-5);
+    Tensor *steps = Tensor::sub(W, W0);
+    ASSERT_TRUE((bool) Tensor::equivalent(steps, ACC, 1e-5f, 1e-5f));
+    delete steps; delete W0;
+
+    delete W; delete M; delete V; delete ACC;
+}
+
+TEST(OptimizerTestSuite, lars_lamb_train){
+    for (int k = 0; k < 2; k++) {
+        layer in = Input({16});
+        layer l = ReLu(BatchNormalization(Dense(in, 32)));
+        layer out = Softmax(Dense(l, 4));
+        model net = Model({in}, {out});
+        net->verbosity_level = 0;
+        build(net, k == 0 ? lars(0.5f) : lamb(0.01f), {"categorical_cross_entropy"}, {"categorical_accuracy"}, CS_CPU(), true);
+
+        Tensor* x = Tensor::randn({8, 16});
+        Tensor* y = Tensor::zeros({8, 4});
+        for (int i = 0; i < 8; i++) y->ptr[i * 4 + (i % 4)] = 1.0f;
+
+        // The loss on the (memorizable) batch has to go down
+        vector<int> ind = {0, 1, 2, 3, 4, 5, 6, 7};
+        net->reset_loss();
+        net->train_batch({x}, {y}, ind);
+        float first = net->get_losses()[0];
+        for (int i = 0; i < 30; i++) net->train_batch({x}, {y}, ind);
+        net->reset_loss();
+        net->train_batch({x}, {y}, ind);
+        ASSERT_LT(net->get_losses()[0], first);
+
+        delete x;
+        delete y;
+        delete net;
+    }
+}
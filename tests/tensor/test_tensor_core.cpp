@@ -107,6 +107,77 @@ TEST(TensorTestSuite, tensor_math_argsort) {
 #endif
 }
 
+TEST(TensorTestSuite, tensor_math_topk) {
+    // Along the last axis: values and positions, ties by position
+    Tensor *t1 = new Tensor({1.0, 5.0, 3.0, 5.0,
+                             -2.0, 0.5, 7.0, 0.0}, {2, 4}, DEV_CPU);
+    Tensor *v1 = new Tensor({2, 2}, DEV_CPU);
+    Tensor *i1 = new Tensor({2, 2}, DEV_CPU);
+    Tensor::topk(t1, v1, i1, 2);
+    Tensor *v1_ref = new Tensor({5.0, 5.0, 7.0, 0.5}, {2, 2}, DEV_CPU);
+    Tensor *i1_ref = new Tensor({1, 3, 2, 1}, {2, 2}, DEV_CPU);
+    ASSERT_TRUE(Tensor::equivalent(v1, v1_ref, 1e-6f));
+    ASSERT_TRUE(Tensor::equivalent(i1, i1_ref, 1e-6f));
+
+    // Smallest along the first axis
+    Tensor *v2 = new Tensor({1, 4}, DEV_CPU);
+    Tensor *i2 = new Tensor({1, 4}, DEV_CPU);
+    Tensor::topk(t1, v2, i2, 1, 0, false);
+    Tensor *v2_ref = new Tensor({-2.0, 0.5, 3.0, 0.0}, {1, 4}, DEV_CPU);
+    Tensor *i2_ref = new Tensor({1, 1, 0, 1}, {1, 4}, DEV_CPU);
+    ASSERT_TRUE(Tensor::equivalent(v2, v2_ref, 1e-6f));
+    ASSERT_TRUE(Tensor::equivalent(i2, i2_ref, 1e-6f));
+
+    // Wrong k
+    ASSERT_THROW(Tensor::topk(t1, v1, i1, 5), std::runtime_error);
+
+    // Large k (selection + sort) and segmented sort along a middle axis match a full sort of every slice
+    Tensor *t3 = Tensor::randn({3, 100, 2});
+    Tensor *v3 = new Tensor({3, 40, 2}, DEV_CPU);
+    Tensor *s3 = new Tensor({3, 100, 2}, DEV_CPU);
+    Tensor *si3 = new Tensor({3, 100, 2}, DEV_CPU);
+    Tensor::topk(t3, v3, nullptr, 40, 1);
+    Tensor::sort(t3, s3, si3, 1, true);
+    for (int o = 0; o < 3; o++) {
+        for (int in = 0; in < 2; in++) {
+            vector<float> slice;
+            for (int j = 0; j < 100; j++) slice.push_back(t3->ptr[o * 200 + j * 2 + in]);
+            std::sort(slice.begin(), slice.end(), std::greater<float>());
+            for (int j = 0; j < 100; j++) {
+                ASSERT_EQ(s3->ptr[o * 200 + j * 2 + in], slice[j]);
+                ASSERT_EQ(t3->ptr[o * 200 + (int)si3->ptr[o * 200 + j * 2 + in] * 2 + in], slice[j]);
+                if (j < 40) ASSERT_EQ(v3->ptr[o * 80 + j * 2 + in], slice[j]);
+            }
+        }
+    }
+
+    // Small k over long rows (blocks skipped once the list is full), with repeated values
+    Tensor *t4 = Tensor::randn({4, 1000});
+    for (int j = 0; j < 1000; j += 7) t4->ptr[j] = 2.5f;
+    Tensor *v4 = new Tensor({4, 5}, DEV_CPU);
+    Tensor *i4 = new Tensor({4, 5}, DEV_CPU);
+    for (bool largest : {true, false}) {
+        Tensor::topk(t4, v4, i4, 5, 1, largest);
+        for (int r = 0; r < 4; r++) {
+            vector<int> order(1000);
+            for (int j = 0; j < 1000; j++) order[j] = j;
+            const float *row = t4->ptr + r * 1000;
+            std::stable_sort(order.begin(), order.end(), [row, largest](int a, int b) {
+                return largest ? row[a] > row[b] : row[a] < row[b];
+            });
+            for (int j = 0; j < 5; j++) {
+                ASSERT_EQ((int)i4->ptr[r * 5 + j], order[j]);
+                ASSERT_EQ(v4->ptr[r * 5 + j], row[order[j]]);
+            }
+        }
+    }
+
+    delete t1; delete v1; delete i1; delete v1_ref; delete i1_ref;
+    delete v2; delete i2; delete v2_ref; delete i2_ref;
+    delete t3; delete v3; delete s3; delete si3;
+    delete t4; delete v4; delete i4;
+}
+
 TEST(TensorTestSuite, tensor_squeeze) {
     // Original
     Tensor* t1 = Tensor::empty({1, 2, 3, 1, 4});
@@ -334,4 +405,70 @@ TEST(TensorTestSuite, tensor_getDeviceID) {
 //    ASSERT_TRUE(-1 == Tensor::getDeviceID("1:fpga"));
 //    ASSERT_TRUE(-1 == Tensor::getDeviceID("nodevice"));
 //    ASSERT_TRUE(-1 == Tensor::getDeviceID(""));
-}
\ No newline at end of file
+}
+TEST(TensorTestSuite, tensor_resize_keeps_capacity){
+    Tensor* t = Tensor::zeros({8, 3, 4});
+    float* data = t->ptr;
+    ASSERT_EQ(t->capacity, 8*3*4);
+
+    // Shrinking and growing back up to the capacity reuses the allocation
+    t->resize(3);
+    ASSERT_EQ(t->shape, vector<int>({3, 3, 4}));
+    ASSERT_EQ(t->size, 3*3*4);
+    ASSERT_EQ(t->ptr, data);
+    t->resize(8);
+    ASSERT_EQ(t->ptr, data);
+    ASSERT_EQ(t->capacity, 8*3*4);
+
+    // Growing beyond the capacity reallocates
+    t->resize(16);
+    ASSERT_EQ(t->size, 16*3*4);
+    ASSERT_EQ(t->capacity, 16*3*4);
+
+    // 2D tensors rebuild their Eigen map
+    Tensor* m = Tensor::ones({6, 5});
+    m->resize(2);
+    ASSERT_EQ(m->ptr2->rows(), 5);
+    ASSERT_EQ(m->ptr2->cols(), 2);
+    ASSERT_EQ(m->ptr2->data(), m->ptr);
+
+    delete m;
+    delete t;
+}
+
+TEST(TensorTestSuite, tensor_concat_blocks){
+    Tensor* a = Tensor::randn({2, 3, 4, 5});
+    Tensor* b = Tensor::randn({2, 3, 4, 5});
+
+    for(int axis=1; axis<4; axis++){
+        vector<int> shape = {2, 3, 4, 5};
+        shape[axis] *= 2;
+        Tensor* c = Tensor::concat({a, b}, axis);
+        ASSERT_EQ(c->shape, shape);
+
+        // Check every element against its source
+        for(int i=0; i<c->size; i++){
+            vector<int> idx(4);
+            for(int d=0; d<4; d++){ idx[d] = i / c->stride[d] % c->shape[d]; }
+            Tensor* src = idx[axis] < a->shape[axis] ? a : b;
+            if(src == b){ idx[axis] -= a->shape[axis]; }
+            int j = 0;
+            for(int d=0; d<4; d++){ j += idx[d] * src->stride[d]; }
+            ASSERT_EQ(c->ptr[i], src->ptr[j]);
+        }
+
+        // Derivative: accumulates the slices into the sources
+        Tensor* da = Tensor::ones(a->shape);
+        Tensor* db = Tensor::zeros(b->shape);
+        Tensor* delta = Tensor::concat({a, b}, axis);
+        Tensor::concat_back(delta, {da, db}, axis);
+        Tensor* a1 = a->clone(); a1->add_(1.0f);
+        ASSERT_TRUE(Tensor::equivalent(da, a1, 1e-6f));
+        ASSERT_TRUE(Tensor::equivalent(db, b, 1e-6f));
+
+        delete a1; delete delta; delete da; delete db; delete c;
+    }
+
+    delete a;
+    delete b;
+}
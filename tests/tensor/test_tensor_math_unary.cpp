@@ -1,10 +1,13 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include <string>
 
 #include "eddl/tensor/tensor.h"
 #include "eddl/tensor/nn/tensor_nn.h"
 #include "eddl/descriptors/descriptors.h"
+#include "eddl/hardware/cpu/cpu_fastmath.h"
 
 
 using namespace std;
@@ -1934,3 +1937,65 @@ TEST(TensorTestSuite, tensor_math_unary_var){
     
 #endif
 }
+
+
+TEST(TensorTestSuite, tensor_math_unary_fastmath){
+    // Accuracy against libm, including values near the overflow/underflow limits
+    int n = 200001;
+    vector<float> x(n), y(n);
+    float max_err;
+
+    // exp up to ln(FLT_MAX), with explicit points where the scale 2^n reaches 2^128
+    for (int i = 0; i < n - 3; i++) x[i] = -87.0f + 175.72f * (float)i / (float)(n - 4);
+    x[n - 3] = 88.38f; x[n - 2] = 88.5f; x[n - 1] = 88.72f;
+    cpu_fast_exp(x.data(), y.data(), n);
+    max_err = 0.0f;
+    for (int i = 0; i < n; i++) {
+        ASSERT_TRUE(std::isfinite(y[i])) << "exp(" << x[i] << ")";
+        max_err = std::max(max_err, std::fabs(y[i] - std::exp(x[i])) / std::exp(x[i]));
+    }
+    ASSERT_LT(max_err, 2e-7f);
+    float big[3] = {88.73f, 100.0f, -100.0f}, big_y[3];
+    cpu_fast_exp(big, big_y, 3);
+    ASSERT_TRUE(std::isinf(big_y[0]) && std::isinf(big_y[1]));
+    ASSERT_EQ(big_y[2], 0.0f);
+
+    for (int i = 0; i < n; i++) x[i] = std::ldexp(1.0f + (float)(i % 1000) / 1000.0f, i / 1000 - 100);
+    cpu_fast_log(x.data(), y.data(), n);
+    max_err = 0.0f;
+    for (int i = 0; i < n; i++) max_err = std::max(max_err, std::fabs(y[i] - std::log(x[i])) / std::max(1.0f, std::fabs(std::log(x[i]))));
+    ASSERT_LT(max_err, 2e-7f);
+
+    for (int i = 0; i < n; i++) x[i] = -20.0f + 40.0f * (float)i / (float)(n - 1);
+    cpu_fast_tanh(x.data(), y.data(), n);
+    max_err = 0.0f;
+    for (int i = 0; i < n; i++) max_err = std::max(max_err, std::fabs(y[i] - std::tanh(x[i])));
+    ASSERT_LT(max_err, 1e-6f);
+
+    cpu_fast_sigmoid(x.data(), y.data(), n);
+    max_err = 0.0f;
+    for (int i = 0; i < n; i++) max_err = std::max(max_err, std::fabs(y[i] - 1.0f / (1.0f + std::exp(-x[i]))));
+    ASSERT_LT(max_err, 1e-6f);
+
+    // The generic tensor ops keep libm
+    Tensor *t = new Tensor({-3.7f, -0.1f, 0.3f, 2.9f, 41.0f}, {5}, DEV_CPU);
+    Tensor *e = t->exp();
+    Tensor *l = e->log();
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(e->ptr[i], ::expf(t->ptr[i]));
+        ASSERT_EQ(l->ptr[i], ::logf(e->ptr[i]));
+    }
+    delete t; delete e; delete l;
+
+    // Limits
+    ASSERT_EQ(fast_expf(-100.0f), 0.0f);
+    ASSERT_TRUE(std::isinf(fast_expf(100.0f)));
+    ASSERT_EQ(fast_expf(0.0f), 1.0f);
+    ASSERT_TRUE(std::isinf(fast_logf(0.0f)) && fast_logf(0.0f) < 0.0f);
+    ASSERT_TRUE(std::isnan(fast_logf(-1.0f)));
+    ASSERT_EQ(fast_logf(1.0f), 0.0f);
+    ASSERT_EQ(fast_tanhf(100.0f), 1.0f);
+    ASSERT_EQ(fast_tanhf(-100.0f), -1.0f);
+    ASSERT_EQ(fast_sigmoidf(-200.0f), 0.0f);
+    ASSERT_EQ(fast_sigmoidf(200.0f), 1.0f);
+}
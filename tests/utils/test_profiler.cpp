@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "eddl/profiler.h"
+#include "eddl/tensor/tensor.h"
+
+using namespace std;
+
+
+static void profiler_nested_zones(){
+    PROFILER_ZONE("outer", PROFILER_NET);
+    for (int i = 0; i < 3; i++) {
+        PROFILER_ZONE("inner \"quoted\"", PROFILER_FORWARD);
+    }
+}
+
+
+TEST(UtilsTestSuite, profiler_chrome_trace){
+    string fname = "test_profiler.json";
+
+    profiler_enable(true);
+    profiler_reset();
+
+    std::thread t1(profiler_nested_zones);
+    std::thread t2(profiler_nested_zones);
+    t1.join();
+    t2.join();
+
+    // Kernels are recorded through _profile()
+    Tensor* t = Tensor::ones({16, 16});
+    t->add_(1.0f);
+
+    profiler_enable(false);
+    profiler_nested_zones();  // Not recorded
+
+    ASSERT_TRUE(profiler_export_chrome_trace(fname));
+    std::ifstream ifs(fname);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    string trace = ss.str();
+
+    // 2 threads x (1 outer + 3 inner)
+    int outer = 0, inner = 0;
+    for (size_t p = trace.find("\"outer\""); p != string::npos; p = trace.find("\"outer\"", p + 1)) outer++;
+    for (size_t p = trace.find("inner \\\"quoted\\\""); p != string::npos; p = trace.find("inner \\\"quoted\\\"", p + 1)) inner++;
+    ASSERT_EQ(outer, 2);
+    ASSERT_EQ(inner, 6);
+    ASSERT_NE(trace.find("\"cat\": \"kernel\""), string::npos);
+
+    profiler_reset();
+    std::remove(fname.c_str());
+    delete t;
+}
+
+
+TEST(UtilsTestSuite, profiler_register_zones){
+    int a = profiler_register("test zone", PROFILER_NET);
+    int b = profiler_register("test zone", PROFILER_FORWARD);
+    ASSERT_GE(a, 0);
+    ASSERT_NE(a, b);
+    ASSERT_EQ(profiler_register("test zone", PROFILER_NET), a);
+
+    // Unscoped begin/end pairs are matched by the zone
+    profiler_enable(true);
+    profiler_begin(a);
+    profiler_end(b);  // Ignored
+    profiler_end(a);
+    profiler_enable(false);
+    profiler_reset();
+}
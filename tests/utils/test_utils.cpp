@@ -3,6 +3,8 @@
 #include <string>
 
 #include "eddl/utils.h"
+#include "eddl/hardware/cpu/cpu_parallel.h"
+#include "eddl/tensor/tensor.h"
 
 using namespace std;
 
@@ -204,4 +206,31 @@ TEST(UtilsTestSuite, parse_indices){
     indices_ref = {{1, 1}, {0, 22}, {16, 27}};
     ASSERT_TRUE(indices.size()==indices_ref.size());
     for(int i=0; i<indices.size(); i++){ ASSERT_TRUE(indices[i] == indices_ref[i]); }
-}
\ No newline at end of file
+}
+
+
+TEST(UtilsTestSuite, cpu_threads_grain){
+    long int saved = cpu_grain;
+    cpu_set_grain(1000);
+    int max_threads = cpu_threads(1L << 30, CPU_COST_CHEAP);
+
+    // Serial below two grains of work, then one thread per grain (up to the OpenMP maximum)
+    ASSERT_EQ(cpu_threads(100, CPU_COST_CHEAP), 1);
+    ASSERT_EQ(cpu_threads(1999, CPU_COST_CHEAP), 1);
+    ASSERT_GE(max_threads, 1);
+    ASSERT_EQ(cpu_threads(2000, CPU_COST_CHEAP), std::min(2, max_threads));
+    ASSERT_EQ(cpu_threads(500, CPU_COST_HEAVY), std::min(8, max_threads));
+    ASSERT_THROW(cpu_set_grain(0), std::runtime_error);
+
+    // Same results with any number of threads
+    Tensor* A = Tensor::randn({100003});
+    Tensor* serial = A->sqrt();
+    cpu_set_grain(1);
+    Tensor* parallel = A->sqrt();
+    ASSERT_TRUE(Tensor::equivalent(serial, parallel, 0.0f, 0.0f, true, true));
+
+    ASSERT_GT(cpu_calibrate_grain(), 0);
+
+    cpu_set_grain(saved);
+    delete A; delete serial; delete parallel;
+}